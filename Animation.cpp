@@ -0,0 +1,123 @@
+#include "Animation.h"
+
+#include <cassert>
+
+
+namespace Animation
+{
+	/* Type [Animation::Timeline] Definition */
+	size_t Timeline::add(float from,float to,double start,double duration,Easing easing)
+	{
+		float linear = 1.0f;
+		float quadratic = 0.0f;
+		float cubic = 0.0f;
+
+
+		switch(easing)
+		{
+			case Easing::LINEAR:
+				break;
+
+			case Easing::EASE_IN:  //t^3
+				linear = 0.0f;
+				cubic = 1.0f;
+
+				break;
+
+			case Easing::EASE_OUT:  //1 - (1 - t)^3
+				linear = 3.0f;
+				quadratic = -3.0f;
+				cubic = 1.0f;
+
+				break;
+
+			case Easing::EASE_IN_OUT:  //3t^2 - 2t^3
+				linear = 0.0f;
+				quadratic = 3.0f;
+				cubic = -2.0f;
+
+				break;
+		}
+
+		this->start.push_back(start);
+		this->end.push_back(start + duration);
+		this->inverse_duration.push_back(duration > 0.0 ? (float)(1.0 / duration) : 1.0e30f);  //A tween without duration is finished as soon as it starts.
+		this->from.push_back(from);
+		this->change.push_back(to - from);
+		this->linear.push_back(linear);
+		this->quadratic.push_back(quadratic);
+		this->cubic.push_back(cubic);
+		this->values.push_back(from);
+
+		return this->values.size() - 1;
+	}
+
+	void Timeline::evaluate(double now)
+	{
+		size_t count = this->values.size();
+		const double* start = this->start.data();
+		const float* inverse_duration = this->inverse_duration.data();
+		const float* from = this->from.data();
+		const float* change = this->change.data();
+		const float* linear = this->linear.data();
+		const float* quadratic = this->quadratic.data();
+		const float* cubic = this->cubic.data();
+		float* values = this->values.data();
+
+
+		for(size_t tween = 0;tween < count;++tween)
+		{
+			float t = (float)(now - start[tween]) * inverse_duration[tween];
+
+
+			t = t < 0.0f ? 0.0f : t;
+			t = t > 1.0f ? 1.0f : t;
+			values[tween] = from[tween] + change[tween] * (t * (linear[tween] + t * (quadratic[tween] + t * cubic[tween])));
+		}
+	}
+
+	size_t Timeline::getCount() const
+	{
+		return this->values.size();
+	}
+
+	double Timeline::getEnd(size_t tween) const
+	{
+		return this->end[tween];
+	}
+
+	float Timeline::getValue(size_t tween) const
+	{
+		return this->values[tween];
+	}
+
+	size_t Timeline::remove(size_t tween)
+	{
+		size_t last = this->values.size() - 1;
+
+
+		assert(tween <= last);
+
+		this->start[tween] = this->start[last];
+		this->end[tween] = this->end[last];
+		this->inverse_duration[tween] = this->inverse_duration[last];
+		this->from[tween] = this->from[last];
+		this->change[tween] = this->change[last];
+		this->linear[tween] = this->linear[last];
+		this->quadratic[tween] = this->quadratic[last];
+		this->cubic[tween] = this->cubic[last];
+		this->values[tween] = this->values[last];
+
+		this->start.pop_back();
+		this->end.pop_back();
+		this->inverse_duration.pop_back();
+		this->from.pop_back();
+		this->change.pop_back();
+		this->linear.pop_back();
+		this->quadratic.pop_back();
+		this->cubic.pop_back();
+		this->values.pop_back();
+
+		return last;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * Tweens kept as a structure of arrays, so that every value of a frame is interpolated by one tight loop the compiler can vectorize.  Easing curves are cubic polynomials whose coefficients are stored per tween, which keeps the loop free of branches.
+ */
+namespace Animation
+{
+	/* Types */
+	enum class Easing
+	{
+		LINEAR,
+		EASE_IN,
+		EASE_OUT,
+		EASE_IN_OUT,
+	};
+
+	/* Class Prototypes */
+	class Timeline
+	{
+		private:
+			std::vector<double> start;  //In milliseconds.
+			std::vector<double> end;
+			std::vector<float> inverse_duration;
+			std::vector<float> from;
+			std::vector<float> change;
+			std::vector<float> linear;  //Coefficients of the easing curve, from t to t cubed.
+			std::vector<float> quadratic;
+			std::vector<float> cubic;
+			std::vector<float> values;
+
+		public:
+			/**
+			 * Adds a tween running from one value to another.
+			 *
+			 * @return Returns the index of the new tween, which stays valid until a tween is removed.
+			 */
+			size_t add(float from,float to,double start,double duration,Easing easing);
+
+			/**
+			 * Interpolates the value of every tween for the given time.  Tweens which have not started yet hold their initial value and those which have finished hold their final value.
+			 */
+			void evaluate(double now);
+
+			size_t getCount() const;
+
+			double getEnd(size_t tween) const;
+
+			/**
+			 * Gets the value of a tween as of the last call to evaluate.
+			 */
+			float getValue(size_t tween) const;
+
+			/**
+			 * Removes a tween by moving the last tween into its place.
+			 *
+			 * @return Returns the index the moved tween had, which equals the removed tween's index if it was the last one.
+			 */
+			size_t remove(size_t tween);
+	};
+}
+
+#endif
\ No newline at end of file
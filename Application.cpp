@@ -1,8 +1,12 @@
 ﻿#pragma comment(lib,"comctl32.lib")
 
 #include "Application.h"
+#include "Layout.h"
 #include <CommCtrl.h>
 #include "./Resources/Resources.h"
+#include "Trace.h"
+#include <cstring>
+#include <future>
 #include <utility>
 
 #include <string>
@@ -10,32 +14,58 @@
 
 std::string wstos(const std::wstring& wstring)
 {
-	char* buffer;
-	size_t buffer_size = wstring.length() + 1;
-	std::string string;
+	std::string string(wstring.length(),'\0');
 
 
-	buffer = new char[buffer_size];
-	buffer[buffer_size - 1] = 0;
-	wcstombs(buffer,wstring.c_str(),buffer_size);
-	string = buffer;
-	delete[] buffer;
+	for(size_t offset = 0;offset < wstring.length();++offset)  //Names of procedures and the like are ASCII, which needs no conversion through the locale.
+	{
+		if(wstring[offset] >= 0x80)
+		{
+			string.assign(wstring.length() + 1,'\0');
+			wcstombs(&string[0],wstring.c_str(),string.length());
+			string.resize(std::strlen(string.c_str()));
+
+			return string;
+		}
+		string[offset] = (char)wstring[offset];
+	}
 
 	return string;
 }
 
 namespace Application
 {
+	struct ClassDescription  //Everything about a window class which can be resolved off the UI thread.
+	{
+		std::wstring name;
+	};
+
+	struct WindowDescription
+	{
+		std::wstring class_name;
+		OS::WindowOnClickCallback on_click;
+		OS::WindowOnCreateCallback on_create;
+		OS::WindowOnDestroyCallback on_destroy;
+	};
+
 	int exit_code;
 	std::vector<OS::WindowClass*> loaded_classes;
+	std::vector<OS::UIClass*> loaded_ui_classes;
 	OS::Module* module;
+	OS::ResourcePack* resource_pack;
 	OS::Window* window;
 	OS::Window* button;
 
 	/* Function Definitions */
 	void Execute()
 	{
-		window->show(SW_SHOWNORMAL);
+		{
+			TRACE_SCOPE("Application::Execute (show)");
+
+
+			window->show(SW_SHOWNORMAL);
+			UpdateWindow(window->getNativeHandle());  //Paints now, so that the first paint is part of the traced scope.
+		}
 		
 		exit_code = OS::StartMessageLoop();
 	}
@@ -50,24 +80,98 @@ namespace Application
 		return *Application::module;
 	}
 
-	void Load()
+	void Load(bool concurrent)
 	{
+		TRACE_SCOPE("Application::Load");
 		OS::Module& module = Application::GetModule();
+		std::launch policy = concurrent ? std::launch::async : std::launch::deferred;
+		LARGE_INTEGER load_start;
+		LARGE_INTEGER phase_start;
 
 		
+		QueryPerformanceCounter(&load_start);
+		phase_start = load_start;
+
+		/* Prefer a resource pack shipped beside the executable over the linked resources. */
+		{
+			wchar path[MAX_PATH];
+			std::wstring pack_path;
+
+
+			GetModuleFileName(module,path,MAX_PATH);
+			pack_path = path;
+			pack_path = pack_path.substr(0,pack_path.find_last_of(L"\\/") + 1).append(L"Resources.pack");
+			if(GetFileAttributes(pack_path.c_str()) != INVALID_FILE_ATTRIBUTES)
+			{
+				Application::resource_pack = new OS::ResourcePack(pack_path);
+				module.attachResourcePack(Application::resource_pack);
+			}
+		}
+		phase_start = Application::ReportStartupPhase(L"Attach resource pack",phase_start);
+
+		/* Resolve the descriptions of the classes and windows concurrently.  Only native objects are thread-affine, so everything else is looked up while the UI thread initializes the common controls. */
+		std::future<std::vector<OS::UIClass*>> ui_classes = std::async(policy,[module]() mutable {
+			TRACE_SCOPE("Application::Load (UI classes)");
+			std::vector<OS::UIClass*> ui_classes;
+
+
+			ui_classes.push_back(OS::UIClass::Load(module,Application_UIClass_Window));  //Classes are loaded before those extending them.
+			ui_classes.push_back(OS::UIClass::Load(module,Application_UIClass_PushButton));
+
+			return ui_classes;
+		});
+		std::future<ClassDescription> button_class_description = std::async(policy,[module]() mutable {
+			TRACE_SCOPE("Application::Load (button class description)");
+			ClassDescription description;
+
+
+			description.name = module.getStringResource(Application_UIClass_Button_Name);
+
+			return description;
+		});
+		std::future<WindowDescription> main_window_description = std::async(policy,[module]() mutable {
+			TRACE_SCOPE("Application::Load (main window description)");
+			WindowDescription description;
+
+
+			description.class_name = module.getStringResource(Application_MainWindow_Class);
+			description.on_create = module.getProcedure<OS::WindowOnCreateCallbackSignature>(wstos(module.getStringResource(Application_MainWindow_OnCreate)).c_str());
+
+			return description;
+		});
+		std::future<WindowDescription> mad_button_description = std::async(policy,[module]() mutable {
+			TRACE_SCOPE("Application::Load (mad button description)");
+			WindowDescription description;
+
+
+			description.class_name = module.getStringResource(Application_MadButton_Class);
+			description.on_click = module.getProcedure<OS::WindowOnClickCallbackSignature>(wstos(module.getStringResource(Application_MadButton_OnClick)).c_str());
+			description.on_create = module.getProcedure<OS::WindowOnCreateCallbackSignature>(wstos(module.getStringResource(Application_MadButton_OnCreate)).c_str());
+			description.on_destroy = module.getProcedure<OS::WindowOnDestroyCallbackSignature>(wstos(module.getStringResource(Application_MadButton_OnDestroy)).c_str());
+
+			return description;
+		});
+		std::future<void> configuration = std::async(policy,[module]() mutable {
+			TRACE_SCOPE("Application::Load (configuration)");
+
+
+			module.getResourceEntry(Application_Config,L"XML");  //Indexes (and, if packed compressed, decompresses) the configuration ahead of its use.
+		});
+
+		phase_start = Application::ReportStartupPhase(L"Resolve descriptions (dispatch)",phase_start);
 		InitCommonControls();
+		phase_start = Application::ReportStartupPhase(L"Initialize common controls",phase_start);
 
 		/* Register the window class(es). */
 		{
-			OS::WindowOnCloseCallback class_on_close = Application::GetModule().getProcedure<OS::WindowOnCloseCallbackSignature>(wstos(module.getStringResource(Application_UIClass_Window_OnClose)).c_str());
+			TRACE_SCOPE("Application::Load (register classes)");
 			OS::WindowClass* window_class;
 
 
-			window_class = OS::WindowClass::Register(module.getStringResource(Application_UIClass_Window_Name),module);
+			Application::loaded_ui_classes = ui_classes.get();
+
+			window_class = OS::WindowClass::Register(Application::loaded_ui_classes.front()->getWindowClassName(),module);  //The window UIClass, whose handlers are attached to each of its windows as it is instantiated.
 			window_class->setWindowDefaults(WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX,WS_EX_APPWINDOW,0,0,0,0);
-			window_class->extendDefaultMessageHandler(WM_CLOSE,[class_on_close](OS::Window* window,WPARAM w_param,LPARAM l_param){
-				class_on_close(*window);
-			});
 
 			Application::loaded_classes.push_back(window_class);
 		}
@@ -76,36 +180,72 @@ namespace Application
 			OS::WindowClass* window_class;
 
 
-			window_class = OS::WindowClass::GetByName(module.getStringResource(Application_UIClass_Button_Name));
+			window_class = OS::WindowClass::GetByName(button_class_description.get().name);  //A system class, which is left registered when the application is unloaded.
 			window_class->setWindowDefaults(WS_TABSTOP | WS_CHILD | BS_PUSHBUTTON,0,0,0,0,0);
-
-			Application::loaded_classes.push_back(window_class);
 		}
+		phase_start = Application::ReportStartupPhase(L"Register classes",phase_start);
 
 		/* Set up the window(s). */
 		{
-			OS::WindowOnCreateCallback on_create = module.getProcedure<OS::WindowOnCreateCallbackSignature>(wstos(module.getStringResource(Application_MainWindow_OnCreate)).c_str());
+			TRACE_SCOPE("Application::Load (main window)");
+			WindowDescription description = main_window_description.get();
 
 
-			window = OS::WindowClass::GetByName(module.getStringResource(Application_MainWindow_Class),module)->instantiate();
-			on_create(*window);
+			window = OS::UIClass::GetByName(description.class_name)->instantiate<MainWindow>();
+			description.on_create(*window);
 		}
 
 		{
-			OS::WindowOnClickCallback on_click = module.getProcedure<OS::WindowOnClickCallbackSignature>(wstos(module.getStringResource(Application_MadButton_OnClick)).c_str());
-			OS::WindowOnCreateCallback on_create = module.getProcedure<OS::WindowOnCreateCallbackSignature>(wstos(module.getStringResource(Application_MadButton_OnCreate)).c_str());
-			OS::WindowOnDestroyCallback on_destroy = module.getProcedure<OS::WindowOnDestroyCallbackSignature>(wstos(module.getStringResource(Application_MadButton_OnDestroy)).c_str());
-
-			button = OS::WindowClass::GetByName(module.getStringResource(Application_MadButton_Class),module)->instantiate();
-			button->extendMessageHandler(WM_LBUTTONUP,[on_click](OS::Window* window,WPARAM w_param,LPARAM l_param){
-				on_click(*window);
-			});
-			button->extendMessageHandler(WM_DESTROY,[on_destroy](OS::Window* window,WPARAM w_param,LPARAM l_param){
-				on_destroy(*window);
-			});
+			TRACE_SCOPE("Application::Load (mad button)");
+			WindowDescription description = mad_button_description.get();
+			MadButton* mad_button = OS::UIClass::GetByName(description.class_name)->instantiate<MadButton>();
+
+
+			mad_button->on_click = description.on_click;
+			mad_button->on_destroy = description.on_destroy;
+			button = mad_button;
 			button->setParent(window);
-			on_create(*button);
+			description.on_create(*button);
 		}
+		configuration.get();
+		phase_start = Application::ReportStartupPhase(L"Create windows",phase_start);
+
+		/* Lay out the window(s). */
+		window->getLayout()->appendChild(button->getLayout());
+		window->getLayout()->update();
+		Application::ReportStartupPhase(L"Lay out windows",phase_start);
+		Application::ReportStartupPhase(L"Load (total)",load_start);
+	}
+
+	LARGE_INTEGER ReportStartupPhase(const wchar* phase_name,LARGE_INTEGER phase_start)
+	{
+		LARGE_INTEGER now;
+		LARGE_INTEGER frequency;
+
+
+		QueryPerformanceCounter(&now);
+		QueryPerformanceFrequency(&frequency);
+		OutputDebugString(std::wstring(L"Startup: ").append(phase_name).append(L" took ").append(std::to_wstring((now.QuadPart - phase_start.QuadPart) * 1000000 / frequency.QuadPart)).append(L" us.\n").c_str());
+
+		return now;
+	}
+
+	void Replay(const std::wstring& path)
+	{
+		LARGE_INTEGER replay_start;
+		LARGE_INTEGER replay_end;
+		LARGE_INTEGER frequency;
+		size_t replayed;
+
+
+		QueryPerformanceCounter(&replay_start);
+		replayed = OS::ReplayMessages(path.c_str());
+		QueryPerformanceCounter(&replay_end);
+		QueryPerformanceFrequency(&frequency);
+		OutputDebugString(std::wstring(L"Replay: ").append(std::to_wstring(replayed)).append(L" messages took ").append(std::to_wstring((replay_end.QuadPart - replay_start.QuadPart) * 1000000 / frequency.QuadPart)).append(L" us.\n").c_str());
+
+		window->destroy();
+		exit_code = 0;
 	}
 
 	void Unload()
@@ -114,5 +254,19 @@ namespace Application
 		{
 			OS::WindowClass::Unregister(window_class);
 		}
+		Application::loaded_classes.clear();
+
+		for(OS::UIClass* ui_class : Application::loaded_ui_classes)  //Only once the windows instantiated from them have been destroyed.
+		{
+			OS::UIClass::Unload(ui_class);
+		}
+		Application::loaded_ui_classes.clear();
+
+		if(Application::resource_pack != nullptr)
+		{
+			Application::GetModule().attachResourcePack(nullptr);
+			delete Application::resource_pack;
+			Application::resource_pack = nullptr;
+		}
 	}
 }
\ No newline at end of file
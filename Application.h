@@ -6,6 +6,34 @@
 
 namespace Application
 {
+	/**
+	 * The button in the main window, whose handlers are procedures named in the resources.  It calls them from its static handlers, after the button's own handling.
+	 */
+	class MadButton : public OS::StaticWindow<MadButton>
+	{
+		public:
+			OS::WindowOnClickCallback on_click;
+			OS::WindowOnDestroyCallback on_destroy;
+
+		public:
+			MadButton(OS::WindowClass* window_class);
+
+			LRESULT onDestroy(WPARAM w_param,LPARAM l_param);
+
+			LRESULT onLeftButtonUp(WPARAM w_param,LPARAM l_param);
+	};
+
+	/**
+	 * The main window, which erases its background itself rather than through the handler of its class.
+	 */
+	class MainWindow : public OS::StaticWindow<MainWindow>
+	{
+		public:
+			MainWindow(OS::WindowClass* window_class);
+
+			LRESULT onEraseBackground(WPARAM w_param,LPARAM l_param);
+	};
+
 	extern OS::Module* module;
 
 	void Execute();
@@ -14,7 +42,22 @@ namespace Application
 
 	OS::Module& GetModule();
 
-	void Load();
+	/**
+	 * Loads the application's resources, classes and windows.  The descriptions of the classes and windows are resolved on other threads while the UI thread initializes the common controls, unless concurrent is false, in which case each is resolved on the calling thread when it is first needed, as a baseline against which the benchmarks measure the concurrent load.
+	 */
+	void Load(bool concurrent = true);
+
+	/**
+	 * Writes how long a phase of startup took to the debugger's output.
+	 *
+	 * @return Returns the time at which the phase ended, from which the next phase can be measured.
+	 */
+	LARGE_INTEGER ReportStartupPhase(const wchar* phase_name,LARGE_INTEGER phase_start);
+
+	/**
+	 * Runs the application without showing it or starting its message loop, instead replaying a log recorded by OS::StartMessageRecording to its windows and writing how long that took to the debugger's output.
+	 */
+	void Replay(const std::wstring& path);
 
 	void Unload();
 }
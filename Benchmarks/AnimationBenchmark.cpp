@@ -0,0 +1,96 @@
+#include "Animation.h"
+#include "Benchmark.h"
+
+#include <vector>
+
+using Animation::Easing;
+using Benchmark::Case;
+
+
+namespace
+{
+	/**
+	 * Tween as an object which picks its easing curve when evaluated, to compare the timeline's layout with.
+	 */
+	struct Tween
+	{
+		double start;
+		double duration;
+		float from;
+		float to;
+		Easing easing;
+		float value;
+
+		void evaluate(double now)
+		{
+			float t = (float)((now - this->start) / this->duration);
+			float eased = t;
+
+
+			t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+			switch(this->easing)
+			{
+				case Easing::LINEAR:
+					eased = t;
+
+					break;
+
+				case Easing::EASE_IN:
+					eased = t * t * t;
+
+					break;
+
+				case Easing::EASE_OUT:
+					eased = 1.0f - (1.0f - t) * (1.0f - t) * (1.0f - t);
+
+					break;
+
+				case Easing::EASE_IN_OUT:
+					eased = t * t * (3.0f - 2.0f * t);
+
+					break;
+			}
+			this->value = this->from + (this->to - this->from) * eased;
+		}
+	};
+
+	/* Constants */
+	const size_t TWEENS = 10000;
+}
+
+int main(int argc,char** argv)
+{
+	Animation::Timeline timeline;
+	std::vector<Tween> tweens;
+	Easing easings[] = {Easing::LINEAR,Easing::EASE_IN,Easing::EASE_OUT,Easing::EASE_IN_OUT};
+	double now = 0.0;
+	std::vector<Case> cases;
+
+
+	for(size_t index = 0;index < TWEENS;++index)
+	{
+		Tween tween = {(double)(index % 300),250.0 + index % 100,0.0f,(float)index,easings[index % 4],0.0f};
+
+
+		tweens.push_back(tween);
+		timeline.add(tween.from,tween.to,tween.start,tween.duration,tween.easing);
+	}
+
+	cases.push_back({"Timeline::evaluate",(double)TWEENS,"tween",[&]()
+	{
+		now = now < 700.0 ? now + 16.0 : 0.0;
+		timeline.evaluate(now);
+		Benchmark::Consume((std::uint64_t)timeline.getValue(TWEENS / 2));
+	}});
+	cases.push_back({"Tween objects",(double)TWEENS,"tween",[&]()
+	{
+		now = now < 700.0 ? now + 16.0 : 0.0;
+		for(Tween& tween : tweens)
+		{
+			tween.evaluate(now);
+		}
+		Benchmark::Consume((std::uint64_t)tweens[TWEENS / 2].value);
+	}});
+
+	return Benchmark::Main(argc,argv,cases);
+}
\ No newline at end of file
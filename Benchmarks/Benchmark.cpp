@@ -0,0 +1,355 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using Benchmark::Case;
+
+
+namespace
+{
+	struct Options
+	{
+		std::string filter;
+		std::string json_path;
+		std::string baseline_path;
+		double tolerance;  //In percent.
+		bool quick;
+	};
+
+	struct Result
+	{
+		std::string name;
+		std::uint64_t iterations;  //Per sample.
+		double nanoseconds;  //Per iteration; the median of the samples.
+		double units;
+		std::string unit;
+	};
+
+	/* Constants */
+	const double MINIMUM_SAMPLE_NANOSECONDS = 20e6;
+	const int SAMPLES = 7;
+
+	volatile std::uint64_t sink;
+
+	std::string EscapeJSON(const std::string& text)
+	{
+		std::string escaped;
+
+
+		for(char character : text)
+		{
+			if(character == '"' || character == '\\')
+			{
+				escaped.push_back('\\');
+			}
+			escaped.push_back(character);
+		}
+
+		return escaped;
+	}
+
+	std::string FormatDuration(double nanoseconds)
+	{
+		const char* units[] = {"ns","us","ms","s"};
+		char text[32];
+		int unit = 0;
+
+
+		for(;unit < 3 && nanoseconds >= 1000.0;++unit)
+		{
+			nanoseconds /= 1000.0;
+		}
+		std::snprintf(text,sizeof(text),"%.3g %s",nanoseconds,units[unit]);
+
+		return text;
+	}
+
+	std::string FormatThroughput(double per_second,const std::string& unit)
+	{
+		const char* prefixes[] = {"","k","M","G","T"};
+		char text[64];
+		int prefix = 0;
+
+
+		for(;prefix < 4 && per_second >= 1000.0;++prefix)
+		{
+			per_second /= 1000.0;
+		}
+		std::snprintf(text,sizeof(text),"%.4g %s%s/s",per_second,prefixes[prefix],unit.c_str());
+
+		return text;
+	}
+
+	double MeasureSample(const Case& benchmark,std::uint64_t iterations)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+
+		for(std::uint64_t iteration = 0;iteration < iterations;++iteration)
+		{
+			benchmark.run();
+		}
+
+		return std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	Result Measure(const Case& benchmark,bool quick)
+	{
+		Result result;
+		std::vector<double> samples;
+
+
+		result.name = benchmark.name;
+		result.units = benchmark.units;
+		result.unit = benchmark.unit;
+		result.iterations = 1;
+
+		if(quick)
+		{
+			result.nanoseconds = MeasureSample(benchmark,1);
+
+			return result;
+		}
+
+		for(;;)  //Find how many iterations make a sample long enough to time reliably.
+		{
+			double elapsed = MeasureSample(benchmark,result.iterations);
+
+
+			if(elapsed >= MINIMUM_SAMPLE_NANOSECONDS)
+			{
+				break;
+			}
+			result.iterations = elapsed < MINIMUM_SAMPLE_NANOSECONDS / 100 ? result.iterations * 100 : (std::uint64_t)(result.iterations * MINIMUM_SAMPLE_NANOSECONDS * 1.2 / elapsed) + 1;
+		}
+
+		for(int sample = 0;sample < SAMPLES;++sample)
+		{
+			samples.push_back(MeasureSample(benchmark,result.iterations) / result.iterations);
+		}
+		std::sort(samples.begin(),samples.end());
+		result.nanoseconds = samples[SAMPLES / 2];
+
+		return result;
+	}
+
+	bool ParseOptions(int argc,char** argv,Options& options)
+	{
+		options.tolerance = 10.0;
+		options.quick = false;
+
+		for(int index = 1;index < argc;++index)
+		{
+			std::string argument = argv[index];
+			bool has_value = index + 1 < argc;
+
+
+			if(argument == "--quick")
+			{
+				options.quick = true;
+			}
+			else if(argument == "--filter" && has_value)
+			{
+				options.filter = argv[++index];
+			}
+			else if(argument == "--json" && has_value)
+			{
+				options.json_path = argv[++index];
+			}
+			else if(argument == "--baseline" && has_value)
+			{
+				options.baseline_path = argv[++index];
+			}
+			else if(argument == "--tolerance" && has_value)
+			{
+				options.tolerance = std::atof(argv[++index]);
+			}
+			else
+			{
+				std::fprintf(stderr,"Usage: %s [--filter <text>] [--json <path>] [--baseline <path>] [--tolerance <percent>] [--quick]\n",argv[0]);
+
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Reads the time per iteration of each case from JSON written by WriteResults.
+	 */
+	bool ReadBaseline(const std::string& path,std::map<std::string,double>& baseline)
+	{
+		std::ifstream file(path.c_str());
+		std::stringstream contents;
+		std::string text;
+		size_t position = 0;
+
+
+		if(!file)
+		{
+			return false;
+		}
+		contents << file.rdbuf();
+		text = contents.str();
+
+		while((position = text.find("\"name\": \"",position)) != std::string::npos)
+		{
+			size_t name_end;
+			size_t object_end;
+			size_t field;
+			std::string name;
+
+
+			position += std::strlen("\"name\": \"");
+			for(name_end = position;name_end < text.size() && text[name_end] != '"';++name_end)
+			{
+				if(text[name_end] == '\\')
+				{
+					++name_end;
+					continue;
+				}
+				name.push_back(text[name_end]);
+			}
+			object_end = text.find('}',name_end);
+			field = text.find("\"nanoseconds\": ",name_end);
+			if(field != std::string::npos && field < object_end)
+			{
+				baseline[name] = std::strtod(text.c_str() + field + std::strlen("\"nanoseconds\": "),nullptr);
+			}
+			position = name_end;
+		}
+
+		return true;
+	}
+
+	bool WriteResults(const std::string& path,const std::vector<Result>& results,const std::map<std::string,std::string>& context)
+	{
+		std::ofstream file(path.c_str());
+		size_t written = 0;
+
+
+		if(!file)
+		{
+			return false;
+		}
+
+		file << "{\n\t\"context\": {";
+		for(const auto& entry : context)
+		{
+			file << (written++ == 0 ? "\n" : ",\n") << "\t\t\"" << EscapeJSON(entry.first) << "\": \"" << EscapeJSON(entry.second) << "\"";
+		}
+		file << "\n\t},\n\t\"results\": [";
+
+		written = 0;
+		file.precision(17);
+		for(const Result& result : results)
+		{
+			file << (written++ == 0 ? "\n" : ",\n")
+				<< "\t\t{\"name\": \"" << EscapeJSON(result.name)
+				<< "\", \"iterations\": " << result.iterations
+				<< ", \"nanoseconds\": " << result.nanoseconds
+				<< ", \"units\": " << result.units
+				<< ", \"unit\": \"" << EscapeJSON(result.unit)
+				<< "\", \"throughput\": " << result.units * 1e9 / result.nanoseconds << "}";
+		}
+		file << "\n\t]\n}\n";
+
+		return (bool)file;
+	}
+}
+
+namespace Benchmark
+{
+	/* Function Definitions */
+	void Consume(std::uint64_t value)
+	{
+		sink = value;
+	}
+
+	int Main(int argc,char** argv,const std::vector<Case>& cases,const std::map<std::string,std::string>& context)
+	{
+		Options options;
+		std::map<std::string,double> baseline;
+		std::vector<Result> results;
+		int regressions = 0;
+
+
+		if(!ParseOptions(argc,argv,options))
+		{
+			return 2;
+		}
+		if(!options.baseline_path.empty() && !ReadBaseline(options.baseline_path,baseline))
+		{
+			std::fprintf(stderr,"Failed to read the baseline \"%s\".\n",options.baseline_path.c_str());
+
+			return 2;
+		}
+		if(options.quick && !baseline.empty())
+		{
+			std::fprintf(stderr,"A quick run is not compared with the baseline.\n");
+			baseline.clear();
+		}
+
+		for(const auto& entry : context)
+		{
+			std::printf("%s: %s\n",entry.first.c_str(),entry.second.c_str());
+		}
+		std::printf("%-52s %12s %20s %12s\n","Case","Time","Throughput",baseline.empty() ? "" : "vs baseline");
+
+		for(const Case& benchmark : cases)
+		{
+			Result result;
+			auto previous = baseline.end();
+			char comparison[32] = "";
+
+
+			if(benchmark.name.find(options.filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			result = Measure(benchmark,options.quick);
+			results.push_back(result);
+
+			previous = baseline.find(result.name);
+			if(previous != baseline.end() && previous->second > 0)
+			{
+				double change = (result.nanoseconds / previous->second - 1.0) * 100.0;  //Positive when slower.
+				bool regressed = change > options.tolerance;
+
+
+				std::snprintf(comparison,sizeof(comparison),"%+.1f%%%s",change,regressed ? " !" : "");
+				if(regressed)
+				{
+					++regressions;
+				}
+			}
+
+			std::printf("%-52s %12s %20s %12s\n",result.name.c_str(),FormatDuration(result.nanoseconds).c_str(),FormatThroughput(result.units * 1e9 / result.nanoseconds,result.unit).c_str(),comparison);
+			std::fflush(stdout);
+		}
+
+		if(!options.json_path.empty() && !WriteResults(options.json_path,results,context))
+		{
+			std::fprintf(stderr,"Failed to write \"%s\".\n",options.json_path.c_str());
+
+			return 2;
+		}
+
+		if(regressions > 0)
+		{
+			std::printf("%d case(s) were more than %g%% slower than the baseline.\n",regressions,options.tolerance);
+
+			return 1;
+		}
+
+		return 0;
+	}
+}
\ No newline at end of file
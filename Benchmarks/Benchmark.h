@@ -0,0 +1,51 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+
+/**
+ * Minimal harness shared by the benchmarks.  Each case is run for enough iterations to last a few milliseconds per sample, and the median of several samples is reported along with the case's throughput in its own unit (pixels, bytes, messages and so on).  The command line accepts:
+ *
+ *   --filter <text>         Runs only the cases whose names contain the text.
+ *   --json <path>           Writes the results as JSON.
+ *   --baseline <path>       Compares the results with the JSON written by an earlier run.
+ *   --tolerance <percent>   Slowdown against the baseline beyond which a case is a regression (10 by default).
+ *   --quick                 Runs every case once, only to check that it still works.
+ *
+ * The exit status is non-zero if any case regressed against the baseline.
+ */
+namespace Benchmark
+{
+	/* Types */
+	struct Case
+	{
+		std::string name;
+		double units;  //Processed by one iteration, such as the pixels of a fill.
+		std::string unit;  //Such as "pixel" or "byte".
+		std::function<void()> run;  //One iteration.
+	};
+
+	/* Function Prototypes */
+	/**
+	 * Keeps the compiler from discarding a value which is computed only to be measured.
+	 */
+	void Consume(std::uint64_t value);
+
+	/**
+	 * Runs the cases selected by the command line and reports their results.
+	 *
+	 * @param
+	 *   context
+	 *     Written along with the results, such as the instruction set a module was built for.
+	 *
+	 * @return Returns the exit status of the benchmark.
+	 */
+	int Main(int argc,char** argv,const std::vector<Case>& cases,const std::map<std::string,std::string>& context = std::map<std::string,std::string>());
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "Benchmark.h"
+#include "Compression.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using Benchmark::Case;
+
+typedef std::vector<std::uint8_t> Bytes;
+
+
+namespace
+{
+	/* Constants */
+	const size_t SIZE = 1 << 20;
+
+	Bytes MakeRandom(size_t size)
+	{
+		Bytes data(size);
+		std::uint32_t state = 1;
+
+
+		for(std::uint8_t& byte : data)
+		{
+			state = state * 1664525 + 1013904223;
+			byte = (std::uint8_t)(state >> 24);
+		}
+
+		return data;
+	}
+
+	Bytes MakeText(size_t size)  //Repetitive, like the markup and strings the codec is used for.
+	{
+		const char* words[] = {"<Window ","name=\"","Button","\" x=\"12\" ","width=\"200\" ","/>\n","Label","text=\"Hello, world\" ","<Layout>","</Layout>\n"};
+		Bytes data;
+		std::uint32_t state = 1;
+
+
+		while(data.size() < size)
+		{
+			const char* word;
+
+
+			state = state * 1664525 + 1013904223;
+			word = words[(state >> 16) % (sizeof(words) / sizeof(words[0]))];
+			data.insert(data.end(),word,word + std::char_traits<char>::length(word));
+		}
+		data.resize(size);
+
+		return data;
+	}
+
+	void AddCases(std::vector<Case>& cases,std::map<std::string,std::string>& context,const std::string& name,const Bytes& data)
+	{
+		Bytes block = Compression::Compress(data.data(),data.size());
+		double bytes = (double)data.size();
+		char ratio[32];
+
+
+		std::snprintf(ratio,sizeof(ratio),"%.3f",(double)block.size() / data.size());
+		context[name + " ratio"] = ratio;
+
+		cases.push_back({"Compress/" + name,bytes,"byte",[&data]()
+		{
+			Benchmark::Consume(Compression::Compress(data.data(),data.size()).size());
+		}});
+		cases.push_back({"Decompress/" + name,bytes,"byte",[&data,block]()
+		{
+			Bytes output(data.size());
+
+
+			Benchmark::Consume(Compression::Decompress(block.data(),block.size(),output.data(),output.size()));
+		}});
+		cases.push_back({"DecompressStream/" + name,bytes,"byte",[block]()
+		{
+			std::uint64_t total = 0;
+
+
+			Compression::DecompressStream(block.data(),block.size(),[&total](const std::uint8_t* data,size_t size)
+			{
+				total += size + data[0];
+			});
+			Benchmark::Consume(total);
+		}});
+	}
+}
+
+int main(int argc,char** argv)
+{
+	Bytes text = MakeText(SIZE);
+	Bytes random = MakeRandom(SIZE);
+	Bytes run(SIZE,'x');
+	std::vector<Case> cases;
+	std::map<std::string,std::string> context;
+
+
+	AddCases(cases,context,"text",text);
+	AddCases(cases,context,"random",random);
+	AddCases(cases,context,"run",run);
+
+	return Benchmark::Main(argc,argv,cases,context);
+}
\ No newline at end of file
@@ -0,0 +1,1026 @@
+#include "Application.h"
+#include "Benchmark.h"
+#include "Control.h"
+#include "Graphics.h"
+#include "Headless.h"
+#include "Layout.h"
+#include "OS.h"
+#include "Resources/Resources.h"
+#include "Trace.h"
+#include "VirtualList.h"
+#include "XML.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Benchmark::Case;
+
+std::string wstos(const std::wstring& wstring);
+
+
+EXPORT void FrameworkBenchmark_OnCreate(OS::Window& window)
+{
+	Benchmark::Consume(1);
+}
+
+
+namespace
+{
+	/* Constants */
+	const UINT WM_BENCHMARK = WM_APP + 1;
+	const UINT WM_BENCHMARK_EXTENDED = WM_APP + 2;
+	const WORD STRING_ID = 0x100;  //Beyond the application's own strings.
+	const int TREE_BRANCHES = 10;
+	const int TREE_LEAVES = 100;  //Per branch.
+	const int TREE_WINDOWS = 1 + TREE_BRANCHES * (1 + TREE_LEAVES);
+	const int LARGE_TREE_BRANCHES = 100;
+	const int LARGE_TREE_LEAVES = 100;
+	const int LARGE_TREE_WINDOWS = 1 + LARGE_TREE_BRANCHES * (1 + LARGE_TREE_LEAVES);
+	const WORD LOADED_UI_CLASS_ID = 100;  //Of the first of a chain of UI_CLASS_LEVELS classes, each extending the one before it, which is loaded and unloaded again.
+	const WORD INSTANTIATED_UI_CLASS_ID = 200;  //Of the first of a chain which stays loaded to be instantiated.
+	const int UI_CLASS_LEVELS = 12;
+	const int UI_CLASS_INSTANCES = 1000;
+	const int READS_PER_THREAD = 20000;  //Enough that starting the threads is a small part of each run.
+	const WORD UI_CLASS_WINDOW_ID = 1;
+	const WORD UI_CLASS_PUSH_BUTTON_ID = 2;
+	const int GRID_CELL_SIZE = 8;  //Of each child in a grid, in pixels, so that a cell of a spatial index holds 64 of them.
+	const int GRID_POINTS = 1024;  //Hit tested in turn.
+	const int GRID_CONTROLS = 100000;
+	const size_t LIST_ROWS = 1000000;
+	const int LIST_ROW_HEIGHT = 20;
+	const size_t TIMERS = 100000;
+	const UINT TIMER_DELAY = 100;  //Milliseconds before the first of the timers measured for lateness comes due, by when all of them have been set.
+	const UINT TIMER_SPREAD = 300;  //Milliseconds over which they come due, beyond the wheel's first level so that most are cascaded.
+	const UINT PENDING_TIMER_DELAY = 3600000;
+	const int APPLICATION_LOADS = 20;  //Of each kind, alternating, of which the median is reported.
+	const int STARTUP_CONTROLS = 5000;
+	const int STARTUP_VISIBLE_INTERVAL = 10;  //One control in so many is visible at start up.
+	const int WINDOW_PROPERTIES = 16;  //Set on the window whose properties are measured, typed and native alike, so that each lookup searches among others.
+
+	struct Tree
+	{
+		OS::Window* root;
+		int width;
+	};
+
+	struct Grid  //A window whose children are laid out edge to edge, for hit tests.
+	{
+		OS::Window* root;
+		OS::SpatialIndex<int> index;  //Of the same rectangles, numbered from 1, without the windows.
+		std::vector<POINT> points;
+		int next_point;
+
+		const POINT& getNextPoint()
+		{
+			this->next_point = (this->next_point + 1) % GRID_POINTS;
+
+			return this->points[this->next_point];
+		}
+	};
+
+	struct StaticBenchmarkWindow : OS::StaticWindow<StaticBenchmarkWindow>
+	{
+		StaticBenchmarkWindow(OS::WindowClass* window_class)
+		: StaticWindow(window_class)
+		{
+		}
+
+		LRESULT onMouseMove(WPARAM w_param,LPARAM l_param)
+		{
+			return w_param;
+		}
+	};
+
+	std::string ReadFile(const char* path)
+	{
+		std::ifstream file(path,std::ios::binary);
+
+
+		return std::string(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+	}
+
+	std::string MakeDocument(int elements)  //Shaped like the UI descriptions:  nested containers of elements with a few attributes each.
+	{
+		std::string document = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<UI>\n";
+
+
+		for(int element = 0;element < elements;++element)
+		{
+			if(element % 10 == 0)
+			{
+				document.append(element == 0 ? "" : "\t</Layout>\n").append("\t<Layout orientation=\"horizontal\" spacing=\"4\">\n");
+			}
+			document.append("\t\t<Window class=\"PushButton\" name=\"Button ").append(std::to_string(element)).append("\" width=\"120\" height=\"24\" padding=\"2\"><!-- Generated --></Window>\n");
+		}
+		document.append("\t</Layout>\n</UI>\n");
+
+		return document;
+	}
+
+	/**
+	 * Calls a function READS_PER_THREAD times on each of the given number of threads at once.
+	 */
+	template<typename Read>
+	void ReadOnThreads(int threads,Read read)
+	{
+		std::vector<std::thread> readers;
+
+
+		for(int thread = 0;thread < threads;++thread)
+		{
+			readers.push_back(std::thread([read](){
+				for(int iteration = 0;iteration < READS_PER_THREAD;++iteration)
+				{
+					read();
+				}
+			}));
+		}
+		for(std::thread& reader : readers)
+		{
+			reader.join();
+		}
+	}
+
+	/**
+	 * Adds the definitions of a chain of UIClasses, named after their resource identifiers, the first extending the given native class and each level adding a capability, a prototype attribute and an OnCreate handler.
+	 */
+	void AddUIClasses(WORD first_id,const std::string& window_class_name)
+	{
+		for(int level = 0;level < UI_CLASS_LEVELS;++level)
+		{
+			std::string level_name = std::to_string(level);
+			std::string definition = "<UIClass>\n\t<Name>Level" + std::to_string(first_id + level) + "</Name>\n";
+
+
+			definition.append("\t<Extends>").append(level == 0 ? window_class_name : "Level" + std::to_string(first_id + level - 1)).append("</Extends>\n");
+			definition.append("\t<Capabilities><Level").append(level_name).append(">true</Level").append(level_name).append("></Capabilities>\n");
+			definition.append("\t<LifecycleHandlers><OnCreate>FrameworkBenchmark_OnCreate</OnCreate></LifecycleHandlers>\n");
+			definition.append("\t<Prototype title=\"Level ").append(level_name).append("\" width=\"").append(std::to_string(10 + level)).append("\" level").append(level_name).append("=\"").append(level_name).append("\"/>\n</UIClass>");
+			Headless::AddResource(nullptr,L"XML",first_id + level,definition.data(),definition.size());
+		}
+	}
+
+	void LoadUIClasses(OS::Module& module,WORD first_id,OS::UIClass* (&ui_classes)[UI_CLASS_LEVELS])
+	{
+		for(int level = 0;level < UI_CLASS_LEVELS;++level)
+		{
+			ui_classes[level] = OS::UIClass::Load(module,first_id + level);
+		}
+	}
+
+	void UnloadUIClasses(OS::UIClass* (&ui_classes)[UI_CLASS_LEVELS])
+	{
+		for(OS::UIClass*& ui_class : ui_classes)
+		{
+			OS::UIClass::Unload(ui_class);
+		}
+	}
+
+	/**
+	 * Creates a window, and the windows of its children, from an element of a UI description whose name is the UIClass of the window.
+	 */
+	OS::Window* CreateFromDescription(const XML::Element& element)
+	{
+		OS::Window* window = OS::UIClass::GetByName(element.getName())->instantiate();
+
+
+		window->setBackground(RGB(0xF0,0xF0,0xF0));
+		for(const std::pair<const std::wstring,std::wstring>& attribute : element.getAttributes())
+		{
+			window->getLayout()->setAttribute(attribute.first,attribute.second);
+		}
+		for(const XML::Element& child : element.getChildren())
+		{
+			if(child.type == XML::Element::Type::CONTAINER)
+			{
+				OS::Window* child_window = CreateFromDescription(child);
+
+
+				child_window->setParent(window);
+				child_window->show();
+				window->getLayout()->appendChild(child_window->getLayout());
+			}
+		}
+
+		return window;
+	}
+
+	/**
+	 * Creates a root window holding the given number of branch windows, of the given number of leaf windows each, with a layout mirroring the tree.
+	 */
+	Tree CreateTree(OS::WindowClass* window_class,OS::WindowClass* child_class,int branches = TREE_BRANCHES,int leaves = TREE_LEAVES)
+	{
+		Tree tree = {window_class->instantiate(L"Root"),800};
+
+
+		tree.root->getLayout()->setOrientation(OS::Layout::Orientation::VERTICAL);
+		for(int branch = 0;branch < branches;++branch)
+		{
+			OS::Window* branch_window = child_class->instantiate(L"Branch");
+
+
+			branch_window->setParent(tree.root);
+			branch_window->getLayout()->setOrientation(OS::Layout::Orientation::HORIZONTAL);
+			branch_window->getLayout()->setGrow(1);
+			tree.root->getLayout()->appendChild(branch_window->getLayout());
+			for(int leaf = 0;leaf < leaves;++leaf)
+			{
+				OS::Window* leaf_window = child_class->instantiate(L"Leaf");
+
+
+				leaf_window->setParent(branch_window);
+				leaf_window->getLayout()->setGrow(1);
+				branch_window->getLayout()->appendChild(leaf_window->getLayout());
+			}
+		}
+
+		return tree;
+	}
+
+	/**
+	 * Creates the root window of a grid of the given number of items, and the points to hit test in it.
+	 *
+	 * @return Returns the number of columns of the grid.
+	 */
+	int CreateGridRoot(OS::WindowClass* window_class,int items,Grid& grid)
+	{
+		int columns = (int)std::ceil(std::sqrt((double)items));
+		int rows = (items + columns - 1) / columns;
+		std::minstd_rand random;
+
+
+		grid.root = window_class->instantiate(L"Grid");
+		grid.root->setDimensions(columns * GRID_CELL_SIZE,rows * GRID_CELL_SIZE);
+		grid.next_point = 0;
+		for(int point = 0;point < GRID_POINTS;++point)
+		{
+			grid.points.push_back({(LONG)(random() % (columns * GRID_CELL_SIZE)),(LONG)(random() % (rows * GRID_CELL_SIZE))});
+		}
+
+		return columns;
+	}
+
+	RECT GetGridRectangle(int item,int columns)
+	{
+		RECT rectangle;
+
+
+		SetRect(&rectangle,item % columns * GRID_CELL_SIZE,item / columns * GRID_CELL_SIZE,(item % columns + 1) * GRID_CELL_SIZE,(item / columns + 1) * GRID_CELL_SIZE);
+
+		return rectangle;
+	}
+
+	void CreateGrid(OS::WindowClass* window_class,OS::WindowClass* child_class,int children,Grid& grid)
+	{
+		int columns = CreateGridRoot(window_class,children,grid);
+
+
+		for(int child = 0;child < children;++child)
+		{
+			OS::Window* child_window = child_class->instantiate(L"Cell");
+			RECT rectangle = GetGridRectangle(child,columns);
+
+
+			child_window->setParent(grid.root);
+			child_window->setPosition(rectangle.left,rectangle.top);
+			child_window->setDimensions(GRID_CELL_SIZE,GRID_CELL_SIZE);
+			grid.index.insert(child + 1,rectangle);
+		}
+	}
+
+	void CreateControlGrid(OS::WindowClass* window_class,int controls,Grid& grid)
+	{
+		int columns = CreateGridRoot(window_class,controls,grid);
+
+
+		grid.root->show();
+		for(int control = 0;control < controls;++control)
+		{
+			OS::Control* created = grid.root->createControl(L"Cell");
+			RECT rectangle = GetGridRectangle(control,columns);
+
+
+			created->setPosition(rectangle.left,rectangle.top);
+			created->setDimensions(GRID_CELL_SIZE,GRID_CELL_SIZE);
+			created->setMessageHandler(WM_MOUSEMOVE,[](OS::Control* control,WPARAM w_param,LPARAM l_param) -> LRESULT {
+				return l_param;
+			});
+		}
+		OS::FlushInvalidations();
+		UpdateWindow(grid.root->getNativeHandle());
+	}
+
+	void PaintWindow(OS::Window* window,const RECT* area)
+	{
+		window->invalidate(area);
+		OS::FlushInvalidations();
+		UpdateWindow(window->getNativeHandle());
+	}
+
+	/**
+	 * Scrolls a list by the given number of rows, back to the top once it reaches the bottom.
+	 */
+	void ScrollList(OS::VirtualList* list,long long rows)
+	{
+		size_t first_row = list->getFirstVisibleRow();
+
+
+		list->scrollBy(rows);
+		if(list->getFirstVisibleRow() == first_row)
+		{
+			list->scrollTo(0);
+		}
+	}
+
+	void InvalidateTree(OS::Window* window)  //So that every window in it is drawn again the next time it is rendered.
+	{
+		window->invalidate();
+		for(HWND child = GetWindow(window->getNativeHandle(),GW_CHILD);child != nullptr;child = GetWindow(child,GW_HWNDNEXT))
+		{
+			InvalidateTree(OS::Window::FromHandle(child));
+		}
+	}
+
+	void LayOutTree(Tree& tree)  //Alternates the root's width, so that every window is arranged again each time.
+	{
+		tree.width = tree.width == 800 ? 1000 : 800;
+		tree.root->getLayout()->setWidth(tree.width);
+		tree.root->getLayout()->setHeight(600);
+		tree.root->getLayout()->update();
+	}
+
+	/**
+	 * Widens one leaf of a tree, or narrows it again, so that only its branch is arranged again.  Successive calls go through the leaves of each branch in turn.
+	 */
+	void LayOutLeaf(Tree& tree,int& step)
+	{
+		const std::vector<OS::Layout*>& branches = tree.root->getLayout()->getChildren();
+		const std::vector<OS::Layout*>& leaves = branches[step % branches.size()]->getChildren();
+		int leaf = (int)(step / branches.size() % leaves.size());
+
+
+		leaves[leaf]->setWidth(step / (branches.size() * leaves.size()) % 2 == 0 ? 4 : OS::Layout::AUTOMATIC);
+		tree.root->getLayout()->update();
+		++step;
+	}
+
+	BOOL CALLBACK CollectWindow(HWND window_handle,LPARAM windows)
+	{
+		((std::vector<HWND>*)windows)->push_back(window_handle);
+
+		return TRUE;
+	}
+
+	/**
+	 * Loads the application as it starts up and unloads it again, resolving its descriptions concurrently and sequentially in turn, and reports the median time each load took.  The application registers, loads and unregisters classes which the other cases share, so it is measured once, before those are set up, rather than as a case of its own.
+	 */
+	void MeasureApplicationLoad(OS::Module& module,std::map<std::string,std::string>& context)
+	{
+		std::string resources[][2] = {{RESOURCE_DIRECTORY "Application.xml",""},{RESOURCE_DIRECTORY "UIClass/PushButton.xml",""},{RESOURCE_DIRECTORY "UIClass/Window.xml",""}};
+		WORD resource_ids[] = {Application_Config,Application_UIClass_PushButton,Application_UIClass_Window};
+		std::vector<double> times[2];  //Sequential, then concurrent, in microseconds.
+		char medians[64];
+
+
+		for(int index = 0;index < 3;++index)
+		{
+			resources[index][1] = ReadFile(resources[index][0].c_str());
+			Headless::AddResource(nullptr,L"XML",resource_ids[index],resources[index][1].data(),resources[index][1].size());
+		}
+		Headless::AddStringResource(nullptr,Application_Title,L"The Angry Button");  //As Resources.rc declares them.
+		Headless::AddStringResource(nullptr,Application_UIClass_Button_Name,L"Button");
+		Headless::AddStringResource(nullptr,Application_MadButton_Class,L"PushButton");
+		Headless::AddStringResource(nullptr,Application_MadButton_OnClick,L"MadButton_OnClick");
+		Headless::AddStringResource(nullptr,Application_MadButton_OnCreate,L"MadButton_OnCreate");
+		Headless::AddStringResource(nullptr,Application_MadButton_OnDestroy,L"MadButton_OnDestroy");
+		Headless::AddStringResource(nullptr,Application_MainWindow_Class,L"Window");
+		Headless::AddStringResource(nullptr,Application_MainWindow_OnCreate,L"MainWindow_OnCreate");
+		Application::module = &module;
+
+		for(int load = 0;load < 2 * APPLICATION_LOADS;++load)
+		{
+			bool concurrent = load % 2 == 1;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			std::vector<HWND> windows;
+
+
+			Application::Load(concurrent);
+			times[concurrent].push_back(std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - start).count());
+
+			EnumThreadWindows(GetCurrentThreadId(),CollectWindow,(LPARAM)&windows);  //The main window, as the application would close it, before its classes are unloaded.
+			for(HWND window_handle : windows)
+			{
+				DestroyWindow(window_handle);
+			}
+			Application::Unload();
+		}
+		Application::module = nullptr;
+
+		for(std::vector<double>& kind : times)
+		{
+			std::sort(kind.begin(),kind.end());
+		}
+		std::snprintf(medians,sizeof(medians),"%.0f sequential, %.0f concurrent",times[0][APPLICATION_LOADS / 2],times[1][APPLICATION_LOADS / 2]);
+		context["Application::Load, median in us"] = medians;
+	}
+
+	/**
+	 * Creates a window holding STARTUP_CONTROLS child windows, of which one in STARTUP_VISIBLE_INTERVAL is visible, and shows it, as an application starts up.  If deferred, only the window and its visible children are realized.
+	 */
+	OS::Window* StartUp(OS::WindowClass* window_class,OS::WindowClass* child_class,bool defer)
+	{
+		OS::Window* root = window_class->instantiate(L"Startup",defer);
+
+
+		for(int index = 0;index < STARTUP_CONTROLS;++index)
+		{
+			OS::Window* control = child_class->instantiate(L"Control",defer);
+
+
+			control->setParent(root);
+			control->setVisible(index % STARTUP_VISIBLE_INTERVAL == 0);  //Child windows are visible by default.
+		}
+		root->show();
+
+		return root;
+	}
+
+	BOOL CALLBACK CountWindow(HWND window_handle,LPARAM count)
+	{
+		++*(size_t*)count;
+
+		return TRUE;
+	}
+
+	size_t CountNativeWindows(OS::Window* window)  //The window and its descendants.
+	{
+		size_t count = 1;
+
+
+		EnumChildWindows(window->getNativeHandle(),CountWindow,(LPARAM)&count);
+
+		return count;
+	}
+
+	/**
+	 * Sets one-shot timers which come due over the given number of milliseconds after a delay, in no particular order, and runs the message loop until every one of them has fired.
+	 */
+	void FireTimers(OS::Window* window,size_t timers,UINT delay,UINT spread)
+	{
+		size_t fired = 0;
+		MSG message;
+
+
+		for(size_t timer = 0;timer < timers;++timer)
+		{
+			window->setTimer(delay + (UINT)(timer * 7919 % spread),[&fired](OS::Window* window){
+				++fired;
+			},false);
+		}
+		while(fired < timers && GetMessage(&message,nullptr,0,0))
+		{
+			DispatchMessage(&message);
+		}
+	}
+}
+
+
+int main(int argc,char** argv)
+{
+	OS::Module module(GetModuleHandle(nullptr));
+	std::vector<Case> cases;
+	std::map<std::string,std::string> context;
+	OS::WindowClass* window_class;
+	OS::WindowClass* child_class;
+	OS::WindowClass* main_window_class;
+	OS::WindowClass* list_class;
+	OS::Window* windows[2];
+	OS::Window* extended_windows[3];
+	OS::Window* static_window;
+	Application::MadButton* static_button;
+	OS::Window* extended_button;
+	int extension_counts[] = {1,4,16};
+	int thread_counts[] = {1,2,4,8};
+	int grid_sizes[] = {1000,10000,100000};
+	Grid grids[3];
+	Grid control_grid;
+	OS::Window* buffered_window;
+	OS::Window* list_window;
+	OS::Window* timer_window;
+	OS::Window* property_window;
+	OS::Window* startup_window;
+	std::string startup_suffix = std::to_string(STARTUP_CONTROLS) + " controls, " + std::to_string(100 / STARTUP_VISIBLE_INTERVAL) + "% visible";
+	OS::Window* observed_window;
+	std::vector<std::wstring> property_names;
+	std::deque<OS::Property<HANDLE>> properties;
+	size_t property_step = 0;
+	OS::TimerStatistics timer_statistics;
+	char lateness[64];
+	OS::VirtualList* list;
+	WNDPROC procedure;
+	Tree tree;
+	Tree large_tree;
+	int leaf_step = 0;
+	size_t trace_scopes = 0;
+	OS::UIClass* ui_classes[UI_CLASS_LEVELS];
+	std::vector<OS::Window*> instances(UI_CLASS_INSTANCES);
+	std::vector<std::pair<std::string,std::string>> documents;
+	std::wstring procedure_name = L"UIClass_Window_OnClose";
+	std::string application_classes[] = {ReadFile(RESOURCE_DIRECTORY "UIClass/Window.xml"),ReadFile(RESOURCE_DIRECTORY "UIClass/PushButton.xml")};
+	std::string main_document = ReadFile(RESOURCE_DIRECTORY "UI/Main.xml");
+	OS::UIClass* application_ui_classes[2];
+	OS::Window* main_window;
+	Graphics::Surface render_target;
+	int result;
+
+
+	MeasureApplicationLoad(module,context);
+	window_class = OS::WindowClass::Register(L"BenchmarkWindow");
+	child_class = OS::WindowClass::Register(L"BenchmarkChild");
+	main_window_class = OS::WindowClass::Register(L"Window");  //The native class of the Window UIClass.
+	list_class = OS::VirtualList::Register(L"BenchmarkList");
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,800,600);
+	child_class->setWindowDefaults(WS_CHILD | WS_VISIBLE,0,0,0,10,10);
+	main_window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,640,480);
+	Headless::AddStringResource(nullptr,STRING_ID,procedure_name);
+	AddUIClasses(LOADED_UI_CLASS_ID,"BenchmarkChild");
+	AddUIClasses(INSTANTIATED_UI_CLASS_ID,"BenchmarkChild");
+
+	for(OS::Window*& window : windows)
+	{
+		window = window_class->instantiate(L"Benchmark");
+		window->setMessageHandler(WM_BENCHMARK,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+			return w_param;
+		});
+	}
+	procedure = (WNDPROC)GetWindowLongPtr(windows[0]->getNativeHandle(),GWLP_WNDPROC);  //OS::Window::HandleMessage, once the window has been subclassed.
+
+	for(int index = 0;index < 3;++index)
+	{
+		extended_windows[index] = window_class->instantiate(L"Extended");
+		extended_windows[index]->setMessageHandler(WM_BENCHMARK_EXTENDED,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+			return w_param;
+		});
+		for(int extension = 0;extension < extension_counts[index];++extension)
+		{
+			extended_windows[index]->extendMessageHandler(WM_BENCHMARK_EXTENDED,[](OS::Window* window,WPARAM w_param,LPARAM l_param){
+				Benchmark::Consume(w_param);
+			});
+		}
+	}
+
+	/* The same handler, found at compile time, on the window and on its class, and a button's click handled as Application::Load handles it against the way it used to. */
+	window_class->setDefaultMessageHandler(WM_MOUSEMOVE,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+		return w_param;
+	});
+	windows[0]->setMessageHandler(WM_MOUSEMOVE,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+		return w_param;
+	});
+	static_window = window_class->instantiate<StaticBenchmarkWindow>(L"Static");
+	static_button = OS::WindowClass::GetByName(L"Button")->instantiate<Application::MadButton>(L"Static");
+	static_button->on_click = [](OS::Window& window){
+		Benchmark::Consume(1);
+	};
+	extended_button = OS::WindowClass::GetByName(L"Button")->instantiate(L"Extended");
+	extended_button->extendMessageHandler(WM_LBUTTONUP,[](OS::Window* window,WPARAM w_param,LPARAM l_param){
+		Benchmark::Consume(1);
+	});
+
+	/* The main window and its children, as described by the application's resources. */
+	OS::WindowClass::GetByName(L"Button")->setWindowDefaults(WS_TABSTOP | WS_CHILD | BS_PUSHBUTTON,0,0,0,0,0);  //As Application::Load sets them.
+	Headless::AddResource(nullptr,L"XML",UI_CLASS_WINDOW_ID,application_classes[0].data(),application_classes[0].size());
+	Headless::AddResource(nullptr,L"XML",UI_CLASS_PUSH_BUTTON_ID,application_classes[1].data(),application_classes[1].size());
+	application_ui_classes[0] = OS::UIClass::Load(module,UI_CLASS_WINDOW_ID);
+	application_ui_classes[1] = OS::UIClass::Load(module,UI_CLASS_PUSH_BUTTON_ID);
+	main_window = CreateFromDescription(*XML::Parse(main_document.data(),main_document.size()).getChild(L"Window"));
+	main_window->getLayout()->update();
+
+	documents.push_back(std::make_pair(std::string("Parse/UIClass Window"),ReadFile(RESOURCE_DIRECTORY "UIClass/Window.xml")));
+	documents.push_back(std::make_pair(std::string("Parse/UI Main"),ReadFile(RESOURCE_DIRECTORY "UI/Main.xml")));
+	documents.push_back(std::make_pair(std::string("Parse/1000 elements"),MakeDocument(1000)));
+
+	/* Micro benchmarks */
+	cases.push_back({"HandleMessage",1,"message",[&]()
+	{
+		Benchmark::Consume(CallWindowProc(procedure,windows[0]->getNativeHandle(),WM_BENCHMARK,1,0));
+	}});
+	cases.push_back({"HandleMessage/alternating windows",2,"message",[&]()
+	{
+		Benchmark::Consume(CallWindowProc(procedure,windows[0]->getNativeHandle(),WM_BENCHMARK,1,0));
+		Benchmark::Consume(CallWindowProc(procedure,windows[1]->getNativeHandle(),WM_BENCHMARK,1,0));
+	}});
+	cases.push_back({"HandleMessage/static handler",1,"message",[&]()
+	{
+		Benchmark::Consume(CallWindowProc(procedure,static_window->getNativeHandle(),WM_MOUSEMOVE,1,0));
+	}});
+	cases.push_back({"HandleMessage/window handler",1,"message",[&]()
+	{
+		Benchmark::Consume(CallWindowProc(procedure,windows[0]->getNativeHandle(),WM_MOUSEMOVE,1,0));
+	}});
+	cases.push_back({"HandleMessage/class handler",1,"message",[&]()
+	{
+		Benchmark::Consume(CallWindowProc(procedure,windows[1]->getNativeHandle(),WM_MOUSEMOVE,1,0));
+	}});
+	cases.push_back({"HandleMessage/button click static",1,"message",[&]()
+	{
+		Benchmark::Consume(CallWindowProc(procedure,static_button->getNativeHandle(),WM_LBUTTONUP,0,0));
+	}});
+	cases.push_back({"HandleMessage/button click extended",1,"message",[&]()
+	{
+		Benchmark::Consume(CallWindowProc(procedure,extended_button->getNativeHandle(),WM_LBUTTONUP,0,0));
+	}});
+	cases.push_back({"SendMessage",1,"message",[&]()  //Through the stand-in's message queue, for scale.
+	{
+		Benchmark::Consume(SendMessage(windows[0]->getNativeHandle(),WM_BENCHMARK,1,0));
+	}});
+	cases.push_back({"Window::FromHandle",1,"lookup",[&]()
+	{
+		Benchmark::Consume((std::uint64_t)OS::Window::FromHandle(windows[0]->getNativeHandle()));
+	}});
+	cases.push_back({"Window::FromHandle/alternating windows",2,"lookup",[&]()
+	{
+		Benchmark::Consume((std::uint64_t)OS::Window::FromHandle(windows[0]->getNativeHandle()));
+		Benchmark::Consume((std::uint64_t)OS::Window::FromHandle(windows[1]->getNativeHandle()));
+	}});
+	cases.push_back({"WindowClass::GetByName/registered",1,"lookup",[&]()
+	{
+		Benchmark::Consume((std::uint64_t)OS::WindowClass::GetByName(L"BenchmarkWindow"));
+	}});
+	cases.push_back({"WindowClass::GetByName/system",1,"lookup",[&]()
+	{
+		Benchmark::Consume((std::uint64_t)OS::WindowClass::GetByName(L"Button"));
+	}});
+	for(int index = 0;index < 3;++index)
+	{
+		OS::Window* window = extended_windows[index];
+		int extensions = extension_counts[index];
+
+
+		cases.push_back({"extendMessageHandler/dispatch " + std::to_string(extensions),1,"message",[window,procedure]()
+		{
+			Benchmark::Consume(CallWindowProc(procedure,window->getNativeHandle(),WM_BENCHMARK_EXTENDED,1,0));
+		}});
+		cases.push_back({"extendMessageHandler/extend " + std::to_string(extensions),(double)extensions,"extension",[window,extensions]()
+		{
+			window->setMessageHandler(WM_BENCHMARK,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+				return w_param;
+			});
+			for(int extension = 0;extension < extensions;++extension)
+			{
+				window->extendMessageHandler(WM_BENCHMARK,[](OS::Window* window,WPARAM w_param,LPARAM l_param){
+					Benchmark::Consume(w_param);
+				});
+			}
+		}});
+	}
+	for(int threads : thread_counts)  //Readers take no lock, so throughput should grow with the threads, up to the number of cores.
+	{
+		HWND window_handle = windows[0]->getNativeHandle();
+		std::string suffix = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+
+
+		cases.push_back({"WindowClass::GetByName/" + suffix,(double)threads * READS_PER_THREAD,"lookup",[threads]()
+		{
+			ReadOnThreads(threads,[](){
+				Benchmark::Consume((std::uint64_t)OS::WindowClass::GetByName(L"BenchmarkWindow"));
+			});
+		}});
+		cases.push_back({"HandleMessage/" + suffix,(double)threads * READS_PER_THREAD,"message",[threads,procedure,window_handle]()
+		{
+			ReadOnThreads(threads,[procedure,window_handle](){
+				Benchmark::Consume(CallWindowProc(procedure,window_handle,WM_BENCHMARK,1,0));
+			});
+		}});
+	}
+	cases.push_back({"Trace::Scope",1,"scope",[&]()  //The thread's buffer is reset whenever it fills, so that every scope is recorded rather than dropped.
+	{
+		{
+			Trace::Scope scope("Benchmark");
+		}
+		if(++trace_scopes == Trace::EVENTS_PER_THREAD)
+		{
+			Trace::Reset();
+			trace_scopes = 0;
+		}
+	}});
+	cases.push_back({"Module::getStringResource",1,"string",[&]()
+	{
+		Benchmark::Consume(module.getStringResource(STRING_ID).length());
+	}});
+	cases.push_back({"wstos",(double)procedure_name.length(),"character",[&]()
+	{
+		Benchmark::Consume(wstos(procedure_name).length());
+	}});
+	for(const auto& document : documents)
+	{
+		const std::string& data = document.second;
+
+
+		cases.push_back({"XML::" + document.first,(double)data.size(),"byte",[&data]()
+		{
+			Benchmark::Consume(XML::Parse(data.data(),data.size()).getChildren().size());
+		}});
+	}
+
+	/* Macro benchmarks */
+	cases.push_back({"Tree/create and destroy " + std::to_string(TREE_WINDOWS),TREE_WINDOWS,"window",[&]()
+	{
+		CreateTree(window_class,child_class).root->destroy();
+	}});
+	cases.push_back({"Tree/create, lay out and destroy " + std::to_string(TREE_WINDOWS),TREE_WINDOWS,"window",[&]()
+	{
+		Tree created = CreateTree(window_class,child_class);
+
+
+		LayOutTree(created);
+		created.root->destroy();
+	}});
+	cases.push_back({"UIClass::Load/" + std::to_string(UI_CLASS_LEVELS) + " levels",UI_CLASS_LEVELS,"class",[&]()
+	{
+		OS::UIClass* loaded[UI_CLASS_LEVELS];
+
+
+		LoadUIClasses(module,LOADED_UI_CLASS_ID,loaded);
+		UnloadUIClasses(loaded);
+	}});
+	LoadUIClasses(module,INSTANTIATED_UI_CLASS_ID,ui_classes);
+	cases.push_back({"UIClass::instantiate/" + std::to_string(UI_CLASS_LEVELS) + " levels, " + std::to_string(UI_CLASS_INSTANCES) + " windows",UI_CLASS_INSTANCES,"window",[&]()
+	{
+		for(OS::Window*& instance : instances)
+		{
+			instance = ui_classes[UI_CLASS_LEVELS - 1]->instantiate();
+		}
+		for(OS::Window* instance : instances)
+		{
+			instance->destroy();
+		}
+	}});
+	cases.push_back({"UIClass::instantiate/" + std::to_string(UI_CLASS_LEVELS) + " levels, " + std::to_string(UI_CLASS_INSTANCES) + " windows deferred",UI_CLASS_INSTANCES,"window",[&]()
+	{
+		for(OS::Window*& instance : instances)
+		{
+			instance = ui_classes[UI_CLASS_LEVELS - 1]->instantiate(true);
+		}
+		for(OS::Window* instance : instances)
+		{
+			instance->destroy();
+		}
+	}});
+	startup_window = StartUp(window_class,child_class,false);
+	context["native windows at start up, " + startup_suffix] = std::to_string(CountNativeWindows(startup_window)) + " realized";
+	startup_window->destroy();
+	startup_window = StartUp(window_class,child_class,true);
+	context["native windows at start up, " + startup_suffix] += ", " + std::to_string(CountNativeWindows(startup_window)) + " deferred";
+	startup_window->destroy();
+	cases.push_back({"Startup/" + startup_suffix,STARTUP_CONTROLS,"control",[&]()  //Created, shown and destroyed.
+	{
+		StartUp(window_class,child_class,false)->destroy();
+	}});
+	cases.push_back({"Startup/" + startup_suffix + " deferred",STARTUP_CONTROLS,"control",[&]()
+	{
+		StartUp(window_class,child_class,true)->destroy();
+	}});
+	cases.push_back({"Window::render/UI Main first",1,"render",[&]()
+	{
+		InvalidateTree(main_window);
+		main_window->render(render_target);
+		Benchmark::Consume(render_target.getPixel(0,0));
+	}});
+	cases.push_back({"Window::render/UI Main cached",1,"render",[&]()
+	{
+		main_window->render(render_target);
+		Benchmark::Consume(render_target.getPixel(0,0));
+	}});
+	tree = CreateTree(window_class,child_class);
+	cases.push_back({"Tree/lay out " + std::to_string(TREE_WINDOWS),TREE_WINDOWS,"window",[&]()
+	{
+		LayOutTree(tree);
+	}});
+	large_tree = CreateTree(window_class,child_class,LARGE_TREE_BRANCHES,LARGE_TREE_LEAVES);
+	LayOutTree(large_tree);
+	cases.push_back({"Layout::update/full " + std::to_string(LARGE_TREE_WINDOWS),1,"update",[&]()  //Every node is arranged again.
+	{
+		LayOutTree(large_tree);
+	}});
+	cases.push_back({"Layout::update/one leaf of " + std::to_string(LARGE_TREE_WINDOWS),1,"update",[&]()  //Only the leaf's branch is.
+	{
+		LayOutLeaf(large_tree,leaf_step);
+	}});
+	cases.push_back({"Window::render/first " + std::to_string(TREE_WINDOWS),TREE_WINDOWS,"window",[&]()
+	{
+		InvalidateTree(tree.root);
+		tree.root->render(render_target);
+		Benchmark::Consume(render_target.getPixel(0,0));
+	}});
+	cases.push_back({"Window::render/cached " + std::to_string(TREE_WINDOWS),TREE_WINDOWS,"window",[&]()
+	{
+		tree.root->render(render_target);
+		Benchmark::Consume(render_target.getPixel(0,0));
+	}});
+	CreateControlGrid(window_class,GRID_CONTROLS,control_grid);
+	cases.push_back({"Window::getControlByLocation/" + std::to_string(GRID_CONTROLS) + " controls",1,"query",[&]()
+	{
+		const POINT& point = control_grid.getNextPoint();
+
+
+		Benchmark::Consume((std::uint64_t)control_grid.root->getControlByLocation(point.x,point.y));
+	}});
+	cases.push_back({"HandleMessage/mouse over " + std::to_string(GRID_CONTROLS) + " controls",1,"message",[&]()  //Hit tested and passed to the control under the cursor.
+	{
+		const POINT& point = control_grid.getNextPoint();
+
+
+		Benchmark::Consume(CallWindowProc(procedure,control_grid.root->getNativeHandle(),WM_MOUSEMOVE,0,MAKELPARAM(point.x,point.y)));
+	}});
+	cases.push_back({"Control/paint 1 of " + std::to_string(GRID_CONTROLS) + " controls",1,"control",[&]()
+	{
+		const POINT& point = control_grid.getNextPoint();
+		RECT area = {point.x,point.y,point.x + 1,point.y + 1};  //Within one control.
+
+
+		PaintWindow(control_grid.root,&area);
+	}});
+	cases.push_back({"Control/paint " + std::to_string(GRID_CONTROLS) + " controls",GRID_CONTROLS,"control",[&]()
+	{
+		PaintWindow(control_grid.root,nullptr);
+	}});
+	buffered_window = window_class->instantiate(L"Buffered");
+	buffered_window->setDoubleBuffered(true);
+	buffered_window->setMessageHandler(WM_PAINT,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+		PAINTSTRUCT paint_struct;
+
+
+		window->beginPaint(paint_struct);
+		window->endPaint(paint_struct);
+
+		return 0;
+	});
+	buffered_window->show();
+	cases.push_back({"Window::beginPaint/double-buffered 800x600",1,"paint",[&]()  //The whole back buffer filled and copied to the screen.
+	{
+		PaintWindow(buffered_window,nullptr);
+	}});
+	cases.push_back({"Window::beginPaint/double-buffered 10x10 of 800x600",1,"paint",[&]()  //Only the invalidated area.
+	{
+		RECT area = {100,100,110,110};
+
+
+		PaintWindow(buffered_window,&area);
+	}});
+	list_window = list_class->instantiate(L"List");
+	list_window->setParent(windows[0]);
+	list_window->setDimensions(400,600);
+	list = OS::VirtualList::FromWindow(list_window);
+	list->setRowHeight(LIST_ROW_HEIGHT);
+	list->setCellClass(child_class);
+	list->setDataSource(LIST_ROWS,[](OS::Window* cell,size_t row,size_t column){
+		cell->setName(std::to_wstring(row));
+	});
+	cases.push_back({"VirtualList/scroll " + std::to_string(LIST_ROWS) + " rows by a row",1,"row",[&]()
+	{
+		ScrollList(list,1);
+	}});
+	cases.push_back({"VirtualList/scroll " + std::to_string(LIST_ROWS) + " rows by a page",(double)list->getVisibleRowCount(),"row",[&]()
+	{
+		ScrollList(list,(long long)list->getVisibleRowCount());
+	}});
+	cases.push_back({"VirtualList/wheel over " + std::to_string(LIST_ROWS) + " rows",3,"row",[&]()  //Three rows a notch.
+	{
+		size_t first_row = list->getFirstVisibleRow();
+
+
+		SendMessage(list_window->getNativeHandle(),WM_MOUSEWHEEL,MAKEWPARAM(0,-WHEEL_DELTA),0);
+		if(list->getFirstVisibleRow() == first_row)
+		{
+			list->scrollTo(0);
+		}
+	}});
+	timer_window = window_class->instantiate(L"Timers");
+	FireTimers(timer_window,TIMERS,TIMER_DELAY,TIMER_SPREAD);  //Measured once, as the lateness of the timers rather than a time per iteration.
+	timer_statistics = OS::GetTimerStatistics();
+	std::snprintf(lateness,sizeof(lateness),"%.3f median, %.3f 99th percentile, %.3f maximum",timer_statistics.median_lateness,timer_statistics.percentile_99_lateness,timer_statistics.maximum_lateness);
+	context["timer lateness of " + std::to_string(TIMERS) + " over " + std::to_string(TIMER_SPREAD) + " ms, in ms"] = lateness;
+	cases.push_back({"Window::setTimer/fire " + std::to_string(TIMERS),TIMERS,"timer",[&]()  //All due at once, and dispatched as one batch.
+	{
+		FireTimers(timer_window,TIMERS,0,1);
+	}});
+	for(size_t timer = 0;timer < TIMERS;++timer)
+	{
+		windows[1]->setTimer(PENDING_TIMER_DELAY,[](OS::Window* window){
+		});
+	}
+	cases.push_back({"Window::setTimer/set and cancel with " + std::to_string(TIMERS) + " pending",1,"timer",[&]()
+	{
+		timer_window->cancelTimer(timer_window->setTimer(PENDING_TIMER_DELAY,[](OS::Window* window){
+		}));
+	}});
+	property_window = window_class->instantiate(L"Properties");
+	observed_window = window_class->instantiate(L"Observed");
+	for(int index = 0;index < WINDOW_PROPERTIES;++index)
+	{
+		property_names.push_back(L"BenchmarkProperty" + std::to_wstring(index));
+	}
+	for(int index = 0;index < WINDOW_PROPERTIES;++index)  //Once every name is in place, so that none of them moves.
+	{
+		properties.emplace_back(property_names[index].c_str());
+		property_window->setProperty(properties.back(),(HANDLE)(UINT_PTR)index);
+		property_window->setProperty(property_names[index],(HANDLE)(UINT_PTR)index);
+		observed_window->setProperty(properties.back(),(HANDLE)(UINT_PTR)index);
+		observed_window->observeProperty(properties.back(),[](OS::Window* window,OS::PropertyId property){
+			Benchmark::Consume(property);
+		});
+	}
+	cases.push_back({"Window::getProperty/typed",1,"property",[&]()
+	{
+		Benchmark::Consume((std::uint64_t)property_window->getProperty(properties[++property_step % WINDOW_PROPERTIES]));
+	}});
+	cases.push_back({"Window::getProperty/native",1,"property",[&]()  //Through GetProp, by name, as every property was kept before typed ones.
+	{
+		Benchmark::Consume((std::uint64_t)property_window->getProperty(property_names[++property_step % WINDOW_PROPERTIES]));
+	}});
+	cases.push_back({"Window::setProperty/typed",1,"property",[&]()
+	{
+		property_window->setProperty(properties[++property_step % WINDOW_PROPERTIES],(HANDLE)property_step);
+	}});
+	cases.push_back({"Window::setProperty/typed and observed",1,"property",[&]()
+	{
+		observed_window->setProperty(properties[++property_step % WINDOW_PROPERTIES],(HANDLE)property_step);
+	}});
+	cases.push_back({"Window::setProperty/native",1,"property",[&]()
+	{
+		property_window->setProperty(property_names[++property_step % WINDOW_PROPERTIES],(HANDLE)property_step);
+	}});
+	for(int index = 0;index < 3;++index)  //Through the index against the system's walk of every child, which is what the index replaced.
+	{
+		Grid* grid = &grids[index];
+		std::string suffix = std::to_string(grid_sizes[index]) + " children";
+
+
+		CreateGrid(window_class,child_class,grid_sizes[index],*grid);
+		cases.push_back({"Window::getChildByLocation/" + suffix,1,"query",[grid]()
+		{
+			const POINT& point = grid->getNextPoint();
+
+
+			Benchmark::Consume((std::uint64_t)grid->root->getChildByLocation(point.x,point.y));
+		}});
+		cases.push_back({"ChildWindowFromPointEx/" + suffix,1,"query",[grid]()
+		{
+			Benchmark::Consume((std::uint64_t)ChildWindowFromPointEx(grid->root->getNativeHandle(),grid->getNextPoint(),CWP_ALL));
+		}});
+		cases.push_back({"SpatialIndex::queryPoint/" + suffix,1,"query",[grid]()
+		{
+			const POINT& point = grid->getNextPoint();
+
+
+			Benchmark::Consume(grid->index.queryPoint(point.x,point.y,[](int item){
+				return true;
+			}));
+		}});
+	}
+
+	result = Benchmark::Main(argc,argv,cases,context);
+
+	for(Grid& grid : grids)
+	{
+		grid.root->destroy();
+	}
+	observed_window->destroy();
+	property_window->destroy();
+	timer_window->destroy();
+	buffered_window->destroy();
+	control_grid.root->destroy();
+	large_tree.root->destroy();
+	tree.root->destroy();
+	main_window->destroy();
+	OS::UIClass::Unload(application_ui_classes[1]);
+	OS::UIClass::Unload(application_ui_classes[0]);
+	UnloadUIClasses(ui_classes);
+	extended_button->destroy();
+	static_button->destroy();
+	static_window->destroy();
+	for(OS::Window* window : extended_windows)
+	{
+		window->destroy();
+	}
+	for(OS::Window* window : windows)
+	{
+		window->destroy();
+	}
+	OS::WindowClass::Unregister(list_class);
+	OS::WindowClass::Unregister(main_window_class);
+	OS::WindowClass::Unregister(child_class);
+	OS::WindowClass::Unregister(window_class);
+
+	return result;
+}
\ No newline at end of file
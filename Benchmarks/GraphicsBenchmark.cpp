@@ -0,0 +1,86 @@
+#include "Benchmark.h"
+#include "Graphics.h"
+
+#include <cstdio>
+#include <vector>
+
+using Benchmark::Case;
+using Graphics::Bounds;
+using Graphics::Surface;
+
+
+namespace
+{
+	/* Constants */
+	const int HEIGHT = 1080;
+	const int WIDTH = 1920;
+
+	Surface MakeSurface(int width,int height,Graphics::Color seed)
+	{
+		Surface surface(width,height);
+		Graphics::Color color = seed;
+
+
+		for(int y = 0;y < height;++y)
+		{
+			for(int x = 0;x < width;++x)
+			{
+				color = color * 1664525 + 1013904223;
+				surface.setPixel(x,y,color);
+			}
+		}
+
+		return surface;
+	}
+}
+
+int main(int argc,char** argv)
+{
+#if defined(__AVX2__) && defined(__GNUC__)
+	if(!__builtin_cpu_supports("avx2"))
+	{
+		std::printf("Skipped, as this machine doesn't support AVX2.\n");
+
+		return 77;  //SKIP_RETURN_CODE
+	}
+#endif
+
+	Surface destination = MakeSurface(WIDTH,HEIGHT,1);
+	Surface source = MakeSurface(WIDTH,HEIGHT,2);
+	Bounds full = {0,0,WIDTH,HEIGHT};
+	Bounds unaligned = {3,1,WIDTH - 5,HEIGHT - 1};  //Starts and ends mid-vector.
+	std::vector<std::uint8_t> mask(WIDTH / 8 * HEIGHT);
+	double pixels = (double)WIDTH * HEIGHT;
+	double unaligned_pixels = (double)(unaligned.right - unaligned.left) * (unaligned.bottom - unaligned.top);
+	std::vector<Case> cases;
+	std::map<std::string,std::string> context;
+
+
+	for(size_t index = 0;index < mask.size();++index)
+	{
+		mask[index] = (std::uint8_t)(index % 5 == 0 ? 0 : index * 37);  //Text-like, with some empty runs.
+	}
+
+	cases.push_back({"FillRectangle/opaque",pixels,"pixel",[&]() { Graphics::FillRectangle(destination,full,0xFF336699); }});
+	cases.push_back({"FillRectangle/unaligned",unaligned_pixels,"pixel",[&]() { Graphics::FillRectangle(destination,unaligned,0xFF336699); }});
+	cases.push_back({"BlendRectangle/translucent",pixels,"pixel",[&]() { Graphics::BlendRectangle(destination,full,0x80336699); }});
+	cases.push_back({"BlendRectangle/unaligned",unaligned_pixels,"pixel",[&]() { Graphics::BlendRectangle(destination,unaligned,0x80336699); }});
+	cases.push_back({"FillGradient/horizontal",pixels,"pixel",[&]() { Graphics::FillGradient(destination,full,0xFF000000,0x80FFFFFF,false); }});
+	cases.push_back({"FillGradient/vertical",pixels,"pixel",[&]() { Graphics::FillGradient(destination,full,0xFF000000,0x80FFFFFF,true); }});
+	cases.push_back({"BlendSurface/full",pixels,"pixel",[&]() { Graphics::BlendSurface(destination,source,0,0); }});
+	cases.push_back({"BlendSurface/offset",(double)(WIDTH - 3) * (HEIGHT - 1),"pixel",[&]() { Graphics::BlendSurface(destination,source,3,1); }});
+	cases.push_back({"CopySurface/full",pixels,"pixel",[&]() { Graphics::CopySurface(destination,source,0,0); }});
+	cases.push_back({"CopySurface/clipped",unaligned_pixels,"pixel",[&]() { Graphics::CopySurface(destination,source,0,0,&unaligned); }});
+	cases.push_back({"DrawMask/text",pixels,"pixel",[&]() { Graphics::DrawMask(destination,0,0,mask.data(),WIDTH,HEIGHT,WIDTH / 8,0xC0202020); }});
+
+	cases.push_back({"Reference/FillRectangle/opaque",pixels,"pixel",[&]() { Graphics::Reference::FillRectangle(destination,full,0xFF336699); }});
+	cases.push_back({"Reference/BlendRectangle/translucent",pixels,"pixel",[&]() { Graphics::Reference::BlendRectangle(destination,full,0x80336699); }});
+	cases.push_back({"Reference/FillGradient/horizontal",pixels,"pixel",[&]() { Graphics::Reference::FillGradient(destination,full,0xFF000000,0x80FFFFFF,false); }});
+	cases.push_back({"Reference/BlendSurface/full",pixels,"pixel",[&]() { Graphics::Reference::BlendSurface(destination,source,0,0); }});
+	cases.push_back({"Reference/DrawMask/text",pixels,"pixel",[&]() { Graphics::Reference::DrawMask(destination,0,0,mask.data(),WIDTH,HEIGHT,WIDTH / 8,0xC0202020); }});
+
+	context["instruction_set"] = Graphics::GetInstructionSet();
+	context["surface"] = std::to_string(WIDTH) + "x" + std::to_string(HEIGHT);
+
+	return Benchmark::Main(argc,argv,cases,context);
+}
\ No newline at end of file
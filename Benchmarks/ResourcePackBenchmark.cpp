@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+#include "ResourcePack.h"
+#include "Resources/Resources.h"
+
+#include <string>
+#include <vector>
+
+using Benchmark::Case;
+using OS::ResourcePack;
+
+
+int main(int argc,char** argv)
+{
+	std::string path_text = RESOURCE_PACK;
+	std::wstring path(path_text.begin(),path_text.end());
+	ResourcePack pack(path);
+	std::uintptr_t strings[] = {Application_Title,Application_UIClass_Button_Name,Application_MadButton_Class,Application_MadButton_OnClick,Application_MadButton_OnCreate,Application_MadButton_OnDestroy,Application_MainWindow_Class,Application_MainWindow_OnCreate};
+	const wchar_t* documents[] = {(const wchar_t*)Application_Config,L"APPLICATION_UI",(const wchar_t*)Application_UIClass_PushButton,(const wchar_t*)Application_UIClass_Window};
+	std::vector<Case> cases;
+
+
+	cases.push_back({"findResource/string",8,"lookup",[&]()
+	{
+		ResourcePack::Entry entry;
+		std::uint64_t total = 0;
+
+
+		for(std::uintptr_t id : strings)
+		{
+			total += pack.findResource((const wchar_t*)6,(const wchar_t*)id,0,entry) ? entry.size : 0;
+		}
+		Benchmark::Consume(total);
+	}});
+	cases.push_back({"findResource/named type",4,"lookup",[&]()
+	{
+		ResourcePack::Entry entry;
+		std::uint64_t total = 0;
+
+
+		for(const wchar_t* name : documents)
+		{
+			total += pack.findResource(L"XML",name,0,entry) ? entry.size : 0;
+		}
+		Benchmark::Consume(total);
+	}});
+	cases.push_back({"findResource/missing language",4,"lookup",[&]()  //Misses the hash and falls back to the directory.
+	{
+		ResourcePack::Entry entry;
+		std::uint64_t total = 0;
+
+
+		for(const wchar_t* name : documents)
+		{
+			total += pack.findResource(L"XML",name,0x0409,entry) ? 1 : 0;
+		}
+		Benchmark::Consume(total);
+	}});
+	cases.push_back({"open",1,"pack",[&]()
+	{
+		ResourcePack opened(path);
+
+
+		Benchmark::Consume(opened.getResourceCount());
+	}});
+
+	return Benchmark::Main(argc,argv,cases);
+}
\ No newline at end of file
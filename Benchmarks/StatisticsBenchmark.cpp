@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+#include "Statistics.h"
+
+#include <vector>
+
+using Benchmark::Case;
+
+
+namespace
+{
+	/* Constants */
+	const size_t VALUES = 4096;
+}
+
+int main(int argc,char** argv)
+{
+	std::vector<std::uint64_t> values(VALUES);
+	std::uint64_t state = 1;
+	Statistics::Histogram histogram;
+	Statistics::Distribution distribution;
+	std::vector<Case> cases;
+
+
+	for(std::uint64_t& value : values)  //Latencies in nanoseconds, from about a microsecond to a few milliseconds.
+	{
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		value = 1000 + (state >> 33) % 4000000;
+	}
+	for(std::uint64_t value : values)
+	{
+		histogram.record(value);
+	}
+	histogram.addTo(distribution);
+
+	cases.push_back({"GetBucket",(double)VALUES,"value",[&]()
+	{
+		std::uint64_t sum = 0;
+
+
+		for(std::uint64_t value : values)
+		{
+			sum += Statistics::GetBucket(value);
+		}
+		Benchmark::Consume(sum);
+	}});
+	cases.push_back({"Histogram::record",(double)VALUES,"value",[&]()
+	{
+		for(std::uint64_t value : values)
+		{
+			histogram.record(value);
+		}
+	}});
+	cases.push_back({"Histogram::addTo",1,"histogram",[&]()
+	{
+		Statistics::Distribution copy;
+
+
+		histogram.addTo(copy);
+		Benchmark::Consume(copy.count);
+	}});
+	cases.push_back({"Distribution::getPercentile",1,"percentile",[&]()
+	{
+		Benchmark::Consume(distribution.getPercentile(0.99));
+	}});
+
+	return Benchmark::Main(argc,argv,cases);
+}
\ No newline at end of file
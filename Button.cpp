@@ -1,4 +1,5 @@
-#include "OS.h"
+#include "Application.h"
+#include "Layout.h"
 
 
 const wchar* sayings[] = {
@@ -10,6 +11,41 @@ const wchar* sayings[] = {
 
 unsigned times_clicked = 0;
 
+namespace Application
+{
+	/* Type [Application::MadButton] Definition */
+	MadButton::MadButton(OS::WindowClass* window_class)
+	: StaticWindow(window_class)
+	{
+	}
+
+	LRESULT MadButton::onDestroy(WPARAM w_param,LPARAM l_param)
+	{
+		LRESULT result = StaticWindow::onDestroy(w_param,l_param);
+
+
+		if(this->on_destroy)
+		{
+			this->on_destroy(*this);
+		}
+
+		return result;
+	}
+
+	LRESULT MadButton::onLeftButtonUp(WPARAM w_param,LPARAM l_param)
+	{
+		LRESULT result = StaticWindow::onLeftButtonUp(w_param,l_param);  //Lets the native button see its release first.
+
+
+		if(this->on_click)
+		{
+			this->on_click(*this);
+		}
+
+		return result;
+	}
+}
+
 EXPORT void MadButton_OnClick(OS::Window& button)
 {
 	if(times_clicked == 0)
@@ -33,8 +69,9 @@ EXPORT void MadButton_OnClick(OS::Window& button)
 EXPORT void MadButton_OnCreate(OS::Window& button)
 {
 	button.setName(L"Do Not Click");
-	button.setPosition(15,15);
-	button.setDimensions(300,25);
+	button.getLayout()->setWidth(300);
+	button.getLayout()->setHeight(25);
+	button.getLayout()->setPadding(15);
 }
 
 EXPORT void MadButton_OnDestroy(OS::Window& button)
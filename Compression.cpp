@@ -0,0 +1,283 @@
+#include "Compression.h"
+
+#include <cstring>
+
+
+namespace
+{
+	const size_t HASH_BITS = 14;
+	const size_t WINDOW_SIZE = Compression::MAXIMUM_OFFSET + 1;
+
+	inline std::uint32_t HashSequence(const std::uint8_t* data)
+	{
+		std::uint32_t sequence;
+
+
+		std::memcpy(&sequence,data,sizeof(sequence));
+
+		return (sequence * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	void WriteLength(std::vector<std::uint8_t>& output,size_t length)  //Extra bytes for a length whose nibble was 15.
+	{
+		for(;length >= 255;length -= 255)
+		{
+			output.push_back(255);
+		}
+		output.push_back((std::uint8_t)length);
+	}
+
+	bool ReadLength(const std::uint8_t*& source,const std::uint8_t* end,size_t& length)
+	{
+		std::uint8_t byte;
+
+
+		do
+		{
+			if(source == end)
+			{
+				return false;
+			}
+			byte = *source++;
+			length += byte;
+		} while(byte == 255);
+
+		return true;
+	}
+
+	void WriteSequence(std::vector<std::uint8_t>& output,const std::uint8_t* literals,size_t literal_count,size_t offset,size_t match_length)
+	{
+		size_t extra_match = match_length - Compression::MINIMUM_MATCH;
+
+
+		output.push_back((std::uint8_t)(((literal_count < 15 ? literal_count : 15) << 4) | (match_length == 0 ? 0 : (extra_match < 15 ? extra_match : 15))));
+		if(literal_count >= 15)
+		{
+			WriteLength(output,literal_count - 15);
+		}
+		output.insert(output.end(),literals,literals + literal_count);
+
+		if(match_length == 0)  //The final sequence.
+		{
+			return;
+		}
+
+		output.push_back((std::uint8_t)(offset & 0xFF));
+		output.push_back((std::uint8_t)(offset >> 8));
+		if(extra_match >= 15)
+		{
+			WriteLength(output,extra_match - 15);
+		}
+	}
+
+	/* Walks the sequences of a block, handing the literals and matches to the given sink.  Sink must provide literal(data,count) and match(offset,length), returning false to stop. */
+	template<typename Sink>
+	bool DecodeSequences(const std::uint8_t* source,size_t source_size,Sink& sink)
+	{
+		const std::uint8_t* end = source + source_size;
+
+
+		while(source < end)
+		{
+			std::uint8_t token = *source++;
+			size_t literal_count = token >> 4;
+			size_t match_length = token & 0x0F;
+			size_t offset;
+
+
+			if(literal_count == 15 && !ReadLength(source,end,literal_count))
+			{
+				return false;
+			}
+			if((size_t)(end - source) < literal_count || !sink.literal(source,literal_count))
+			{
+				return false;
+			}
+			source += literal_count;
+
+			if(source == end)  //The final sequence has no match.
+			{
+				return true;
+			}
+
+			if(end - source < 2)
+			{
+				return false;
+			}
+			offset = source[0] | ((size_t)source[1] << 8);
+			source += 2;
+			if(match_length == 15 && !ReadLength(source,end,match_length))
+			{
+				return false;
+			}
+			if(offset == 0 || !sink.match(offset,match_length + Compression::MINIMUM_MATCH))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	struct BlockSink
+	{
+		std::uint8_t* begin;
+		std::uint8_t* position;
+		std::uint8_t* end;
+
+		bool literal(const std::uint8_t* data,size_t count)
+		{
+			if((size_t)(this->end - this->position) < count)
+			{
+				return false;
+			}
+			std::memcpy(this->position,data,count);
+			this->position += count;
+
+			return true;
+		}
+
+		bool match(size_t offset,size_t length)
+		{
+			const std::uint8_t* from = this->position - offset;
+
+
+			if((size_t)(this->position - this->begin) < offset || (size_t)(this->end - this->position) < length)
+			{
+				return false;
+			}
+			for(size_t index = 0;index < length;++index)  //Byte by byte, as a match may overlap its own output.
+			{
+				this->position[index] = from[index];
+			}
+			this->position += length;
+
+			return true;
+		}
+	};
+
+	struct StreamSink
+	{
+		const std::function<void(const std::uint8_t*,size_t)>* consumer;
+		std::vector<std::uint8_t> window;
+		size_t written;  //Total bytes decoded so far.
+		size_t flushed;
+
+		void put(std::uint8_t byte)
+		{
+			this->window[this->written % WINDOW_SIZE] = byte;
+			if(++this->written % WINDOW_SIZE == 0)  //Hand the window over before any of it is overwritten.
+			{
+				this->flush();
+			}
+		}
+
+		void flush()
+		{
+			size_t start = this->flushed % WINDOW_SIZE;
+
+
+			if(this->written > this->flushed)
+			{
+				(*this->consumer)(this->window.data() + start,this->written - this->flushed);
+				this->flushed = this->written;
+			}
+		}
+
+		bool literal(const std::uint8_t* data,size_t count)
+		{
+			for(size_t index = 0;index < count;++index)
+			{
+				this->put(data[index]);
+			}
+
+			return true;
+		}
+
+		bool match(size_t offset,size_t length)
+		{
+			if(this->written < offset)
+			{
+				return false;
+			}
+			for(size_t index = 0;index < length;++index)
+			{
+				this->put(this->window[(this->written - offset) % WINDOW_SIZE]);
+			}
+
+			return true;
+		}
+	};
+}
+
+namespace Compression
+{
+	/* Function Definitions */
+	std::vector<std::uint8_t> Compress(const std::uint8_t* data,size_t size)
+	{
+		std::vector<std::uint8_t> output;
+		std::vector<size_t> last_positions((size_t)1 << HASH_BITS,(size_t)-1);
+		size_t anchor = 0;  //Start of the pending literals.
+		size_t position = 0;
+
+
+		output.reserve(size / 2 + 16);
+		while(size >= MINIMUM_MATCH && position <= size - MINIMUM_MATCH)
+		{
+			std::uint32_t hash = HashSequence(data + position);
+			size_t candidate = last_positions[hash];
+			size_t match_length = 0;
+
+
+			last_positions[hash] = position;
+			if(candidate != (size_t)-1 && position - candidate <= MAXIMUM_OFFSET && std::memcmp(data + candidate,data + position,MINIMUM_MATCH) == 0)
+			{
+				match_length = MINIMUM_MATCH;
+				while(position + match_length < size && data[candidate + match_length] == data[position + match_length])
+				{
+					++match_length;
+				}
+			}
+
+			if(match_length == 0)
+			{
+				++position;
+
+				continue;
+			}
+
+			WriteSequence(output,data + anchor,position - anchor,position - candidate,match_length);
+			position += match_length;
+			anchor = position;
+		}
+		WriteSequence(output,data + anchor,size - anchor,0,0);
+
+		return output;
+	}
+
+	bool Decompress(const std::uint8_t* source,size_t source_size,std::uint8_t* destination,size_t destination_size)
+	{
+		BlockSink sink = {destination,destination,destination + destination_size};
+
+
+		return DecodeSequences(source,source_size,sink) && sink.position == sink.end;
+	}
+
+	bool DecompressStream(const std::uint8_t* source,size_t source_size,const std::function<void(const std::uint8_t* data,size_t size)>& consumer)
+	{
+		StreamSink sink;
+
+
+		sink.consumer = &consumer;
+		sink.window.resize(WINDOW_SIZE);
+		sink.written = 0;
+		sink.flushed = 0;
+		if(!DecodeSequences(source,source_size,sink))
+		{
+			return false;
+		}
+		sink.flush();
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+/**
+ * Small LZ77 block codec used for compressed resources.  A block is a series of sequences, each made of a token byte (the high nibble being the literal count and the low nibble the match length minus MINIMUM_MATCH; 15 in either means further length bytes follow, each adding up to 255), the literals, a two-byte little-endian offset and any extra match length bytes.  The final sequence has literals only.  Matches reach at most MAXIMUM_OFFSET bytes back, so a decoder needs no more history than that.
+ */
+namespace Compression
+{
+	/* Constants */
+	const size_t MAXIMUM_OFFSET = 65535;
+	const size_t MINIMUM_MATCH = 4;
+
+	/* Function Prototypes */
+	std::vector<std::uint8_t> Compress(const std::uint8_t* data,size_t size);
+
+	/**
+	 * Decompresses a whole block.
+	 *
+	 * @return Returns false if the block is corrupt or does not decompress to exactly destination_size bytes.
+	 */
+	bool Decompress(const std::uint8_t* source,size_t source_size,std::uint8_t* destination,size_t destination_size);
+
+	/**
+	 * Decompresses a block piece by piece, keeping only the last MAXIMUM_OFFSET + 1 bytes of output in memory.
+	 *
+	 * @param
+	 *   consumer
+	 *     Receives the decompressed data in order, at most 64 KiB at a time.
+	 *
+	 * @return Returns false if the block is corrupt.
+	 */
+	bool DecompressStream(const std::uint8_t* source,size_t source_size,const std::function<void(const std::uint8_t* data,size_t size)>& consumer);
+}
+
+#endif
\ No newline at end of file
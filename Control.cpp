@@ -0,0 +1,235 @@
+#include "Control.h"
+
+#include "MessageHandlerChain.h"
+
+
+namespace OS
+{
+	/* Type [OS::Control] Definition */
+	Control::Control(Window* host,const wchar* control_name)
+	: name(control_name)
+	{
+		assert(host != nullptr);
+
+
+		this->enabled = true;
+		this->host = host;
+		this->visible = true;
+		SetRectEmpty(&this->rectangle);
+
+		this->setDefaultMessageHandlers();
+	}
+
+	void Control::extendMessageHandler(UINT message,ExtendingControlMessageHandler handler)
+	{
+		assert(handler);
+
+
+		this->setMessageHandler(message,ExtendMessageHandler<Control>(this->getMessageHandler(message),handler));
+	}
+
+	int Control::getHeight()
+	{
+		return this->rectangle.bottom - this->rectangle.top;
+	}
+
+	Window* Control::getHost()
+	{
+		return this->host;
+	}
+
+	ControlMessageHandler Control::getMessageHandler(UINT message)
+	{
+		if(this->message_handlers.count(message) > 0)
+		{
+			return this->message_handlers[message];
+		}
+		else
+		{
+			return [](Control* control,WPARAM w_param,LPARAM l_param)
+			{
+				return (LRESULT)0;
+			};
+		}
+	}
+
+	std::wstring Control::getName()
+	{
+		return this->name;
+	}
+
+	RECT Control::getRectangle()
+	{
+		return this->rectangle;
+	}
+
+	int Control::getWidth()
+	{
+		return this->rectangle.right - this->rectangle.left;
+	}
+
+	int Control::getXCoordinate()
+	{
+		return this->rectangle.left;
+	}
+
+	int Control::getYCoordinate()
+	{
+		return this->rectangle.top;
+	}
+
+	bool Control::hasFocus()
+	{
+		return this->host->focused_control == this;
+	}
+
+	void Control::invalidate()
+	{
+		this->host->invalidate(&this->rectangle);
+	}
+
+	bool Control::isEligibleForHitTest(UINT flags)
+	{
+		if((flags & CWP_SKIPINVISIBLE) != 0 && !this->isVisible())
+		{
+			return false;
+		}
+
+		if((flags & CWP_SKIPDISABLED) != 0 && !this->isEnabled())
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	bool Control::isEnabled()
+	{
+		return this->enabled;
+	}
+
+	bool Control::isVisible()
+	{
+		return this->visible;
+	}
+
+	LRESULT Control::sendMessage(UINT message,WPARAM w_param,LPARAM l_param)
+	{
+		return this->getMessageHandler(message)(this,w_param,l_param);
+	}
+
+	void Control::setDefaultMessageHandlers()
+	{
+		this->setMessageHandler(WM_PAINT,[](Control* control,WPARAM w_param,LPARAM l_param){
+			HDC device_context = (HDC)w_param;
+			RECT rectangle = *(RECT*)l_param;
+			std::wstring name = control->getName();
+
+
+			FillRect(device_context,&rectangle,control->getHost()->getBackground());
+			SetBkMode(device_context,TRANSPARENT);
+			DrawText(device_context,name.c_str(),(int)name.length(),&rectangle,DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+			if(control->hasFocus())
+			{
+				DrawFocusRect(device_context,&rectangle);
+			}
+
+			return 0;
+		});
+	}
+
+	void Control::setDimensions(int width,int height)
+	{
+		this->invalidate();
+		this->rectangle.right = this->rectangle.left + width;
+		this->rectangle.bottom = this->rectangle.top + height;
+		this->host->control_index.update(this,this->rectangle);
+		this->invalidate();
+	}
+
+	void Control::setEnabled(bool enabled)
+	{
+		if(!enabled && this->hasFocus())
+		{
+			this->host->focused_control = nullptr;
+			this->sendMessage(WM_KILLFOCUS);
+		}
+
+		this->enabled = enabled;
+		this->sendMessage(WM_ENABLE,enabled ? TRUE : FALSE);
+		this->invalidate();
+	}
+
+	void Control::setFocus()
+	{
+		Control* previous_focus = this->host->focused_control;
+
+
+		if(previous_focus == this)
+		{
+			return;
+		}
+
+		if(this->host->isRealized() && this->host->isAlive())
+		{
+			SetFocus(this->host->window_handle);
+		}
+
+		this->host->focused_control = this;
+		if(previous_focus != nullptr)
+		{
+			previous_focus->sendMessage(WM_KILLFOCUS);
+			previous_focus->invalidate();
+		}
+		this->sendMessage(WM_SETFOCUS);
+		this->invalidate();
+	}
+
+	void Control::setMessageHandler(UINT message,ControlMessageHandler handler)
+	{
+		assert(handler);
+
+
+		this->message_handlers[message] = handler;
+	}
+
+	void Control::setName(const wchar* control_name)
+	{
+		assert(control_name != nullptr);
+
+
+		this->name = control_name;
+		this->invalidate();
+	}
+
+	void Control::setName(const std::wstring& control_name)
+	{
+		this->setName(control_name.c_str());
+	}
+
+	void Control::setPosition(int x,int y)
+	{
+		this->invalidate();
+		OffsetRect(&this->rectangle,x - this->rectangle.left,y - this->rectangle.top);
+		this->host->control_index.update(this,this->rectangle);
+		this->invalidate();
+	}
+
+	void Control::setVisible(bool visible)
+	{
+		if(!visible && this->hasFocus())
+		{
+			this->host->focused_control = nullptr;
+			this->sendMessage(WM_KILLFOCUS);
+		}
+
+		this->invalidate();  //Either the control or what was underneath it must be redrawn.
+		this->visible = visible;
+		this->sendMessage(WM_SHOWWINDOW,visible ? TRUE : FALSE);
+	}
+
+	void Control::unsetMessageHandler(UINT message)
+	{
+		this->message_handlers.erase(message);
+	}
+}
\ No newline at end of file
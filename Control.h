@@ -0,0 +1,84 @@
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include "OS.h"
+
+
+namespace OS
+{
+	/* Class Prototypes */
+	/**
+	 * A lightweight control which lives only as a node of its host window.  Messages are delivered to a control by its host: mouse messages carry coordinates relative to the control, keyboard messages are delivered to the focused control, and WM_PAINT is sent with the host's device context as the w_param and a pointer to the control's rectangle (in the host's client coordinates) as the l_param.
+	 */
+	class Control
+	{
+		friend class Window;
+
+		private:
+			bool enabled;
+			Window* host;
+			std::map<UINT,ControlMessageHandler> message_handlers;
+			std::wstring name;
+			RECT rectangle;
+			bool visible;
+
+		private:
+			Control(Window* host,const wchar* control_name);
+
+			bool isEligibleForHitTest(UINT flags);
+
+			void setDefaultMessageHandlers();
+
+		public:
+			void extendMessageHandler(UINT message,ExtendingControlMessageHandler handler);
+
+			int getHeight();
+
+			Window* getHost();
+
+			ControlMessageHandler getMessageHandler(UINT message);
+
+			std::wstring getName();
+
+			RECT getRectangle();
+
+			int getWidth();
+
+			int getXCoordinate();
+
+			int getYCoordinate();
+
+			bool hasFocus();
+
+			/**
+			 * Marks the area occupied by this control in its host as needing to be repainted.
+			 */
+			void invalidate();
+
+			bool isEnabled();
+
+			bool isVisible();
+
+			LRESULT sendMessage(UINT message,WPARAM w_param = 0,LPARAM l_param = 0);
+
+			void setDimensions(int width,int height);
+
+			void setEnabled(bool enabled);
+
+			void setFocus();
+
+			void setMessageHandler(UINT message,ControlMessageHandler handler);
+
+			void setName(const wchar* control_name);
+
+			void setName(const std::wstring& control_name);
+
+			void setPosition(int x,int y);
+
+			void setVisible(bool visible);
+
+			void unsetMessageHandler(UINT message);
+	};
+}
+
+#endif
\ No newline at end of file
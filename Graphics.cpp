@@ -0,0 +1,625 @@
+#include "Graphics.h"
+
+#include <cassert>
+#include <cstring>
+
+#if !defined(GRAPHICS_SCALAR)  //Defined to build only the portable code, such as to test it on a machine which has SSE2.
+	#if defined(__AVX2__)
+		#define GRAPHICS_AVX2
+	#endif
+	#if defined(GRAPHICS_AVX2) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define GRAPHICS_SSE2
+	#endif
+#endif
+
+#if defined(GRAPHICS_AVX2)
+	#include <immintrin.h>
+#elif defined(GRAPHICS_SSE2)
+	#include <emmintrin.h>
+#endif
+
+using Graphics::Bounds;
+using Graphics::Color;
+using Graphics::Surface;
+
+namespace
+{
+	/* Scalar Helpers */
+	inline std::uint32_t Divide255(std::uint32_t value)
+	{
+		return (value + 127) / 255;  //Rounds to nearest; a multiple of 255 can never be exactly halfway.
+	}
+
+	/* The color channels are weighted by the source's alpha; the destination's alpha is combined as if the source's alpha channel were opaque. */
+	inline Color BlendPixel(Color destination,Color source)
+	{
+		std::uint32_t alpha = source >> 24;
+		std::uint32_t inverse = 255 - alpha;
+		Color result = 0;
+
+
+		source |= 0xFF000000;
+		for(int shift = 0;shift < 32;shift += 8)
+		{
+			result |= Divide255(((source >> shift) & 0xFF) * alpha + ((destination >> shift) & 0xFF) * inverse) << shift;
+		}
+
+		return result;
+	}
+
+	inline Color Interpolate(Color from,Color to,int position,int length)
+	{
+		Color result = 0;
+
+
+		if(length <= 1)
+		{
+			return from;
+		}
+
+		for(int shift = 0;shift < 32;shift += 8)
+		{
+			std::uint32_t start = (from >> shift) & 0xFF;
+			std::uint32_t end = (to >> shift) & 0xFF;
+
+
+			result |= ((start * (length - 1 - position) + end * position + (length - 1) / 2) / (length - 1)) << shift;
+		}
+
+		return result;
+	}
+
+	inline bool IsMaskBitSet(const std::uint8_t* row,int column)
+	{
+		return (row[column >> 3] & (0x80 >> (column & 7))) != 0;
+	}
+
+	/* Vector Helpers */
+#if defined(GRAPHICS_SSE2)
+	inline __m128i Divide255(__m128i value)  //Same rounding as the scalar version for every value up to 255 * 255, in 16-bit lanes.
+	{
+		value = _mm_add_epi16(value,_mm_set1_epi16(128));
+
+		return _mm_srli_epi16(_mm_add_epi16(value,_mm_srli_epi16(value,8)),8);
+	}
+
+	inline __m128i BlendHalf(__m128i destination,__m128i source,__m128i alpha)
+	{
+		alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(alpha,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(3,3,3,3));
+
+		return Divide255(_mm_add_epi16(_mm_mullo_epi16(source,alpha),_mm_mullo_epi16(destination,_mm_sub_epi16(_mm_set1_epi16(255),alpha))));
+	}
+
+	inline __m128i BlendPixels(__m128i destination,__m128i source)  //Four pixels at a time.
+	{
+		__m128i opaque_source = _mm_or_si128(source,_mm_set1_epi32((int)0xFF000000));
+		__m128i zero = _mm_setzero_si128();
+		__m128i low = BlendHalf(_mm_unpacklo_epi8(destination,zero),_mm_unpacklo_epi8(opaque_source,zero),_mm_unpacklo_epi8(source,zero));
+		__m128i high = BlendHalf(_mm_unpackhi_epi8(destination,zero),_mm_unpackhi_epi8(opaque_source,zero),_mm_unpackhi_epi8(source,zero));
+
+
+		return _mm_packus_epi16(low,high);
+	}
+
+	inline __m128i SelectPixels(__m128i mask,__m128i selected,__m128i otherwise)
+	{
+		return _mm_or_si128(_mm_and_si128(mask,selected),_mm_andnot_si128(mask,otherwise));
+	}
+#endif
+
+#if defined(GRAPHICS_AVX2)
+	inline __m256i Divide255(__m256i value)
+	{
+		value = _mm256_add_epi16(value,_mm256_set1_epi16(128));
+
+		return _mm256_srli_epi16(_mm256_add_epi16(value,_mm256_srli_epi16(value,8)),8);
+	}
+
+	inline __m256i BlendHalf(__m256i destination,__m256i source,__m256i alpha)
+	{
+		alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(alpha,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(3,3,3,3));
+
+		return Divide255(_mm256_add_epi16(_mm256_mullo_epi16(source,alpha),_mm256_mullo_epi16(destination,_mm256_sub_epi16(_mm256_set1_epi16(255),alpha))));
+	}
+
+	inline __m256i BlendPixels(__m256i destination,__m256i source)  //Eight pixels at a time.  Unpacking and packing both work within 128-bit lanes, so pixel order is preserved.
+	{
+		__m256i opaque_source = _mm256_or_si256(source,_mm256_set1_epi32((int)0xFF000000));
+		__m256i zero = _mm256_setzero_si256();
+		__m256i low = BlendHalf(_mm256_unpacklo_epi8(destination,zero),_mm256_unpacklo_epi8(opaque_source,zero),_mm256_unpacklo_epi8(source,zero));
+		__m256i high = BlendHalf(_mm256_unpackhi_epi8(destination,zero),_mm256_unpackhi_epi8(opaque_source,zero),_mm256_unpackhi_epi8(source,zero));
+
+
+		return _mm256_packus_epi16(low,high);
+	}
+#endif
+
+	/* Row Operations */
+	void BlendRow(Color* destination,const Color* source,int count)
+	{
+		int x = 0;
+
+
+#if defined(GRAPHICS_AVX2)
+		for(;x + 8 <= count;x += 8)
+		{
+			__m256i pixels = _mm256_loadu_si256((const __m256i*)(destination + x));
+
+
+			_mm256_storeu_si256((__m256i*)(destination + x),BlendPixels(pixels,_mm256_loadu_si256((const __m256i*)(source + x))));
+		}
+#endif
+#if defined(GRAPHICS_SSE2)
+		for(;x + 4 <= count;x += 4)
+		{
+			__m128i pixels = _mm_loadu_si128((const __m128i*)(destination + x));
+
+
+			_mm_storeu_si128((__m128i*)(destination + x),BlendPixels(pixels,_mm_loadu_si128((const __m128i*)(source + x))));
+		}
+#endif
+		for(;x < count;++x)
+		{
+			destination[x] = BlendPixel(destination[x],source[x]);
+		}
+	}
+
+	void BlendSolidRow(Color* destination,int count,Color color)
+	{
+		int x = 0;
+
+
+#if defined(GRAPHICS_AVX2)
+		__m256i color8 = _mm256_set1_epi32((int)color);
+
+
+		for(;x + 8 <= count;x += 8)
+		{
+			_mm256_storeu_si256((__m256i*)(destination + x),BlendPixels(_mm256_loadu_si256((const __m256i*)(destination + x)),color8));
+		}
+#endif
+#if defined(GRAPHICS_SSE2)
+		__m128i color4 = _mm_set1_epi32((int)color);
+
+
+		for(;x + 4 <= count;x += 4)
+		{
+			_mm_storeu_si128((__m128i*)(destination + x),BlendPixels(_mm_loadu_si128((const __m128i*)(destination + x)),color4));
+		}
+#endif
+		for(;x < count;++x)
+		{
+			destination[x] = BlendPixel(destination[x],color);
+		}
+	}
+
+	void FillRow(Color* destination,int count,Color color)
+	{
+		int x = 0;
+
+
+#if defined(GRAPHICS_AVX2)
+		__m256i color8 = _mm256_set1_epi32((int)color);
+
+
+		for(;x + 8 <= count;x += 8)
+		{
+			_mm256_storeu_si256((__m256i*)(destination + x),color8);
+		}
+#endif
+#if defined(GRAPHICS_SSE2)
+		__m128i color4 = _mm_set1_epi32((int)color);
+
+
+		for(;x + 4 <= count;x += 4)
+		{
+			_mm_storeu_si128((__m128i*)(destination + x),color4);
+		}
+#endif
+		for(;x < count;++x)
+		{
+			destination[x] = color;
+		}
+	}
+
+	/* Draws the mask bits [column,column + count) of a row onto the destination. */
+	void MaskRow(Color* destination,const std::uint8_t* mask,int column,int count,Color color)
+	{
+		int end = column + count;
+
+
+		for(;column < end && (column & 7) != 0;++column,++destination)  //Reach a whole byte of the mask.
+		{
+			if(IsMaskBitSet(mask,column))
+			{
+				*destination = BlendPixel(*destination,color);
+			}
+		}
+
+#if defined(GRAPHICS_SSE2)
+		{
+#if defined(GRAPHICS_AVX2)
+			__m256i color8 = _mm256_set1_epi32((int)color);
+			__m256i bits = _mm256_setr_epi32(0x80,0x40,0x20,0x10,0x08,0x04,0x02,0x01);
+#else
+			__m128i color4 = _mm_set1_epi32((int)color);
+			__m128i high_bits = _mm_setr_epi32(0x80,0x40,0x20,0x10);
+			__m128i low_bits = _mm_setr_epi32(0x08,0x04,0x02,0x01);
+#endif
+
+
+			for(;column + 8 <= end;column += 8,destination += 8)
+			{
+				std::uint8_t byte = mask[column >> 3];
+
+
+				if(byte == 0)
+				{
+					continue;
+				}
+
+#if defined(GRAPHICS_AVX2)
+				__m256i lanes = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(byte),bits),bits);
+				__m256i pixels = _mm256_loadu_si256((const __m256i*)destination);
+
+
+				pixels = _mm256_or_si256(_mm256_and_si256(lanes,BlendPixels(pixels,color8)),_mm256_andnot_si256(lanes,pixels));
+				_mm256_storeu_si256((__m256i*)destination,pixels);
+#else
+				__m128i byte4 = _mm_set1_epi32(byte);
+				__m128i pixels_high = _mm_loadu_si128((const __m128i*)destination);
+				__m128i pixels_low = _mm_loadu_si128((const __m128i*)(destination + 4));
+
+
+				pixels_high = SelectPixels(_mm_cmpeq_epi32(_mm_and_si128(byte4,high_bits),high_bits),BlendPixels(pixels_high,color4),pixels_high);
+				pixels_low = SelectPixels(_mm_cmpeq_epi32(_mm_and_si128(byte4,low_bits),low_bits),BlendPixels(pixels_low,color4),pixels_low);
+				_mm_storeu_si128((__m128i*)destination,pixels_high);
+				_mm_storeu_si128((__m128i*)(destination + 4),pixels_low);
+#endif
+			}
+		}
+#endif
+
+		for(;column < end;++column,++destination)
+		{
+			if(IsMaskBitSet(mask,column))
+			{
+				*destination = BlendPixel(*destination,color);
+			}
+		}
+	}
+}
+
+namespace Graphics
+{
+	/* Function Definitions */
+	void BlendRectangle(Surface& surface,const Bounds& bounds,Color color)
+	{
+		Bounds clipped = bounds;
+
+
+		if((color >> 24) == 255)
+		{
+			FillRectangle(surface,bounds,color);
+
+			return;
+		}
+
+		if((color >> 24) == 0 || !surface.clip(clipped))
+		{
+			return;
+		}
+
+		for(int y = clipped.top;y < clipped.bottom;++y)
+		{
+			BlendSolidRow(surface.getRow(y) + clipped.left,clipped.right - clipped.left,color);
+		}
+	}
+
+	void BlendSurface(Surface& destination,const Surface& source,int x,int y)
+	{
+		Bounds clipped = {x,y,x + source.getWidth(),y + source.getHeight()};
+
+
+		if(!destination.clip(clipped))
+		{
+			return;
+		}
+
+		for(int row = clipped.top;row < clipped.bottom;++row)
+		{
+			BlendRow(destination.getRow(row) + clipped.left,source.getRow(row - y) + (clipped.left - x),clipped.right - clipped.left);
+		}
+	}
+
+	void CopySurface(Surface& destination,const Surface& source,int x,int y,const Bounds* clip)
+	{
+		Bounds clipped = {x,y,x + source.getWidth(),y + source.getHeight()};
+
+
+		if(clip != nullptr)
+		{
+			clipped.left = clipped.left > clip->left ? clipped.left : clip->left;
+			clipped.top = clipped.top > clip->top ? clipped.top : clip->top;
+			clipped.right = clipped.right < clip->right ? clipped.right : clip->right;
+			clipped.bottom = clipped.bottom < clip->bottom ? clipped.bottom : clip->bottom;
+		}
+		if(!destination.clip(clipped))
+		{
+			return;
+		}
+
+		for(int row = clipped.top;row < clipped.bottom;++row)
+		{
+			std::memcpy(destination.getRow(row) + clipped.left,source.getRow(row - y) + (clipped.left - x),(clipped.right - clipped.left) * sizeof(Color));
+		}
+	}
+
+	void DrawMask(Surface& surface,int x,int y,const std::uint8_t* mask,int width,int height,int stride,Color color)
+	{
+		assert(mask != nullptr);
+
+
+		Bounds clipped = {x,y,x + width,y + height};
+
+
+		if((color >> 24) == 0 || !surface.clip(clipped))
+		{
+			return;
+		}
+
+		for(int row = clipped.top;row < clipped.bottom;++row)
+		{
+			MaskRow(surface.getRow(row) + clipped.left,mask + (row - y) * stride,clipped.left - x,clipped.right - clipped.left,color);
+		}
+	}
+
+	void FillGradient(Surface& surface,const Bounds& bounds,Color from,Color to,bool vertical)
+	{
+		Bounds clipped = bounds;
+
+
+		if(!surface.clip(clipped))
+		{
+			return;
+		}
+
+		if(vertical)  //Every row is a single color.
+		{
+			for(int y = clipped.top;y < clipped.bottom;++y)
+			{
+				FillRow(surface.getRow(y) + clipped.left,clipped.right - clipped.left,Interpolate(from,to,y - bounds.top,bounds.bottom - bounds.top));
+			}
+		}
+		else  //Every row is the same, so compute the first and copy it.
+		{
+			Color* first_row = surface.getRow(clipped.top) + clipped.left;
+
+
+			for(int x = clipped.left;x < clipped.right;++x)
+			{
+				first_row[x - clipped.left] = Interpolate(from,to,x - bounds.left,bounds.right - bounds.left);
+			}
+
+			for(int y = clipped.top + 1;y < clipped.bottom;++y)
+			{
+				std::memcpy(surface.getRow(y) + clipped.left,first_row,(clipped.right - clipped.left) * sizeof(Color));
+			}
+		}
+	}
+
+	void FillRectangle(Surface& surface,const Bounds& bounds,Color color)
+	{
+		Bounds clipped = bounds;
+
+
+		if(!surface.clip(clipped))
+		{
+			return;
+		}
+
+		for(int y = clipped.top;y < clipped.bottom;++y)
+		{
+			FillRow(surface.getRow(y) + clipped.left,clipped.right - clipped.left,color);
+		}
+	}
+
+	const char* GetInstructionSet()
+	{
+#if defined(GRAPHICS_AVX2)
+		return "AVX2";
+#elif defined(GRAPHICS_SSE2)
+		return "SSE2";
+#else
+		return "Scalar";
+#endif
+	}
+
+	Color MakeColor(std::uint8_t red,std::uint8_t green,std::uint8_t blue,std::uint8_t alpha)
+	{
+		return ((Color)alpha << 24) | ((Color)red << 16) | ((Color)green << 8) | blue;
+	}
+
+	/* Reference Implementation */
+	void Reference::BlendRectangle(Surface& surface,const Bounds& bounds,Color color)
+	{
+		Bounds clipped = bounds;
+
+
+		if(!surface.clip(clipped))
+		{
+			return;
+		}
+
+		for(int y = clipped.top;y < clipped.bottom;++y)
+		{
+			for(int x = clipped.left;x < clipped.right;++x)
+			{
+				surface.setPixel(x,y,(color >> 24) == 0 ? surface.getPixel(x,y) : BlendPixel(surface.getPixel(x,y),color));
+			}
+		}
+	}
+
+	void Reference::BlendSurface(Surface& destination,const Surface& source,int x,int y)
+	{
+		for(int row = 0;row < source.getHeight();++row)
+		{
+			for(int column = 0;column < source.getWidth();++column)
+			{
+				if(x + column >= 0 && x + column < destination.getWidth() && y + row >= 0 && y + row < destination.getHeight())
+				{
+					destination.setPixel(x + column,y + row,BlendPixel(destination.getPixel(x + column,y + row),source.getPixel(column,row)));
+				}
+			}
+		}
+	}
+
+	void Reference::DrawMask(Surface& surface,int x,int y,const std::uint8_t* mask,int width,int height,int stride,Color color)
+	{
+		for(int row = 0;row < height;++row)
+		{
+			for(int column = 0;column < width;++column)
+			{
+				if(x + column >= 0 && x + column < surface.getWidth() && y + row >= 0 && y + row < surface.getHeight() && IsMaskBitSet(mask + row * stride,column) && (color >> 24) != 0)
+				{
+					surface.setPixel(x + column,y + row,BlendPixel(surface.getPixel(x + column,y + row),color));
+				}
+			}
+		}
+	}
+
+	void Reference::FillGradient(Surface& surface,const Bounds& bounds,Color from,Color to,bool vertical)
+	{
+		Bounds clipped = bounds;
+
+
+		if(!surface.clip(clipped))
+		{
+			return;
+		}
+
+		for(int y = clipped.top;y < clipped.bottom;++y)
+		{
+			for(int x = clipped.left;x < clipped.right;++x)
+			{
+				surface.setPixel(x,y,vertical ? Interpolate(from,to,y - bounds.top,bounds.bottom - bounds.top) : Interpolate(from,to,x - bounds.left,bounds.right - bounds.left));
+			}
+		}
+	}
+
+	void Reference::FillRectangle(Surface& surface,const Bounds& bounds,Color color)
+	{
+		Bounds clipped = bounds;
+
+
+		if(!surface.clip(clipped))
+		{
+			return;
+		}
+
+		for(int y = clipped.top;y < clipped.bottom;++y)
+		{
+			for(int x = clipped.left;x < clipped.right;++x)
+			{
+				surface.setPixel(x,y,color);
+			}
+		}
+	}
+
+	/* Type [Graphics::Surface] Definition */
+	Surface::Surface()
+	: Surface(0,0)
+	{
+	}
+
+	Surface::Surface(int width,int height)
+	{
+		this->height = 0;
+		this->stride = 0;
+		this->width = 0;
+
+		this->resize(width,height);
+	}
+
+	bool Surface::clip(Bounds& bounds) const
+	{
+		if(bounds.left < 0)
+		{
+			bounds.left = 0;
+		}
+		if(bounds.top < 0)
+		{
+			bounds.top = 0;
+		}
+		if(bounds.right > this->width)
+		{
+			bounds.right = this->width;
+		}
+		if(bounds.bottom > this->height)
+		{
+			bounds.bottom = this->height;
+		}
+
+		return bounds.left < bounds.right && bounds.top < bounds.bottom;
+	}
+
+	int Surface::getHeight() const
+	{
+		return this->height;
+	}
+
+	Color Surface::getPixel(int x,int y) const
+	{
+		assert(x >= 0 && x < this->width && y >= 0 && y < this->height);
+
+
+		return this->pixels[(size_t)y * this->stride + x];
+	}
+
+	Color* Surface::getRow(int y)
+	{
+		return this->pixels.data() + (size_t)y * this->stride;
+	}
+
+	const Color* Surface::getRow(int y) const
+	{
+		return this->pixels.data() + (size_t)y * this->stride;
+	}
+
+	int Surface::getStride() const
+	{
+		return this->stride;
+	}
+
+	int Surface::getWidth() const
+	{
+		return this->width;
+	}
+
+	void Surface::resize(int width,int height)
+	{
+		assert(width >= 0 && height >= 0);
+
+
+		size_t required;
+
+
+		this->width = width;
+		this->height = height;
+		this->stride = (width + 7) & ~7;
+
+		required = (size_t)this->stride * height;
+		if(required > this->pixels.size())
+		{
+			this->pixels.resize(required);
+		}
+	}
+
+	void Surface::setPixel(int x,int y,Color color)
+	{
+		assert(x >= 0 && x < this->width && y >= 0 && y < this->height);
+
+
+		this->pixels[(size_t)y * this->stride + x] = color;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#ifndef GRAPHICS_H
+#define GRAPHICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Graphics
+{
+	/* Types */
+	typedef std::uint32_t Color;  //Laid out in memory as blue, green, red, alpha (BGRA).
+
+	struct Bounds
+	{
+		int left;
+		int top;
+		int right;
+		int bottom;
+	};
+
+	class Surface;
+
+	/* Function Prototypes */
+	/**
+	 * Blends a solid color over an area of a surface using the color's alpha.
+	 */
+	void BlendRectangle(Surface& surface,const Bounds& bounds,Color color);
+
+	/**
+	 * Blends one surface over another, placing the source's top-left corner at (x,y) in the destination and using the source's per-pixel alpha.
+	 */
+	void BlendSurface(Surface& destination,const Surface& source,int x,int y);
+
+	/**
+	 * Copies one surface into another, placing the source's top-left corner at (x,y) in the destination.  Alpha is copied rather than blended.
+	 *
+	 * @param
+	 *   clip
+	 *     Area of the destination outside of which nothing is copied.  If nullptr, only the destination's own bounds apply.
+	 */
+	void CopySurface(Surface& destination,const Surface& source,int x,int y,const Bounds* clip = nullptr);
+
+	/**
+	 * Draws a 1-bit mask (such as a rasterized glyph run) in the given color.  Each row of the mask is stride bytes long, with the most significant bit of each byte being the left-most pixel.  Pixels whose bit is set are blended using the color's alpha; all other pixels are left untouched.
+	 */
+	void DrawMask(Surface& surface,int x,int y,const std::uint8_t* mask,int width,int height,int stride,Color color);
+
+	/**
+	 * Fills an area of a surface with a gradient running from one color to another, either from left to right or from top to bottom.
+	 */
+	void FillGradient(Surface& surface,const Bounds& bounds,Color from,Color to,bool vertical = false);
+
+	/**
+	 * Replaces every pixel in an area of a surface with the given color.
+	 */
+	void FillRectangle(Surface& surface,const Bounds& bounds,Color color);
+
+	/**
+	 * Gets the name of the instruction set the rasterizer was built to use ("AVX2", "SSE2" or "Scalar").
+	 */
+	const char* GetInstructionSet();
+
+	Color MakeColor(std::uint8_t red,std::uint8_t green,std::uint8_t blue,std::uint8_t alpha = 255);
+
+	/**
+	 * Straightforward per-pixel implementations of the rasterizer's operations.  The vectorized implementations must produce exactly the same pixels as these.
+	 */
+	namespace Reference
+	{
+		void BlendRectangle(Surface& surface,const Bounds& bounds,Color color);
+
+		void BlendSurface(Surface& destination,const Surface& source,int x,int y);
+
+		void DrawMask(Surface& surface,int x,int y,const std::uint8_t* mask,int width,int height,int stride,Color color);
+
+		void FillGradient(Surface& surface,const Bounds& bounds,Color from,Color to,bool vertical = false);
+
+		void FillRectangle(Surface& surface,const Bounds& bounds,Color color);
+	}
+
+	/* Class Prototypes */
+	/**
+	 * 32-bit BGRA pixel buffer.  Rows are padded to a multiple of 32 bytes.
+	 */
+	class Surface
+	{
+		private:
+			int height;
+			std::vector<Color> pixels;
+			int stride;  //In pixels.
+			int width;
+
+		public:
+			Surface();
+
+			Surface(int width,int height);
+
+			/**
+			 * Clips the given bounds to this surface.
+			 *
+			 * @return Returns false if nothing of the bounds lies within this surface.
+			 */
+			bool clip(Bounds& bounds) const;
+
+			int getHeight() const;
+
+			Color getPixel(int x,int y) const;
+
+			Color* getRow(int y);
+
+			const Color* getRow(int y) const;
+
+			int getStride() const;
+
+			int getWidth() const;
+
+			/**
+			 * Changes the dimensions of this surface.  Memory is only reallocated when the surface grows beyond its current capacity; the contents are undefined afterwards.
+			 */
+			void resize(int width,int height);
+
+			void setPixel(int x,int y,Color color);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#ifndef HEADLESS_COMMCTRL_H
+#define HEADLESS_COMMCTRL_H
+
+#include <Windows.h>
+
+
+void InitCommonControls();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,4257 @@
+#include "Headless.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <cwctype>
+#include <deque>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sys/stat.h>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <CommCtrl.h>
+
+
+namespace
+{
+	/* Types */
+	typedef std::chrono::steady_clock Clock;
+
+	struct ClassRecord
+	{
+		std::wstring name;  //As registered.
+		std::wstring key;  //Lowercase, as class names are compared without regard to case.
+		WNDCLASSEX data;
+		ATOM atom;
+		bool system;  //Registered by the system and found from any module, as "Button" is.
+		size_t windows;
+	};
+
+	struct ScrollBar
+	{
+		int minimum;
+		int maximum;
+		UINT page;
+		int position;
+		int track_position;
+	};
+
+	struct WindowRecord
+	{
+		HWND handle;
+		ClassRecord* window_class;
+		WNDPROC procedure;
+		DWORD style;
+		DWORD style_extended;
+		LONG_PTR id;
+		LONG_PTR user_data;
+		HINSTANCE instance;
+		DWORD thread;
+		std::wstring text;
+		std::vector<std::pair<ATOM,HANDLE>> properties;
+		WindowRecord* parent;  //The desktop, or the root of the message-only windows, for top-level windows.
+		WindowRecord* first_child;  //The top of the children's z-order.
+		WindowRecord* last_child;
+		WindowRecord* next;  //The sibling below this window.
+		WindowRecord* previous;
+		HWND owner;
+		std::set<HWND> owned;
+		RECT rectangle;  //Relative to the parent's client area.  Windows have no non-client area here, so this is the client area too.
+		RECT normal_rectangle;  //Restored to once the window is no longer minimized or maximized.
+		RECT update_rectangle;
+		bool invalid;
+		bool erase;
+		bool destroying;
+		ScrollBar scroll_bars[2];
+		BYTE alpha;
+		COLORREF color_key;
+		DWORD layered_flags;
+	};
+
+	struct ThreadQueue;
+
+	struct SentMessage  //Sent to a window of another thread, which handles it the next time it checks its queue.
+	{
+		MSG message;
+		LRESULT result;
+		bool done;
+		ThreadQueue* sender;
+	};
+
+	struct Timer
+	{
+		HWND window;
+		UINT_PTR id;
+		TIMERPROC procedure;
+		Clock::duration interval;
+		Clock::time_point due;
+	};
+
+	struct ThreadQueue
+	{
+		DWORD thread;
+		std::condition_variable signal;  //Notified whenever a message is posted or sent to the thread, or one it sent has been handled.
+		std::deque<MSG> posted;
+		std::deque<SentMessage*> sent;
+		std::set<HWND> invalid_windows;  //Ordered by handle, so that parents are painted before the children created after them.
+		std::vector<Timer> timers;
+		HWND focus;
+		bool quit;
+		int exit_code;
+	};
+
+	struct QueueOwner  //Releases a thread's queue as the thread exits.
+	{
+		ThreadQueue* queue;
+
+		~QueueOwner();
+	};
+
+	struct DeviceState
+	{
+		struct GdiObject* bitmap;
+		HGDIOBJ brush;
+		HGDIOBJ font;
+		POINT origin;  //Where the logical origin lies in the device's coordinates.
+		RECT clip;  //In the device's coordinates.
+		bool clipped;
+		int background_mode;
+		COLORREF text_color;
+	};
+
+	struct GdiObject
+	{
+		UINT type;  //OBJ_BITMAP, OBJ_BRUSH, OBJ_DC or OBJ_MEMDC.
+
+		/* Bitmaps */
+		int width;
+		int height;
+		bool bottom_up;
+		std::vector<std::uint32_t> pixels;  //As GDI stores them:  0x00RRGGBB.
+		GdiObject* selected_into;
+
+		/* Brushes */
+		COLORREF color;
+
+		/* Device contexts */
+		HWND window;
+		DeviceState state;
+		std::vector<DeviceState> saved_states;
+	};
+
+	struct Image
+	{
+		UINT type;
+		bool shared;
+	};
+
+	struct DeferredPositions
+	{
+		std::vector<WINDOWPOS> positions;
+	};
+
+	typedef std::tuple<HMODULE,std::wstring,std::wstring,WORD> ResourceKey;  //Module, type, name and language.
+
+	struct Resource
+	{
+		std::vector<BYTE> data;
+	};
+
+	/* Constants */
+	const UINT USER_TIMER_MINIMUM = 10;
+	const ATOM FIRST_ATOM = 0xC000;
+	const HMODULE EXECUTABLE_MODULE = (HMODULE)0x400000;
+	const HMONITOR PRIMARY_MONITOR = (HMONITOR)1;
+	const RECT SCREEN_RECTANGLE = {0,0,1920,1080};
+	const RECT WORK_AREA_RECTANGLE = {0,0,1920,1040};  //Less the taskbar.
+	const WCHAR* SYSTEM_CLASS_NAMES[] = {L"Button",L"ComboBox",L"Edit",L"ListBox",L"ScrollBar",L"Static"};
+
+	std::mutex state_mutex;  //Guards the windows, classes, atoms, queues and resources; never held while a window procedure is called.
+	std::unordered_map<HWND,WindowRecord*> windows;
+	std::vector<ClassRecord*> classes;
+	std::vector<std::wstring> atom_names;
+	std::unordered_map<std::wstring,ATOM> atoms_by_name;
+	std::unordered_map<DWORD,ThreadQueue*> queues;
+	std::map<ResourceKey,Resource> resources;
+	std::map<std::pair<HMODULE,UINT>,std::wstring> strings;
+	WindowRecord desktop;
+	WindowRecord message_root;
+	std::uintptr_t last_window_handle = 0x10000;
+	ATOM next_class_atom = FIRST_ATOM;
+	UINT_PTR last_thread_timer = 0;
+	bool system_classes_registered = false;
+
+	std::mutex gdi_mutex;  //Guards the GDI objects and images.
+	std::unordered_set<GdiObject*> gdi_objects;
+	std::unordered_set<Image*> images;
+	std::map<std::pair<UINT,std::wstring>,Image*> shared_images;
+	GdiObject stock_bitmap;  //Selected into every new memory device context, as the 1x1 monochrome bitmap is on Windows.
+
+	std::atomic<DWORD> last_thread_id(0);
+	thread_local DWORD thread_id = 0;
+	thread_local DWORD last_error = ERROR_SUCCESS;
+	thread_local QueueOwner queue_owner = {nullptr};
+	thread_local bool counting_calls = false;  //Set by Headless::ResetCallCounts.
+	thread_local std::unordered_map<const char*,size_t> call_counts;  //Keyed by the name of each function called, as __func__ gives it.
+
+
+	/* Function Definitions */
+	/* Helpers */
+	void CountCall(const char* function)
+	{
+		if(counting_calls)
+		{
+			++call_counts[function];
+		}
+	}
+
+	DWORD CurrentThreadId()
+	{
+		if(thread_id == 0)
+		{
+			thread_id = ++last_thread_id;
+		}
+
+		return thread_id;
+	}
+
+	std::wstring Lowercase(const WCHAR* text)
+	{
+		std::wstring lowercase(text);
+
+
+		for(WCHAR& character : lowercase)
+		{
+			character = std::towlower(character);
+		}
+
+		return lowercase;
+	}
+
+	std::wstring GetResourceKey(LPCWSTR name)  //Integer resources are keyed as "#<id>", as the resource compiler writes them; names are compared without regard to case.
+	{
+		if(IS_INTRESOURCE(name))
+		{
+			return std::wstring(L"#").append(std::to_wstring(LOWORD(name)));
+		}
+
+		return Lowercase(name);
+	}
+
+	std::string GetPath(LPCWSTR path)  //UTF-8, as POSIX file names are bytes.
+	{
+		std::string narrow_path;
+
+
+		for(;*path != 0;++path)
+		{
+			std::uint32_t code_point = (std::uint32_t)*path;
+
+
+			if(code_point < 0x80)
+			{
+				narrow_path.push_back((char)code_point);
+			}
+			else if(code_point < 0x800)
+			{
+				narrow_path.push_back((char)(0xC0 | (code_point >> 6)));
+				narrow_path.push_back((char)(0x80 | (code_point & 0x3F)));
+			}
+			else if(code_point < 0x10000)
+			{
+				narrow_path.push_back((char)(0xE0 | (code_point >> 12)));
+				narrow_path.push_back((char)(0x80 | ((code_point >> 6) & 0x3F)));
+				narrow_path.push_back((char)(0x80 | (code_point & 0x3F)));
+			}
+			else
+			{
+				narrow_path.push_back((char)(0xF0 | (code_point >> 18)));
+				narrow_path.push_back((char)(0x80 | ((code_point >> 12) & 0x3F)));
+				narrow_path.push_back((char)(0x80 | ((code_point >> 6) & 0x3F)));
+				narrow_path.push_back((char)(0x80 | (code_point & 0x3F)));
+			}
+		}
+
+		return narrow_path;
+	}
+
+	HMODULE GetModule(HMODULE module)  //A null module is the executable, as it is for GetModuleHandle(nullptr).
+	{
+		return module == nullptr ? EXECUTABLE_MODULE : module;
+	}
+
+	bool Intersect(RECT& destination,const RECT& first,const RECT& second)
+	{
+		destination.left = std::max(first.left,second.left);
+		destination.top = std::max(first.top,second.top);
+		destination.right = std::min(first.right,second.right);
+		destination.bottom = std::min(first.bottom,second.bottom);
+		if(destination.left >= destination.right || destination.top >= destination.bottom)
+		{
+			destination.left = destination.top = destination.right = destination.bottom = 0;
+
+			return false;
+		}
+
+		return true;
+	}
+
+	std::uint32_t GetPixelValue(COLORREF color)
+	{
+		return ((color & 0xFF) << 16) | (color & 0xFF00) | ((color >> 16) & 0xFF);
+	}
+
+	/* Atoms (the state's lock must be held) */
+	ATOM AddAtomLocked(LPCWSTR name)
+	{
+		std::wstring key;
+
+
+		if(IS_INTRESOURCE(name))
+		{
+			return LOWORD(name);
+		}
+
+		key = Lowercase(name);
+		auto known = atoms_by_name.find(key);
+
+
+		if(known != atoms_by_name.end())
+		{
+			return known->second;
+		}
+
+		atom_names.push_back(name);
+		atoms_by_name[key] = (ATOM)(FIRST_ATOM + atom_names.size() - 1);
+
+		return (ATOM)(FIRST_ATOM + atom_names.size() - 1);
+	}
+
+	ATOM FindAtomLocked(LPCWSTR name)
+	{
+		if(IS_INTRESOURCE(name))
+		{
+			return LOWORD(name);
+		}
+
+		auto known = atoms_by_name.find(Lowercase(name));
+
+
+		return known == atoms_by_name.end() ? 0 : known->second;
+	}
+
+	/* Window classes (the state's lock must be held) */
+	void RegisterSystemClasses()
+	{
+		if(system_classes_registered)
+		{
+			return;
+		}
+		system_classes_registered = true;
+
+		for(const WCHAR* name : SYSTEM_CLASS_NAMES)
+		{
+			ClassRecord* window_class = new ClassRecord();
+
+
+			window_class->name = name;
+			window_class->key = Lowercase(name);
+			window_class->data.cbSize = sizeof(WNDCLASSEX);
+			window_class->data.style = CS_PARENTDC;
+			window_class->data.lpfnWndProc = DefWindowProc;
+			window_class->data.hbrBackground = (HBRUSH)(COLOR_BTNFACE + 1);
+			window_class->data.lpszClassName = window_class->name.c_str();
+			window_class->atom = next_class_atom++;
+			window_class->system = true;
+			classes.push_back(window_class);
+		}
+	}
+
+	ClassRecord* FindClass(LPCWSTR name,HINSTANCE instance)  //A module's own classes take precedence over the system's.
+	{
+		ClassRecord* system_class = nullptr;
+		std::wstring key;
+
+
+		RegisterSystemClasses();
+		instance = GetModule(instance);
+		if(!IS_INTRESOURCE(name))
+		{
+			key = Lowercase(name);
+		}
+
+		for(ClassRecord* window_class : classes)
+		{
+			bool matches = IS_INTRESOURCE(name) ? window_class->atom == LOWORD(name) : window_class->key == key;
+
+
+			if(!matches)
+			{
+				continue;
+			}
+			if(window_class->system)
+			{
+				system_class = window_class;
+			}
+			else if(window_class->data.hInstance == instance)
+			{
+				return window_class;
+			}
+		}
+
+		return system_class;
+	}
+
+	/* Windows (the state's lock must be held) */
+	ThreadQueue* GetQueue()
+	{
+		if(queue_owner.queue == nullptr)
+		{
+			queue_owner.queue = new ThreadQueue();
+			queue_owner.queue->thread = CurrentThreadId();
+			queue_owner.queue->focus = nullptr;
+			queue_owner.queue->quit = false;
+			queue_owner.queue->exit_code = 0;
+			queues[queue_owner.queue->thread] = queue_owner.queue;
+		}
+
+		return queue_owner.queue;
+	}
+
+	ThreadQueue* GetQueue(DWORD thread)
+	{
+		auto queue = queues.find(thread);
+
+
+		return queue == queues.end() ? nullptr : queue->second;
+	}
+
+	WindowRecord* FindWindow(HWND window_handle)
+	{
+		auto window = windows.find(window_handle);
+
+
+		if(window == windows.end())
+		{
+			last_error = ERROR_INVALID_WINDOW_HANDLE;
+
+			return nullptr;
+		}
+
+		return window->second;
+	}
+
+	bool IsTopLevel(const WindowRecord* window)
+	{
+		return window->parent == &desktop || window->parent == &message_root;
+	}
+
+	bool IsVisible(const WindowRecord* window)  //Along with every ancestor.
+	{
+		for(;!IsTopLevel(window);window = window->parent)
+		{
+			if((window->style & WS_VISIBLE) == 0)
+			{
+				return false;
+			}
+		}
+
+		return (window->style & WS_VISIBLE) != 0;
+	}
+
+	bool IsDescendant(const WindowRecord* ancestor,const WindowRecord* window)
+	{
+		for(;window != nullptr;window = window->parent)
+		{
+			if(window->parent == ancestor)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	POINT GetScreenOrigin(const WindowRecord* window)  //Of the window's client area.
+	{
+		POINT origin = {0,0};
+
+
+		for(;window != nullptr && window != &desktop && window != &message_root;window = window->parent)
+		{
+			origin.x += window->rectangle.left;
+			origin.y += window->rectangle.top;
+		}
+
+		return origin;
+	}
+
+	RECT GetClientRectangle(const WindowRecord* window)
+	{
+		RECT rectangle = {0,0,window->rectangle.right - window->rectangle.left,window->rectangle.bottom - window->rectangle.top};
+
+
+		return rectangle;
+	}
+
+	void Link(WindowRecord* window,WindowRecord* parent,HWND insert_after)
+	{
+		WindowRecord* above = nullptr;  //The sibling which is to be above the window, if any.
+
+
+		window->parent = parent;
+		if(insert_after == HWND_BOTTOM)
+		{
+			above = parent->last_child;
+		}
+		else if(insert_after != HWND_TOP && insert_after != HWND_TOPMOST && insert_after != HWND_NOTOPMOST)
+		{
+			auto sibling = windows.find(insert_after);
+
+
+			if(sibling != windows.end() && sibling->second->parent == parent)
+			{
+				above = sibling->second;
+			}
+		}
+
+		window->previous = above;
+		window->next = above == nullptr ? parent->first_child : above->next;
+		(window->previous == nullptr ? parent->first_child : window->previous->next) = window;
+		(window->next == nullptr ? parent->last_child : window->next->previous) = window;
+	}
+
+	void Unlink(WindowRecord* window)
+	{
+		(window->previous == nullptr ? window->parent->first_child : window->previous->next) = window->next;
+		(window->next == nullptr ? window->parent->last_child : window->next->previous) = window->previous;
+		window->next = nullptr;
+		window->previous = nullptr;
+	}
+
+	void Invalidate(WindowRecord* window,const RECT* rectangle,bool erase,bool children)
+	{
+		RECT client = GetClientRectangle(window);
+		RECT update;
+
+
+		if(!IsVisible(window))
+		{
+			return;
+		}
+
+		if(rectangle == nullptr ? !Intersect(update,client,client) : !Intersect(update,client,*rectangle))
+		{
+			update.left = update.top = update.right = update.bottom = 0;
+		}
+		else if(!window->invalid)
+		{
+			window->update_rectangle = update;
+			window->invalid = true;
+			GetQueue(window->thread)->invalid_windows.insert(window->handle);
+		}
+		else
+		{
+			UnionRect(&window->update_rectangle,&window->update_rectangle,&update);
+		}
+		window->erase = window->erase || erase;
+
+		if(!children)
+		{
+			return;
+		}
+
+		for(WindowRecord* child = window->first_child;child != nullptr;child = child->next)
+		{
+			RECT child_rectangle = update;
+
+
+			if(rectangle == nullptr)
+			{
+				Invalidate(child,nullptr,erase,true);
+			}
+			else if(OffsetRect(&child_rectangle,-child->rectangle.left,-child->rectangle.top))
+			{
+				Invalidate(child,&child_rectangle,erase,true);
+			}
+		}
+	}
+
+	void Validate(WindowRecord* window,bool children)
+	{
+		if(window->invalid)
+		{
+			ThreadQueue* queue = GetQueue(window->thread);
+
+
+			if(queue != nullptr)
+			{
+				queue->invalid_windows.erase(window->handle);
+			}
+			window->invalid = false;
+			window->erase = false;
+			SetRectEmpty(&window->update_rectangle);
+		}
+
+		if(children)
+		{
+			for(WindowRecord* child = window->first_child;child != nullptr;child = child->next)
+			{
+				Validate(child,true);
+			}
+		}
+	}
+
+	void Remove(WindowRecord* window)  //Once the window has been sent WM_NCDESTROY.
+	{
+		ThreadQueue* queue = GetQueue(window->thread);
+		auto owner = windows.find(window->owner);
+
+
+		Validate(window,false);
+		if(queue != nullptr)
+		{
+			if(queue->focus == window->handle)
+			{
+				queue->focus = nullptr;
+			}
+			queue->timers.erase(std::remove_if(queue->timers.begin(),queue->timers.end(),[window](const Timer& timer){
+				return timer.window == window->handle;
+			}),queue->timers.end());
+		}
+		if(owner != windows.end())
+		{
+			owner->second->owned.erase(window->handle);
+		}
+		while(window->first_child != nullptr)  //Children created while the window was being destroyed are orphaned.
+		{
+			WindowRecord* child = window->first_child;
+
+
+			Unlink(child);
+			Link(child,&desktop,HWND_BOTTOM);
+		}
+
+		Unlink(window);
+		--window->window_class->windows;
+		windows.erase(window->handle);
+		delete window;
+	}
+
+	/* Messages (the state's lock must be held) */
+	bool MatchesFilter(HWND message_window,UINT message,HWND window_handle,UINT first,UINT last)
+	{
+		if(first != 0 || last != 0)
+		{
+			if(message < first || message > last)
+			{
+				return false;
+			}
+		}
+
+		if(window_handle == nullptr)
+		{
+			return true;
+		}
+		if(window_handle == (HWND)-1)  //Only messages posted to the thread itself.
+		{
+			return message_window == nullptr;
+		}
+		if(message_window == window_handle)
+		{
+			return true;
+		}
+
+		auto ancestor = windows.find(window_handle);
+		auto window = windows.find(message_window);
+
+
+		return ancestor != windows.end() && window != windows.end() && IsDescendant(ancestor->second,window->second);
+	}
+
+	void ReceiveSentMessages(std::unique_lock<std::mutex>& lock,ThreadQueue* queue)
+	{
+		while(!queue->sent.empty())
+		{
+			SentMessage* sent = queue->sent.front();
+			WindowRecord* window = FindWindow(sent->message.hwnd);
+			WNDPROC procedure = window == nullptr ? nullptr : window->procedure;
+			LRESULT result = 0;
+
+
+			queue->sent.pop_front();
+
+			lock.unlock();
+			if(procedure != nullptr)
+			{
+				result = procedure(sent->message.hwnd,sent->message.message,sent->message.wParam,sent->message.lParam);
+			}
+			lock.lock();
+
+			sent->result = result;
+			sent->done = true;
+			sent->sender->signal.notify_all();
+		}
+	}
+
+	/**
+	 * Takes the next message the filter allows, in the order Windows retrieves them:  messages sent from other threads are handled first, then posted messages are returned, then WM_QUIT, then WM_PAINT for invalidated windows and finally WM_TIMER for timers which are due.
+	 */
+	bool RetrieveMessage(std::unique_lock<std::mutex>& lock,ThreadQueue* queue,MSG* message,HWND window_handle,UINT first,UINT last,bool remove)
+	{
+		Clock::time_point now;
+
+
+		ReceiveSentMessages(lock,queue);
+
+		for(auto posted = queue->posted.begin();posted != queue->posted.end();++posted)
+		{
+			if(MatchesFilter(posted->hwnd,posted->message,window_handle,first,last))
+			{
+				*message = *posted;
+				if(remove)
+				{
+					queue->posted.erase(posted);
+				}
+
+				return true;
+			}
+		}
+
+		if(queue->quit && (window_handle == nullptr || window_handle == (HWND)-1))
+		{
+			message->hwnd = nullptr;
+			message->message = WM_QUIT;
+			message->wParam = (WPARAM)queue->exit_code;
+			message->lParam = 0;
+			if(remove)
+			{
+				queue->quit = false;
+			}
+
+			return true;
+		}
+
+		for(auto invalid = queue->invalid_windows.begin();invalid != queue->invalid_windows.end();)
+		{
+			WindowRecord* window = FindWindow(*invalid);
+
+
+			if(window == nullptr || !IsVisible(window))  //Hidden windows are painted in full once they are shown again.
+			{
+				if(window != nullptr)
+				{
+					window->invalid = false;
+					window->erase = false;
+				}
+				invalid = queue->invalid_windows.erase(invalid);
+
+				continue;
+			}
+
+			if(MatchesFilter(window->handle,WM_PAINT,window_handle,first,last))
+			{
+				message->hwnd = window->handle;
+				message->message = WM_PAINT;
+				message->wParam = 0;
+				message->lParam = 0;
+
+				return true;  //Left in place until the window is validated.
+			}
+			++invalid;
+		}
+
+		now = Clock::now();
+		for(Timer& timer : queue->timers)
+		{
+			if(timer.due <= now && MatchesFilter(timer.window,WM_TIMER,window_handle,first,last))
+			{
+				message->hwnd = timer.window;
+				message->message = WM_TIMER;
+				message->wParam = timer.id;
+				message->lParam = (LPARAM)timer.procedure;
+				if(remove)
+				{
+					timer.due = now + timer.interval;  //A timer which fell behind is not made to catch up.
+				}
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/* Windows */
+	/**
+	 * Sends WM_PARENTNOTIFY for a child window being created or destroyed to its parent, and on to each ancestor for as long as the window notified is itself a child without WS_EX_NOPARENTNOTIFY.
+	 */
+	void NotifyParents(HWND window_handle,WORD event)
+	{
+		std::vector<HWND> parents;
+		WORD id = 0;
+
+
+		{
+			std::lock_guard<std::mutex> lock(state_mutex);
+			WindowRecord* window = FindWindow(window_handle);
+
+
+			if(window != nullptr)
+			{
+				id = (WORD)window->id;
+			}
+			for(;window != nullptr && !IsTopLevel(window) && (window->style_extended & WS_EX_NOPARENTNOTIFY) == 0;window = window->parent)
+			{
+				parents.push_back(window->parent->handle);
+			}
+		}
+
+		for(HWND parent_handle : parents)
+		{
+			SendMessage(parent_handle,WM_PARENTNOTIFY,MAKEWPARAM(event,id),(LPARAM)window_handle);
+		}
+	}
+
+	void DestroyTree(HWND window_handle)
+	{
+		std::vector<HWND> owned;
+		std::vector<HWND> children;
+
+
+		{
+			std::lock_guard<std::mutex> lock(state_mutex);
+			WindowRecord* window = FindWindow(window_handle);
+
+
+			if(window == nullptr)
+			{
+				return;
+			}
+			window->destroying = true;
+			owned.assign(window->owned.begin(),window->owned.end());
+		}
+
+		for(HWND owned_handle : owned)  //Owned windows go before their owner.
+		{
+			DestroyTree(owned_handle);
+		}
+
+		NotifyParents(window_handle,WM_DESTROY);
+		SendMessage(window_handle,WM_DESTROY,0,0);  //The parent is told first, then its children, whose windows are gone before the parent's WM_NCDESTROY.
+
+		{
+			std::lock_guard<std::mutex> lock(state_mutex);
+			WindowRecord* window = FindWindow(window_handle);
+
+
+			if(window == nullptr)
+			{
+				return;
+			}
+			for(WindowRecord* child = window->first_child;child != nullptr;child = child->next)
+			{
+				child->destroying = true;
+				children.push_back(child->handle);
+			}
+		}
+
+		for(HWND child : children)
+		{
+			DestroyTree(child);
+		}
+
+		SendMessage(window_handle,WM_NCDESTROY,0,0);
+
+		{
+			std::lock_guard<std::mutex> lock(state_mutex);
+			WindowRecord* window = FindWindow(window_handle);
+
+
+			if(window != nullptr)
+			{
+				Remove(window);
+			}
+		}
+	}
+
+	void CollectDescendants(const WindowRecord* window,std::vector<HWND>& descendants)
+	{
+		for(const WindowRecord* child = window->first_child;child != nullptr;child = child->next)
+		{
+			descendants.push_back(child->handle);
+			CollectDescendants(child,descendants);
+		}
+	}
+
+	/* GDI (the GDI lock must be held) */
+	GdiObject* FindObject(HGDIOBJ object,UINT type)
+	{
+		auto found = gdi_objects.find((GdiObject*)object);
+
+
+		if(found == gdi_objects.end() || (*found)->type != type)
+		{
+			return nullptr;
+		}
+
+		return *found;
+	}
+
+	GdiObject* FindDeviceContext(HDC device_context)
+	{
+		GdiObject* found = FindObject(device_context,OBJ_MEMDC);
+
+
+		return found != nullptr ? found : FindObject(device_context,OBJ_DC);
+	}
+
+	GdiObject* CreateDeviceContext(UINT type,HWND window_handle)
+	{
+		GdiObject* device_context = new GdiObject();
+
+
+		if(stock_bitmap.type == 0)
+		{
+			stock_bitmap.type = OBJ_BITMAP;
+			stock_bitmap.width = 1;
+			stock_bitmap.height = 1;
+			stock_bitmap.pixels.assign(1,0);
+		}
+
+		device_context->type = type;
+		device_context->window = window_handle;
+		device_context->state.bitmap = type == OBJ_MEMDC ? &stock_bitmap : nullptr;
+		device_context->state.background_mode = OPAQUE;
+		gdi_objects.insert(device_context);
+
+		return device_context;
+	}
+
+	void DeleteDeviceContext(GdiObject* device_context)
+	{
+		if(device_context->state.bitmap != nullptr)
+		{
+			device_context->state.bitmap->selected_into = nullptr;
+		}
+		gdi_objects.erase(device_context);
+		delete device_context;
+	}
+
+	bool GetBrushColor(HBRUSH brush,COLORREF& color)
+	{
+		GdiObject* solid = FindObject(brush,OBJ_BRUSH);
+
+
+		if(solid != nullptr)
+		{
+			color = solid->color;
+
+			return true;
+		}
+		if((ULONG_PTR)brush > 0 && (ULONG_PTR)brush <= 31)  //(HBRUSH)(COLOR_* + 1) stands for the system's color.
+		{
+			color = GetSysColor((int)(ULONG_PTR)brush - 1);
+
+			return true;
+		}
+
+		return false;
+	}
+
+	std::uint32_t* GetRow(GdiObject* bitmap,int y)
+	{
+		return &bitmap->pixels[(size_t)(bitmap->bottom_up ? bitmap->height - 1 - y : y) * bitmap->width];
+	}
+
+	/**
+	 * Converts a rectangle in a device context's logical coordinates to the part of its bitmap which may be drawn to.
+	 *
+	 * @return Returns false if nothing may be drawn, as is always the case for the device context of a window.
+	 */
+	bool GetDrawableBounds(const GdiObject* device_context,const RECT& rectangle,RECT& bounds)
+	{
+		const DeviceState& state = device_context->state;
+		RECT bitmap_bounds;
+		RECT device_rectangle = rectangle;
+
+
+		if(state.bitmap == nullptr)
+		{
+			return false;
+		}
+
+		SetRect(&bitmap_bounds,0,0,state.bitmap->width,state.bitmap->height);
+		OffsetRect(&device_rectangle,state.origin.x,state.origin.y);
+		if(!Intersect(bounds,device_rectangle,bitmap_bounds))
+		{
+			return false;
+		}
+
+		return !state.clipped || Intersect(bounds,bounds,state.clip);
+	}
+}
+
+QueueOwner::~QueueOwner()
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+
+
+	if(this->queue == nullptr)
+	{
+		return;
+	}
+
+	for(SentMessage* sent : this->queue->sent)  //Nobody is left to handle them.
+	{
+		sent->done = true;
+		sent->sender->signal.notify_all();
+	}
+	queues.erase(this->queue->thread);
+	delete this->queue;
+	this->queue = nullptr;
+}
+
+namespace Headless
+{
+	/* Function Definitions */
+	void AddResource(HMODULE module,LPCWSTR type,WORD resource_id,const void* data,size_t size,WORD language)
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		Resource& resource = resources[ResourceKey(GetModule(module),GetResourceKey(type),GetResourceKey(MAKEINTRESOURCE(resource_id)),language)];
+
+
+		resource.data.assign((const BYTE*)data,(const BYTE*)data + size);
+	}
+
+	void AddStringResource(HMODULE module,UINT string_id,const std::wstring& text)
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+
+
+		strings[std::make_pair(GetModule(module),string_id)] = text;
+	}
+
+	size_t GetCallCount(const char* function)
+	{
+		for(const auto& call_count : call_counts)
+		{
+			if(std::strcmp(call_count.first,function) == 0)
+			{
+				return call_count.second;
+			}
+		}
+
+		return 0;
+	}
+
+	size_t GetWindowCount()
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+
+
+		return windows.size();
+	}
+
+	size_t PumpMessages()
+	{
+		MSG message;
+		size_t dispatched = 0;
+
+
+		while(PeekMessage(&message,nullptr,0,0,PM_REMOVE))
+		{
+			if(message.message == WM_QUIT)  //Left for the message loop to see.
+			{
+				PostQuitMessage((int)message.wParam);
+
+				break;
+			}
+
+			TranslateMessage(&message);
+			DispatchMessage(&message);
+			++dispatched;
+		}
+
+		return dispatched;
+	}
+
+	void ResetCallCounts()
+	{
+		counting_calls = true;
+		call_counts.clear();
+	}
+}
+
+/* Windows */
+HWND ChildWindowFromPointEx(HWND parent_handle,POINT point,UINT flags)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* parent = FindWindow(parent_handle);
+
+
+	CountCall(__func__);
+	if(parent == nullptr || point.x < 0 || point.y < 0 || point.x >= parent->rectangle.right - parent->rectangle.left || point.y >= parent->rectangle.bottom - parent->rectangle.top)
+	{
+		return nullptr;
+	}
+
+	for(WindowRecord* child = parent->first_child;child != nullptr;child = child->next)  //Top-most first.
+	{
+		if(!PtInRect(&child->rectangle,point))
+		{
+			continue;
+		}
+		if((flags & CWP_SKIPINVISIBLE) != 0 && (child->style & WS_VISIBLE) == 0)
+		{
+			continue;
+		}
+		if((flags & CWP_SKIPDISABLED) != 0 && (child->style & WS_DISABLED) != 0)
+		{
+			continue;
+		}
+		if((flags & CWP_SKIPTRANSPARENT) != 0 && (child->style_extended & WS_EX_TRANSPARENT) != 0)
+		{
+			continue;
+		}
+
+		return child->handle;
+	}
+
+	return parent_handle;  //A point inside the parent but over none of its children is over the parent.
+}
+
+HWND CreateWindowEx(DWORD style_extended,LPCWSTR class_name,LPCWSTR window_name,DWORD style,int x,int y,int width,int height,HWND parent_handle,HMENU menu,HINSTANCE instance,LPVOID parameter)
+{
+	CREATESTRUCT creation;
+	HWND window_handle;
+
+
+	CountCall(__func__);
+	width = std::max(width,0);
+	height = std::max(height,0);
+
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		ClassRecord* window_class = FindClass(class_name,instance);
+		WindowRecord* parent = &desktop;
+		WindowRecord* window;
+		HWND owner = nullptr;
+
+
+		if(window_class == nullptr)
+		{
+			last_error = ERROR_CLASS_DOES_NOT_EXIST;
+
+			return nullptr;
+		}
+
+		if(parent_handle == HWND_MESSAGE)
+		{
+			parent = &message_root;
+		}
+		else if(parent_handle != nullptr)
+		{
+			WindowRecord* given = FindWindow(parent_handle);
+
+
+			if(given == nullptr)
+			{
+				return nullptr;
+			}
+			if((style & WS_CHILD) != 0)
+			{
+				parent = given;
+			}
+			else  //A top-level window is owned by the top-level window it is given, rather than being its child.
+			{
+				while(!IsTopLevel(given))
+				{
+					given = given->parent;
+				}
+				owner = given->handle;
+				given->owned.insert((HWND)(last_window_handle + 4));
+			}
+		}
+		else if((style & WS_CHILD) != 0)
+		{
+			last_error = ERROR_TLW_WITH_WSCHILD;
+
+			return nullptr;
+		}
+
+		window = new WindowRecord();
+		last_window_handle += 4;
+		window->handle = (HWND)last_window_handle;
+		window->window_class = window_class;
+		window->procedure = window_class->data.lpfnWndProc;
+		window->style = (style & ~WS_VISIBLE) | WS_CLIPSIBLINGS * ((style & WS_CHILD) == 0);  //Shown once created, as on Windows; top-level windows always clip their siblings.
+		window->style_extended = style_extended;
+		window->id = (LONG_PTR)menu;
+		window->instance = instance;
+		window->thread = CurrentThreadId();
+		window->text = window_name != nullptr ? window_name : L"";
+		window->owner = owner;
+		SetRect(&window->rectangle,x,y,x + width,y + height);
+		window->normal_rectangle = window->rectangle;
+		window->alpha = 255;
+		Link(window,parent,HWND_TOP);
+		windows[window->handle] = window;
+		++window_class->windows;
+		GetQueue();
+
+		window_handle = window->handle;
+	}
+
+	creation.lpCreateParams = parameter;
+	creation.hInstance = instance;
+	creation.hMenu = menu;
+	creation.hwndParent = parent_handle;
+	creation.cy = height;
+	creation.cx = width;
+	creation.y = y;
+	creation.x = x;
+	creation.style = (LONG)style;
+	creation.lpszName = window_name;
+	creation.lpszClass = class_name;
+	creation.dwExStyle = style_extended;
+
+	if(!SendMessage(window_handle,WM_NCCREATE,0,(LPARAM)&creation) || SendMessage(window_handle,WM_CREATE,0,(LPARAM)&creation) == -1)
+	{
+		DestroyWindow(window_handle);
+
+		return nullptr;
+	}
+	if(!IsWindow(window_handle))  //Destroyed by one of its own handlers.
+	{
+		return nullptr;
+	}
+
+	SendMessage(window_handle,WM_SIZE,0,MAKELPARAM(width,height));
+	SendMessage(window_handle,WM_MOVE,0,MAKELPARAM(x,y));
+	NotifyParents(window_handle,WM_CREATE);
+	if(!IsWindow(window_handle))
+	{
+		return nullptr;
+	}
+	if((style & WS_VISIBLE) != 0)
+	{
+		ShowWindow(window_handle,SW_SHOW);
+	}
+
+	return window_handle;
+}
+
+BOOL DestroyWindow(HWND window_handle)
+{
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+		if(window->thread != CurrentThreadId())  //Only the thread which created a window may destroy it.
+		{
+			last_error = ERROR_ACCESS_DENIED;
+
+			return FALSE;
+		}
+		if(window->destroying)
+		{
+			return TRUE;
+		}
+	}
+
+	DestroyTree(window_handle);
+
+	return TRUE;
+}
+
+BOOL EnableWindow(HWND window_handle,BOOL enable)
+{
+	BOOL was_disabled;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+		was_disabled = (window->style & WS_DISABLED) != 0;
+		if(was_disabled == !enable)
+		{
+			return was_disabled;
+		}
+		window->style ^= WS_DISABLED;
+	}
+
+	SendMessage(window_handle,WM_ENABLE,enable,0);
+
+	return was_disabled;
+}
+
+BOOL EnumChildWindows(HWND parent_handle,WNDENUMPROC callback,LPARAM parameter)
+{
+	std::vector<HWND> descendants;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* parent = parent_handle == nullptr ? &desktop : FindWindow(parent_handle);
+
+
+		if(parent == nullptr)
+		{
+			return FALSE;
+		}
+		CollectDescendants(parent,descendants);
+	}
+
+	for(HWND window_handle : descendants)
+	{
+		if(IsWindow(window_handle) && !callback(window_handle,parameter))
+		{
+			break;
+		}
+	}
+
+	return TRUE;
+}
+
+BOOL EnumThreadWindows(DWORD thread_id,WNDENUMPROC callback,LPARAM parameter)
+{
+	std::vector<HWND> top_level_windows;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+
+
+		for(WindowRecord* window = desktop.first_child;window != nullptr;window = window->next)
+		{
+			if(window->thread == thread_id)
+			{
+				top_level_windows.push_back(window->handle);
+			}
+		}
+	}
+
+	for(HWND window_handle : top_level_windows)
+	{
+		if(IsWindow(window_handle) && !callback(window_handle,parameter))
+		{
+			return FALSE;
+		}
+	}
+
+	return !top_level_windows.empty();
+}
+
+HWND GetAncestor(HWND window_handle,UINT flags)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	if(window == nullptr || flags != GA_PARENT || IsTopLevel(window))  //The desktop and the root of the message-only windows have no handles here.
+	{
+		return nullptr;
+	}
+
+	return window->parent->handle;
+}
+
+BOOL GetClientRect(HWND window_handle,LPRECT rectangle)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return FALSE;
+	}
+	*rectangle = GetClientRectangle(window);
+
+	return TRUE;
+}
+
+HWND GetFocus()
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+
+
+	CountCall(__func__);
+	return GetQueue()->focus;
+}
+
+BOOL GetLayeredWindowAttributes(HWND window_handle,COLORREF* key,BYTE* alpha,DWORD* flags)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	if(window == nullptr || (window->style_extended & WS_EX_LAYERED) == 0 || window->layered_flags == 0)  //Fails until the attributes have been set.
+	{
+		return FALSE;
+	}
+
+	if(key != nullptr)
+	{
+		*key = window->color_key;
+	}
+	if(alpha != nullptr)
+	{
+		*alpha = window->alpha;
+	}
+	if(flags != nullptr)
+	{
+		*flags = window->layered_flags;
+	}
+
+	return TRUE;
+}
+
+HWND GetParent(HWND window_handle)  //The parent of a child window, but the owner of a top-level one.
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return nullptr;
+	}
+
+	return IsTopLevel(window) ? window->owner : window->parent->handle;
+}
+
+BOOL GetScrollInfo(HWND window_handle,int bar,SCROLLINFO* information)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	const ScrollBar* scroll_bar;
+
+
+	CountCall(__func__);
+	if(window == nullptr || (bar != SB_HORZ && bar != SB_VERT))
+	{
+		return FALSE;
+	}
+
+	scroll_bar = &window->scroll_bars[bar];
+	if((information->fMask & SIF_RANGE) != 0)
+	{
+		information->nMin = scroll_bar->minimum;
+		information->nMax = scroll_bar->maximum;
+	}
+	if((information->fMask & SIF_PAGE) != 0)
+	{
+		information->nPage = scroll_bar->page;
+	}
+	if((information->fMask & SIF_POS) != 0)
+	{
+		information->nPos = scroll_bar->position;
+	}
+	if((information->fMask & SIF_TRACKPOS) != 0)
+	{
+		information->nTrackPos = scroll_bar->track_position;
+	}
+
+	return TRUE;
+}
+
+BOOL GetUpdateRect(HWND window_handle,LPRECT rectangle,BOOL erase)
+{
+	bool invalid;
+	bool erase_pending;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+
+		invalid = window->invalid;
+		erase_pending = window->erase;
+		if(rectangle != nullptr)
+		{
+			*rectangle = window->update_rectangle;
+		}
+	}
+
+	if(invalid && erase && erase_pending)
+	{
+		HDC device_context = GetDC(window_handle);
+
+
+		if(SendMessage(window_handle,WM_ERASEBKGND,(WPARAM)device_context,0) != 0)
+		{
+			std::lock_guard<std::mutex> lock(state_mutex);
+			WindowRecord* window = FindWindow(window_handle);
+
+
+			if(window != nullptr)
+			{
+				window->erase = false;
+			}
+		}
+		ReleaseDC(window_handle,device_context);
+	}
+
+	return invalid;
+}
+
+HWND GetWindow(HWND window_handle,UINT relationship)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	WindowRecord* related = nullptr;
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return nullptr;
+	}
+
+	switch(relationship)
+	{
+		case GW_HWNDFIRST:
+			related = window->parent->first_child;
+
+			break;
+
+		case GW_HWNDLAST:
+			related = window->parent->last_child;
+
+			break;
+
+		case GW_HWNDNEXT:
+			related = window->next;
+
+			break;
+
+		case GW_HWNDPREV:
+			related = window->previous;
+
+			break;
+
+		case GW_OWNER:
+			return window->owner;
+
+		case GW_CHILD:
+			related = window->first_child;
+
+			break;
+	}
+
+	return related == nullptr ? nullptr : related->handle;
+}
+
+LONG_PTR GetWindowLongPtr(HWND window_handle,int index)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return 0;
+	}
+
+	switch(index)
+	{
+		case GWLP_WNDPROC:
+			return (LONG_PTR)window->procedure;
+
+		case GWLP_HINSTANCE:
+			return (LONG_PTR)window->instance;
+
+		case GWLP_HWNDPARENT:
+			return (LONG_PTR)(IsTopLevel(window) ? window->owner : window->parent->handle);
+
+		case GWLP_ID:
+			return window->id;
+
+		case GWL_STYLE:
+			return (LONG_PTR)window->style;
+
+		case GWL_EXSTYLE:
+			return (LONG_PTR)window->style_extended;
+
+		case GWLP_USERDATA:
+			return window->user_data;
+	}
+
+	return 0;
+}
+
+BOOL GetWindowPlacement(HWND window_handle,WINDOWPLACEMENT* placement)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return FALSE;
+	}
+
+	placement->flags = 0;
+	if((window->style & WS_MINIMIZE) != 0)
+	{
+		placement->showCmd = SW_SHOWMINIMIZED;
+	}
+	else if((window->style & WS_MAXIMIZE) != 0)
+	{
+		placement->showCmd = SW_SHOWMAXIMIZED;
+	}
+	else
+	{
+		placement->showCmd = SW_SHOWNORMAL;
+	}
+	placement->ptMinPosition.x = placement->ptMinPosition.y = -1;
+	placement->ptMaxPosition.x = placement->ptMaxPosition.y = -1;
+	placement->rcNormalPosition = (window->style & (WS_MINIMIZE | WS_MAXIMIZE)) != 0 ? window->normal_rectangle : window->rectangle;
+
+	return TRUE;
+}
+
+BOOL GetWindowRect(HWND window_handle,LPRECT rectangle)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	POINT origin;
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return FALSE;
+	}
+
+	origin = GetScreenOrigin(window);
+	SetRect(rectangle,origin.x,origin.y,origin.x + window->rectangle.right - window->rectangle.left,origin.y + window->rectangle.bottom - window->rectangle.top);
+
+	return TRUE;
+}
+
+int GetWindowText(HWND window_handle,LPWSTR text,int capacity)
+{
+	CountCall(__func__);
+	return (int)SendMessage(window_handle,WM_GETTEXT,(WPARAM)capacity,(LPARAM)text);
+}
+
+int GetWindowTextLength(HWND window_handle)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	return window == nullptr ? 0 : (int)window->text.length();
+}
+
+DWORD GetWindowThreadProcessId(HWND window_handle,LPDWORD process_id)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return 0;
+	}
+
+	if(process_id != nullptr)
+	{
+		*process_id = GetCurrentProcessId();
+	}
+
+	return window->thread;
+}
+
+BOOL InvalidateRect(HWND window_handle,const RECT* rectangle,BOOL erase)
+{
+	CountCall(__func__);
+	return RedrawWindow(window_handle,rectangle,nullptr,RDW_INVALIDATE | (erase ? (UINT)RDW_ERASE : 0));
+}
+
+BOOL IsIconic(HWND window_handle)
+{
+	CountCall(__func__);
+	return (GetWindowLongPtr(window_handle,GWL_STYLE) & WS_MINIMIZE) != 0;
+}
+
+BOOL IsWindow(HWND window_handle)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+
+
+	CountCall(__func__);
+	return windows.count(window_handle) != 0;
+}
+
+BOOL IsWindowEnabled(HWND window_handle)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	return window != nullptr && (window->style & WS_DISABLED) == 0;
+}
+
+BOOL IsWindowVisible(HWND window_handle)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	return window != nullptr && IsVisible(window);
+}
+
+BOOL IsZoomed(HWND window_handle)
+{
+	CountCall(__func__);
+	return (GetWindowLongPtr(window_handle,GWL_STYLE) & WS_MAXIMIZE) != 0;
+}
+
+int MapWindowPoints(HWND from,HWND to,POINT* points,UINT count)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* from_window = from == nullptr ? &desktop : FindWindow(from);
+	WindowRecord* to_window = to == nullptr ? &desktop : FindWindow(to);
+	POINT from_origin;
+	POINT to_origin;
+	int x;
+	int y;
+
+
+	CountCall(__func__);
+	if(from_window == nullptr || to_window == nullptr)
+	{
+		return 0;
+	}
+
+	from_origin = GetScreenOrigin(from_window);
+	to_origin = GetScreenOrigin(to_window);
+	x = from_origin.x - to_origin.x;
+	y = from_origin.y - to_origin.y;
+	for(UINT point = 0;point < count;++point)
+	{
+		points[point].x += x;
+		points[point].y += y;
+	}
+	last_error = ERROR_SUCCESS;  //A result of zero is otherwise taken as a failure.
+
+	return (int)(WORD)x | (int)((DWORD)(WORD)y << 16);
+}
+
+BOOL MoveWindow(HWND window_handle,int x,int y,int width,int height,BOOL repaint)
+{
+	CountCall(__func__);
+	return SetWindowPos(window_handle,nullptr,x,y,width,height,SWP_NOZORDER | SWP_NOACTIVATE | (repaint ? 0 : (UINT)SWP_NOREDRAW));
+}
+
+BOOL RedrawWindow(HWND window_handle,const RECT* rectangle,HRGN region,UINT flags)
+{
+	std::vector<HWND> painted;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window;
+
+
+		if(window_handle == nullptr)  //The desktop, which draws nothing here.
+		{
+			return TRUE;
+		}
+		window = FindWindow(window_handle);
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+
+		if((flags & RDW_INVALIDATE) != 0)
+		{
+			Invalidate(window,rectangle,(flags & RDW_ERASE) != 0,(flags & RDW_ALLCHILDREN) != 0);
+		}
+		else if((flags & RDW_VALIDATE) != 0)
+		{
+			Validate(window,(flags & RDW_ALLCHILDREN) != 0);
+		}
+
+		if((flags & RDW_UPDATENOW) != 0)
+		{
+			painted.push_back(window_handle);
+			if((flags & RDW_ALLCHILDREN) != 0)
+			{
+				CollectDescendants(window,painted);
+			}
+		}
+	}
+
+	for(HWND painted_handle : painted)
+	{
+		UpdateWindow(painted_handle);
+	}
+
+	return TRUE;
+}
+
+BOOL ScreenToClient(HWND window_handle,POINT* point)
+{
+	CountCall(__func__);
+	return MapWindowPoints(nullptr,window_handle,point,1) != 0 || GetLastError() == ERROR_SUCCESS;
+}
+
+HWND SetFocus(HWND window_handle)
+{
+	HWND previous;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		ThreadQueue* queue = GetQueue();
+
+
+		if(window_handle != nullptr && FindWindow(window_handle) == nullptr)
+		{
+			return nullptr;
+		}
+		previous = queue->focus;
+		if(previous == window_handle)
+		{
+			return previous;
+		}
+		queue->focus = window_handle;
+	}
+
+	if(previous != nullptr)
+	{
+		SendMessage(previous,WM_KILLFOCUS,(WPARAM)window_handle,0);
+	}
+	if(window_handle != nullptr)
+	{
+		SendMessage(window_handle,WM_SETFOCUS,(WPARAM)previous,0);
+	}
+
+	return previous;
+}
+
+BOOL SetLayeredWindowAttributes(HWND window_handle,COLORREF key,BYTE alpha,DWORD flags)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+
+
+	CountCall(__func__);
+	if(window == nullptr || (window->style_extended & WS_EX_LAYERED) == 0)
+	{
+		return FALSE;
+	}
+
+	window->color_key = key;
+	window->alpha = alpha;
+	window->layered_flags = flags;
+
+	return TRUE;
+}
+
+HWND SetParent(HWND window_handle,HWND parent_handle)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	WindowRecord* parent;
+	HWND previous;
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return nullptr;
+	}
+
+	if(parent_handle == nullptr)
+	{
+		parent = &desktop;
+	}
+	else if(parent_handle == HWND_MESSAGE)
+	{
+		parent = &message_root;
+	}
+	else
+	{
+		parent = FindWindow(parent_handle);
+		if(parent == nullptr || parent == window || IsDescendant(window,parent))
+		{
+			return nullptr;
+		}
+	}
+
+	previous = IsTopLevel(window) ? nullptr : window->parent->handle;
+	if(window->parent != parent)
+	{
+		bool was_visible = IsVisible(window);
+
+
+		Unlink(window);
+		Link(window,parent,HWND_TOP);
+		if(!was_visible && IsVisible(window))
+		{
+			Invalidate(window,nullptr,true,true);
+		}
+	}
+	last_error = ERROR_SUCCESS;
+
+	return previous;
+}
+
+int SetScrollInfo(HWND window_handle,int bar,const SCROLLINFO* information,BOOL redraw)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	ScrollBar* scroll_bar;
+	int maximum_position;
+
+
+	CountCall(__func__);
+	if(window == nullptr || (bar != SB_HORZ && bar != SB_VERT))
+	{
+		return 0;
+	}
+
+	scroll_bar = &window->scroll_bars[bar];
+	if((information->fMask & SIF_RANGE) != 0)
+	{
+		scroll_bar->minimum = information->nMin;
+		scroll_bar->maximum = information->nMax;
+	}
+	if((information->fMask & SIF_PAGE) != 0)
+	{
+		scroll_bar->page = information->nPage;
+	}
+	if((information->fMask & SIF_POS) != 0)
+	{
+		scroll_bar->position = information->nPos;
+	}
+
+	maximum_position = scroll_bar->maximum - std::max((int)scroll_bar->page - 1,0);  //The position stays where a page still fits.
+	scroll_bar->position = std::max(scroll_bar->minimum,std::min(scroll_bar->position,maximum_position));
+	scroll_bar->track_position = scroll_bar->position;
+	(void)redraw;
+
+	return scroll_bar->position;
+}
+
+LONG_PTR SetWindowLongPtr(HWND window_handle,int index,LONG_PTR value)
+{
+	STYLESTRUCT styles;
+	LONG_PTR previous;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return 0;
+		}
+
+		switch(index)
+		{
+			case GWLP_WNDPROC:
+				previous = (LONG_PTR)window->procedure;
+				window->procedure = (WNDPROC)value;
+
+				return previous;
+
+			case GWLP_HINSTANCE:
+				previous = (LONG_PTR)window->instance;
+				window->instance = (HINSTANCE)value;
+
+				return previous;
+
+			case GWLP_HWNDPARENT:
+				{
+					auto owner = windows.find(window->owner);
+					auto new_owner = windows.find((HWND)value);
+
+
+					previous = (LONG_PTR)window->owner;
+					if(!IsTopLevel(window))  //Only top-level windows are owned.
+					{
+						return previous;
+					}
+					if(owner != windows.end())
+					{
+						owner->second->owned.erase(window_handle);
+					}
+					window->owner = new_owner != windows.end() ? (HWND)value : nullptr;
+					if(new_owner != windows.end())
+					{
+						new_owner->second->owned.insert(window_handle);
+					}
+
+					return previous;
+				}
+
+			case GWLP_ID:
+				previous = window->id;
+				window->id = value;
+
+				return previous;
+
+			case GWLP_USERDATA:
+				previous = window->user_data;
+				window->user_data = value;
+
+				return previous;
+
+			case GWL_STYLE:
+				styles.styleOld = window->style;
+
+				break;
+
+			case GWL_EXSTYLE:
+				styles.styleOld = window->style_extended;
+
+				break;
+
+			default:
+				return 0;
+		}
+	}
+
+	styles.styleNew = (DWORD)value;
+	SendMessage(window_handle,WM_STYLECHANGING,(WPARAM)index,(LPARAM)&styles);
+
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return 0;
+		}
+		(index == GWL_STYLE ? window->style : window->style_extended) = styles.styleNew;
+	}
+
+	SendMessage(window_handle,WM_STYLECHANGED,(WPARAM)index,(LPARAM)&styles);
+
+	return (LONG_PTR)styles.styleOld;
+}
+
+BOOL SetWindowPlacement(HWND window_handle,const WINDOWPLACEMENT* placement)
+{
+	bool restored;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+		window->normal_rectangle = placement->rcNormalPosition;
+		restored = (window->style & (WS_MINIMIZE | WS_MAXIMIZE)) == 0;
+	}
+
+	switch(placement->showCmd)
+	{
+		case SW_MAXIMIZE:
+		case SW_MINIMIZE:
+		case SW_SHOWMINIMIZED:
+			ShowWindow(window_handle,placement->showCmd);
+
+			break;
+
+		default:
+			if(!restored)
+			{
+				ShowWindow(window_handle,SW_RESTORE);
+			}
+			else
+			{
+				SetWindowPos(window_handle,nullptr,placement->rcNormalPosition.left,placement->rcNormalPosition.top,placement->rcNormalPosition.right - placement->rcNormalPosition.left,placement->rcNormalPosition.bottom - placement->rcNormalPosition.top,SWP_NOZORDER | SWP_NOACTIVATE);
+			}
+			if(placement->showCmd != SW_HIDE)
+			{
+				ShowWindow(window_handle,placement->showCmd);
+			}
+
+			break;
+	}
+
+	return TRUE;
+}
+
+BOOL SetWindowPos(HWND window_handle,HWND insert_after,int x,int y,int width,int height,UINT flags)
+{
+	WINDOWPOS position;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+
+		position.hwnd = window_handle;
+		position.hwndInsertAfter = insert_after;
+		position.x = (flags & SWP_NOMOVE) != 0 ? window->rectangle.left : x;
+		position.y = (flags & SWP_NOMOVE) != 0 ? window->rectangle.top : y;
+		position.cx = (flags & SWP_NOSIZE) != 0 ? window->rectangle.right - window->rectangle.left : std::max(width,0);
+		position.cy = (flags & SWP_NOSIZE) != 0 ? window->rectangle.bottom - window->rectangle.top : std::max(height,0);
+		position.flags = flags;
+	}
+
+	SendMessage(window_handle,WM_WINDOWPOSCHANGING,0,(LPARAM)&position);
+
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+		bool was_visible;
+		bool moved;
+		bool resized;
+
+
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+
+		was_visible = IsVisible(window);
+		moved = position.x != window->rectangle.left || position.y != window->rectangle.top;
+		resized = position.cx != window->rectangle.right - window->rectangle.left || position.cy != window->rectangle.bottom - window->rectangle.top;
+		SetRect(&window->rectangle,position.x,position.y,position.x + std::max(position.cx,0),position.y + std::max(position.cy,0));
+		if(!moved)  //So that the window is only sent WM_MOVE and WM_SIZE for what changed.
+		{
+			position.flags |= SWP_NOMOVE;
+		}
+		if(!resized)
+		{
+			position.flags |= SWP_NOSIZE;
+		}
+
+		if((position.flags & SWP_NOZORDER) == 0 && position.hwndInsertAfter != window_handle)
+		{
+			Unlink(window);
+			Link(window,window->parent,position.hwndInsertAfter);
+		}
+
+		if((position.flags & SWP_SHOWWINDOW) != 0)
+		{
+			window->style |= WS_VISIBLE;
+		}
+		else if((position.flags & SWP_HIDEWINDOW) != 0)
+		{
+			window->style &= ~WS_VISIBLE;
+		}
+
+		if(!was_visible && IsVisible(window))
+		{
+			Invalidate(window,nullptr,true,true);
+		}
+		else if(resized && (position.flags & SWP_NOREDRAW) == 0)
+		{
+			Invalidate(window,nullptr,true,false);
+		}
+	}
+
+	SendMessage(window_handle,WM_WINDOWPOSCHANGED,0,(LPARAM)&position);
+
+	return TRUE;
+}
+
+BOOL SetWindowText(HWND window_handle,LPCWSTR text)
+{
+	CountCall(__func__);
+	return (BOOL)SendMessage(window_handle,WM_SETTEXT,0,(LPARAM)text);
+}
+
+BOOL ShowWindow(HWND window_handle,int command)
+{
+	const UINT SHOW_FLAGS = SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE;
+	bool was_visible;
+	DWORD style;
+	RECT target;
+
+
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+
+		was_visible = (window->style & WS_VISIBLE) != 0;
+		style = window->style;
+		switch(command)
+		{
+			case SW_MINIMIZE:
+			case SW_SHOWMINIMIZED:
+				if((style & (WS_MINIMIZE | WS_MAXIMIZE)) == 0)
+				{
+					window->normal_rectangle = window->rectangle;
+				}
+				window->style = (window->style | WS_MINIMIZE) & ~WS_MAXIMIZE;
+
+				break;
+
+			case SW_MAXIMIZE:
+				if((style & (WS_MINIMIZE | WS_MAXIMIZE)) == 0)
+				{
+					window->normal_rectangle = window->rectangle;
+				}
+				window->style = (window->style | WS_MAXIMIZE) & ~WS_MINIMIZE;
+				target = IsTopLevel(window) ? WORK_AREA_RECTANGLE : GetClientRectangle(window->parent);
+
+				break;
+
+			case SW_RESTORE:
+			case SW_SHOWNORMAL:
+				window->style &= ~(WS_MINIMIZE | WS_MAXIMIZE);
+				target = window->normal_rectangle;
+
+				break;
+		}
+	}
+
+	if(command == SW_HIDE)
+	{
+		if(was_visible)
+		{
+			SendMessage(window_handle,WM_SHOWWINDOW,FALSE,0);
+			SetWindowPos(window_handle,nullptr,0,0,0,0,SHOW_FLAGS | SWP_HIDEWINDOW);
+		}
+
+		return was_visible;
+	}
+
+	if(!was_visible)
+	{
+		SendMessage(window_handle,WM_SHOWWINDOW,TRUE,0);
+	}
+	if(command == SW_MAXIMIZE || ((command == SW_RESTORE || command == SW_SHOWNORMAL) && (style & (WS_MINIMIZE | WS_MAXIMIZE)) != 0))
+	{
+		SetWindowPos(window_handle,nullptr,target.left,target.top,target.right - target.left,target.bottom - target.top,SWP_NOZORDER | SWP_NOACTIVATE | SWP_SHOWWINDOW);
+	}
+	else if(!was_visible)
+	{
+		SetWindowPos(window_handle,nullptr,0,0,0,0,SHOW_FLAGS | SWP_SHOWWINDOW);
+	}
+
+	return was_visible;
+}
+
+BOOL UpdateWindow(HWND window_handle)
+{
+	CountCall(__func__);
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+		if(!window->invalid || !IsVisible(window))
+		{
+			return TRUE;
+		}
+	}
+
+	SendMessage(window_handle,WM_PAINT,0,0);
+
+	return TRUE;
+}
+
+BOOL ValidateRect(HWND window_handle,const RECT* rectangle)
+{
+	CountCall(__func__);
+	return RedrawWindow(window_handle,rectangle,nullptr,RDW_VALIDATE);
+}
+
+HDWP BeginDeferWindowPos(int count)
+{
+	DeferredPositions* positions = new DeferredPositions();
+
+
+	CountCall(__func__);
+	positions->positions.reserve(std::max(count,0));
+
+	return positions;
+}
+
+HDWP DeferWindowPos(HDWP positions,HWND window_handle,HWND insert_after,int x,int y,int width,int height,UINT flags)
+{
+	WINDOWPOS position = {window_handle,insert_after,x,y,width,height,flags};
+
+
+	CountCall(__func__);
+	if(positions == nullptr || !IsWindow(window_handle))
+	{
+		delete (DeferredPositions*)positions;  //A failure abandons every position deferred so far, as on Windows.
+
+		return nullptr;
+	}
+
+	((DeferredPositions*)positions)->positions.push_back(position);
+
+	return positions;
+}
+
+BOOL EndDeferWindowPos(HDWP positions)
+{
+	DeferredPositions* deferred = (DeferredPositions*)positions;
+
+
+	CountCall(__func__);
+	if(deferred == nullptr)
+	{
+		return FALSE;
+	}
+
+	for(const WINDOWPOS& position : deferred->positions)
+	{
+		SetWindowPos(position.hwnd,position.hwndInsertAfter,position.x,position.y,position.cx,position.cy,position.flags);
+	}
+	delete deferred;
+
+	return TRUE;
+}
+
+/* Window classes */
+BOOL GetClassInfoEx(HINSTANCE instance,LPCWSTR class_name,WNDCLASSEX* window_class)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	ClassRecord* found = FindClass(class_name,instance);
+
+
+	CountCall(__func__);
+	if(found == nullptr)
+	{
+		last_error = ERROR_CLASS_DOES_NOT_EXIST;
+
+		return FALSE;
+	}
+
+	*window_class = found->data;
+
+	return found->atom;
+}
+
+ULONG_PTR GetClassLongPtr(HWND window_handle,int index)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	const WNDCLASSEX* data;
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return 0;
+	}
+
+	data = &window->window_class->data;
+	switch(index)
+	{
+		case GCLP_MENUNAME:
+			return (ULONG_PTR)data->lpszMenuName;
+
+		case GCLP_HBRBACKGROUND:
+			return (ULONG_PTR)data->hbrBackground;
+
+		case GCLP_HCURSOR:
+			return (ULONG_PTR)data->hCursor;
+
+		case GCLP_HICON:
+			return (ULONG_PTR)data->hIcon;
+
+		case GCLP_HMODULE:
+			return (ULONG_PTR)data->hInstance;
+
+		case GCLP_WNDPROC:
+			return (ULONG_PTR)data->lpfnWndProc;
+
+		case GCL_STYLE:
+			return data->style;
+
+		case GCW_ATOM:
+			return window->window_class->atom;
+
+		case GCLP_HICONSM:
+			return (ULONG_PTR)data->hIconSm;
+	}
+
+	return 0;
+}
+
+int GetClassName(HWND window_handle,LPWSTR class_name,int capacity)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	int length;
+
+
+	CountCall(__func__);
+	if(window == nullptr || capacity <= 0)
+	{
+		return 0;
+	}
+
+	length = std::min((int)window->window_class->name.length(),capacity - 1);
+	std::wmemcpy(class_name,window->window_class->name.c_str(),length);
+	class_name[length] = 0;
+
+	return length;
+}
+
+BOOL RegisterClassEx(const WNDCLASSEX* window_class)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	ClassRecord* registered;
+	ClassRecord* existing = FindClass(window_class->lpszClassName,window_class->hInstance);
+
+
+	CountCall(__func__);
+	if(existing != nullptr && !existing->system)
+	{
+		last_error = ERROR_CLASS_ALREADY_EXISTS;
+
+		return FALSE;
+	}
+
+	registered = new ClassRecord();
+	registered->name = window_class->lpszClassName;
+	registered->key = Lowercase(window_class->lpszClassName);
+	registered->data = *window_class;
+	registered->data.hInstance = GetModule(window_class->hInstance);
+	registered->data.lpszClassName = registered->name.c_str();
+	registered->atom = next_class_atom++;
+	registered->system = false;
+	registered->windows = 0;
+	classes.push_back(registered);
+
+	return registered->atom;
+}
+
+ULONG_PTR SetClassLongPtr(HWND window_handle,int index,LONG_PTR value)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	WNDCLASSEX* data;
+	ULONG_PTR previous = 0;
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return 0;
+	}
+
+	data = &window->window_class->data;  //Applies to the windows created from now on, not those which already exist.
+	switch(index)
+	{
+		case GCLP_MENUNAME:
+			previous = (ULONG_PTR)data->lpszMenuName;
+			data->lpszMenuName = (LPCWSTR)value;
+
+			break;
+
+		case GCLP_HBRBACKGROUND:
+			previous = (ULONG_PTR)data->hbrBackground;
+			data->hbrBackground = (HBRUSH)value;
+
+			break;
+
+		case GCLP_HCURSOR:
+			previous = (ULONG_PTR)data->hCursor;
+			data->hCursor = (HCURSOR)value;
+
+			break;
+
+		case GCLP_HICON:
+			previous = (ULONG_PTR)data->hIcon;
+			data->hIcon = (HICON)value;
+
+			break;
+
+		case GCLP_WNDPROC:
+			previous = (ULONG_PTR)data->lpfnWndProc;
+			data->lpfnWndProc = (WNDPROC)value;
+
+			break;
+
+		case GCL_STYLE:
+			previous = data->style;
+			data->style = (UINT)value;
+
+			break;
+
+		case GCLP_HICONSM:
+			previous = (ULONG_PTR)data->hIconSm;
+			data->hIconSm = (HICON)value;
+
+			break;
+	}
+
+	return previous;
+}
+
+BOOL UnregisterClass(LPCWSTR class_name,HINSTANCE instance)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	ClassRecord* window_class = FindClass(class_name,instance);
+
+
+	CountCall(__func__);
+	if(window_class == nullptr || window_class->system)
+	{
+		last_error = ERROR_CLASS_DOES_NOT_EXIST;
+
+		return FALSE;
+	}
+	if(window_class->windows != 0)
+	{
+		last_error = ERROR_CLASS_HAS_WINDOWS;
+
+		return FALSE;
+	}
+
+	classes.erase(std::find(classes.begin(),classes.end(),window_class));
+	delete window_class;
+
+	return TRUE;
+}
+
+/* Properties */
+HANDLE GetProp(HWND window_handle,LPCWSTR name)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	ATOM atom;
+
+
+	CountCall(__func__);
+	if(window == nullptr || (atom = FindAtomLocked(name)) == 0)
+	{
+		return nullptr;
+	}
+
+	for(const auto& property : window->properties)
+	{
+		if(property.first == atom)
+		{
+			return property.second;
+		}
+	}
+
+	return nullptr;
+}
+
+HANDLE RemoveProp(HWND window_handle,LPCWSTR name)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	ATOM atom;
+
+
+	CountCall(__func__);
+	if(window == nullptr || (atom = FindAtomLocked(name)) == 0)
+	{
+		return nullptr;
+	}
+
+	for(auto property = window->properties.begin();property != window->properties.end();++property)
+	{
+		if(property->first == atom)
+		{
+			HANDLE data = property->second;
+
+
+			window->properties.erase(property);
+
+			return data;
+		}
+	}
+
+	return nullptr;
+}
+
+BOOL SetProp(HWND window_handle,LPCWSTR name,HANDLE data)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	ATOM atom;
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return FALSE;
+	}
+
+	atom = AddAtomLocked(name);
+	for(auto& property : window->properties)
+	{
+		if(property.first == atom)
+		{
+			property.second = data;
+
+			return TRUE;
+		}
+	}
+	window->properties.push_back(std::make_pair(atom,data));
+
+	return TRUE;
+}
+
+ATOM GlobalAddAtom(LPCWSTR name)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+
+
+	CountCall(__func__);
+	return AddAtomLocked(name);
+}
+
+ATOM GlobalFindAtom(LPCWSTR name)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+
+
+	CountCall(__func__);
+	return FindAtomLocked(name);
+}
+
+/* Messages */
+LRESULT CallWindowProc(WNDPROC procedure,HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param)
+{
+	CountCall(__func__);
+	return procedure(window_handle,message,w_param,l_param);
+}
+
+LRESULT DefWindowProc(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param)
+{
+	CountCall(__func__);
+	switch(message)
+	{
+		case WM_NCCREATE:
+			return TRUE;
+
+		case WM_CLOSE:
+			DestroyWindow(window_handle);
+
+			return 0;
+
+		case WM_ERASEBKGND:
+			{
+				HBRUSH background = (HBRUSH)GetClassLongPtr(window_handle,GCLP_HBRBACKGROUND);
+				RECT client_rectangle;
+
+
+				if(background == nullptr)
+				{
+					return 0;
+				}
+				GetClientRect(window_handle,&client_rectangle);
+				FillRect((HDC)w_param,&client_rectangle,background);
+
+				return 1;
+			}
+
+		case WM_GETTEXT:
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				WindowRecord* window = FindWindow(window_handle);
+				int length;
+
+
+				if(window == nullptr || w_param == 0)
+				{
+					return 0;
+				}
+				length = std::min((int)window->text.length(),(int)w_param - 1);
+				std::wmemcpy((LPWSTR)l_param,window->text.c_str(),length);
+				((LPWSTR)l_param)[length] = 0;
+
+				return length;
+			}
+
+		case WM_NCHITTEST:
+			return HTCLIENT;
+
+		case WM_PAINT:
+			{
+				PAINTSTRUCT paint;
+
+
+				BeginPaint(window_handle,&paint);
+				EndPaint(window_handle,&paint);
+
+				return 0;
+			}
+
+		case WM_PRINT:
+			if((l_param & PRF_ERASEBKGND) != 0)
+			{
+				SendMessage(window_handle,WM_ERASEBKGND,w_param,0);
+			}
+			if((l_param & PRF_CLIENT) != 0)
+			{
+				SendMessage(window_handle,WM_PRINTCLIENT,w_param,l_param);
+			}
+
+			return 0;
+
+		case WM_QUERYENDSESSION:
+			return TRUE;
+
+		case WM_SETTEXT:
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				WindowRecord* window = FindWindow(window_handle);
+
+
+				if(window == nullptr)
+				{
+					return FALSE;
+				}
+				window->text = l_param != 0 ? (LPCWSTR)l_param : L"";
+
+				return TRUE;
+			}
+
+		case WM_SYSCOMMAND:
+			if((w_param & 0xFFF0) == SC_CLOSE)
+			{
+				SendMessage(window_handle,WM_CLOSE,0,0);
+			}
+
+			return 0;
+
+		case WM_WINDOWPOSCHANGED:
+			{
+				const WINDOWPOS* position = (const WINDOWPOS*)l_param;
+
+
+				if((position->flags & SWP_NOMOVE) == 0)
+				{
+					SendMessage(window_handle,WM_MOVE,0,MAKELPARAM(position->x,position->y));
+				}
+				if((position->flags & SWP_NOSIZE) == 0)
+				{
+					SendMessage(window_handle,WM_SIZE,0,MAKELPARAM(position->cx,position->cy));
+				}
+
+				return 0;
+			}
+	}
+
+	return 0;
+}
+
+LRESULT DispatchMessage(const MSG* message)
+{
+	WNDPROC procedure;
+
+
+	CountCall(__func__);
+	if(message->message == WM_TIMER && message->lParam != 0)
+	{
+		((TIMERPROC)message->lParam)(message->hwnd,WM_TIMER,message->wParam,GetTickCount());
+
+		return 0;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(message->hwnd);
+
+
+		if(window == nullptr)
+		{
+			return 0;
+		}
+		procedure = window->procedure;
+	}
+
+	return procedure(message->hwnd,message->message,message->wParam,message->lParam);
+}
+
+BOOL GetMessage(MSG* message,HWND window_handle,UINT first,UINT last)
+{
+	std::unique_lock<std::mutex> lock(state_mutex);
+	ThreadQueue* queue = GetQueue();
+
+
+	CountCall(__func__);
+	for(;;)
+	{
+		Clock::time_point next_timer = Clock::time_point::max();
+
+
+		if(RetrieveMessage(lock,queue,message,window_handle,first,last,true))
+		{
+			return message->message != WM_QUIT;
+		}
+
+		for(const Timer& timer : queue->timers)
+		{
+			next_timer = std::min(next_timer,timer.due);
+		}
+		if(next_timer == Clock::time_point::max())
+		{
+			queue->signal.wait(lock);
+		}
+		else
+		{
+			queue->signal.wait_until(lock,next_timer);
+		}
+	}
+}
+
+BOOL KillTimer(HWND window_handle,UINT_PTR id)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	ThreadQueue* queue = GetQueue();
+
+
+	CountCall(__func__);
+	for(auto timer = queue->timers.begin();timer != queue->timers.end();++timer)
+	{
+		if(timer->window == window_handle && timer->id == id)
+		{
+			queue->timers.erase(timer);
+
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+BOOL PeekMessage(MSG* message,HWND window_handle,UINT first,UINT last,UINT flags)
+{
+	std::unique_lock<std::mutex> lock(state_mutex);
+
+
+	CountCall(__func__);
+	return RetrieveMessage(lock,GetQueue(),message,window_handle,first,last,(flags & PM_REMOVE) != 0);
+}
+
+BOOL PostMessage(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	ThreadQueue* queue;
+	MSG posted = {window_handle,message,w_param,l_param,GetTickCount(),{0,0}};
+
+
+	CountCall(__func__);
+	if(window_handle == nullptr)  //Posted to the thread itself.
+	{
+		queue = GetQueue();
+	}
+	else
+	{
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return FALSE;
+		}
+		queue = GetQueue(window->thread);
+		if(queue == nullptr)
+		{
+			return FALSE;
+		}
+	}
+
+	queue->posted.push_back(posted);
+	queue->signal.notify_all();
+
+	return TRUE;
+}
+
+void PostQuitMessage(int exit_code)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	ThreadQueue* queue = GetQueue();
+
+
+	CountCall(__func__);
+	queue->quit = true;
+	queue->exit_code = exit_code;
+}
+
+LRESULT SendMessage(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param)
+{
+	std::unique_lock<std::mutex> lock(state_mutex);
+	WindowRecord* window = FindWindow(window_handle);
+	ThreadQueue* sender;
+	ThreadQueue* receiver;
+	SentMessage sent;
+
+
+	CountCall(__func__);
+	if(window == nullptr)
+	{
+		return 0;
+	}
+
+	sender = GetQueue();
+	receiver = GetQueue(window->thread);
+	if(receiver == sender || receiver == nullptr)  //Called directly when the window belongs to this thread, or its thread has gone.
+	{
+		WNDPROC procedure = window->procedure;
+
+
+		lock.unlock();
+
+		return procedure(window_handle,message,w_param,l_param);
+	}
+
+	sent.message.hwnd = window_handle;
+	sent.message.message = message;
+	sent.message.wParam = w_param;
+	sent.message.lParam = l_param;
+	sent.result = 0;
+	sent.done = false;
+	sent.sender = sender;
+	receiver->sent.push_back(&sent);
+	receiver->signal.notify_all();
+
+	while(!sent.done)  //Messages sent to this thread meanwhile are handled, so that two threads sending to each other don't deadlock.
+	{
+		if(!sender->sent.empty())
+		{
+			ReceiveSentMessages(lock,sender);
+
+			continue;
+		}
+		sender->signal.wait(lock);
+	}
+
+	return sent.result;
+}
+
+UINT_PTR SetTimer(HWND window_handle,UINT_PTR id,UINT elapse,TIMERPROC procedure)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	ThreadQueue* queue;
+	Timer timer;
+
+
+	CountCall(__func__);
+	if(window_handle != nullptr)
+	{
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr || window->thread != CurrentThreadId())
+		{
+			return 0;
+		}
+	}
+	queue = GetQueue();
+
+	timer.window = window_handle;
+	timer.id = id;
+	timer.procedure = procedure;
+	timer.interval = std::chrono::milliseconds(std::max(std::min(elapse,(UINT)USER_TIMER_MAXIMUM),USER_TIMER_MINIMUM));
+	timer.due = Clock::now() + timer.interval;
+
+	for(Timer& existing : queue->timers)  //Setting a timer again replaces it.
+	{
+		if(existing.window == window_handle && existing.id == id && (window_handle != nullptr || id != 0))
+		{
+			existing = timer;
+
+			return window_handle == nullptr ? id : 1;
+		}
+	}
+
+	if(window_handle == nullptr)  //Thread timers are given their identifiers.
+	{
+		timer.id = ++last_thread_timer;
+	}
+	queue->timers.push_back(timer);
+	queue->signal.notify_all();
+
+	return window_handle == nullptr ? timer.id : 1;
+}
+
+BOOL TranslateMessage(const MSG* message)
+{
+	CountCall(__func__);
+	(void)message;
+
+	return FALSE;  //No keyboard input arrives here to be translated into characters.
+}
+
+/* Painting and GDI */
+HDC BeginPaint(HWND window_handle,PAINTSTRUCT* paint)
+{
+	HDC device_context;
+	bool erase;
+
+
+	CountCall(__func__);
+	std::memset(paint,0,sizeof(*paint));
+
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		WindowRecord* window = FindWindow(window_handle);
+
+
+		if(window == nullptr)
+		{
+			return nullptr;
+		}
+
+		paint->rcPaint = window->update_rectangle;
+		erase = window->erase;
+		Validate(window,false);
+	}
+
+	device_context = GetDC(window_handle);
+	IntersectClipRect(device_context,paint->rcPaint.left,paint->rcPaint.top,paint->rcPaint.right,paint->rcPaint.bottom);
+	paint->hdc = device_context;
+	paint->fErase = erase && SendMessage(window_handle,WM_ERASEBKGND,(WPARAM)device_context,0) == 0;  //Left for the window to erase, if it didn't when asked.
+
+	return device_context;
+}
+
+BOOL BitBlt(HDC destination,int x,int y,int width,int height,HDC source,int source_x,int source_y,DWORD operation)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* destination_context = FindDeviceContext(destination);
+	GdiObject* source_context = FindDeviceContext(source);
+	RECT target = {x,y,x + width,y + height};
+	RECT bounds;
+
+
+	CountCall(__func__);
+	if(destination_context == nullptr || source_context == nullptr || operation != SRCCOPY)
+	{
+		return FALSE;
+	}
+	if(source_context->state.bitmap == nullptr || !GetDrawableBounds(destination_context,target,bounds))  //The screen can't be read from or drawn to here.
+	{
+		return TRUE;
+	}
+
+	for(int row = bounds.top;row < bounds.bottom;++row)
+	{
+		std::uint32_t* destination_row = GetRow(destination_context->state.bitmap,row);
+		int from_y = source_y + source_context->state.origin.y + (row - destination_context->state.origin.y - y);
+
+
+		if(from_y < 0 || from_y >= source_context->state.bitmap->height)
+		{
+			continue;
+		}
+
+		const std::uint32_t* source_row = GetRow(source_context->state.bitmap,from_y);
+
+
+		for(int column = bounds.left;column < bounds.right;++column)
+		{
+			int from_x = source_x + source_context->state.origin.x + (column - destination_context->state.origin.x - x);
+
+
+			if(from_x >= 0 && from_x < source_context->state.bitmap->width)
+			{
+				destination_row[column] = source_row[from_x];
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+HDC CreateCompatibleDC(HDC device_context)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+
+
+	CountCall(__func__);
+	(void)device_context;
+
+	return (HDC)CreateDeviceContext(OBJ_MEMDC,nullptr);
+}
+
+HBITMAP CreateCompatibleBitmap(HDC device_context,int width,int height)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* bitmap;
+
+
+	CountCall(__func__);
+	if(FindDeviceContext(device_context) == nullptr || width < 0 || height < 0)
+	{
+		return nullptr;
+	}
+
+	bitmap = new GdiObject();
+	bitmap->type = OBJ_BITMAP;
+	bitmap->width = width;
+	bitmap->height = height;
+	bitmap->pixels.assign((size_t)width * height,0);
+	gdi_objects.insert(bitmap);
+
+	return (HBITMAP)bitmap;
+}
+
+HBITMAP CreateDIBSection(HDC device_context,const BITMAPINFO* information,UINT usage,void** bits,HANDLE section,DWORD offset)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	const BITMAPINFOHEADER& header = information->bmiHeader;
+	GdiObject* bitmap;
+
+
+	CountCall(__func__);
+	(void)device_context;
+	(void)offset;
+	if(header.biBitCount != 32 || header.biCompression != BI_RGB || usage != DIB_RGB_COLORS || section != nullptr || header.biWidth < 0)  //Only the format the framework draws in.
+	{
+		return nullptr;
+	}
+
+	bitmap = new GdiObject();
+	bitmap->type = OBJ_BITMAP;
+	bitmap->width = header.biWidth;
+	bitmap->height = header.biHeight < 0 ? -header.biHeight : header.biHeight;
+	bitmap->bottom_up = header.biHeight > 0;
+	bitmap->pixels.assign((size_t)bitmap->width * bitmap->height + 1,0);  //Never empty, so that the bits are never null.
+	gdi_objects.insert(bitmap);
+	if(bits != nullptr)
+	{
+		*bits = bitmap->pixels.data();
+	}
+
+	return (HBITMAP)bitmap;
+}
+
+HBRUSH CreateSolidBrush(COLORREF color)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* brush = new GdiObject();
+
+
+	CountCall(__func__);
+	brush->type = OBJ_BRUSH;
+	brush->color = color & 0x00FFFFFF;
+	gdi_objects.insert(brush);
+
+	return (HBRUSH)brush;
+}
+
+BOOL DeleteDC(HDC device_context)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindObject(device_context,OBJ_MEMDC);
+
+
+	CountCall(__func__);
+	if(found == nullptr)
+	{
+		return FALSE;
+	}
+	DeleteDeviceContext(found);
+
+	return TRUE;
+}
+
+BOOL DeleteObject(HGDIOBJ object)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	auto found = gdi_objects.find((GdiObject*)object);
+
+
+	CountCall(__func__);
+	if(found == gdi_objects.end() || (*found)->type == OBJ_DC || (*found)->type == OBJ_MEMDC)
+	{
+		return (ULONG_PTR)object > 0 && (ULONG_PTR)object <= 31;  //System color brushes need not be deleted, but may be.
+	}
+	if((*found)->type == OBJ_BITMAP && (*found)->selected_into != nullptr)  //Still selected into a device context.
+	{
+		return FALSE;
+	}
+
+	delete *found;
+	gdi_objects.erase(found);
+
+	return TRUE;
+}
+
+BOOL DestroyCursor(HCURSOR cursor)
+{
+	CountCall(__func__);
+	return DestroyIcon(cursor);
+}
+
+BOOL DestroyIcon(HICON icon)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	auto found = images.find((Image*)icon);
+
+
+	CountCall(__func__);
+	if(found == images.end())
+	{
+		return FALSE;
+	}
+	if(!(*found)->shared)
+	{
+		delete *found;
+		images.erase(found);
+	}
+
+	return TRUE;
+}
+
+BOOL DrawFocusRect(HDC device_context,const RECT* rectangle)
+{
+	CountCall(__func__);
+	(void)rectangle;
+
+	return device_context != nullptr;
+}
+
+int DrawText(HDC device_context,LPCWSTR text,int length,LPRECT rectangle,UINT format)  //Text is measured but not drawn.
+{
+	const int LINE_HEIGHT = 16;
+
+
+	CountCall(__func__);
+	(void)text;
+	(void)length;
+	(void)rectangle;
+	(void)format;
+
+	return device_context != nullptr ? LINE_HEIGHT : 0;
+}
+
+BOOL EndPaint(HWND window_handle,const PAINTSTRUCT* paint)
+{
+	CountCall(__func__);
+	return ReleaseDC(window_handle,paint->hdc);
+}
+
+int FillRect(HDC device_context,const RECT* rectangle,HBRUSH brush)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+	COLORREF color;
+	RECT bounds;
+	std::uint32_t pixel;
+
+
+	CountCall(__func__);
+	if(found == nullptr || !GetBrushColor(brush,color))
+	{
+		return FALSE;
+	}
+	if(!GetDrawableBounds(found,*rectangle,bounds))
+	{
+		return TRUE;
+	}
+
+	pixel = GetPixelValue(color);
+	for(int y = bounds.top;y < bounds.bottom;++y)
+	{
+		std::fill_n(GetRow(found->state.bitmap,y) + bounds.left,bounds.right - bounds.left,pixel);
+	}
+
+	return TRUE;
+}
+
+BOOL GdiFlush()
+{
+	CountCall(__func__);
+	return TRUE;
+}
+
+HDC GetDC(HWND window_handle)
+{
+	CountCall(__func__);
+	if(window_handle != nullptr && !IsWindow(window_handle))
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+
+
+	return (HDC)CreateDeviceContext(OBJ_DC,window_handle);
+}
+
+DWORD GetGuiResources(HANDLE process,DWORD flags)
+{
+	CountCall(__func__);
+	(void)process;
+
+	if(flags == GR_USEROBJECTS)
+	{
+		size_t window_count = Headless::GetWindowCount();
+		std::lock_guard<std::mutex> lock(gdi_mutex);
+
+
+		return (DWORD)(window_count + images.size());
+	}
+
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+
+
+	return (DWORD)gdi_objects.size();
+}
+
+int GetObject(HGDIOBJ object,int size,LPVOID description)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	COLORREF color;
+
+
+	CountCall(__func__);
+	if(size != sizeof(LOGBRUSH) || !GetBrushColor((HBRUSH)object,color))  //Only brushes are described.
+	{
+		return 0;
+	}
+
+	((LOGBRUSH*)description)->lbStyle = BS_SOLID;
+	((LOGBRUSH*)description)->lbColor = color;
+	((LOGBRUSH*)description)->lbHatch = 0;
+
+	return sizeof(LOGBRUSH);
+}
+
+COLORREF GetPixel(HDC device_context,int x,int y)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+	RECT point = {x,y,x + 1,y + 1};
+	RECT bounds;
+	std::uint32_t pixel;
+
+
+	CountCall(__func__);
+	if(found == nullptr || !GetDrawableBounds(found,point,bounds))
+	{
+		return CLR_INVALID;
+	}
+
+	pixel = GetRow(found->state.bitmap,bounds.top)[bounds.left];
+
+	return RGB((pixel >> 16) & 0xFF,(pixel >> 8) & 0xFF,pixel & 0xFF);
+}
+
+COLORREF GetSysColor(int index)
+{
+	CountCall(__func__);
+	switch(index)
+	{
+		case COLOR_WINDOW:
+			return RGB(0xFF,0xFF,0xFF);
+
+		case COLOR_WINDOWTEXT:
+			return RGB(0,0,0);
+
+		case COLOR_BTNFACE:
+			return RGB(0xF0,0xF0,0xF0);
+	}
+
+	return RGB(0xC0,0xC0,0xC0);
+}
+
+int GetSystemMetrics(int index)
+{
+	CountCall(__func__);
+	switch(index)
+	{
+		case SM_CXSCREEN:
+			return SCREEN_RECTANGLE.right;
+
+		case SM_CYSCREEN:
+			return SCREEN_RECTANGLE.bottom;
+
+		case SM_CXICON:
+		case SM_CYICON:
+			return 32;
+
+		case SM_CXSMICON:
+		case SM_CYSMICON:
+			return 16;
+	}
+
+	return 0;
+}
+
+int IntersectClipRect(HDC device_context,int left,int top,int right,int bottom)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+	RECT clip = {left,top,right,bottom};
+
+
+	CountCall(__func__);
+	if(found == nullptr)
+	{
+		return ERROR;
+	}
+
+	OffsetRect(&clip,found->state.origin.x,found->state.origin.y);
+	if(found->state.clipped)
+	{
+		Intersect(clip,clip,found->state.clip);
+	}
+	found->state.clip = clip;
+	found->state.clipped = true;
+
+	return IsRectEmpty(&clip) ? NULLREGION : SIMPLEREGION;
+}
+
+HANDLE LoadImage(HINSTANCE instance,LPCWSTR name,UINT type,int width,int height,UINT flags)  //Images are not decoded; a placeholder stands in for each.
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	Image* image;
+
+
+	CountCall(__func__);
+	(void)instance;
+	(void)width;
+	(void)height;
+	if(type != IMAGE_ICON && type != IMAGE_CURSOR)
+	{
+		return nullptr;
+	}
+
+	if((flags & LR_SHARED) != 0)
+	{
+		Image*& shared = shared_images[std::make_pair(type,GetResourceKey(name))];
+
+
+		if(shared == nullptr)
+		{
+			shared = new Image();
+			shared->type = type;
+			shared->shared = true;
+			images.insert(shared);
+		}
+
+		return shared;
+	}
+
+	image = new Image();
+	image->type = type;
+	image->shared = false;
+	images.insert(image);
+
+	return image;
+}
+
+BOOL OffsetViewportOrgEx(HDC device_context,int x,int y,POINT* previous)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+
+
+	CountCall(__func__);
+	if(found == nullptr)
+	{
+		return FALSE;
+	}
+	if(previous != nullptr)
+	{
+		*previous = found->state.origin;
+	}
+	found->state.origin.x += x;
+	found->state.origin.y += y;
+
+	return TRUE;
+}
+
+int ReleaseDC(HWND window_handle,HDC device_context)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindObject(device_context,OBJ_DC);
+
+
+	CountCall(__func__);
+	if(found == nullptr || found->window != window_handle)
+	{
+		return 0;
+	}
+	DeleteDeviceContext(found);
+
+	return 1;
+}
+
+BOOL RestoreDC(HDC device_context,int saved)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+	size_t index;
+
+
+	CountCall(__func__);
+	if(found == nullptr || saved == 0)
+	{
+		return FALSE;
+	}
+
+	index = saved < 0 ? found->saved_states.size() + saved : (size_t)saved - 1;  //Negative values count back from the most recently saved state.
+	if(index >= found->saved_states.size())
+	{
+		return FALSE;
+	}
+
+	if(found->state.bitmap != nullptr)
+	{
+		found->state.bitmap->selected_into = nullptr;
+	}
+	found->state = found->saved_states[index];
+	if(found->state.bitmap != nullptr)
+	{
+		found->state.bitmap->selected_into = found;
+	}
+	found->saved_states.resize(index);
+
+	return TRUE;
+}
+
+int SaveDC(HDC device_context)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+
+
+	CountCall(__func__);
+	if(found == nullptr)
+	{
+		return 0;
+	}
+	found->saved_states.push_back(found->state);
+
+	return (int)found->saved_states.size();
+}
+
+HGDIOBJ SelectObject(HDC device_context,HGDIOBJ object)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+	GdiObject* bitmap;
+	HGDIOBJ previous;
+
+
+	CountCall(__func__);
+	if(found == nullptr || object == nullptr)
+	{
+		return nullptr;
+	}
+
+	bitmap = object == &stock_bitmap ? &stock_bitmap : FindObject(object,OBJ_BITMAP);
+	if(bitmap != nullptr)
+	{
+		if(found->type != OBJ_MEMDC || (bitmap->selected_into != nullptr && bitmap->selected_into != found && bitmap != &stock_bitmap))  //A bitmap can be selected into one memory device context at a time.
+		{
+			return nullptr;
+		}
+
+		previous = found->state.bitmap;
+		found->state.bitmap->selected_into = nullptr;
+		found->state.bitmap = bitmap;
+		bitmap->selected_into = found;
+
+		return previous;
+	}
+
+	if(FindObject(object,OBJ_BRUSH) != nullptr || ((ULONG_PTR)object > 0 && (ULONG_PTR)object <= 31))
+	{
+		previous = found->state.brush;
+		found->state.brush = object;
+
+		return previous;
+	}
+
+	previous = found->state.font;  //Anything else is taken to be a font, which is only remembered.
+	found->state.font = object;
+
+	return previous;
+}
+
+int SetBkMode(HDC device_context,int mode)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+	int previous;
+
+
+	CountCall(__func__);
+	if(found == nullptr)
+	{
+		return 0;
+	}
+	previous = found->state.background_mode;
+	found->state.background_mode = mode;
+
+	return previous;
+}
+
+int SetDIBitsToDevice(HDC device_context,int x,int y,DWORD width,DWORD height,int source_x,int source_y,UINT start_scan,UINT scan_count,const void* bits,const BITMAPINFO* information,UINT usage)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+	const BITMAPINFOHEADER& header = information->bmiHeader;
+	int source_height = header.biHeight < 0 ? -header.biHeight : header.biHeight;
+	RECT target = {x,y,x + (int)width,y + (int)height};
+	RECT bounds;
+
+
+	CountCall(__func__);
+	if(found == nullptr || header.biBitCount != 32 || header.biCompression != BI_RGB || usage != DIB_RGB_COLORS)
+	{
+		return 0;
+	}
+	if(!GetDrawableBounds(found,target,bounds))
+	{
+		return (int)scan_count;
+	}
+
+	for(int row = bounds.top;row < bounds.bottom;++row)
+	{
+		int from_y = source_y + (row - found->state.origin.y - y);  //Measured from the top of the source.
+		int scan = header.biHeight < 0 ? from_y : source_height - 1 - from_y;  //Scans are stored in the order of the bits.
+
+
+		if(scan < (int)start_scan || scan >= (int)(start_scan + scan_count))
+		{
+			continue;
+		}
+
+		const std::uint32_t* source_row = (const std::uint32_t*)bits + (size_t)(scan - start_scan) * header.biWidth;
+		std::uint32_t* destination_row = GetRow(found->state.bitmap,row);
+
+
+		for(int column = bounds.left;column < bounds.right;++column)
+		{
+			int from_x = source_x + (column - found->state.origin.x - x);
+
+
+			if(from_x >= 0 && from_x < header.biWidth)
+			{
+				destination_row[column] = source_row[from_x];
+			}
+		}
+	}
+
+	return (int)scan_count;
+}
+
+COLORREF SetTextColor(HDC device_context,COLORREF color)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+	COLORREF previous;
+
+
+	CountCall(__func__);
+	if(found == nullptr)
+	{
+		return CLR_INVALID;
+	}
+	previous = found->state.text_color;
+	found->state.text_color = color;
+
+	return previous;
+}
+
+BOOL SetViewportOrgEx(HDC device_context,int x,int y,POINT* previous)
+{
+	std::lock_guard<std::mutex> lock(gdi_mutex);
+	GdiObject* found = FindDeviceContext(device_context);
+
+
+	CountCall(__func__);
+	if(found == nullptr)
+	{
+		return FALSE;
+	}
+	if(previous != nullptr)
+	{
+		*previous = found->state.origin;
+	}
+	found->state.origin.x = x;
+	found->state.origin.y = y;
+
+	return TRUE;
+}
+
+/* Rectangles */
+BOOL EqualRect(const RECT* first,const RECT* second)
+{
+	CountCall(__func__);
+	return first->left == second->left && first->top == second->top && first->right == second->right && first->bottom == second->bottom;
+}
+
+BOOL IntersectRect(LPRECT destination,const RECT* first,const RECT* second)
+{
+	CountCall(__func__);
+	return Intersect(*destination,*first,*second);
+}
+
+BOOL IsRectEmpty(const RECT* rectangle)
+{
+	CountCall(__func__);
+	return rectangle->left >= rectangle->right || rectangle->top >= rectangle->bottom;
+}
+
+BOOL OffsetRect(LPRECT rectangle,int x,int y)
+{
+	CountCall(__func__);
+	rectangle->left += x;
+	rectangle->top += y;
+	rectangle->right += x;
+	rectangle->bottom += y;
+
+	return TRUE;
+}
+
+BOOL PtInRect(const RECT* rectangle,POINT point)
+{
+	CountCall(__func__);
+	return point.x >= rectangle->left && point.x < rectangle->right && point.y >= rectangle->top && point.y < rectangle->bottom;
+}
+
+BOOL SetRect(LPRECT rectangle,int left,int top,int right,int bottom)
+{
+	CountCall(__func__);
+	rectangle->left = left;
+	rectangle->top = top;
+	rectangle->right = right;
+	rectangle->bottom = bottom;
+
+	return TRUE;
+}
+
+BOOL SetRectEmpty(LPRECT rectangle)
+{
+	CountCall(__func__);
+	return SetRect(rectangle,0,0,0,0);
+}
+
+BOOL UnionRect(LPRECT destination,const RECT* first,const RECT* second)
+{
+	CountCall(__func__);
+	if(IsRectEmpty(first))
+	{
+		*destination = *second;
+	}
+	else if(IsRectEmpty(second))
+	{
+		*destination = *first;
+	}
+	else
+	{
+		SetRect(destination,std::min(first->left,second->left),std::min(first->top,second->top),std::max(first->right,second->right),std::max(first->bottom,second->bottom));
+	}
+
+	return !IsRectEmpty(destination);
+}
+
+/* Monitors */
+BOOL GetMonitorInfo(HMONITOR monitor,MONITORINFO* information)
+{
+	CountCall(__func__);
+	if(monitor != PRIMARY_MONITOR)
+	{
+		return FALSE;
+	}
+
+	information->rcMonitor = SCREEN_RECTANGLE;
+	information->rcWork = WORK_AREA_RECTANGLE;
+	information->dwFlags = MONITORINFOF_PRIMARY;
+
+	return TRUE;
+}
+
+HMONITOR MonitorFromWindow(HWND window_handle,DWORD flags)
+{
+	CountCall(__func__);
+	(void)window_handle;
+	(void)flags;
+
+	return PRIMARY_MONITOR;
+}
+
+/* Modules and resources */
+HRSRC FindResourceEx(HMODULE module,LPCWSTR type,LPCWSTR name,WORD language)  //Falls back to the neutral language, then to any, as Windows does.
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	std::wstring type_key = GetResourceKey(type);
+	std::wstring name_key = GetResourceKey(name);
+	auto resource = resources.find(ResourceKey(GetModule(module),type_key,name_key,language));
+
+
+	CountCall(__func__);
+	if(resource == resources.end())
+	{
+		resource = resources.find(ResourceKey(GetModule(module),type_key,name_key,MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL)));
+	}
+	if(resource == resources.end())
+	{
+		resource = resources.lower_bound(ResourceKey(GetModule(module),type_key,name_key,0));
+		if(resource != resources.end() && (std::get<0>(resource->first) != GetModule(module) || std::get<1>(resource->first) != type_key || std::get<2>(resource->first) != name_key))
+		{
+			resource = resources.end();
+		}
+	}
+	if(resource == resources.end())
+	{
+		last_error = ERROR_RESOURCE_NAME_NOT_FOUND;
+
+		return nullptr;
+	}
+
+	return (HRSRC)&resource->second;
+}
+
+DWORD GetModuleFileName(HINSTANCE module,LPWSTR path,DWORD capacity)
+{
+	char executable_path[4096];
+	ssize_t length;
+	std::wstring wide_path;
+
+
+	CountCall(__func__);
+	if(GetModule(module) != EXECUTABLE_MODULE || capacity == 0 || (length = readlink("/proc/self/exe",executable_path,sizeof(executable_path) - 1)) <= 0)
+	{
+		return 0;
+	}
+	executable_path[length] = 0;
+
+	wide_path.resize(length + 1);
+	wide_path.resize(std::mbstowcs(&wide_path[0],executable_path,wide_path.size()));
+	if(wide_path.length() >= capacity)
+	{
+		wide_path.resize(capacity - 1);
+	}
+	std::wmemcpy(path,wide_path.c_str(),wide_path.length() + 1);
+
+	return (DWORD)wide_path.length();
+}
+
+HMODULE GetModuleHandle(LPCWSTR module_name)
+{
+	CountCall(__func__);
+	return module_name == nullptr ? EXECUTABLE_MODULE : nullptr;
+}
+
+void* GetProcAddress(HMODULE module,const char* name)  //Procedures are exported from the executable, which must be linked to export its symbols.
+{
+	CountCall(__func__);
+	if(GetModule(module) != EXECUTABLE_MODULE)
+	{
+		return nullptr;
+	}
+
+	return dlsym(RTLD_DEFAULT,name);
+}
+
+HGLOBAL LoadResource(HMODULE module,HRSRC resource)
+{
+	CountCall(__func__);
+	(void)module;
+
+	return (HGLOBAL)resource;
+}
+
+int LoadString(HINSTANCE instance,UINT id,LPWSTR buffer,int capacity)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	auto string = strings.find(std::make_pair(GetModule(instance),id));
+	int length;
+
+
+	CountCall(__func__);
+	if(string == strings.end())
+	{
+		last_error = ERROR_RESOURCE_NAME_NOT_FOUND;
+
+		return 0;
+	}
+
+	if(capacity == 0)  //The string is left in place, and a pointer to it given instead.
+	{
+		*(const WCHAR**)buffer = string->second.c_str();
+
+		return (int)string->second.length();
+	}
+
+	length = std::min((int)string->second.length(),capacity - 1);
+	std::wmemcpy(buffer,string->second.c_str(),length);
+	buffer[length] = 0;
+
+	return length;
+}
+
+void* LockResource(HGLOBAL resource)
+{
+	CountCall(__func__);
+	return resource == nullptr ? nullptr : ((Resource*)resource)->data.data();
+}
+
+DWORD SizeofResource(HMODULE module,HRSRC resource)
+{
+	CountCall(__func__);
+	(void)module;
+
+	return resource == nullptr ? 0 : (DWORD)((Resource*)resource)->data.size();
+}
+
+/* Files */
+BOOL CloseHandle(HANDLE handle)
+{
+	CountCall(__func__);
+	return close((int)(LONG_PTR)handle - 1) == 0;
+}
+
+HANDLE CreateFile(LPCWSTR path,DWORD access,DWORD share_mode,void* security,DWORD disposition,DWORD attributes,HANDLE template_file)
+{
+	int flags = 0;
+	int file;
+
+
+	CountCall(__func__);
+	(void)share_mode;
+	(void)security;
+	(void)attributes;
+	(void)template_file;
+
+	if((access & GENERIC_READ) != 0 && (access & GENERIC_WRITE) != 0)
+	{
+		flags = O_RDWR;
+	}
+	else
+	{
+		flags = (access & GENERIC_WRITE) != 0 ? O_WRONLY : O_RDONLY;
+	}
+	if(disposition == CREATE_ALWAYS)
+	{
+		flags |= O_CREAT | O_TRUNC;
+	}
+
+	file = open(GetPath(path).c_str(),flags | O_CLOEXEC,0644);
+	if(file < 0)
+	{
+		last_error = ERROR_FILE_NOT_FOUND;
+
+		return INVALID_HANDLE_VALUE;
+	}
+
+	return (HANDLE)(LONG_PTR)(file + 1);  //Never null, as a descriptor of zero would be.
+}
+
+DWORD GetFileAttributes(LPCWSTR path)
+{
+	struct stat status;
+
+
+	CountCall(__func__);
+	if(stat(GetPath(path).c_str(),&status) != 0)
+	{
+		last_error = ERROR_FILE_NOT_FOUND;
+
+		return INVALID_FILE_ATTRIBUTES;
+	}
+
+	return S_ISDIR(status.st_mode) ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_NORMAL;
+}
+
+BOOL GetFileSizeEx(HANDLE file,LARGE_INTEGER* size)
+{
+	struct stat status;
+
+
+	CountCall(__func__);
+	if(fstat((int)(LONG_PTR)file - 1,&status) != 0)
+	{
+		return FALSE;
+	}
+	size->QuadPart = status.st_size;
+
+	return TRUE;
+}
+
+BOOL ReadFile(HANDLE file,LPVOID buffer,DWORD size,DWORD* read_size,void* overlapped)
+{
+	ssize_t result;
+
+
+	CountCall(__func__);
+	(void)overlapped;
+	result = read((int)(LONG_PTR)file - 1,buffer,size);
+	if(result < 0)
+	{
+		return FALSE;
+	}
+	if(read_size != nullptr)
+	{
+		*read_size = (DWORD)result;
+	}
+
+	return TRUE;
+}
+
+DWORD SetFilePointer(HANDLE file,LONG distance,LONG* distance_high,DWORD method)
+{
+	off_t offset = distance_high != nullptr ? ((off_t)*distance_high << 32) | (DWORD)distance : distance;
+	off_t result = lseek((int)(LONG_PTR)file - 1,offset,method == FILE_BEGIN ? SEEK_SET : method == FILE_CURRENT ? SEEK_CUR : SEEK_END);
+
+
+	CountCall(__func__);
+	if(result < 0)
+	{
+		return INVALID_SET_FILE_POINTER;
+	}
+	if(distance_high != nullptr)
+	{
+		*distance_high = (LONG)(result >> 32);
+	}
+
+	return (DWORD)result;
+}
+
+BOOL WriteFile(HANDLE file,const void* buffer,DWORD size,DWORD* written,void* overlapped)
+{
+	ssize_t result;
+
+
+	CountCall(__func__);
+	(void)overlapped;
+	result = write((int)(LONG_PTR)file - 1,buffer,size);
+	if(result < 0)
+	{
+		return FALSE;
+	}
+	if(written != nullptr)
+	{
+		*written = (DWORD)result;
+	}
+
+	return TRUE;
+}
+
+/* System */
+void DebugBreak()
+{
+	CountCall(__func__);
+	std::raise(SIGTRAP);
+}
+
+DWORD FormatMessage(DWORD flags,const void* source,DWORD message_id,DWORD language,LPWSTR buffer,DWORD size,va_list* arguments)
+{
+	std::wstring message = std::wstring(L"Error ").append(std::to_wstring(message_id)).append(L".");
+	LPWSTR allocated;
+
+
+	CountCall(__func__);
+	(void)source;
+	(void)language;
+	(void)size;
+	(void)arguments;
+	if((flags & FORMAT_MESSAGE_ALLOCATE_BUFFER) == 0)
+	{
+		return 0;
+	}
+
+	allocated = (LPWSTR)std::malloc((message.length() + 1) * sizeof(WCHAR));  //Released with LocalFree.
+	std::wmemcpy(allocated,message.c_str(),message.length() + 1);
+	*(LPWSTR*)buffer = allocated;
+
+	return (DWORD)message.length();
+}
+
+HANDLE GetCurrentProcess()
+{
+	CountCall(__func__);
+	return (HANDLE)(LONG_PTR)-1;
+}
+
+DWORD GetCurrentProcessId()
+{
+	CountCall(__func__);
+	return (DWORD)getpid();
+}
+
+DWORD GetCurrentThreadId()
+{
+	CountCall(__func__);
+	return CurrentThreadId();
+}
+
+DWORD GetLastError()
+{
+	CountCall(__func__);
+	return last_error;
+}
+
+DWORD GetTickCount()
+{
+	CountCall(__func__);
+	return (DWORD)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void InitCommonControls()
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+
+
+	CountCall(__func__);
+	RegisterSystemClasses();
+}
+
+BOOL IsDebuggerPresent()
+{
+	CountCall(__func__);
+	return FALSE;
+}
+
+HLOCAL LocalFree(HLOCAL memory)
+{
+	CountCall(__func__);
+	std::free(memory);
+
+	return nullptr;
+}
+
+int MessageBox(HWND window_handle,LPCWSTR text,LPCWSTR caption,UINT type)  //Nobody is there to answer, so it is answered as if OK had been pressed.
+{
+	CountCall(__func__);
+	(void)window_handle;
+	(void)text;
+	(void)caption;
+	(void)type;
+
+	return IDOK;
+}
+
+void OutputDebugString(LPCWSTR text)  //No debugger is attached to read it.
+{
+	CountCall(__func__);
+	(void)text;
+}
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* count)
+{
+	CountCall(__func__);
+	count->QuadPart = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+
+	return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency)
+{
+	CountCall(__func__);
+	frequency->QuadPart = 1000000000;
+
+	return TRUE;
+}
+
+void SetLastError(DWORD error)
+{
+	CountCall(__func__);
+	last_error = error;
+}
+
+void Sleep(DWORD milliseconds)
+{
+	CountCall(__func__);
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+int lstrcmpi(LPCWSTR first,LPCWSTR second)
+{
+	CountCall(__func__);
+	for(;;++first,++second)
+	{
+		wint_t first_character = std::towlower(*first);
+		wint_t second_character = std::towlower(*second);
+
+
+		if(first_character != second_character || first_character == 0)
+		{
+			return first_character < second_character ? -1 : first_character > second_character ? 1 : 0;
+		}
+	}
+}
+
+LPWSTR lstrcpy(LPWSTR destination,LPCWSTR source)
+{
+	CountCall(__func__);
+	return std::wcscpy(destination,source);
+}
\ No newline at end of file
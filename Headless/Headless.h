@@ -0,0 +1,64 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <cstddef>
+#include <string>
+#include <Windows.h>
+
+
+/**
+ * A stand-in for the parts of Windows the framework uses, so that OS, Layout, Control and the application's own modules can be built, tested and benchmarked on any machine.  Windows, window classes, properties, message queues, timers and painting behave as they do on Windows, from the order of the messages sent while creating and destroying a window to the per-thread queues that messages are posted to and sent across.  Drawing into memory device contexts and DIB sections is real, so a window tree renders through Window::render as it would on Windows, but device contexts of windows draw nothing, text is not drawn at all and images are not decoded.
+ *
+ * Resources are not linked into a module as they are on Windows, and must instead be added through this interface before they are used.
+ */
+namespace Headless
+{
+	/* Function Prototypes */
+	/**
+	 * Adds a resource to a module, replacing any with the same type, identifier and language.
+	 *
+	 * @param
+	 *   module
+	 *     Module to add the resource to, or nullptr for the executable's.
+	 *   type
+	 *     Type of the resource, either a name or an integer resource such as RT_RCDATA.
+	 */
+	void AddResource(HMODULE module,LPCWSTR type,WORD resource_id,const void* data,size_t size,WORD language = MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL));
+
+	/**
+	 * Adds a string to a module's string table, replacing any with the same identifier.
+	 *
+	 * @param
+	 *   module
+	 *     Module to add the string to, or nullptr for the executable's.
+	 */
+	void AddStringResource(HMODULE module,UINT string_id,const std::wstring& text);
+
+	/**
+	 * Gets how many times the calling thread has called a function of the stand-in since it last reset its counts, including the calls the stand-in makes to itself, as InvalidateRect does to RedrawWindow.  Tests use this to check which native calls the framework makes, and how many.
+	 *
+	 * @param
+	 *   function
+	 *     Name of the function, such as "RedrawWindow".
+	 */
+	size_t GetCallCount(const char* function);
+
+	/**
+	 * Gets how many windows exist, over every thread.
+	 */
+	size_t GetWindowCount();
+
+	/**
+	 * Processes every message which is waiting in the calling thread's queue, painting invalidated windows and running timers which are due, without waiting for more to arrive.
+	 *
+	 * @return Returns how many messages were dispatched.
+	 */
+	size_t PumpMessages();
+
+	/**
+	 * Resets the calling thread's counts of the calls it has made to the stand-in.  Calls are only counted on threads which have called this, so that they cost nothing elsewhere, such as in the benchmarks.
+	 */
+	void ResetCallCounts();
+}
+
+#endif
\ No newline at end of file
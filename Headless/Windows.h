@@ -0,0 +1,747 @@
+#ifndef HEADLESS_WINDOWS_H
+#define HEADLESS_WINDOWS_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+
+
+/**
+ * Stand-in for the parts of the Windows API the framework uses, so that it can be built and exercised on machines without Windows (see Headless.h).  Types and constants have the values Windows gives them; WCHAR is the platform's wchar_t, so strings are not UTF-16 here.
+ */
+
+#define CALLBACK
+#define WINAPI
+#define __declspec(attribute)
+
+#define DECLARE_HANDLE(name) struct name##__ { int unused; }; typedef struct name##__* name
+
+
+/* Types */
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef std::uint16_t WORD;
+typedef std::uint32_t DWORD;
+typedef std::int32_t LONG;
+typedef std::uint32_t ULONG;
+typedef long long LONGLONG;
+typedef unsigned long long ULONGLONG;
+typedef unsigned int UINT;
+typedef std::intptr_t INT_PTR;
+typedef std::intptr_t LONG_PTR;
+typedef std::uintptr_t UINT_PTR;
+typedef std::uintptr_t ULONG_PTR;
+typedef UINT_PTR WPARAM;
+typedef LONG_PTR LPARAM;
+typedef LONG_PTR LRESULT;
+typedef WORD ATOM;
+typedef DWORD COLORREF;
+typedef void* LPVOID;
+typedef DWORD* LPDWORD;
+typedef char* LPSTR;
+typedef wchar_t WCHAR;
+typedef WCHAR* LPWSTR;
+typedef const WCHAR* LPCWSTR;
+typedef const WCHAR* LPCTSTR;
+
+typedef void* HANDLE;
+typedef HANDLE HDWP;
+typedef HANDLE HGLOBAL;
+typedef HANDLE HLOCAL;
+typedef HANDLE HMONITOR;
+typedef void* HGDIOBJ;
+DECLARE_HANDLE(HBITMAP);
+DECLARE_HANDLE(HBRUSH);
+DECLARE_HANDLE(HDC);
+DECLARE_HANDLE(HFONT);
+DECLARE_HANDLE(HICON);
+DECLARE_HANDLE(HINSTANCE);
+DECLARE_HANDLE(HMENU);
+DECLARE_HANDLE(HRGN);
+DECLARE_HANDLE(HRSRC);
+DECLARE_HANDLE(HWND);
+typedef HICON HCURSOR;
+typedef HINSTANCE HMODULE;
+
+typedef LRESULT (CALLBACK* WNDPROC)(HWND,UINT,WPARAM,LPARAM);
+typedef void (CALLBACK* TIMERPROC)(HWND,UINT,UINT_PTR,DWORD);
+typedef BOOL (CALLBACK* WNDENUMPROC)(HWND,LPARAM);
+
+typedef union
+{
+	struct
+	{
+		DWORD LowPart;
+		LONG HighPart;
+	};
+	LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+typedef struct
+{
+	LONG x;
+	LONG y;
+} POINT;
+
+typedef struct
+{
+	LONG left;
+	LONG top;
+	LONG right;
+	LONG bottom;
+} RECT, *LPRECT;
+
+typedef struct
+{
+	LONG cx;
+	LONG cy;
+} SIZE;
+
+typedef struct
+{
+	HWND hwnd;
+	UINT message;
+	WPARAM wParam;
+	LPARAM lParam;
+	DWORD time;
+	POINT pt;
+} MSG;
+
+typedef struct
+{
+	HDC hdc;
+	BOOL fErase;
+	RECT rcPaint;
+	BOOL fRestore;
+	BOOL fIncUpdate;
+	BYTE rgbReserved[32];
+} PAINTSTRUCT;
+
+typedef struct
+{
+	UINT cbSize;
+	UINT style;
+	WNDPROC lpfnWndProc;
+	int cbClsExtra;
+	int cbWndExtra;
+	HINSTANCE hInstance;
+	HICON hIcon;
+	HCURSOR hCursor;
+	HBRUSH hbrBackground;
+	LPCWSTR lpszMenuName;
+	LPCWSTR lpszClassName;
+	HICON hIconSm;
+} WNDCLASSEX;
+
+typedef struct
+{
+	LPVOID lpCreateParams;
+	HINSTANCE hInstance;
+	HMENU hMenu;
+	HWND hwndParent;
+	int cy;
+	int cx;
+	int y;
+	int x;
+	LONG style;
+	LPCWSTR lpszName;
+	LPCWSTR lpszClass;
+	DWORD dwExStyle;
+} CREATESTRUCT;
+
+typedef struct
+{
+	HWND hwnd;
+	HWND hwndInsertAfter;
+	int x;
+	int y;
+	int cx;
+	int cy;
+	UINT flags;
+} WINDOWPOS;
+
+typedef struct
+{
+	UINT length;
+	UINT flags;
+	UINT showCmd;
+	POINT ptMinPosition;
+	POINT ptMaxPosition;
+	RECT rcNormalPosition;
+} WINDOWPLACEMENT;
+
+typedef struct
+{
+	DWORD cbSize;
+	RECT rcMonitor;
+	RECT rcWork;
+	DWORD dwFlags;
+} MONITORINFO;
+
+typedef struct
+{
+	UINT cbSize;
+	UINT fMask;
+	int nMin;
+	int nMax;
+	UINT nPage;
+	int nPos;
+	int nTrackPos;
+} SCROLLINFO;
+
+typedef struct
+{
+	DWORD biSize;
+	LONG biWidth;
+	LONG biHeight;
+	WORD biPlanes;
+	WORD biBitCount;
+	DWORD biCompression;
+	DWORD biSizeImage;
+	LONG biXPelsPerMeter;
+	LONG biYPelsPerMeter;
+	DWORD biClrUsed;
+	DWORD biClrImportant;
+} BITMAPINFOHEADER;
+
+typedef struct
+{
+	BYTE rgbBlue;
+	BYTE rgbGreen;
+	BYTE rgbRed;
+	BYTE rgbReserved;
+} RGBQUAD;
+
+typedef struct
+{
+	BITMAPINFOHEADER bmiHeader;
+	RGBQUAD bmiColors[1];
+} BITMAPINFO;
+
+typedef struct
+{
+	DWORD styleOld;
+	DWORD styleNew;
+} STYLESTRUCT;
+
+typedef struct
+{
+	UINT lbStyle;
+	COLORREF lbColor;
+	ULONG_PTR lbHatch;
+} LOGBRUSH;
+
+
+/* Macros */
+#define FALSE 0
+#define TRUE 1
+
+#define GET_WHEEL_DELTA_WPARAM(w_param) ((short)HIWORD(w_param))
+#define GetBValue(color) ((BYTE)((color) >> 16))
+#define GetGValue(color) ((BYTE)((color) >> 8))
+#define GetRValue(color) ((BYTE)(color))
+#define HIWORD(value) ((WORD)((((ULONG_PTR)(value)) >> 16) & 0xFFFF))
+#define IS_INTRESOURCE(resource) ((((ULONG_PTR)(resource)) >> 16) == 0)
+#define LOWORD(value) ((WORD)(((ULONG_PTR)(value)) & 0xFFFF))
+#define MAKEINTATOM(atom) ((LPWSTR)(ULONG_PTR)(WORD)(atom))
+#define MAKEINTRESOURCE(id) ((LPWSTR)(ULONG_PTR)(WORD)(id))
+#define MAKELANGID(primary,sub) ((((WORD)(sub)) << 10) | (WORD)(primary))
+#define MAKELPARAM(low,high) ((LPARAM)(DWORD)((WORD)(low) | ((DWORD)(WORD)(high)) << 16))
+#define MAKEWPARAM(low,high) ((WPARAM)(DWORD)((WORD)(low) | ((DWORD)(WORD)(high)) << 16))
+#define RGB(red,green,blue) ((COLORREF)(((BYTE)(red) | ((WORD)((BYTE)(green)) << 8)) | (((DWORD)(BYTE)(blue)) << 16)))
+
+#define CLR_INVALID ((COLORREF)0xFFFFFFFF)
+#define HWND_BOTTOM ((HWND)1)
+#define HWND_MESSAGE ((HWND)-3)
+#define HWND_NOTOPMOST ((HWND)-2)
+#define HWND_TOP ((HWND)0)
+#define HWND_TOPMOST ((HWND)-1)
+#define IDC_ARROW MAKEINTRESOURCE(32512)
+#define IDI_APPLICATION MAKEINTRESOURCE(32512)
+#define INVALID_FILE_ATTRIBUTES ((DWORD)-1)
+#define INVALID_HANDLE_VALUE ((HANDLE)(LONG_PTR)-1)
+#define INVALID_SET_FILE_POINTER ((DWORD)-1)
+#define RT_RCDATA MAKEINTRESOURCE(10)
+#define RT_STRING MAKEINTRESOURCE(6)
+#define WHEEL_DELTA 120  //An int, as on Windows, so that wheel rotation divided by it keeps its sign.
+
+
+/* Constants */
+enum : DWORD
+{
+	INFINITE = 0xFFFFFFFF,
+	MAXDWORD = 0xFFFFFFFF,
+	MAX_PATH = 260,
+	USER_TIMER_MAXIMUM = 0x7FFFFFFF,
+};
+
+enum : DWORD
+{
+	ERROR_SUCCESS = 0,
+	ERROR_FILE_NOT_FOUND = 2,
+	ERROR_ACCESS_DENIED = 5,
+	ERROR_INVALID_WINDOW_HANDLE = 1400,
+	ERROR_TLW_WITH_WSCHILD = 1406,
+	ERROR_CLASS_ALREADY_EXISTS = 1410,
+	ERROR_CLASS_DOES_NOT_EXIST = 1411,
+	ERROR_CLASS_HAS_WINDOWS = 1412,
+	ERROR_RESOURCE_NAME_NOT_FOUND = 1814,
+};
+
+enum : DWORD
+{
+	WS_OVERLAPPED = 0x00000000,
+	WS_TABSTOP = 0x00010000,
+	WS_MAXIMIZEBOX = 0x00010000,
+	WS_MINIMIZEBOX = 0x00020000,
+	WS_THICKFRAME = 0x00040000,
+	WS_SYSMENU = 0x00080000,
+	WS_HSCROLL = 0x00100000,
+	WS_VSCROLL = 0x00200000,
+	WS_DLGFRAME = 0x00400000,
+	WS_BORDER = 0x00800000,
+	WS_CAPTION = 0x00C00000,
+	WS_MAXIMIZE = 0x01000000,
+	WS_CLIPCHILDREN = 0x02000000,
+	WS_CLIPSIBLINGS = 0x04000000,
+	WS_DISABLED = 0x08000000,
+	WS_VISIBLE = 0x10000000,
+	WS_MINIMIZE = 0x20000000,
+	WS_CHILD = 0x40000000,
+	WS_POPUP = 0x80000000,
+
+	WS_EX_DLGMODALFRAME = 0x00000001,
+	WS_EX_NOPARENTNOTIFY = 0x00000004,
+	WS_EX_TRANSPARENT = 0x00000020,
+	WS_EX_TOOLWINDOW = 0x00000080,
+	WS_EX_WINDOWEDGE = 0x00000100,
+	WS_EX_CLIENTEDGE = 0x00000200,
+	WS_EX_CONTEXTHELP = 0x00000400,
+	WS_EX_LEFTSCROLLBAR = 0x00004000,
+	WS_EX_STATICEDGE = 0x00020000,
+	WS_EX_APPWINDOW = 0x00040000,
+	WS_EX_LAYERED = 0x00080000,
+	WS_EX_LAYOUTRTL = 0x00400000,
+	WS_EX_COMPOSITED = 0x02000000,
+
+	BS_PUSHBUTTON = 0,
+};
+
+enum : UINT
+{
+	WM_NULL = 0x0000,
+	WM_CREATE = 0x0001,
+	WM_DESTROY = 0x0002,
+	WM_MOVE = 0x0003,
+	WM_SIZE = 0x0005,
+	WM_ACTIVATE = 0x0006,
+	WM_SETFOCUS = 0x0007,
+	WM_KILLFOCUS = 0x0008,
+	WM_ENABLE = 0x000A,
+	WM_SETREDRAW = 0x000B,
+	WM_SETTEXT = 0x000C,
+	WM_GETTEXT = 0x000D,
+	WM_PAINT = 0x000F,
+	WM_CLOSE = 0x0010,
+	WM_QUERYENDSESSION = 0x0011,
+	WM_QUIT = 0x0012,
+	WM_ERASEBKGND = 0x0014,
+	WM_ENDSESSION = 0x0016,
+	WM_SHOWWINDOW = 0x0018,
+	WM_SETTINGCHANGE = 0x001A,
+	WM_SETCURSOR = 0x0020,
+	WM_MOUSEACTIVATE = 0x0021,
+	WM_GETMINMAXINFO = 0x0024,
+	WM_NEXTDLGCTL = 0x0028,
+	WM_DRAWITEM = 0x002B,
+	WM_MEASUREITEM = 0x002C,
+	WM_SETFONT = 0x0030,
+	WM_WINDOWPOSCHANGING = 0x0046,
+	WM_WINDOWPOSCHANGED = 0x0047,
+	WM_COPYDATA = 0x004A,
+	WM_NOTIFY = 0x004E,
+	WM_CONTEXTMENU = 0x007B,
+	WM_STYLECHANGING = 0x007C,
+	WM_STYLECHANGED = 0x007D,
+	WM_NCCREATE = 0x0081,
+	WM_NCDESTROY = 0x0082,
+	WM_NCCALCSIZE = 0x0083,
+	WM_NCHITTEST = 0x0084,
+	WM_NCPAINT = 0x0085,
+	WM_GETDLGCODE = 0x0087,
+	WM_KEYDOWN = 0x0100,
+	WM_KEYUP = 0x0101,
+	WM_CHAR = 0x0102,
+	WM_COMMAND = 0x0111,
+	WM_SYSCOMMAND = 0x0112,
+	WM_TIMER = 0x0113,
+	WM_HSCROLL = 0x0114,
+	WM_VSCROLL = 0x0115,
+	WM_CTLCOLORMSGBOX = 0x0132,
+	WM_CTLCOLOREDIT = 0x0133,
+	WM_CTLCOLORLISTBOX = 0x0134,
+	WM_CTLCOLORBTN = 0x0135,
+	WM_CTLCOLORDLG = 0x0136,
+	WM_CTLCOLORSCROLLBAR = 0x0137,
+	WM_CTLCOLORSTATIC = 0x0138,
+	WM_MOUSEMOVE = 0x0200,
+	WM_LBUTTONDOWN = 0x0201,
+	WM_LBUTTONUP = 0x0202,
+	WM_RBUTTONDOWN = 0x0204,
+	WM_RBUTTONUP = 0x0205,
+	WM_MOUSEWHEEL = 0x020A,
+	WM_PARENTNOTIFY = 0x0210,
+	WM_SIZING = 0x0214,
+	WM_CAPTURECHANGED = 0x0215,
+	WM_MOVING = 0x0216,
+	WM_PRINT = 0x0317,
+	WM_PRINTCLIENT = 0x0318,
+	WM_USER = 0x0400,
+	WM_APP = 0x8000,
+};
+
+enum : UINT
+{
+	SIZE_RESTORED = 0,
+	SIZE_MINIMIZED = 1,
+	SIZE_MAXIMIZED = 2,
+
+	HTCLIENT = 1,
+
+	SC_CLOSE = 0xF060,
+};
+
+enum : int
+{
+	GWLP_WNDPROC = -4,
+	GWLP_HINSTANCE = -6,
+	GWLP_HWNDPARENT = -8,
+	GWLP_ID = -12,
+	GWL_STYLE = -16,
+	GWL_EXSTYLE = -20,
+	GWLP_USERDATA = -21,
+
+	GCLP_MENUNAME = -8,
+	GCLP_HBRBACKGROUND = -10,
+	GCLP_HCURSOR = -12,
+	GCLP_HICON = -14,
+	GCLP_HMODULE = -16,
+	GCLP_WNDPROC = -24,
+	GCL_STYLE = -26,
+	GCW_ATOM = -32,
+	GCLP_HICONSM = -34,
+};
+
+enum : UINT
+{
+	CS_VREDRAW = 0x0001,
+	CS_HREDRAW = 0x0002,
+	CS_PARENTDC = 0x0080,
+
+	COLOR_BTNFACE = 15,
+	COLOR_WINDOW = 5,
+	COLOR_WINDOWTEXT = 8,
+
+	GA_PARENT = 1,
+	GW_HWNDFIRST = 0,
+	GW_HWNDLAST = 1,
+	GW_HWNDNEXT = 2,
+	GW_HWNDPREV = 3,
+	GW_OWNER = 4,
+	GW_CHILD = 5,
+
+	CWP_ALL = 0x0000,
+	CWP_SKIPINVISIBLE = 0x0001,
+	CWP_SKIPDISABLED = 0x0002,
+	CWP_SKIPTRANSPARENT = 0x0004,
+
+	SW_HIDE = 0,
+	SW_SHOWNORMAL = 1,
+	SW_SHOWMINIMIZED = 2,
+	SW_SHOWMAXIMIZED = 3,
+	SW_MAXIMIZE = 3,
+	SW_SHOWNOACTIVATE = 4,
+	SW_SHOW = 5,
+	SW_MINIMIZE = 6,
+	SW_SHOWNA = 8,
+	SW_RESTORE = 9,
+
+	SWP_NOSIZE = 0x0001,
+	SWP_NOMOVE = 0x0002,
+	SWP_NOZORDER = 0x0004,
+	SWP_NOREDRAW = 0x0008,
+	SWP_NOACTIVATE = 0x0010,
+	SWP_FRAMECHANGED = 0x0020,
+	SWP_SHOWWINDOW = 0x0040,
+	SWP_HIDEWINDOW = 0x0080,
+	SWP_NOOWNERZORDER = 0x0200,
+
+	RDW_INVALIDATE = 0x0001,
+	RDW_INTERNALPAINT = 0x0002,
+	RDW_ERASE = 0x0004,
+	RDW_VALIDATE = 0x0008,
+	RDW_NOERASE = 0x0020,
+	RDW_NOCHILDREN = 0x0040,
+	RDW_ALLCHILDREN = 0x0080,
+	RDW_UPDATENOW = 0x0100,
+	RDW_ERASENOW = 0x0200,
+	RDW_FRAME = 0x0400,
+
+	SB_HORZ = 0,
+	SB_VERT = 1,
+	SB_LINEUP = 0,
+	SB_LINEDOWN = 1,
+	SB_PAGEUP = 2,
+	SB_PAGEDOWN = 3,
+	SB_THUMBPOSITION = 4,
+	SB_THUMBTRACK = 5,
+	SB_TOP = 6,
+	SB_BOTTOM = 7,
+	SIF_RANGE = 0x0001,
+	SIF_PAGE = 0x0002,
+	SIF_POS = 0x0004,
+	SIF_TRACKPOS = 0x0010,
+	SIF_ALL = 0x0017,
+
+	VK_TAB = 0x09,
+	VK_RETURN = 0x0D,
+	VK_SHIFT = 0x10,
+	VK_SPACE = 0x20,
+
+	PM_NOREMOVE = 0x0000,
+	PM_REMOVE = 0x0001,
+
+	MB_OK = 0x0000,
+	MB_ICONERROR = 0x0010,
+	IDOK = 1,
+
+	FORMAT_MESSAGE_ALLOCATE_BUFFER = 0x0100,
+	FORMAT_MESSAGE_IGNORE_INSERTS = 0x0200,
+	FORMAT_MESSAGE_FROM_SYSTEM = 0x1000,
+
+	BI_RGB = 0,
+	BS_SOLID = 0,
+	DIB_RGB_COLORS = 0,
+	SRCCOPY = 0x00CC0020,
+	TRANSPARENT = 1,
+	OPAQUE = 2,
+	DT_LEFT = 0x0000,
+	DT_CENTER = 0x0001,
+	DT_VCENTER = 0x0004,
+	DT_SINGLELINE = 0x0020,
+	PRF_NONCLIENT = 0x0002,
+	PRF_CLIENT = 0x0004,
+	PRF_ERASEBKGND = 0x0008,
+	PRF_CHILDREN = 0x0010,
+
+	IMAGE_BITMAP = 0,
+	IMAGE_ICON = 1,
+	IMAGE_CURSOR = 2,
+	LR_DEFAULTSIZE = 0x0040,
+	LR_SHARED = 0x8000,
+	SM_CXSCREEN = 0,
+	SM_CYSCREEN = 1,
+	SM_CXICON = 11,
+	SM_CYICON = 12,
+	SM_CXSMICON = 49,
+	SM_CYSMICON = 50,
+
+	OBJ_BRUSH = 2,
+	OBJ_DC = 3,
+	OBJ_BITMAP = 7,
+	OBJ_MEMDC = 10,
+	ERROR = 0,
+	NULLREGION = 1,
+	SIMPLEREGION = 2,
+
+	GR_GDIOBJECTS = 0,
+	GR_USEROBJECTS = 1,
+
+	LWA_ALPHA = 0x0002,
+	MONITOR_DEFAULTTONEAREST = 0x0002,
+	MONITORINFOF_PRIMARY = 0x0001,
+
+	LANG_NEUTRAL = 0x00,
+	LANG_ENGLISH = 0x09,
+	SUBLANG_NEUTRAL = 0x00,
+	SUBLANG_DEFAULT = 0x01,
+};
+
+enum : DWORD
+{
+	GENERIC_WRITE = 0x40000000,
+	GENERIC_READ = 0x80000000,
+	FILE_SHARE_READ = 0x00000001,
+	CREATE_ALWAYS = 2,
+	OPEN_EXISTING = 3,
+	FILE_ATTRIBUTE_DIRECTORY = 0x00000010,
+	FILE_ATTRIBUTE_NORMAL = 0x00000080,
+	FILE_BEGIN = 0,
+	FILE_CURRENT = 1,
+	FILE_END = 2,
+};
+
+
+/* Function Prototypes */
+/* Windows */
+HWND ChildWindowFromPointEx(HWND parent_handle,POINT point,UINT flags);
+HWND CreateWindowEx(DWORD style_extended,LPCWSTR class_name,LPCWSTR window_name,DWORD style,int x,int y,int width,int height,HWND parent_handle,HMENU menu,HINSTANCE instance,LPVOID parameter);
+BOOL DestroyWindow(HWND window_handle);
+BOOL EnableWindow(HWND window_handle,BOOL enable);
+BOOL EnumChildWindows(HWND parent_handle,WNDENUMPROC callback,LPARAM parameter);
+BOOL EnumThreadWindows(DWORD thread_id,WNDENUMPROC callback,LPARAM parameter);
+HWND GetAncestor(HWND window_handle,UINT flags);
+BOOL GetClientRect(HWND window_handle,LPRECT rectangle);
+HWND GetFocus();
+BOOL GetLayeredWindowAttributes(HWND window_handle,COLORREF* key,BYTE* alpha,DWORD* flags);
+HWND GetParent(HWND window_handle);
+BOOL GetScrollInfo(HWND window_handle,int bar,SCROLLINFO* information);
+BOOL GetUpdateRect(HWND window_handle,LPRECT rectangle,BOOL erase);
+HWND GetWindow(HWND window_handle,UINT relationship);
+LONG_PTR GetWindowLongPtr(HWND window_handle,int index);
+BOOL GetWindowPlacement(HWND window_handle,WINDOWPLACEMENT* placement);
+BOOL GetWindowRect(HWND window_handle,LPRECT rectangle);
+int GetWindowText(HWND window_handle,LPWSTR text,int capacity);
+int GetWindowTextLength(HWND window_handle);
+DWORD GetWindowThreadProcessId(HWND window_handle,LPDWORD process_id);
+BOOL InvalidateRect(HWND window_handle,const RECT* rectangle,BOOL erase);
+BOOL IsIconic(HWND window_handle);
+BOOL IsWindow(HWND window_handle);
+BOOL IsWindowEnabled(HWND window_handle);
+BOOL IsWindowVisible(HWND window_handle);
+BOOL IsZoomed(HWND window_handle);
+int MapWindowPoints(HWND from,HWND to,POINT* points,UINT count);
+BOOL MoveWindow(HWND window_handle,int x,int y,int width,int height,BOOL repaint);
+BOOL RedrawWindow(HWND window_handle,const RECT* rectangle,HRGN region,UINT flags);
+BOOL ScreenToClient(HWND window_handle,POINT* point);
+HWND SetFocus(HWND window_handle);
+BOOL SetLayeredWindowAttributes(HWND window_handle,COLORREF key,BYTE alpha,DWORD flags);
+HWND SetParent(HWND window_handle,HWND parent_handle);
+int SetScrollInfo(HWND window_handle,int bar,const SCROLLINFO* information,BOOL redraw);
+LONG_PTR SetWindowLongPtr(HWND window_handle,int index,LONG_PTR value);
+BOOL SetWindowPlacement(HWND window_handle,const WINDOWPLACEMENT* placement);
+BOOL SetWindowPos(HWND window_handle,HWND insert_after,int x,int y,int width,int height,UINT flags);
+BOOL SetWindowText(HWND window_handle,LPCWSTR text);
+BOOL ShowWindow(HWND window_handle,int command);
+BOOL UpdateWindow(HWND window_handle);
+BOOL ValidateRect(HWND window_handle,const RECT* rectangle);
+HDWP BeginDeferWindowPos(int count);
+HDWP DeferWindowPos(HDWP positions,HWND window_handle,HWND insert_after,int x,int y,int width,int height,UINT flags);
+BOOL EndDeferWindowPos(HDWP positions);
+
+/* Window classes */
+BOOL GetClassInfoEx(HINSTANCE instance,LPCWSTR class_name,WNDCLASSEX* window_class);
+ULONG_PTR GetClassLongPtr(HWND window_handle,int index);
+int GetClassName(HWND window_handle,LPWSTR class_name,int capacity);
+BOOL RegisterClassEx(const WNDCLASSEX* window_class);
+ULONG_PTR SetClassLongPtr(HWND window_handle,int index,LONG_PTR value);
+BOOL UnregisterClass(LPCWSTR class_name,HINSTANCE instance);
+
+/* Properties */
+HANDLE GetProp(HWND window_handle,LPCWSTR name);
+HANDLE RemoveProp(HWND window_handle,LPCWSTR name);
+BOOL SetProp(HWND window_handle,LPCWSTR name,HANDLE data);
+ATOM GlobalAddAtom(LPCWSTR name);
+ATOM GlobalFindAtom(LPCWSTR name);
+
+/* Messages */
+LRESULT CallWindowProc(WNDPROC procedure,HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param);
+LRESULT DefWindowProc(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param);
+LRESULT DispatchMessage(const MSG* message);
+BOOL GetMessage(MSG* message,HWND window_handle,UINT first,UINT last);
+BOOL KillTimer(HWND window_handle,UINT_PTR id);
+BOOL PeekMessage(MSG* message,HWND window_handle,UINT first,UINT last,UINT flags);
+BOOL PostMessage(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param);
+void PostQuitMessage(int exit_code);
+LRESULT SendMessage(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param);
+UINT_PTR SetTimer(HWND window_handle,UINT_PTR id,UINT elapse,TIMERPROC procedure);
+BOOL TranslateMessage(const MSG* message);
+
+/* Painting and GDI */
+HDC BeginPaint(HWND window_handle,PAINTSTRUCT* paint);
+BOOL BitBlt(HDC destination,int x,int y,int width,int height,HDC source,int source_x,int source_y,DWORD operation);
+HDC CreateCompatibleDC(HDC device_context);
+HBITMAP CreateCompatibleBitmap(HDC device_context,int width,int height);
+HBITMAP CreateDIBSection(HDC device_context,const BITMAPINFO* information,UINT usage,void** bits,HANDLE section,DWORD offset);
+HBRUSH CreateSolidBrush(COLORREF color);
+BOOL DeleteDC(HDC device_context);
+BOOL DeleteObject(HGDIOBJ object);
+BOOL DestroyCursor(HCURSOR cursor);
+BOOL DestroyIcon(HICON icon);
+BOOL DrawFocusRect(HDC device_context,const RECT* rectangle);
+int DrawText(HDC device_context,LPCWSTR text,int length,LPRECT rectangle,UINT format);
+BOOL EndPaint(HWND window_handle,const PAINTSTRUCT* paint);
+int FillRect(HDC device_context,const RECT* rectangle,HBRUSH brush);
+BOOL GdiFlush();
+HDC GetDC(HWND window_handle);
+DWORD GetGuiResources(HANDLE process,DWORD flags);
+int GetObject(HGDIOBJ object,int size,LPVOID description);
+COLORREF GetPixel(HDC device_context,int x,int y);
+COLORREF GetSysColor(int index);
+int GetSystemMetrics(int index);
+int IntersectClipRect(HDC device_context,int left,int top,int right,int bottom);
+HANDLE LoadImage(HINSTANCE instance,LPCWSTR name,UINT type,int width,int height,UINT flags);
+BOOL OffsetViewportOrgEx(HDC device_context,int x,int y,POINT* previous);
+int ReleaseDC(HWND window_handle,HDC device_context);
+BOOL RestoreDC(HDC device_context,int saved);
+int SaveDC(HDC device_context);
+HGDIOBJ SelectObject(HDC device_context,HGDIOBJ object);
+int SetBkMode(HDC device_context,int mode);
+int SetDIBitsToDevice(HDC device_context,int x,int y,DWORD width,DWORD height,int source_x,int source_y,UINT start_scan,UINT scan_count,const void* bits,const BITMAPINFO* information,UINT usage);
+COLORREF SetTextColor(HDC device_context,COLORREF color);
+BOOL SetViewportOrgEx(HDC device_context,int x,int y,POINT* previous);
+
+/* Rectangles */
+BOOL EqualRect(const RECT* first,const RECT* second);
+BOOL IntersectRect(LPRECT destination,const RECT* first,const RECT* second);
+BOOL IsRectEmpty(const RECT* rectangle);
+BOOL OffsetRect(LPRECT rectangle,int x,int y);
+BOOL PtInRect(const RECT* rectangle,POINT point);
+BOOL SetRect(LPRECT rectangle,int left,int top,int right,int bottom);
+BOOL SetRectEmpty(LPRECT rectangle);
+BOOL UnionRect(LPRECT destination,const RECT* first,const RECT* second);
+
+/* Monitors */
+BOOL GetMonitorInfo(HMONITOR monitor,MONITORINFO* information);
+HMONITOR MonitorFromWindow(HWND window_handle,DWORD flags);
+
+/* Modules and resources */
+HRSRC FindResourceEx(HMODULE module,LPCWSTR type,LPCWSTR name,WORD language);
+DWORD GetModuleFileName(HINSTANCE module,LPWSTR path,DWORD capacity);
+HMODULE GetModuleHandle(LPCWSTR module_name);
+void* GetProcAddress(HMODULE module,const char* name);
+HGLOBAL LoadResource(HMODULE module,HRSRC resource);
+int LoadString(HINSTANCE instance,UINT id,LPWSTR buffer,int capacity);
+void* LockResource(HGLOBAL resource);
+DWORD SizeofResource(HMODULE module,HRSRC resource);
+
+/* Files */
+BOOL CloseHandle(HANDLE handle);
+HANDLE CreateFile(LPCWSTR path,DWORD access,DWORD share_mode,void* security,DWORD disposition,DWORD attributes,HANDLE template_file);
+DWORD GetFileAttributes(LPCWSTR path);
+BOOL GetFileSizeEx(HANDLE file,LARGE_INTEGER* size);
+BOOL ReadFile(HANDLE file,LPVOID buffer,DWORD size,DWORD* read,void* overlapped);
+DWORD SetFilePointer(HANDLE file,LONG distance,LONG* distance_high,DWORD method);
+BOOL WriteFile(HANDLE file,const void* buffer,DWORD size,DWORD* written,void* overlapped);
+
+/* System */
+void DebugBreak();
+DWORD FormatMessage(DWORD flags,const void* source,DWORD message_id,DWORD language,LPWSTR buffer,DWORD size,va_list* arguments);
+HANDLE GetCurrentProcess();
+DWORD GetCurrentProcessId();
+DWORD GetCurrentThreadId();
+DWORD GetLastError();
+DWORD GetTickCount();
+BOOL IsDebuggerPresent();
+HLOCAL LocalFree(HLOCAL memory);
+int MessageBox(HWND window_handle,LPCWSTR text,LPCWSTR caption,UINT type);
+void OutputDebugString(LPCWSTR text);
+BOOL QueryPerformanceCounter(LARGE_INTEGER* count);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency);
+void SetLastError(DWORD error);
+void Sleep(DWORD milliseconds);
+int lstrcmpi(LPCWSTR first,LPCWSTR second);
+LPWSTR lstrcpy(LPWSTR destination,LPCWSTR source);
+
+#endif
\ No newline at end of file
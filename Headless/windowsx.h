@@ -0,0 +1,10 @@
+#ifndef HEADLESS_WINDOWSX_H
+#define HEADLESS_WINDOWSX_H
+
+#include <Windows.h>
+
+
+#define GET_X_LPARAM(l_param) ((int)(short)LOWORD(l_param))
+#define GET_Y_LPARAM(l_param) ((int)(short)HIWORD(l_param))
+
+#endif
\ No newline at end of file
@@ -0,0 +1,406 @@
+#include "Layout.h"
+
+#include <algorithm>
+#include <cwchar>
+
+
+namespace OS
+{
+	/* Type [OS::Layout] Definition */
+	Layout::Layout(Window* window)
+	{
+		this->attributes.grow = 0;
+		this->attributes.height = Layout::AUTOMATIC;
+		this->attributes.orientation = Orientation::VERTICAL;
+		this->attributes.padding = 0;
+		this->attributes.spacing = 0;
+		this->attributes.width = Layout::AUTOMATIC;
+
+		this->arrange_valid = false;
+		this->measure_valid = false;
+		this->measured_size.cx = 0;
+		this->measured_size.cy = 0;
+		this->parent = nullptr;
+		SetRectEmpty(&this->rectangle);
+		this->updating = false;
+		this->window = window;
+		this->window_placed = false;
+	}
+
+	Layout::~Layout()
+	{
+		if(this->parent != nullptr)
+		{
+			this->parent->removeChild(this);
+		}
+
+		for(Layout* child : this->children)
+		{
+			child->parent = nullptr;
+		}
+	}
+
+	void Layout::appendChild(Layout* child)
+	{
+		assert(child != nullptr);
+		assert(child != this);
+
+
+		if(child->parent != nullptr)
+		{
+			child->parent->removeChild(child);
+		}
+
+		child->parent = this;
+		this->children.push_back(child);
+		child->invalidate();
+		this->invalidate();  //The child may already have been invalid, in which case invalidating it stopped short of this node.
+	}
+
+	void Layout::arrange(const RECT& rectangle,std::vector<std::pair<Window*,RECT>>& changes)
+	{
+		RECT content_rectangle;
+
+
+		if(this->arrange_valid && EqualRect(&this->rectangle,&rectangle))  //Neither this node nor anything beneath it has changed.
+		{
+			return;
+		}
+
+		if(this->window != nullptr && (!this->window_placed || !EqualRect(&this->rectangle,&rectangle)))  //The ancestors of a node which changed are arranged again, but their windows need not move.
+		{
+			changes.push_back(std::make_pair(this->window,rectangle));
+			this->window_placed = true;
+		}
+		this->rectangle = rectangle;
+		if(this->window != nullptr)
+		{
+			SetRect(&content_rectangle,0,0,rectangle.right - rectangle.left,rectangle.bottom - rectangle.top);  //Children of a window are positioned within its client area.
+		}
+		else
+		{
+			content_rectangle = rectangle;
+		}
+
+		this->arrangeChildren(content_rectangle,changes);
+		this->arrange_valid = true;
+	}
+
+	void Layout::arrangeChildren(const RECT& content_rectangle,std::vector<std::pair<Window*,RECT>>& changes)
+	{
+		bool horizontal = this->attributes.orientation == Orientation::HORIZONTAL;
+		LONG available = horizontal ? content_rectangle.right - content_rectangle.left : content_rectangle.bottom - content_rectangle.top;
+		LONG available_cross = horizontal ? content_rectangle.bottom - content_rectangle.top : content_rectangle.right - content_rectangle.left;
+		LONG distributed = 0;
+		int grow_seen = 0;
+		LONG position = horizontal ? content_rectangle.left : content_rectangle.top;
+		LONG remaining;
+		int total_grow = 0;
+		LONG used = 0;
+
+
+		for(Layout* child : this->children)
+		{
+			SIZE size = child->measure();
+
+
+			used += (horizontal ? size.cx : size.cy) + 2 * child->attributes.padding;
+			total_grow += child->attributes.grow;
+		}
+		if(!this->children.empty())
+		{
+			used += this->attributes.spacing * (LONG)(this->children.size() - 1);
+		}
+		remaining = available - used;
+
+		for(Layout* child : this->children)
+		{
+			SIZE size = child->measure();
+			LONG main = horizontal ? size.cx : size.cy;
+			LONG cross = horizontal ? child->attributes.height : child->attributes.width;
+			int padding = child->attributes.padding;
+			RECT slot;
+
+
+			if(cross == Layout::AUTOMATIC)
+			{
+				cross = available_cross - 2 * padding;  //Stretch across the parent.
+				if(cross < 0)
+				{
+					cross = 0;
+				}
+			}
+
+			if(remaining > 0 && child->attributes.grow > 0)
+			{
+				LONG share;
+
+
+				grow_seen += child->attributes.grow;
+				share = remaining * grow_seen / total_grow - distributed;  //Computed cumulatively so that rounding never loses a pixel.
+				distributed += share;
+				main += share;
+			}
+
+			position += padding;
+			if(horizontal)
+			{
+				SetRect(&slot,position,content_rectangle.top + padding,position + main,content_rectangle.top + padding + cross);
+			}
+			else
+			{
+				SetRect(&slot,content_rectangle.left + padding,position,content_rectangle.left + padding + cross,position + main);
+			}
+			child->arrange(slot,changes);
+			position += main + padding + this->attributes.spacing;
+		}
+	}
+
+	const std::vector<Layout*>& Layout::getChildren() const
+	{
+		return this->children;
+	}
+
+	Layout* Layout::getParent()
+	{
+		return this->parent;
+	}
+
+	RECT Layout::getRectangle()
+	{
+		return this->rectangle;
+	}
+
+	Window* Layout::getWindow()
+	{
+		return this->window;
+	}
+
+	void Layout::invalidate()
+	{
+		for(Layout* node = this;node != nullptr && (node->measure_valid || node->arrange_valid);node = node->parent)  //An invalid node's ancestors are already invalid.
+		{
+			node->arrange_valid = false;
+			node->measure_valid = false;
+		}
+	}
+
+	SIZE Layout::measure()
+	{
+		bool horizontal = this->attributes.orientation == Orientation::HORIZONTAL;
+		LONG cross = 0;
+		LONG main = 0;
+
+
+		if(this->measure_valid)
+		{
+			return this->measured_size;
+		}
+
+		for(Layout* child : this->children)
+		{
+			SIZE size = child->measure();
+			LONG child_cross = (horizontal ? size.cy : size.cx) + 2 * child->attributes.padding;
+
+
+			main += (horizontal ? size.cx : size.cy) + 2 * child->attributes.padding;
+			if(child_cross > cross)
+			{
+				cross = child_cross;
+			}
+		}
+		if(!this->children.empty())
+		{
+			main += this->attributes.spacing * (LONG)(this->children.size() - 1);
+		}
+
+		this->measured_size.cx = this->attributes.width != Layout::AUTOMATIC ? this->attributes.width : (horizontal ? main : cross);
+		this->measured_size.cy = this->attributes.height != Layout::AUTOMATIC ? this->attributes.height : (horizontal ? cross : main);
+		this->measure_valid = true;
+
+		return this->measured_size;
+	}
+
+	void Layout::removeChild(Layout* child)
+	{
+		assert(child != nullptr);
+		assert(child->parent == this);
+
+
+		this->children.erase(std::remove(this->children.begin(),this->children.end(),child),this->children.end());
+		child->parent = nullptr;
+		this->invalidate();
+	}
+
+	void Layout::setAttribute(const wchar* name,const wchar* value)
+	{
+		assert(name != nullptr);
+		assert(value != nullptr);
+
+
+		std::wstring attribute(name);
+		int number = std::wstring(value) == L"auto" ? Layout::AUTOMATIC : (int)std::wcstol(value,nullptr,10);
+
+
+		if(attribute == L"grow")
+		{
+			this->setGrow(number);
+		}
+		else if(attribute == L"height")
+		{
+			this->setHeight(number);
+		}
+		else if(attribute == L"orientation")
+		{
+			this->setOrientation(std::wstring(value) == L"horizontal" ? Orientation::HORIZONTAL : Orientation::VERTICAL);
+		}
+		else if(attribute == L"padding")
+		{
+			this->setPadding(number);
+		}
+		else if(attribute == L"spacing")
+		{
+			this->setSpacing(number);
+		}
+		else if(attribute == L"width")
+		{
+			this->setWidth(number);
+		}
+	}
+
+	void Layout::setAttribute(const std::wstring& name,const std::wstring& value)
+	{
+		this->setAttribute(name.c_str(),value.c_str());
+	}
+
+	void Layout::setGrow(int grow)
+	{
+		if(this->attributes.grow != grow)
+		{
+			this->attributes.grow = grow;
+			this->invalidate();
+		}
+	}
+
+	void Layout::setHeight(int height)
+	{
+		if(this->attributes.height != height)
+		{
+			this->attributes.height = height;
+			this->invalidate();
+		}
+	}
+
+	void Layout::setOrientation(Orientation orientation)
+	{
+		if(this->attributes.orientation != orientation)
+		{
+			this->attributes.orientation = orientation;
+			this->invalidate();
+		}
+	}
+
+	void Layout::setPadding(int padding)
+	{
+		if(this->attributes.padding != padding)
+		{
+			this->attributes.padding = padding;
+			this->invalidate();
+		}
+	}
+
+	void Layout::setSpacing(int spacing)
+	{
+		if(this->attributes.spacing != spacing)
+		{
+			this->attributes.spacing = spacing;
+			this->invalidate();
+		}
+	}
+
+	void Layout::setWidth(int width)
+	{
+		if(this->attributes.width != width)
+		{
+			this->attributes.width = width;
+			this->invalidate();
+		}
+	}
+
+	void Layout::update()
+	{
+		std::map<HWND,std::vector<std::pair<Window*,RECT>>> batches;
+		std::vector<std::pair<Window*,RECT>> changes;
+		RECT content_rectangle;
+		Layout* root = this;
+
+
+		while(root->parent != nullptr)
+		{
+			root = root->parent;
+		}
+
+		if(root->updating)  //Resizing the root's window below sends WM_SIZE, which would otherwise lay the tree out again.
+		{
+			return;
+		}
+		root->updating = true;
+
+		if(!root->measure_valid)
+		{
+			root->measure();
+
+			if(root->window != nullptr && (root->attributes.width != Layout::AUTOMATIC || root->attributes.height != Layout::AUTOMATIC))
+			{
+				root->window->setDimensions(
+					root->attributes.width != Layout::AUTOMATIC ? root->attributes.width : root->window->getWidth(),
+					root->attributes.height != Layout::AUTOMATIC ? root->attributes.height : root->window->getHeight()
+				);
+			}
+		}
+
+		if(root->window != nullptr)
+		{
+			content_rectangle = root->window->getRectangle(true);
+		}
+		else
+		{
+			SetRect(&content_rectangle,0,0,root->measured_size.cx,root->measured_size.cy);
+		}
+		root->rectangle = content_rectangle;
+
+		if(!root->arrange_valid)
+		{
+			root->arrangeChildren(content_rectangle,changes);
+			root->arrange_valid = true;
+		}
+
+		/* Apply the new geometry, batching the windows which share a parent into a single deferred update. */
+		for(auto& change : changes)
+		{
+			if(change.first->isRealized())
+			{
+				batches[GetAncestor(change.first->getNativeHandle(),GA_PARENT)].push_back(change);
+			}
+			else
+			{
+				change.first->setPosition(change.second.left,change.second.top);
+				change.first->setDimensions(change.second.right - change.second.left,change.second.bottom - change.second.top);
+			}
+		}
+
+		for(auto& batch : batches)
+		{
+			HDWP positions = BeginDeferWindowPos((int)batch.second.size());
+
+
+			for(auto& change : batch.second)
+			{
+				positions = DeferWindowPos(positions,change.first->getNativeHandle(),nullptr,change.second.left,change.second.top,change.second.right - change.second.left,change.second.bottom - change.second.top,SWP_NOZORDER | SWP_NOACTIVATE);
+			}
+			EndDeferWindowPos(positions);
+		}
+
+		root->updating = false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "OS.h"
+
+#include <utility>
+#include <vector>
+
+
+namespace OS
+{
+	/* Class Prototypes */
+	/**
+	 * Node of a stack layout tree.  Each node stacks its children along one axis and stretches them along the other, computing their geometry from the same attributes used by the UI descriptions (width, height, padding) plus orientation, spacing and grow.  Padding is the space kept around a node within its parent.
+	 *
+	 * Changing an attribute only marks the node and its ancestors as dirty; the next call to update re-measures the dirty nodes, re-arranges only the subtrees whose geometry actually changed and applies the resulting window geometry in one deferred batch per parent window.
+	 */
+	class Layout
+	{
+		friend class Window;
+
+		public:
+			enum class Orientation
+			{
+				HORIZONTAL,
+				VERTICAL,
+			};
+
+			static const int AUTOMATIC = -1;
+
+		private:
+			struct
+			{
+				int grow;
+				int height;
+				Orientation orientation;
+				int padding;
+				int spacing;
+				int width;
+			} attributes;
+
+			bool arrange_valid;
+			std::vector<Layout*> children;
+			bool measure_valid;
+			SIZE measured_size;
+			Layout* parent;
+			RECT rectangle;  //Relative to the client area of the nearest ancestor that has a window.
+			bool updating;
+			Window* window;
+			bool window_placed;  //Whether the window has been given a rectangle computed for this node.
+
+		private:
+			void arrange(const RECT& rectangle,std::vector<std::pair<Window*,RECT>>& changes);
+
+			void arrangeChildren(const RECT& content_rectangle,std::vector<std::pair<Window*,RECT>>& changes);
+
+			SIZE measure();
+
+		public:
+			Layout(Window* window = nullptr);
+
+			~Layout();
+
+			void appendChild(Layout* child);
+
+			const std::vector<Layout*>& getChildren() const;
+
+			Layout* getParent();
+
+			/**
+			 * Gets the rectangle most recently computed for this node, relative to the client area of the nearest ancestor that has a window.
+			 */
+			RECT getRectangle();
+
+			Window* getWindow();
+
+			/**
+			 * Marks this node and its ancestors as needing to be laid out again.
+			 */
+			void invalidate();
+
+			void removeChild(Layout* child);
+
+			/**
+			 * Sets an attribute from its textual form, as found in a UI description.  Recognized attributes are width, height, padding, spacing, grow and orientation ("horizontal" or "vertical"); any other attribute is ignored so that all of an element's attributes may be passed through.
+			 */
+			void setAttribute(const wchar* name,const wchar* value);
+
+			void setAttribute(const std::wstring& name,const std::wstring& value);
+
+			void setGrow(int grow);
+
+			void setHeight(int height);
+
+			void setOrientation(Orientation orientation);
+
+			void setPadding(int padding);
+
+			void setSpacing(int spacing);
+
+			void setWidth(int width);
+
+			/**
+			 * Lays out the tree this node belongs to, starting from its root.  If the root has a window, the root's width and height attributes are applied to that window when they change, and its children are arranged within the window's client area.
+			 */
+			void update();
+	};
+}
+
+#endif
\ No newline at end of file
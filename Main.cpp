@@ -1,4 +1,8 @@
+#pragma comment(lib,"shell32.lib")
+
 #include "Application.h"
+#include <shellapi.h>
+#include "Trace.h"
 
 
 /* Main */
@@ -6,16 +10,57 @@ int WINAPI WinMain(HINSTANCE m,HINSTANCE p,LPSTR command_line,int show_command)
 {
 	OS::Module application_module(m);
 	int exit_code;
+	wchar** arguments;
+	int argument_count;
+	std::wstring record_path;
+	std::wstring replay_path;
 
 
 	Application::module = new OS::Module(m);
 
-	Application::Load();
-	Application::Execute();
-	Application::Unload();
-	exit_code = Application::GetExitCode();
+	/* "/record <log>" writes every message handled to a log; "/replay <log>" sends a log's messages to the windows instead of showing them. */
+	arguments = CommandLineToArgvW(GetCommandLineW(),&argument_count);
+	for(int index = 1;arguments != nullptr && index + 1 < argument_count;++index)
+	{
+		if(lstrcmpi(arguments[index],L"/record") == 0)
+		{
+			record_path = arguments[++index];
+		}
+		else if(lstrcmpi(arguments[index],L"/replay") == 0)
+		{
+			replay_path = arguments[++index];
+		}
+	}
+	LocalFree(arguments);
+
+	{
+		TRACE_SCOPE("WinMain");
+
+
+		if(!record_path.empty())
+		{
+			OS::StartMessageRecording(record_path.c_str());
+		}
+
+		Application::Load();
+		if(replay_path.empty())
+		{
+			Application::Execute();
+		}
+		else
+		{
+			Application::Replay(replay_path);
+		}
+		OS::StopMessageRecording();
+		Application::Unload();
+		exit_code = Application::GetExitCode();
+	}
 
 	delete Application::module;
 
+#if TRACING_ENABLED
+	Trace::WriteChromeTrace(L"Startup.trace.json");
+#endif
+
 	return exit_code;
 }
\ No newline at end of file
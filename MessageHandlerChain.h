@@ -0,0 +1,62 @@
+#ifndef MESSAGE_HANDLER_CHAIN_H
+#define MESSAGE_HANDLER_CHAIN_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <Windows.h>
+
+
+namespace OS
+{
+	/* Class Prototypes */
+	template<typename Subject>
+	struct MessageHandlerChain  //A handler followed by the handlers extending it, called in turn rather than through nested closures.  Copies share the handlers, which are never changed once shared.
+	{
+		struct Handlers
+		{
+			std::function<LRESULT(Subject*,WPARAM,LPARAM)> handler;
+			std::vector<std::function<void(Subject*,WPARAM,LPARAM)>> extensions;
+		};
+
+		std::shared_ptr<const Handlers> handlers;
+
+		LRESULT operator()(Subject* subject,WPARAM w_param,LPARAM l_param) const
+		{
+			LRESULT result = this->handlers->handler(subject,w_param,l_param);
+
+
+			for(const auto& extension : this->handlers->extensions)
+			{
+				extension(subject,w_param,l_param);
+			}
+
+			return result;
+		}
+	};
+
+	/* Function Definitions */
+	template<typename Subject>
+	std::function<LRESULT(Subject*,WPARAM,LPARAM)> ExtendMessageHandler(const std::function<LRESULT(Subject*,WPARAM,LPARAM)>& previous_handler,const std::function<void(Subject*,WPARAM,LPARAM)>& handler)
+	{
+		const MessageHandlerChain<Subject>* previous_chain = previous_handler.template target<MessageHandlerChain<Subject>>();
+		std::shared_ptr<typename MessageHandlerChain<Subject>::Handlers> handlers = std::make_shared<typename MessageHandlerChain<Subject>::Handlers>();
+		MessageHandlerChain<Subject> chain;
+
+
+		if(previous_chain != nullptr)
+		{
+			*handlers = *previous_chain->handlers;
+		}
+		else
+		{
+			handlers->handler = previous_handler;
+		}
+		handlers->extensions.push_back(handler);
+		chain.handlers = handlers;
+
+		return chain;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -1,16 +1,314 @@
 #include "OS.h"
 
+#include "Compression.h"
+#include "Control.h"
+#include "Layout.h"
+#include "MessageHandlerChain.h"
+#include "Statistics.h"
+#include "Trace.h"
+#include "VirtualList.h"
+#include "XML.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cwchar>
 #include <cwctype>
+#include <deque>
+#include <list>
 #include <map>
 #include <string>
+#include <windowsx.h>
 
+#if defined(_MSC_VER)
+	#define OS_THREAD_LOCAL __declspec(thread)
+#else
+	#define OS_THREAD_LOCAL thread_local
+#endif
+
+using OS::Control;
+using OS::Layout;
 using OS::RuntimeException;
+using OS::VirtualList;
 using OS::Window;
 using OS::WindowClass;
 
 namespace OS
 {
-	std::map<std::wstring,WindowClass*> window_class_by_name;
+	std::atomic<size_t> back_buffer_budget(64 * 1024 * 1024);
+	std::atomic<size_t> back_buffer_usage(0);  //By the windows of every thread.
+	std::unordered_map<COLORREF,HBRUSH> cached_brushes;
+	std::unordered_map<std::wstring,HANDLE> cached_images;  //Keyed by OS::GetImageCacheKey.
+
+	typedef std::map<UINT,MessageHandler> MessageHandlerTable;
+	typedef std::map<std::wstring,WindowClass*> WindowClassTable;
+
+	struct SharedTableReader  //One per thread which has read a shared table; never freed, as a thread may end while a table is being retired.
+	{
+		std::atomic<std::uint64_t> epoch;  //Epoch in which the thread's current read began, or 0 while it is not reading.
+		unsigned depth;  //Nesting of OS::SharedTableRead scopes; only the owning thread touches it.
+	};
+
+	struct SharedTableRead  //Keeps every shared table seen within its scope from being freed, without taking a lock.
+	{
+		SharedTableRead();
+
+		~SharedTableRead();
+	};
+
+	struct RetiredSharedTable
+	{
+		std::uint64_t epoch;  //Readers which began before this epoch may still see the table.
+		std::function<void()> release;
+	};
+
+	std::atomic<std::uint64_t> shared_table_epoch(1);
+	std::vector<SharedTableReader*> shared_table_readers;
+	std::vector<RetiredSharedTable> retired_shared_tables;
+	std::mutex shared_table_readers_mutex;  //Guards the two above.
+	OS_THREAD_LOCAL SharedTableReader* current_shared_table_reader = nullptr;
+
+	std::atomic<const WindowClassTable*> window_class_by_name(new WindowClassTable());  //Read within an OS::SharedTableRead and replaced through OS::PublishSharedTable.
+	std::recursive_mutex window_class_registration_mutex;  //Serializes registering and unregistering classes, which may destroy windows whose handlers register classes in turn.
+	OS_THREAD_LOCAL Window* realizing_window = nullptr;  //Adopted by OS::WindowClass::manage for the handle being created, instead of a new object.
+
+	struct ResourceKey
+	{
+		HINSTANCE module;
+		std::wstring type;  //Integer types are written as "#<id>".
+		WORD id;
+		WORD language;
+
+		bool operator==(const ResourceKey& other) const
+		{
+			return this->module == other.module && this->id == other.id && this->language == other.language && this->type == other.type;
+		}
+	};
+
+	struct ResourceKeyHash
+	{
+		size_t operator()(const ResourceKey& key) const
+		{
+			return std::hash<std::wstring>()(key.type) ^ std::hash<ULONG_PTR>()((ULONG_PTR)key.module) ^ ((size_t)key.id << 16 | key.language);
+		}
+	};
+
+	std::map<HINSTANCE,ResourcePack*> resource_packs;
+	struct IndexedResource
+	{
+		HRSRC location;
+		ResourcePack::Entry stored;
+	};
+
+	std::unordered_map<ResourceKey,IndexedResource,ResourceKeyHash> resource_index;
+	std::mutex resource_index_mutex;  //Guards resource_index and resource_packs, which may be consulted while resources are loaded off the UI thread.
+
+	size_t resource_cache_budget = 8 * 1024 * 1024;
+	size_t resource_cache_usage = 0;
+	struct CachedResource
+	{
+		const void* stored_data;
+		std::shared_ptr<const void> data;
+		size_t size;
+	};
+
+	std::list<CachedResource> resource_cache;  //Most recently used first.
+	std::unordered_map<const void*,std::list<CachedResource>::iterator> resource_cache_by_stored_data;
+	std::mutex resource_cache_mutex;
+
+	struct GdiCacheEntry
+	{
+		UINT type;  //IMAGE_BITMAP stands in for brushes.
+		size_t references;
+		bool shared;  //Owned by the system, so never destroyed.
+		COLORREF color;
+		std::wstring key;
+	};
+
+	std::unordered_map<HANDLE,GdiCacheEntry> gdi_cache_entries;
+	size_t gdi_cache_hits = 0;
+	size_t gdi_cache_misses = 0;
+	std::mutex gdi_cache_mutex;  //Guards the GDI object cache, which windows of any thread share.
+
+	struct MessageDispatchScope  //Spans OS::Window::HandleMessage, so that invalidations are flushed once the outermost message being handled returns.
+	{
+		MessageDispatchScope();
+
+		~MessageDispatchScope();
+	};
+
+	OS_THREAD_LOCAL unsigned message_dispatch_depth = 0;  //Nesting of OS::MessageDispatchScope on this thread.
+
+	struct MessageLatencySlot
+	{
+		std::atomic<Statistics::Histogram*> histogram;  //Published last, once the rest of the slot is filled in; only the owning thread writes the slot.
+		UINT message;
+		const WindowClass* window_class;
+		std::wstring class_name;
+	};
+
+	struct MessageLatencyRecorder  //Times the whole of its scope, so that every return from OS::Window::HandleMessage is measured.
+	{
+		UINT message;
+		const WindowClass* window_class;
+		LONGLONG start;  //0 when not recording.
+
+		MessageLatencyRecorder(UINT message,const WindowClass* window_class);
+
+		~MessageLatencyRecorder();
+	};
+
+	std::vector<MessageLatencySlot*> message_latency_tables;  //One open-addressed table per thread which has recorded a message; never freed, as a thread may end before the statistics are read.
+	std::mutex message_latency_tables_mutex;
+	std::atomic<bool> message_latency_recording(false);
+	UINT_PTR message_latency_dump_timer = 0;
+	OS_THREAD_LOCAL MessageLatencySlot* current_message_latency_table = nullptr;
+
+	struct MessageLogHeader
+	{
+		char magic[4];
+		DWORD version;
+		DWORD message_count;
+		DWORD window_count;
+		DWORD windows_offset;  //Relative to the start of the log.
+		DWORD reserved;
+	};
+
+	struct MessageLogRecord
+	{
+		LONGLONG time;  //Microseconds since recording started.
+		ULONGLONG w_param;  //A window identifier rather than a handle if MESSAGE_LOG_W_PARAM_WINDOW is set.
+		ULONGLONG l_param;
+		DWORD window;  //Windows are numbered from 1 in the order in which they were first seen.
+		UINT message;
+		DWORD flags;
+		DWORD reserved;
+	};
+
+	struct MessageLogWindow  //Followed by the class name and then the window name, as UTF-16 without terminators.
+	{
+		DWORD id;
+		DWORD parent;  //0 for top-level windows.
+		WORD class_name_length;
+		WORD name_length;
+	};
+
+	struct RecordedWindow
+	{
+		DWORD parent;
+		std::wstring class_name;
+		std::wstring name;
+	};
+
+	struct MessageReplay
+	{
+		std::vector<RecordedWindow> windows;  //Indexed by identifier - 1, as are the two below.
+		std::vector<HWND> window_handles;
+		std::vector<bool> resolved;
+		std::set<HWND> claimed;
+	};
+
+	std::atomic<bool> message_recording(false);
+	bool message_recording_describing = false;  //Set while a window's name is read, so that the messages this sends are not recorded.
+	HANDLE message_recording_file = INVALID_HANDLE_VALUE;  //INVALID_HANDLE_VALUE when recording to memory.
+	LONGLONG message_recording_frequency = 0;
+	size_t message_recording_next = 0;  //Slot of the buffer which the next record goes into.
+	std::vector<MessageLogRecord> message_recording_buffer;
+	LONGLONG message_recording_start = 0;
+	DWORD message_recording_thread = 0;
+	bool message_recording_wrapped = false;  //Set once a recording to memory has overwritten its oldest records.
+	DWORD message_recording_written = 0;  //Records already written to the log file.
+	std::unordered_map<HWND,DWORD> recorded_window_ids;
+	std::vector<RecordedWindow> recorded_windows;  //Indexed by identifier - 1.
+
+	std::unordered_map<std::wstring,PropertyId> property_ids;
+	std::vector<std::wstring> property_names;  //Indexed by identifier - 1.
+	std::mutex property_names_mutex;
+
+	std::atomic<ATOM> window_instance_atom(0);
+	std::atomic<unsigned> window_instance_generation(0);  //Advanced whenever a window's instance property is removed, invalidating the lookups remembered by OS::Window::FromHandle.
+	OS_THREAD_LOCAL HWND last_window_handle = nullptr;
+	OS_THREAD_LOCAL Window* last_window = nullptr;
+	OS_THREAD_LOCAL unsigned last_window_generation = 0;
+
+	struct WindowTimer
+	{
+		Window* window;
+		TimerHandler handler;
+		ULONGLONG expiry;  //In milliseconds of the timer clock.
+		UINT interval;
+		bool repeat;
+		bool active;
+		bool firing;  //Set while the handler runs, so that cancelling the timer from its own handler defers freeing it.
+		UINT generation;  //Advanced each time the entry is freed, so that stale identifiers are recognized.
+		size_t slot;  //Slot of the wheel holding the timer, or TIMER_NONE while it is being dispatched.
+		size_t previous;  //Neighbours in the slot, or in the list of free entries.
+		size_t next;
+		size_t window_previous;  //Neighbours among the timers of the same window.
+		size_t window_next;
+	};
+
+	std::atomic<LONGLONG> timer_clock_frequency(0);
+
+	struct WindowAnimation
+	{
+		enum Channel
+		{
+			X,
+			Y,
+			WIDTH,
+			HEIGHT,
+			OPACITY,
+			RED,
+			GREEN,
+			BLUE,
+			CHANNELS
+		};
+
+		enum Group  //Channels animated together, by one call and with one handler.
+		{
+			GEOMETRY,
+			TRANSLUCENCY,
+			BACKGROUND,
+			GROUPS
+		};
+
+		size_t tweens[CHANNELS];  //Index of each channel's tween in animation_timeline, or ANIMATION_NONE if the channel is not being animated.
+		AnimationHandler handlers[GROUPS];
+		double ends[GROUPS];  //In milliseconds of the animation clock.
+	};
+
+	/**
+	 * The state of the windows belonging to one thread.  As on Windows, a window belongs to the thread which created it, and is invalidated, painted, timed and animated from that thread's message loop, so that none of this is shared between threads.
+	 */
+	struct ThreadWindowState
+	{
+		std::list<Window*> back_buffered_windows;  //Most recently painted first.
+		std::vector<Window*> invalidated_windows;
+
+		std::deque<WindowTimer> timers;  //Entries never move, so a handler may set timers while another is being called.
+		size_t free_timers;
+		std::vector<size_t> timer_slots;  //First timer of each slot: 256 of a millisecond each, then three levels of 64 slots, each slot covering a whole rotation of the level below.
+		std::uint64_t timer_occupancy[7];  //Bit per slot which holds any timers, in the same order as the slots.
+		ULONGLONG timer_wheel_time;  //Next millisecond the wheel will process.
+		size_t active_timers;
+		std::unordered_map<Window*,size_t> window_timers;  //First timer of each window which has any.
+		UINT_PTR native_timer;
+		std::uint64_t timers_fired;
+		Statistics::Histogram timer_lateness;  //In microseconds.
+
+		Animation::Timeline animation_timeline;  //Tweens of every window being animated, so that each frame interpolates them all in one pass.
+		std::vector<std::pair<Window*,size_t>> animation_tween_owners;  //Window and channel of each tween, in the timeline's order.
+		UINT_PTR animation_timer;
+		std::unordered_map<Window*,WindowAnimation> window_animations;
+
+		ThreadWindowState();
+	};
+
+	OS_THREAD_LOCAL ThreadWindowState* current_thread_window_state = nullptr;  //Never freed, as a thread may end without any notice which is portable to every toolset.
+
+	std::unordered_map<std::wstring,UIClass*> ui_classes;  //By lowercase name.
+	std::mutex ui_classes_mutex;
 
 	struct WindowPropertyCache
 	{
@@ -19,567 +317,4378 @@ namespace OS
 	};
 
 	/* Constants */
+	const UINT ANIMATION_FRAME_INTERVAL = 16;  //In milliseconds; roughly once per refresh of a 60 Hz display.
+	const size_t ANIMATION_NONE = (size_t)-1;
+	const DWORD FRAME_EXTENDED_STYLES = WS_EX_CLIENTEDGE | WS_EX_CONTEXTHELP | WS_EX_DLGMODALFRAME | WS_EX_LAYOUTRTL | WS_EX_LEFTSCROLLBAR | WS_EX_STATICEDGE | WS_EX_TOOLWINDOW | WS_EX_WINDOWEDGE;
+	const DWORD FRAME_STYLES = WS_BORDER | WS_CHILD | WS_DLGFRAME | WS_HSCROLL | WS_MAXIMIZEBOX | WS_MINIMIZEBOX | WS_POPUP | WS_SYSMENU | WS_THICKFRAME | WS_VSCROLL;  //Those which change a window's non-client area, and only take effect once its frame is recalculated.  WS_MAXIMIZEBOX shares its bit with WS_TABSTOP.
+	const size_t MESSAGE_LATENCY_SLOTS = 1024;  //Per thread; must be a power of two.
+	const DWORD MESSAGE_LOG_L_PARAM_WINDOW = 0x2;
+	const DWORD MESSAGE_LOG_POINTER_PARAMETERS = 0x4;
+	const DWORD MESSAGE_LOG_VERSION = 1;
+	const DWORD MESSAGE_LOG_W_PARAM_WINDOW = 0x1;
+	const size_t MESSAGE_RECORDING_CAPACITY = 8192;  //Records buffered before a batch is written, or kept when recording to memory.
+	const size_t TIMER_GENERATION_SHIFT = 20;  //Identifiers are the entry's index plus one in the low bits, and its generation above them.
+	const size_t TIMER_LEVEL_BITS = 6;
+	const size_t TIMER_LEVELS = 4;
+	const size_t TIMER_NONE = (size_t)-1;
+	const size_t TIMER_SLOT_BITS = 8;
+	const wchar* const UI_CLASS_EVENT_NAMES[] = {L"OnClick",L"OnClose",L"OnCreate",L"OnDestroy"};  //In the order of OS::UIClass::Event, and matched regardless of case.
+	const UINT UI_CLASS_EVENT_MESSAGES[] = {WM_LBUTTONUP,WM_CLOSE,WM_NULL,WM_DESTROY};  //OnCreate handlers are called by OS::UIClass::instantiate rather than for a message.
+	const size_t UI_CLASS_NO_EVENT = (size_t)-1;
 	const wchar* WINDOW_INSTANCE_PROPERTY = L"Window.Instance";
+	const UINT WINDOW_STATE_ANIMATION_DURATION = 200;  //Of animated maximizing, minimizing and restoring, in milliseconds.
 
 	/* Function Definitions */
-	void DisplayErrorMessage()
+	std::wstring GetImageCacheKey(UINT type,HINSTANCE module,const wchar* resource,int size)
 	{
-		DisplayErrorMessage(GetLastError());
+		std::wstring key;
+
+
+		key
+			.append(std::to_wstring(type))
+			.append(L":")
+			.append(std::to_wstring((ULONG_PTR)module))
+			.append(L":")
+			.append(std::to_wstring(size))
+			.append(L":");
+		if(IS_INTRESOURCE(resource))
+		{
+			key.append(L"#").append(std::to_wstring((ULONG_PTR)resource));
+		}
+		else
+		{
+			key.append(resource);
+		}
+
+		return key;
 	}
 
-	void DisplayErrorMessage(DWORD error)
+	std::wstring GetResourceIdentifier(const wchar* identifier)  //Integer identifiers are written as "#<id>", and names in uppercase, as the system compares them without regard to case.
 	{
-		wchar* buffer;
-		std::wstring error_message;
+		std::wstring name;
 
 
-		buffer = nullptr;
-		FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,nullptr,error,MAKELANGID(LANG_ENGLISH,SUBLANG_DEFAULT),(wchar*)&buffer,0,nullptr);
-		error_message
-			.append(L"Error Code:\n")
-			.append(std::to_wstring(error))
-			.append(L"\n\nMessage:\n")
-			.append(buffer);
-		LocalFree(buffer);
+		if(IS_INTRESOURCE(identifier))
+		{
+			return std::wstring(L"#").append(std::to_wstring((ULONG_PTR)identifier));
+		}
 
-		MessageBox(nullptr,error_message.c_str(),L"An Error Has Occured",MB_OK | MB_ICONERROR);
+		name = identifier;
+		for(wchar& character : name)
+		{
+			character = std::towupper(character);
+		}
+
+		return name;
 	}
 
-	int StartMessageLoop()
+	Statistics::Histogram* GetMessageLatencyHistogram(UINT message,const WindowClass* window_class)
 	{
-		MSG message;
+		MessageLatencySlot* table = current_message_latency_table;
+		size_t first_slot = (((size_t)window_class >> 4) ^ (message * 2654435761u)) & (MESSAGE_LATENCY_SLOTS - 1);
 
 
-		while(GetMessage(&message,nullptr,0,0) > 0)
+		if(table == nullptr)
 		{
-			TranslateMessage(&message);
-			DispatchMessage(&message);
+			std::lock_guard<std::mutex> lock(message_latency_tables_mutex);
+
+
+			table = new MessageLatencySlot[MESSAGE_LATENCY_SLOTS];
+			for(size_t slot = 0;slot < MESSAGE_LATENCY_SLOTS;++slot)
+			{
+				table[slot].histogram.store(nullptr,std::memory_order_relaxed);
+			}
+			message_latency_tables.push_back(table);
+			current_message_latency_table = table;
 		}
 
-		return message.wParam;
+		for(size_t probe = 0;probe < MESSAGE_LATENCY_SLOTS;++probe)
+		{
+			MessageLatencySlot& slot = table[(first_slot + probe) & (MESSAGE_LATENCY_SLOTS - 1)];
+			Statistics::Histogram* histogram = slot.histogram.load(std::memory_order_relaxed);
+
+
+			if(histogram == nullptr)
+			{
+				slot.message = message;
+				slot.window_class = window_class;
+				slot.class_name = window_class != nullptr ? window_class->getClassName() : L"";
+				histogram = new Statistics::Histogram;
+				slot.histogram.store(histogram,std::memory_order_release);
+
+				return histogram;
+			}
+
+			if(slot.message == message && slot.window_class == window_class)
+			{
+				return histogram;
+			}
+		}
+
+		return nullptr;  //The table is full; further pairings go unrecorded.
 	}
 
-	void StopMessageLoop(int exit_code)
+	ThreadWindowState& GetThreadWindowState()
 	{
-		PostQuitMessage(exit_code);
+		if(current_thread_window_state == nullptr)
+		{
+			current_thread_window_state = new ThreadWindowState();
+		}
+
+		return *current_thread_window_state;
 	}
 
-	/* Type [OS::RuntimeException] Definition */
-	RuntimeException::RuntimeException()
-	: RuntimeException("A runtime exception has occured.  Use the \"cause\" method to obtain additional information.",GetLastError())
+	void ReclaimSharedTables()  //Frees the retired tables which no reader can still see.  Called with shared_table_readers_mutex held.
 	{
+		std::uint64_t oldest = (std::uint64_t)-1;
+
+
+		for(SharedTableReader* reader : shared_table_readers)
+		{
+			std::uint64_t epoch = reader->epoch.load();
+
+
+			if(epoch != 0 && epoch < oldest)
+			{
+				oldest = epoch;
+			}
+		}
+
+		for(size_t index = 0;index < retired_shared_tables.size();)
+		{
+			if(retired_shared_tables[index].epoch <= oldest)
+			{
+				retired_shared_tables[index].release();
+				std::swap(retired_shared_tables[index],retired_shared_tables.back());
+				retired_shared_tables.pop_back();
+			}
+			else
+			{
+				++index;
+			}
+		}
 	}
 
-	RuntimeException::RuntimeException(const char* information)
-	: RuntimeException(information,GetLastError())
+	/**
+	 * Replaces a table read within OS::SharedTableRead scopes by a changed copy of it.  The replaced table is freed once every reader which could have seen it has left its scope.  Changes to the same table must be serialized by the caller.
+	 */
+	template<typename Table,typename Modifier>
+	void PublishSharedTable(std::atomic<const Table*>& table,Modifier modify)
 	{
+		std::unique_ptr<Table> replacement(new Table(*table.load()));
+		const Table* replaced;
+		RetiredSharedTable retired;
+
+
+		modify(*replacement);
+		replaced = table.exchange(replacement.release());
+
+		retired.epoch = shared_table_epoch.fetch_add(1) + 1;  //A reader which began after this saw the table just published.
+		retired.release = [replaced](){
+			delete replaced;
+		};
+		{
+			std::lock_guard<std::mutex> lock(shared_table_readers_mutex);
+
+
+			retired_shared_tables.push_back(retired);
+			ReclaimSharedTables();
+		}
 	}
-	
-	RuntimeException::RuntimeException(const std::string& information)
-	: RuntimeException(information.c_str(),GetLastError())
+
+	SharedTableRead::SharedTableRead()
 	{
+		SharedTableReader* reader = current_shared_table_reader;
+
+
+		if(reader == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(shared_table_readers_mutex);
+
+
+			reader = new SharedTableReader();
+			reader->epoch.store(0);
+			reader->depth = 0;
+			shared_table_readers.push_back(reader);
+			current_shared_table_reader = reader;
+		}
+
+		if(reader->depth++ == 0)
+		{
+			reader->epoch.store(shared_table_epoch.load());  //Sequentially consistent, so that a writer which sees the reader idle has already published what it reads next.
+		}
 	}
-	
-	RuntimeException::RuntimeException(const char* information,DWORD cause)
-	: std::runtime_error(information)
+
+	SharedTableRead::~SharedTableRead()
 	{
-		this->m_cause = cause;
+		SharedTableReader* reader = current_shared_table_reader;
+
+
+		if(--reader->depth == 0)
+		{
+			reader->epoch.store(0,std::memory_order_release);
+		}
 	}
-	
-	RuntimeException::RuntimeException(const std::string& information,DWORD cause)
-	: RuntimeException(information.c_str(),cause)
+
+	MessageDispatchScope::MessageDispatchScope()
 	{
+		++message_dispatch_depth;
 	}
 
-	DWORD RuntimeException::cause() const
+	MessageDispatchScope::~MessageDispatchScope()
 	{
-		return this->m_cause;
+		if(--message_dispatch_depth == 0 && current_thread_window_state != nullptr && !current_thread_window_state->invalidated_windows.empty())  //Modal loops, such as those of dialogs, menus and moving or sizing a window, dispatch messages without returning to OS::StartMessageLoop.
+		{
+			FlushInvalidations();
+		}
 	}
 
-	/* Type [OS::Module] Definition */
-	Module::Module(HINSTANCE module)
+	MessageLatencyRecorder::MessageLatencyRecorder(UINT message,const WindowClass* window_class)
+	: message(message),window_class(window_class),start(0)
 	{
-		//assert();
+		if(message_latency_recording.load(std::memory_order_relaxed))
+		{
+			LARGE_INTEGER now;
 
 
-		this->module_handle = module;
+			QueryPerformanceCounter(&now);
+			this->start = now.QuadPart;
+		}
 	}
 
-	Module Module::GetCurrent()
+	MessageLatencyRecorder::~MessageLatencyRecorder()
 	{
-		return Module(GetModuleHandle(nullptr));
+		if(this->start != 0)
+		{
+			LARGE_INTEGER now;
+			Statistics::Histogram* histogram = GetMessageLatencyHistogram(this->message,this->window_class);
+
+
+			QueryPerformanceCounter(&now);
+			if(histogram != nullptr)
+			{
+				histogram->record((std::uint64_t)(now.QuadPart - this->start));
+			}
+		}
 	}
 
-	void* Module::getResource(WORD resource_id,const wchar* resource_type,WORD language)
+	ThreadWindowState::ThreadWindowState()
+	: free_timers(TIMER_NONE),timer_wheel_time(0),active_timers(0),native_timer(0),timers_fired(0),animation_timer(0)
 	{
-		return LockResource(LoadResource(*this,this->getResourceLocation(resource_id,resource_type,language)));
+		std::fill(this->timer_occupancy,this->timer_occupancy + 7,(std::uint64_t)0);
 	}
 
-	HRSRC Module::getResourceLocation(WORD resource_id,const wchar* resource_type,WORD language)
+	void CALLBACK DumpMessageLatencyTimerProc(HWND window_handle,UINT message,UINT_PTR timer,DWORD time)
+	{
+		DumpMessageLatencyStatistics();
+	}
+
+	Window* GetWindowInstance(HWND window_handle)
+	{
+		ATOM atom = window_instance_atom.load(std::memory_order_relaxed);
+
+
+		if(atom == 0)  //Looking the property up by atom spares the system from finding the atom of its name on every call.
+		{
+			atom = GlobalAddAtom(WINDOW_INSTANCE_PROPERTY);
+			window_instance_atom.store(atom,std::memory_order_relaxed);
+		}
+
+		return (Window*)GetProp(window_handle,MAKEINTATOM(atom));
+	}
+
+	ULONGLONG GetTimerClock(LONGLONG* microseconds = nullptr)  //Milliseconds of the performance counter, which is finer than the tick count.
+	{
+		LONGLONG frequency = timer_clock_frequency.load(std::memory_order_relaxed);
+		LARGE_INTEGER now;
+		LONGLONG elapsed;
+
+
+		if(frequency == 0)
+		{
+			LARGE_INTEGER queried;
+
+
+			QueryPerformanceFrequency(&queried);
+			frequency = queried.QuadPart;
+			timer_clock_frequency.store(frequency,std::memory_order_relaxed);
+		}
+
+		QueryPerformanceCounter(&now);
+		elapsed = now.QuadPart / frequency * 1000000 + now.QuadPart % frequency * 1000000 / frequency;
+		if(microseconds != nullptr)
+		{
+			*microseconds = elapsed;
+		}
+
+		return (ULONGLONG)(elapsed / 1000);
+	}
+
+	size_t GetTimerLevelSlot(size_t level,ULONGLONG time)  //Slot of a level 1 and up which a time falls into.
+	{
+		size_t shift = TIMER_SLOT_BITS + (level - 1) * TIMER_LEVEL_BITS;
+
+
+		return ((size_t)1 << TIMER_SLOT_BITS) + (level - 1) * ((size_t)1 << TIMER_LEVEL_BITS) + (size_t)((time >> shift) & (((ULONGLONG)1 << TIMER_LEVEL_BITS) - 1));
+	}
+
+	size_t FindOccupiedTimerSlot(size_t first,size_t end)  //Gets the first slot in [first,end) which holds any timers, or TIMER_NONE.
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+
+
+		for(size_t slot = first;slot < end;)
+		{
+			std::uint64_t occupied = thread_state.timer_occupancy[slot / 64] >> (slot % 64);
+
+
+			if(occupied == 0)
+			{
+				slot = (slot / 64 + 1) * 64;
+
+				continue;
+			}
+
+			while((occupied & 1) == 0)
+			{
+				occupied >>= 1;
+				++slot;
+			}
+
+			return slot < end ? slot : TIMER_NONE;
+		}
+
+		return TIMER_NONE;
+	}
+
+	/**
+	 * Gets the first time, no earlier than the given one, at which cascading a level (or one above it) moves any timers.  The time must be a multiple of the span of one of the level's slots.
+	 */
+	ULONGLONG GetNextTimerCascade(size_t level,ULONGLONG time)
 	{
-		HRSRC resource_location = FindResourceEx(*this,resource_type,MAKEINTRESOURCE(resource_id),language);
+		size_t shift = TIMER_SLOT_BITS + (level - 1) * TIMER_LEVEL_BITS;
+		size_t first_slot = GetTimerLevelSlot(level,0);
+		size_t index = (size_t)((time >> shift) & (((ULONGLONG)1 << TIMER_LEVEL_BITS) - 1));
+		ULONGLONG rotation = time & ~((((ULONGLONG)1 << TIMER_LEVEL_BITS) << shift) - 1);
+		ULONGLONG next = (ULONGLONG)-1;
+		size_t slot;
+
+
+		slot = FindOccupiedTimerSlot(first_slot + index,first_slot + ((size_t)1 << TIMER_LEVEL_BITS));
+		if(slot != TIMER_NONE)
+		{
+			next = rotation + ((ULONGLONG)(slot - first_slot) << shift);
+		}
+		else
+		{
+			slot = FindOccupiedTimerSlot(first_slot,first_slot + index);  //Slots before the current one come around again in the next rotation.
+			if(slot != TIMER_NONE)
+			{
+				next = rotation + (((ULONGLONG)1 << TIMER_LEVEL_BITS) << shift) + ((ULONGLONG)(slot - first_slot) << shift);
+			}
+		}
+
+		if(level + 1 < TIMER_LEVELS)  //The level above is cascaded whenever this one wraps around.
+		{
+			ULONGLONG above = GetNextTimerCascade(level + 1,index == 0 ? time : rotation + (((ULONGLONG)1 << TIMER_LEVEL_BITS) << shift));
+
+
+			next = above < next ? above : next;
+		}
+
+		return next;
+	}
+
+	/**
+	 * Gets the next millisecond at which the wheel has anything to do: either a millisecond slot holding timers, or a cascade which moves timers down from a coarser level.  Returns (ULONGLONG)-1 if the wheel is empty.
+	 */
+	ULONGLONG GetNextTimerTime()
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		size_t index = (size_t)(thread_state.timer_wheel_time & 255);
+		ULONGLONG boundary = (thread_state.timer_wheel_time + 255) & ~(ULONGLONG)255;
+		ULONGLONG next = GetNextTimerCascade(1,boundary);
+		ULONGLONG slot_time = (ULONGLONG)-1;
+		size_t slot;
+
+
+		slot = FindOccupiedTimerSlot(index,256);
+		if(slot != TIMER_NONE)
+		{
+			slot_time = (thread_state.timer_wheel_time & ~(ULONGLONG)255) | slot;
+		}
+		else
+		{
+			slot = FindOccupiedTimerSlot(0,index);
+			if(slot != TIMER_NONE)
+			{
+				slot_time = boundary + slot;
+			}
+		}
+
+		return slot_time < next ? slot_time : next;
+	}
+
+	void LinkTimer(size_t timer,size_t slot)
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		WindowTimer& entry = thread_state.timers[timer];
+
+
+		entry.slot = slot;
+		entry.previous = TIMER_NONE;
+		entry.next = thread_state.timer_slots[slot];
+		if(entry.next != TIMER_NONE)
+		{
+			thread_state.timers[entry.next].previous = timer;
+		}
+		thread_state.timer_slots[slot] = timer;
+		thread_state.timer_occupancy[slot / 64] |= (std::uint64_t)1 << (slot % 64);
+	}
+
+	void UnlinkTimer(size_t timer)
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		WindowTimer& entry = thread_state.timers[timer];
+
+
+		if(entry.previous != TIMER_NONE)
+		{
+			thread_state.timers[entry.previous].next = entry.next;
+		}
+		else
+		{
+			thread_state.timer_slots[entry.slot] = entry.next;
+			if(entry.next == TIMER_NONE)
+			{
+				thread_state.timer_occupancy[entry.slot / 64] &= ~((std::uint64_t)1 << (entry.slot % 64));
+			}
+		}
+		if(entry.next != TIMER_NONE)
+		{
+			thread_state.timers[entry.next].previous = entry.previous;
+		}
+		entry.slot = TIMER_NONE;
+	}
+
+	void ScheduleTimer(size_t timer)  //Places a timer in the slot for its expiry relative to the wheel's time; distant timers are cascaded closer as the wheel turns.
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		ULONGLONG expiry = thread_state.timers[timer].expiry > thread_state.timer_wheel_time ? thread_state.timers[timer].expiry : thread_state.timer_wheel_time;
+		ULONGLONG delta = expiry - thread_state.timer_wheel_time;
+
+
+		if(delta < ((ULONGLONG)1 << TIMER_SLOT_BITS))
+		{
+			LinkTimer(timer,(size_t)(expiry & 255));
+
+			return;
+		}
+
+		for(size_t level = 1;level < TIMER_LEVELS;++level)
+		{
+			ULONGLONG span = (ULONGLONG)1 << (TIMER_SLOT_BITS + level * TIMER_LEVEL_BITS);
+
+
+			if(delta < span || level == TIMER_LEVELS - 1)
+			{
+				if(delta >= span)  //Beyond the wheel; re-scheduled from its real expiry once cascaded.
+				{
+					expiry = thread_state.timer_wheel_time + span - 1;
+				}
+				LinkTimer(timer,GetTimerLevelSlot(level,expiry));
+
+				return;
+			}
+		}
+	}
+
+	void FreeTimer(size_t timer)
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		WindowTimer& entry = thread_state.timers[timer];
+
+
+		entry.handler = nullptr;
+		entry.window = nullptr;
+		++entry.generation;
+		entry.next = thread_state.free_timers;
+		thread_state.free_timers = timer;
+	}
+
+	void RemoveTimer(size_t timer)
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		WindowTimer& entry = thread_state.timers[timer];
+
+
+		if(entry.slot != TIMER_NONE)
+		{
+			UnlinkTimer(timer);
+		}
+
+		if(entry.window_previous != TIMER_NONE)
+		{
+			thread_state.timers[entry.window_previous].window_next = entry.window_next;
+		}
+		else if(entry.window_next != TIMER_NONE)
+		{
+			thread_state.window_timers[entry.window] = entry.window_next;
+		}
+		else
+		{
+			thread_state.window_timers.erase(entry.window);
+		}
+		if(entry.window_next != TIMER_NONE)
+		{
+			thread_state.timers[entry.window_next].window_previous = entry.window_previous;
+		}
+
+		entry.active = false;
+		--thread_state.active_timers;
+		if(!entry.firing)
+		{
+			FreeTimer(timer);
+		}
+	}
+
+	void CALLBACK DispatchTimers(HWND window_handle,UINT message,UINT_PTR native,DWORD time);
+
+	void ArmNativeTimer()
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		ULONGLONG now;
+		ULONGLONG next;
+
+
+		if(thread_state.active_timers == 0)
+		{
+			if(thread_state.native_timer != 0)
+			{
+				KillTimer(nullptr,thread_state.native_timer);
+				thread_state.native_timer = 0;
+			}
+
+			return;
+		}
+
+		now = GetTimerClock();
+		next = GetNextTimerTime();
+		if(next == (ULONGLONG)-1)  //Every pending timer is being dispatched, after which the timer is armed again.
+		{
+			return;
+		}
+		thread_state.native_timer = SetTimer(nullptr,thread_state.native_timer,next > now ? (UINT)(next - now) : 0,DispatchTimers);
+	}
+
+	void CALLBACK DispatchTimers(HWND window_handle,UINT message,UINT_PTR native,DWORD time)  //Turns the wheel up to the present and calls the handlers of every timer which came due, as one batch.
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		LONGLONG now_microseconds;
+		ULONGLONG now = GetTimerClock(&now_microseconds);
+		std::vector<std::pair<size_t,UINT>> expired;
+
+
+		if(thread_state.active_timers == 0)  //A native timer message outlived the last timer.
+		{
+			thread_state.timer_wheel_time = now + 1;
+			ArmNativeTimer();
+
+			return;
+		}
+
+		for(;;)
+		{
+			ULONGLONG next = GetNextTimerTime();
+
+
+			if(next > now)
+			{
+				thread_state.timer_wheel_time = now + 1;
+
+				break;
+			}
+
+			thread_state.timer_wheel_time = next;
+			if((next & 255) == 0)
+			{
+				for(size_t level = 1;level < TIMER_LEVELS;++level)
+				{
+					size_t slot = GetTimerLevelSlot(level,next);
+					size_t timer = thread_state.timer_slots[slot];
+
+
+					thread_state.timer_slots[slot] = TIMER_NONE;
+					thread_state.timer_occupancy[slot / 64] &= ~((std::uint64_t)1 << (slot % 64));
+					while(timer != TIMER_NONE)
+					{
+						size_t following = thread_state.timers[timer].next;
+
+
+						ScheduleTimer(timer);
+						timer = following;
+					}
+
+					if((next >> (TIMER_SLOT_BITS + (level - 1) * TIMER_LEVEL_BITS)) % ((ULONGLONG)1 << TIMER_LEVEL_BITS) != 0)  //The level above only turns when this one wraps around.
+					{
+						break;
+					}
+				}
+			}
+
+			while(thread_state.timer_slots[(size_t)(next & 255)] != TIMER_NONE)
+			{
+				size_t timer = thread_state.timer_slots[(size_t)(next & 255)];
+
+
+				UnlinkTimer(timer);
+				expired.push_back(std::make_pair(timer,thread_state.timers[timer].generation));
+			}
+			thread_state.timer_wheel_time = next + 1;
+		}
+
+		for(auto& due : expired)
+		{
+			WindowTimer& entry = thread_state.timers[due.first];
+
+
+			if(!entry.active || entry.generation != due.second)  //Cancelled by a handler called earlier in the batch.
+			{
+				continue;
+			}
+
+			thread_state.timer_lateness.record((std::uint64_t)(now_microseconds - (LONGLONG)entry.expiry * 1000));
+			++thread_state.timers_fired;
+			entry.firing = true;
+			entry.handler(entry.window);
+			entry.firing = false;
+
+			if(!entry.active)
+			{
+				FreeTimer(due.first);
+			}
+			else if(entry.repeat)
+			{
+				entry.expiry += entry.interval;
+				if(entry.expiry <= now)  //Periods missed entirely are skipped rather than fired in a burst.
+				{
+					entry.expiry = now + entry.interval;
+				}
+				ScheduleTimer(due.first);
+			}
+			else
+			{
+				RemoveTimer(due.first);
+			}
+		}
+
+		ArmNativeTimer();
+	}
+
+	void CancelWindowTimers(Window* window)
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		bool cancelled = false;
+
+
+		for(auto first = thread_state.window_timers.find(window);first != thread_state.window_timers.end();first = thread_state.window_timers.find(window))
+		{
+			RemoveTimer(first->second);
+			cancelled = true;
+		}
+
+		if(cancelled)
+		{
+			ArmNativeTimer();
+		}
+	}
+
+	double GetAnimationClock()  //Milliseconds of the timer clock, keeping the fraction so that frames are interpolated for the instant they are run.
+	{
+		LONGLONG microseconds;
+
+
+		GetTimerClock(&microseconds);
+
+		return microseconds / 1000.0;
+	}
+
+	size_t GetAnimationGroup(size_t channel)
+	{
+		if(channel <= WindowAnimation::HEIGHT)
+		{
+			return WindowAnimation::GEOMETRY;
+		}
+
+		return channel == WindowAnimation::OPACITY ? WindowAnimation::TRANSLUCENCY : WindowAnimation::BACKGROUND;
+	}
+
+	bool IsAnimationGroupActive(const WindowAnimation& animation,size_t group)
+	{
+		for(size_t channel = 0;channel < WindowAnimation::CHANNELS;++channel)
+		{
+			if(GetAnimationGroup(channel) == group && animation.tweens[channel] != ANIMATION_NONE)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void StopAnimationGroup(WindowAnimation& animation,size_t group)
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+
+
+		for(size_t channel = 0;channel < WindowAnimation::CHANNELS;++channel)
+		{
+			size_t tween = animation.tweens[channel];
+
+
+			if(GetAnimationGroup(channel) != group || tween == ANIMATION_NONE)
+			{
+				continue;
+			}
+
+			animation.tweens[channel] = ANIMATION_NONE;
+			if(thread_state.animation_timeline.remove(tween) != tween)  //The last tween took the removed one's place.
+			{
+				std::pair<Window*,size_t> moved = thread_state.animation_tween_owners.back();
+
+
+				thread_state.animation_tween_owners[tween] = moved;
+				thread_state.window_animations.find(moved.first)->second.tweens[moved.second] = tween;
+			}
+			thread_state.animation_tween_owners.pop_back();
+		}
+
+		animation.handlers[group] = nullptr;
+	}
+
+	void CALLBACK DispatchAnimationFrame(HWND window_handle,UINT message,UINT_PTR timer,DWORD time)
+	{
+		RunAnimationFrame();
+	}
+
+	void ArmAnimationTimer()  //Runs the frame clock for as long as anything is being animated.
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+
+
+		if(thread_state.window_animations.empty())
+		{
+			if(thread_state.animation_timer != 0)
+			{
+				KillTimer(nullptr,thread_state.animation_timer);
+				thread_state.animation_timer = 0;
+			}
+		}
+		else if(thread_state.animation_timer == 0)
+		{
+			thread_state.animation_timer = SetTimer(nullptr,0,ANIMATION_FRAME_INTERVAL,DispatchAnimationFrame);
+		}
+	}
+
+	void StartAnimation(Window* window,size_t group,const float* from,const float* to,UINT milliseconds,Animation::Easing easing,AnimationHandler handler)  //Only the group's channels of from and to are read; channels already being animated continue from their current value instead.
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		double now = GetAnimationClock();
+		auto inserted = thread_state.window_animations.emplace(window,WindowAnimation());
+		WindowAnimation& animation = inserted.first->second;
+		float start[WindowAnimation::CHANNELS];
+
+
+		if(inserted.second)
+		{
+			std::fill(animation.tweens,animation.tweens + WindowAnimation::CHANNELS,ANIMATION_NONE);
+		}
+
+		for(size_t channel = 0;channel < WindowAnimation::CHANNELS;++channel)
+		{
+			if(GetAnimationGroup(channel) == group)
+			{
+				start[channel] = animation.tweens[channel] != ANIMATION_NONE ? thread_state.animation_timeline.getValue(animation.tweens[channel]) : from[channel];
+			}
+		}
+		StopAnimationGroup(animation,group);
+
+		for(size_t channel = 0;channel < WindowAnimation::CHANNELS;++channel)
+		{
+			if(GetAnimationGroup(channel) == group)
+			{
+				animation.tweens[channel] = thread_state.animation_timeline.add(start[channel],to[channel],now,milliseconds,easing);
+				thread_state.animation_tween_owners.push_back(std::make_pair(window,channel));
+			}
+		}
+		animation.handlers[group] = handler;
+		animation.ends[group] = now + milliseconds;
+
+		ArmAnimationTimer();
+	}
+
+	void StopWindowAnimations(Window* window)
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		auto animation = thread_state.window_animations.find(window);
+
+
+		if(animation == thread_state.window_animations.end())
+		{
+			return;
+		}
+
+		for(size_t group = 0;group < WindowAnimation::GROUPS;++group)
+		{
+			StopAnimationGroup(animation->second,group);
+		}
+		thread_state.window_animations.erase(animation);
+
+		ArmAnimationTimer();
+	}
+
+	COLORREF GetBrushColor(HBRUSH brush)  //The system's window color stands in for brushes which are not solid.
+	{
+		LOGBRUSH description;
+
+
+		if(brush != nullptr && GetObject(brush,sizeof(description),&description) == sizeof(description) && description.lbStyle == BS_SOLID)
+		{
+			return description.lbColor;
+		}
+
+		return GetSysColor(COLOR_WINDOW);
+	}
+
+	RECT GetMaximizedRectangle(HWND window_handle)  //The work area of the window's monitor, or its parent's client area for child windows.
+	{
+		RECT rectangle;
+		MONITORINFO monitor;
+
+
+		if((GetWindowLongPtr(window_handle,GWL_STYLE) & WS_CHILD) != 0)
+		{
+			GetClientRect(GetAncestor(window_handle,GA_PARENT),&rectangle);
+
+			return rectangle;
+		}
+
+		monitor.cbSize = sizeof(monitor);
+		GetMonitorInfo(MonitorFromWindow(window_handle,MONITOR_DEFAULTTONEAREST),&monitor);
+
+		return monitor.rcWork;
+	}
+
+	RECT GetPlacementRectangle(Window* window)  //Bounds in the coordinates taken by DeferWindowPos:  relative to the parent's client area, or to the screen for top-level windows.
+	{
+		RECT rectangle = window->getRectangle();
+
+
+		if(window->isRealized())
+		{
+			MapWindowPoints(nullptr,GetAncestor(window->getNativeHandle(),GA_PARENT),(POINT*)&rectangle,2);
+		}
+
+		return rectangle;
+	}
+
+	BYTE GetWindowOpacity(Window* window)
+	{
+		BYTE opacity;
+		DWORD flags;
+
+
+		if((window->getExtendedStyle() & WS_EX_LAYERED) == 0 || !GetLayeredWindowAttributes(window->getNativeHandle(),nullptr,&opacity,&flags) || (flags & LWA_ALPHA) == 0)
+		{
+			return 255;
+		}
+
+		return opacity;
+	}
+
+	POINT GetWorkspaceOffset(HWND window_handle)  //From the workspace coordinates of a window's placement to screen coordinates.
+	{
+		POINT offset = {0,0};
+		MONITORINFO monitor;
+
+
+		if((GetWindowLongPtr(window_handle,GWL_STYLE) & WS_CHILD) != 0 || (GetWindowLongPtr(window_handle,GWL_EXSTYLE) & WS_EX_TOOLWINDOW) != 0)  //Their placements are in the same coordinates as their positions.
+		{
+			return offset;
+		}
+
+		monitor.cbSize = sizeof(monitor);
+		GetMonitorInfo(MonitorFromWindow(window_handle,MONITOR_DEFAULTTONEAREST),&monitor);
+		offset.x = monitor.rcWork.left - monitor.rcMonitor.left;
+		offset.y = monitor.rcWork.top - monitor.rcMonitor.top;
+
+		return offset;
+	}
+
+	int RoundAnimationValue(float value)
+	{
+		return (int)(value < 0.0f ? value - 0.5f : value + 0.5f);
+	}
+
+	void SetWindowOpacity(Window* window,BYTE opacity)
+	{
+		if((window->getExtendedStyle() & WS_EX_LAYERED) == 0)
+		{
+			window->addExtendedStyle(WS_EX_LAYERED);
+		}
+
+		SetLayeredWindowAttributes(window->getNativeHandle(),0,opacity,LWA_ALPHA);
+	}
+
+	BOOL CALLBACK CollectWindow(HWND window_handle,LPARAM window_handles)
+	{
+		((std::vector<HWND>*)window_handles)->push_back(window_handle);
+
+		return TRUE;
+	}
+
+	DWORD GetRecordedWindowId(HWND window_handle)
+	{
+		auto existing = recorded_window_ids.find(window_handle);
+		HWND parent_handle;
+		RecordedWindow window;
+		wchar text[256];
+		DWORD id;
+
+
+		if(existing != recorded_window_ids.end())
+		{
+			return existing->second;
+		}
+
+		parent_handle = GetParent(window_handle);
+		window.parent = (GetWindowLongPtr(window_handle,GWL_STYLE) & WS_CHILD) != 0 && parent_handle != nullptr ? GetRecordedWindowId(parent_handle) : 0;
+		GetClassName(window_handle,text,sizeof(text) / sizeof(text[0]));
+		window.class_name = text;
+		message_recording_describing = true;
+		text[0] = L'\0';
+		GetWindowText(window_handle,text,sizeof(text) / sizeof(text[0]));
+		message_recording_describing = false;
+		window.name = text;
+
+		recorded_windows.push_back(window);
+		id = (DWORD)recorded_windows.size();
+		recorded_window_ids[window_handle] = id;
+
+		return id;
+	}
+
+	bool HasPointerParameters(UINT message)  //Messages whose parameters are pointers or GDI handles, which only mean something within the process which sent them.
+	{
+		switch(message)
+		{
+			case WM_COPYDATA:
+			case WM_CREATE:
+			case WM_CTLCOLORBTN:
+			case WM_CTLCOLORDLG:
+			case WM_CTLCOLOREDIT:
+			case WM_CTLCOLORLISTBOX:
+			case WM_CTLCOLORMSGBOX:
+			case WM_CTLCOLORSCROLLBAR:
+			case WM_CTLCOLORSTATIC:
+			case WM_DRAWITEM:
+			case WM_ERASEBKGND:
+			case WM_GETDLGCODE:
+			case WM_GETMINMAXINFO:
+			case WM_GETTEXT:
+			case WM_MEASUREITEM:
+			case WM_MOVING:
+			case WM_NCCALCSIZE:
+			case WM_NCCREATE:
+			case WM_NCPAINT:
+			case WM_NOTIFY:
+			case WM_PRINT:
+			case WM_PRINTCLIENT:
+			case WM_SETFONT:
+			case WM_SETTEXT:
+			case WM_SETTINGCHANGE:
+			case WM_SIZING:
+			case WM_STYLECHANGED:
+			case WM_STYLECHANGING:
+			case WM_WINDOWPOSCHANGED:
+			case WM_WINDOWPOSCHANGING:
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+	DWORD GetWindowParameters(UINT message,WPARAM w_param,LPARAM l_param)  //Which of a system message's parameters are window handles, as MESSAGE_LOG_W_PARAM_WINDOW and MESSAGE_LOG_L_PARAM_WINDOW.
+	{
+		switch(message)
+		{
+			case WM_CONTEXTMENU:
+			case WM_KILLFOCUS:
+			case WM_MOUSEACTIVATE:
+			case WM_SETCURSOR:
+			case WM_SETFOCUS:
+				return MESSAGE_LOG_W_PARAM_WINDOW;
+
+			case WM_ACTIVATE:
+			case WM_CAPTURECHANGED:
+			case WM_COMMAND:  //Null for menus and accelerators.
+			case WM_HSCROLL:  //Null for a window's own scroll bars.
+			case WM_VSCROLL:
+				return MESSAGE_LOG_L_PARAM_WINDOW;
+
+			case WM_NEXTDLGCTL:
+				return LOWORD(l_param) != 0 ? MESSAGE_LOG_W_PARAM_WINDOW : 0;
+
+			case WM_PARENTNOTIFY:
+				return LOWORD(w_param) == WM_CREATE || LOWORD(w_param) == WM_DESTROY ? MESSAGE_LOG_L_PARAM_WINDOW : 0;  //Otherwise the cursor's position.
+
+			default:
+				return 0;
+		}
+	}
+
+	bool IsTeardownMessage(UINT message,WPARAM w_param)  //Messages which, if replayed, would close or destroy windows or end the message loop.
+	{
+		switch(message)
+		{
+			case WM_CLOSE:
+			case WM_DESTROY:
+			case WM_ENDSESSION:
+			case WM_NCDESTROY:
+			case WM_QUERYENDSESSION:
+			case WM_QUIT:
+				return true;
+
+			case WM_SYSCOMMAND:
+				return (w_param & 0xFFF0) == SC_CLOSE;  //The low four bits are used by the system.
+
+			default:
+				return false;
+		}
+	}
+
+	HWND ResolveRecordedWindow(MessageReplay& replay,DWORD id)
+	{
+		const RecordedWindow* recorded;
+		HWND parent_handle = nullptr;
+		std::vector<HWND> candidates;
+		HWND match = nullptr;
+
+
+		if(id == 0 || id > replay.windows.size())
+		{
+			return nullptr;
+		}
+
+		if(replay.resolved[id - 1])
+		{
+			return replay.window_handles[id - 1];
+		}
+		replay.resolved[id - 1] = true;
+		recorded = &replay.windows[id - 1];
+
+		if(recorded->parent != 0)
+		{
+			parent_handle = ResolveRecordedWindow(replay,recorded->parent);
+			if(parent_handle == nullptr)
+			{
+				return nullptr;
+			}
+			EnumChildWindows(parent_handle,CollectWindow,(LPARAM)&candidates);
+		}
+		else
+		{
+			EnumThreadWindows(GetCurrentThreadId(),CollectWindow,(LPARAM)&candidates);
+		}
+
+		for(HWND candidate : candidates)
+		{
+			wchar text[256];
+
+
+			if(replay.claimed.count(candidate) > 0 || (parent_handle != nullptr && GetParent(candidate) != parent_handle))  //EnumChildWindows also lists grandchildren.
+			{
+				continue;
+			}
+
+			GetClassName(candidate,text,sizeof(text) / sizeof(text[0]));
+			if(recorded->class_name != text)
+			{
+				continue;
+			}
+
+			if(match == nullptr)
+			{
+				match = candidate;
+			}
+
+			text[0] = L'\0';
+			GetWindowText(candidate,text,sizeof(text) / sizeof(text[0]));
+			if(recorded->name == text)
+			{
+				match = candidate;
+
+				break;
+			}
+		}
+
+		if(match != nullptr)
+		{
+			replay.claimed.insert(match);
+			replay.window_handles[id - 1] = match;
+		}
+
+		return match;
+	}
+
+	bool WriteMessageLog(HANDLE file,const void* data,size_t size)
+	{
+		DWORD written;
+
+
+		return WriteFile(file,data,(DWORD)size,&written,nullptr) && written == size;
+	}
+
+	bool WriteMessageLogWindows(HANDLE file)
+	{
+		for(size_t index = 0;index < recorded_windows.size();++index)
+		{
+			const RecordedWindow& window = recorded_windows[index];
+			MessageLogWindow entry;
+
+
+			entry.id = (DWORD)(index + 1);
+			entry.parent = window.parent;
+			entry.class_name_length = (WORD)window.class_name.length();
+			entry.name_length = (WORD)window.name.length();
+			if(!WriteMessageLog(file,&entry,sizeof(entry)) || !WriteMessageLog(file,window.class_name.c_str(),entry.class_name_length * sizeof(wchar)) || !WriteMessageLog(file,window.name.c_str(),entry.name_length * sizeof(wchar)))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	MessageLogHeader MakeMessageLogHeader(DWORD message_count)
+	{
+		MessageLogHeader header;
+
+
+		std::memcpy(header.magic,"MLOG",sizeof(header.magic));
+		header.version = MESSAGE_LOG_VERSION;
+		header.message_count = message_count;
+		header.window_count = (DWORD)recorded_windows.size();
+		header.windows_offset = (DWORD)(sizeof(MessageLogHeader) + message_count * sizeof(MessageLogRecord));
+		header.reserved = 0;
+
+		return header;
+	}
+
+	void RecordMessage(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param)
+	{
+		MessageLogRecord record;
+		LARGE_INTEGER now;
+
+
+		if(message_recording_describing || GetCurrentThreadId() != message_recording_thread)
+		{
+			return;
+		}
+
+		QueryPerformanceCounter(&now);
+		record.time = (now.QuadPart - message_recording_start) * 1000000 / message_recording_frequency;
+		record.w_param = (ULONGLONG)w_param;
+		record.l_param = (ULONGLONG)l_param;
+		record.window = GetRecordedWindowId(window_handle);
+		record.message = message;
+		record.flags = 0;
+		record.reserved = 0;
+		if(HasPointerParameters(message))
+		{
+			record.flags |= MESSAGE_LOG_POINTER_PARAMETERS;
+		}
+		else if(message < WM_USER)
+		{
+			record.flags |= GetWindowParameters(message,w_param,l_param);
+			if((record.flags & MESSAGE_LOG_W_PARAM_WINDOW) != 0)
+			{
+				record.w_param = w_param != 0 && IsWindow((HWND)w_param) ? GetRecordedWindowId((HWND)w_param) : 0;  //A window which no longer exists is replayed as none.
+			}
+			if((record.flags & MESSAGE_LOG_L_PARAM_WINDOW) != 0)
+			{
+				record.l_param = l_param != 0 && IsWindow((HWND)l_param) ? GetRecordedWindowId((HWND)l_param) : 0;
+			}
+		}
+		else  //The meaning of an application's own messages is unknown, so only parameters which are windows already recorded are taken to be windows.
+		{
+			auto w_param_window = recorded_window_ids.find((HWND)w_param);
+			auto l_param_window = recorded_window_ids.find((HWND)l_param);
+
+
+			if(w_param != 0 && w_param_window != recorded_window_ids.end())
+			{
+				record.w_param = w_param_window->second;
+				record.flags |= MESSAGE_LOG_W_PARAM_WINDOW;
+			}
+			if(l_param != 0 && l_param_window != recorded_window_ids.end())
+			{
+				record.l_param = l_param_window->second;
+				record.flags |= MESSAGE_LOG_L_PARAM_WINDOW;
+			}
+		}
+
+		message_recording_buffer[message_recording_next] = record;
+		if(++message_recording_next < MESSAGE_RECORDING_CAPACITY)
+		{
+			return;
+		}
+
+		message_recording_next = 0;
+		if(message_recording_file == INVALID_HANDLE_VALUE)
+		{
+			message_recording_wrapped = true;
+		}
+		else if(WriteMessageLog(message_recording_file,message_recording_buffer.data(),MESSAGE_RECORDING_CAPACITY * sizeof(MessageLogRecord)))
+		{
+			message_recording_written += (DWORD)MESSAGE_RECORDING_CAPACITY;
+		}
+		else
+		{
+			OutputDebugString(L"Failed to write the message log; recording has stopped.\n");
+			message_recording.store(false,std::memory_order_relaxed);
+			CloseHandle(message_recording_file);
+			message_recording_file = INVALID_HANDLE_VALUE;
+		}
+	}
+
+	Module::Resource DecompressResource(const IndexedResource& indexed)
+	{
+		TRACE_SCOPE("OS::Module::decompressResource");
+		std::shared_ptr<std::vector<BYTE>> buffer;
+		Module::Resource resource;
+
+
+		resource.location = indexed.location;
+		resource.size = indexed.stored.original_size;
+
+		{
+			std::lock_guard<std::mutex> lock(resource_cache_mutex);
+			auto cached = resource_cache_by_stored_data.find(indexed.stored.data);
+
+
+			if(cached != resource_cache_by_stored_data.end())
+			{
+				resource_cache.splice(resource_cache.begin(),resource_cache,cached->second);
+				resource.storage = cached->second->data;
+				resource.data = resource.storage.get();
+
+				return resource;
+			}
+		}
+
+		buffer = std::make_shared<std::vector<BYTE>>(indexed.stored.original_size);
+		if(!Compression::Decompress((const BYTE*)indexed.stored.data,indexed.stored.size,buffer->data(),buffer->size()))
+		{
+			throw OS::RuntimeException("A compressed resource is corrupt.");
+		}
+		resource.storage = std::shared_ptr<const void>(buffer,buffer->data());
+		resource.data = resource.storage.get();
+
+		if(resource.size <= resource_cache_budget)
+		{
+			std::lock_guard<std::mutex> lock(resource_cache_mutex);
+			CachedResource cached;
+
+
+			if(resource_cache_by_stored_data.count(indexed.stored.data) > 0)  //Another thread decompressed it in the meantime.
+			{
+				return resource;
+			}
+
+			cached.stored_data = indexed.stored.data;
+			cached.data = resource.storage;
+			cached.size = resource.size;
+			resource_cache.push_front(cached);
+			resource_cache_by_stored_data[cached.stored_data] = resource_cache.begin();
+			resource_cache_usage += cached.size;
+			while(resource_cache_usage > resource_cache_budget)  //Whoever still holds an evicted resource keeps its data alive.
+			{
+				resource_cache_usage -= resource_cache.back().size;
+				resource_cache_by_stored_data.erase(resource_cache.back().stored_data);
+				resource_cache.pop_back();
+			}
+		}
+
+		return resource;
+	}
+
+	bool FindPackedString(HINSTANCE module,WORD resource_id,Module::Resource& resource)  //Packed strings are stored individually and without a terminator.
+	{
+		IndexedResource indexed;
+
+
+		{
+			std::lock_guard<std::mutex> lock(resource_index_mutex);
+			auto pack = resource_packs.find(module);
+
+
+			if(pack == resource_packs.end() || !pack->second->findResource(RT_STRING,MAKEINTRESOURCE(resource_id),MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL),indexed.stored))
+			{
+				return false;
+			}
+		}
+
+		if(indexed.stored.compressed)
+		{
+			indexed.location = nullptr;
+			resource = DecompressResource(indexed);
+		}
+		else
+		{
+			resource.location = nullptr;
+			resource.data = indexed.stored.data;
+			resource.size = indexed.stored.size;
+		}
+
+		return true;
+	}
+
+	IndexedResource LocateResource(HINSTANCE module,WORD resource_id,const wchar* resource_type,WORD language)
+	{
+		assert(resource_type != nullptr);
+
+
+		TRACE_SCOPE("OS::Module::locateResource");
+		ResourceKey key;
+		IndexedResource resource;
+
+
+		key.module = module;
+		key.type = GetResourceIdentifier(resource_type);
+		key.id = resource_id;
+		key.language = language;
+
+		{
+			std::lock_guard<std::mutex> lock(resource_index_mutex);
+			auto indexed = resource_index.find(key);
+			auto pack = resource_packs.find(module);
+
+
+			if(indexed != resource_index.end())
+			{
+				return indexed->second;
+			}
+			if(pack != resource_packs.end() && pack->second->findResource(resource_type,MAKEINTRESOURCE(resource_id),language,resource.stored))
+			{
+				resource.location = nullptr;
+				resource_index[key] = resource;
+
+				return resource;
+			}
+		}
+
+		resource.location = FindResourceEx(module,resource_type,MAKEINTRESOURCE(resource_id),language);
+		if(resource.location == nullptr)
+		{
+			if(IsDebuggerPresent())
+			{
+				OutputDebugString(std::wstring(L"Failed to locate resource with id=").append(std::to_wstring(resource_id)).append(L".\n").c_str());
+				DisplayErrorMessage();
+			}
+
+			throw OS::RuntimeException();
+		}
+		resource.stored.data = LockResource(LoadResource(module,resource.location));
+		resource.stored.size = SizeofResource(module,resource.location);
+		resource.stored.original_size = resource.stored.size;
+		resource.stored.compressed = false;
+
+		{
+			std::lock_guard<std::mutex> lock(resource_index_mutex);
+
+
+			resource_index[key] = resource;  //Another thread may have got here first, with the same result.
+		}
+
+		return resource;
+	}
+
+	std::wstring GetUIClassKey(const std::wstring& name)
+	{
+		std::wstring key(name);
+
+
+		for(size_t offset = 0;offset < key.length();++offset)
+		{
+			key[offset] = std::towlower(key[offset]);
+		}
+
+		return key;
+	}
+
+	size_t GetUIClassEvent(const std::wstring& name)
+	{
+		for(size_t event = 0;event < sizeof(UI_CLASS_EVENT_NAMES) / sizeof(UI_CLASS_EVENT_NAMES[0]);++event)
+		{
+			if(lstrcmpi(name.c_str(),UI_CLASS_EVENT_NAMES[event]) == 0)
+			{
+				return event;
+			}
+		}
+
+		return UI_CLASS_NO_EVENT;
+	}
+
+	int ParseUIClassInteger(const std::wstring& attribute,const std::wstring& value)
+	{
+		wchar* end;
+		long integer = std::wcstol(value.c_str(),&end,10);
+
+
+		if(value.empty() || *end != L'\0')
+		{
+			throw OS::RuntimeException(std::string("The UIClass prototype attribute \"").append(attribute.begin(),attribute.end()).append("\" is not an integer."));
+		}
+
+		return (int)integer;
+	}
+
+	HANDLE AcquireImage(UINT type,HINSTANCE module,const wchar* resource,int size)
+	{
+		assert(resource != nullptr);
+
+
+		std::wstring key = GetImageCacheKey(type,module,resource,size);
+		std::lock_guard<std::mutex> lock(gdi_cache_mutex);
+		auto cached = cached_images.find(key);
+		UINT flags = size == 0 ? (UINT)LR_DEFAULTSIZE : 0;
+		GdiCacheEntry entry;
+		HANDLE image;
+
+
+		if(cached != cached_images.end())
+		{
+			++gdi_cache_hits;
+			++gdi_cache_entries[cached->second].references;
+
+			return cached->second;
+		}
+
+		if(module == nullptr)  //The system's images can only be loaded as shared ones.
+		{
+			flags |= LR_SHARED;
+		}
+		image = LoadImage(module,resource,type,size,size,flags);
+		if(image == nullptr)
+		{
+			throw OS::RuntimeException("Failed to load an image resource.",GetLastError());
+		}
+
+		entry.type = type;
+		entry.references = 1;
+		entry.shared = module == nullptr;
+		entry.color = 0;
+		entry.key = key;
+
+		++gdi_cache_misses;
+		cached_images[key] = image;
+		gdi_cache_entries[image] = entry;
+
+		return image;
+	}
+
+	HBRUSH AcquireBrush(COLORREF color)
+	{
+		std::lock_guard<std::mutex> lock(gdi_cache_mutex);
+		auto cached = cached_brushes.find(color);
+		GdiCacheEntry entry;
+		HBRUSH brush;
+
+
+		if(cached != cached_brushes.end())
+		{
+			++gdi_cache_hits;
+			++gdi_cache_entries[cached->second].references;
+
+			return cached->second;
+		}
+
+		brush = CreateSolidBrush(color);
+		if(brush == nullptr)
+		{
+			throw OS::RuntimeException("Failed to create a brush.");
+		}
+
+		entry.type = IMAGE_BITMAP;
+		entry.references = 1;
+		entry.shared = false;
+		entry.color = color;
+
+		++gdi_cache_misses;
+		cached_brushes[color] = brush;
+		gdi_cache_entries[brush] = entry;
+
+		return brush;
+	}
+
+	HCURSOR AcquireCursor(HINSTANCE module,const wchar* resource)
+	{
+		return (HCURSOR)AcquireImage(IMAGE_CURSOR,module,resource,0);
+	}
+
+	HICON AcquireIcon(HINSTANCE module,const wchar* resource,int size)
+	{
+		return (HICON)AcquireImage(IMAGE_ICON,module,resource,size);
+	}
+
+	void DisplayErrorMessage()
+	{
+		DisplayErrorMessage(GetLastError());
+	}
+
+	void DisplayErrorMessage(DWORD error)
+	{
+		wchar* buffer;
+		std::wstring error_message;
+
+
+		buffer = nullptr;
+		FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,nullptr,error,MAKELANGID(LANG_ENGLISH,SUBLANG_DEFAULT),(wchar*)&buffer,0,nullptr);
+		error_message
+			.append(L"Error Code:\n")
+			.append(std::to_wstring(error))
+			.append(L"\n\nMessage:\n")
+			.append(buffer);
+		LocalFree(buffer);
+
+		MessageBox(nullptr,error_message.c_str(),L"An Error Has Occured",MB_OK | MB_ICONERROR);
+	}
+
+	void DumpMessageLatencyStatistics()
+	{
+		for(const MessageLatencyStatistics& statistics : GetMessageLatencyStatistics())
+		{
+			wchar line[512];
+
+
+			std::swprintf(line,sizeof(line) / sizeof(line[0]),L"Dispatch: %ls 0x%04X: %llu calls, %.1f us total, mean %.1f us, median %.1f us, 90%% %.1f us, 99%% %.1f us, maximum %.1f us.\n",
+				statistics.class_name.empty() ? L"(unknown class)" : statistics.class_name.c_str(),
+				statistics.message,
+				(unsigned long long)statistics.count,
+				statistics.total,
+				statistics.mean,
+				statistics.median,
+				statistics.percentile_90,
+				statistics.percentile_99,
+				statistics.maximum
+			);
+			OutputDebugString(line);
+		}
+	}
+
+	void FlushInvalidations()
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		std::vector<Window*> windows;
+
+
+		windows.swap(thread_state.invalidated_windows);
+		for(Window* window : windows)
+		{
+			UINT flags = RDW_INVALIDATE;
+
+
+			window->invalidation.pending = false;
+			if(!window->isRealized() || !window->isAlive() || window->isPaintingSuspended())  //Suspended windows are invalidated as a whole when painting resumes.
+			{
+				continue;
+			}
+
+			if(window->invalidation.erase)
+			{
+				flags |= RDW_ERASE;
+			}
+			if(window->invalidation.children)
+			{
+				flags |= RDW_ALLCHILDREN;
+			}
+
+			RedrawWindow(window->window_handle,window->invalidation.whole ? nullptr : &window->invalidation.rectangle,nullptr,flags);
+		}
+	}
+
+	size_t GetAnimatedWindowCount()
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+
+
+		return thread_state.window_animations.size();
+	}
+
+	size_t GetBackBufferUsage()
+	{
+		return back_buffer_usage;
+	}
+
+	GdiCacheStatistics GetGdiCacheStatistics()
+	{
+		GdiCacheStatistics statistics = {};
+		std::lock_guard<std::mutex> lock(gdi_cache_mutex);
+
+
+		statistics.brushes = cached_brushes.size();
+		for(auto& entry : gdi_cache_entries)
+		{
+			if(entry.second.type == IMAGE_CURSOR)
+			{
+				++statistics.cursors;
+			}
+			else if(entry.second.type == IMAGE_ICON)
+			{
+				++statistics.icons;
+			}
+		}
+		statistics.hits = gdi_cache_hits;
+		statistics.misses = gdi_cache_misses;
+		statistics.gdi_objects = GetGuiResources(GetCurrentProcess(),GR_GDIOBJECTS);
+		statistics.user_objects = GetGuiResources(GetCurrentProcess(),GR_USEROBJECTS);
+
+		return statistics;
+	}
+
+	std::vector<MessageLatencyStatistics> GetMessageLatencyStatistics()
+	{
+		std::lock_guard<std::mutex> lock(message_latency_tables_mutex);
+		std::map<std::pair<const WindowClass*,UINT>,std::pair<std::wstring,Statistics::Distribution>> distributions;
+		LARGE_INTEGER frequency;
+		double microseconds_per_tick;
+		std::vector<MessageLatencyStatistics> result;
+
+
+		QueryPerformanceFrequency(&frequency);
+		microseconds_per_tick = 1000000.0 / frequency.QuadPart;
+
+		for(MessageLatencySlot* table : message_latency_tables)
+		{
+			for(size_t slot = 0;slot < MESSAGE_LATENCY_SLOTS;++slot)
+			{
+				Statistics::Histogram* histogram = table[slot].histogram.load(std::memory_order_acquire);
+
+
+				if(histogram != nullptr)
+				{
+					auto& distribution = distributions[std::make_pair(table[slot].window_class,table[slot].message)];
+
+
+					distribution.first = table[slot].class_name;
+					histogram->addTo(distribution.second);
+				}
+			}
+		}
+
+		for(auto& entry : distributions)
+		{
+			const Statistics::Distribution& distribution = entry.second.second;
+			MessageLatencyStatistics statistics;
+
+
+			if(distribution.count == 0)
+			{
+				continue;
+			}
+
+			statistics.message = entry.first.second;
+			statistics.window_class = entry.first.first;
+			statistics.class_name = entry.second.first;
+			statistics.count = distribution.count;
+			statistics.total = distribution.total * microseconds_per_tick;
+			statistics.mean = distribution.getMean() * microseconds_per_tick;
+			statistics.median = distribution.getPercentile(0.5) * microseconds_per_tick;
+			statistics.percentile_90 = distribution.getPercentile(0.9) * microseconds_per_tick;
+			statistics.percentile_99 = distribution.getPercentile(0.99) * microseconds_per_tick;
+			statistics.maximum = distribution.maximum * microseconds_per_tick;
+			result.push_back(statistics);
+		}
+		std::sort(result.begin(),result.end(),[](const MessageLatencyStatistics& left,const MessageLatencyStatistics& right){
+			return left.total > right.total;
+		});
+
+		return result;
+	}
+
+	std::wstring GetPropertyName(PropertyId property)
+	{
+		std::lock_guard<std::mutex> lock(property_names_mutex);
+
+
+		assert(property >= 1 && property <= property_names.size());
+
+		return property_names[property - 1];
+	}
+
+	size_t GetResourceCacheUsage()
+	{
+		std::lock_guard<std::mutex> lock(resource_cache_mutex);
+
+
+		return resource_cache_usage;
+	}
+
+	TimerStatistics GetTimerStatistics()
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		TimerStatistics statistics;
+		Statistics::Distribution lateness;
+
+
+		thread_state.timer_lateness.addTo(lateness);
+		statistics.active = thread_state.active_timers;
+		statistics.fired = thread_state.timers_fired;
+		statistics.median_lateness = lateness.getPercentile(0.5) / 1000.0;
+		statistics.percentile_99_lateness = lateness.getPercentile(0.99) / 1000.0;
+		statistics.maximum_lateness = lateness.maximum / 1000.0;
+
+		return statistics;
+	}
+
+	PropertyId InternProperty(const wchar* name)
+	{
+		std::lock_guard<std::mutex> lock(property_names_mutex);
+		auto existing = property_ids.find(name);
+
+
+		assert(name != nullptr);
+
+		if(existing != property_ids.end())
+		{
+			return existing->second;
+		}
+
+		property_names.push_back(name);
+		property_ids[name] = (PropertyId)property_names.size();
+
+		return (PropertyId)property_names.size();
+	}
+
+	bool IsRecordingMessageLatency()
+	{
+		return message_latency_recording.load(std::memory_order_relaxed);
+	}
+
+	bool ReleaseGdiObject(HANDLE handle)
+	{
+		std::lock_guard<std::mutex> lock(gdi_cache_mutex);
+		auto entry = gdi_cache_entries.find(handle);
+
+
+		if(entry == gdi_cache_entries.end())
+		{
+			return false;
+		}
+
+		if(--entry->second.references > 0)
+		{
+			return true;
+		}
+
+		switch(entry->second.type)
+		{
+			case IMAGE_BITMAP:
+				cached_brushes.erase(entry->second.color);
+				DeleteObject((HGDIOBJ)handle);
+
+				break;
+
+			case IMAGE_CURSOR:
+				cached_images.erase(entry->second.key);
+				if(!entry->second.shared)
+				{
+					DestroyCursor((HCURSOR)handle);
+				}
+
+				break;
+
+			case IMAGE_ICON:
+				cached_images.erase(entry->second.key);
+				if(!entry->second.shared)
+				{
+					DestroyIcon((HICON)handle);
+				}
+
+				break;
+		}
+		gdi_cache_entries.erase(entry);
+
+		return true;
+	}
+
+	size_t ReplayMessages(const wchar* path,bool paced)
+	{
+		HANDLE file;
+		LARGE_INTEGER file_size;
+		std::vector<BYTE> log;
+		DWORD read = 0;
+		MessageLogHeader header;
+		size_t offset;
+		MessageReplay replay;
+		LARGE_INTEGER frequency;
+		LARGE_INTEGER start;
+		size_t replayed = 0;
+
+
+		assert(!message_recording.load(std::memory_order_relaxed));  //The replayed messages would be recorded over again.
+
+		file = CreateFile(path,GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+		if(file == INVALID_HANDLE_VALUE)
+		{
+			throw OS::RuntimeException("Failed to open message log.",GetLastError());
+		}
+		if(GetFileSizeEx(file,&file_size) && file_size.QuadPart >= (LONGLONG)sizeof(MessageLogHeader) && file_size.QuadPart <= MAXDWORD)
+		{
+			log.resize((size_t)file_size.QuadPart);
+			ReadFile(file,log.data(),(DWORD)log.size(),&read,nullptr);
+		}
+		CloseHandle(file);
+		if(log.empty() || read != log.size())
+		{
+			throw OS::RuntimeException("Failed to read message log.");
+		}
+
+		std::memcpy(&header,log.data(),sizeof(header));
+		if(std::memcmp(header.magic,"MLOG",sizeof(header.magic)) != 0 || header.version != MESSAGE_LOG_VERSION || header.windows_offset > log.size() || header.windows_offset < sizeof(MessageLogHeader) + (ULONGLONG)header.message_count * sizeof(MessageLogRecord))
+		{
+			throw OS::RuntimeException("Message log is corrupt.");
+		}
+
+		replay.windows.resize(header.window_count);
+		offset = header.windows_offset;
+		for(DWORD index = 0;index < header.window_count;++index)
+		{
+			MessageLogWindow entry;
+			const wchar* text;
+
+
+			if(log.size() - offset < sizeof(entry))
+			{
+				throw OS::RuntimeException("Message log is corrupt.");
+			}
+			std::memcpy(&entry,&log[offset],sizeof(entry));
+			offset += sizeof(entry);
+			if(entry.id == 0 || entry.id > header.window_count || entry.parent > header.window_count || log.size() - offset < (entry.class_name_length + entry.name_length) * sizeof(wchar))
+			{
+				throw OS::RuntimeException("Message log is corrupt.");
+			}
+			text = (const wchar*)&log[offset];
+			replay.windows[entry.id - 1].parent = entry.parent;
+			replay.windows[entry.id - 1].class_name.assign(text,entry.class_name_length);
+			replay.windows[entry.id - 1].name.assign(text + entry.class_name_length,entry.name_length);
+			offset += (entry.class_name_length + entry.name_length) * sizeof(wchar);
+		}
+		replay.window_handles.assign(header.window_count,nullptr);
+		replay.resolved.assign(header.window_count,false);
+
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&start);
+		for(DWORD index = 0;index < header.message_count;++index)
+		{
+			MessageLogRecord record;
+			HWND window_handle;
+			WPARAM w_param;
+			LPARAM l_param;
+
+
+			std::memcpy(&record,&log[sizeof(MessageLogHeader) + index * sizeof(MessageLogRecord)],sizeof(record));
+			if((record.flags & MESSAGE_LOG_POINTER_PARAMETERS) != 0 || IsTeardownMessage(record.message,(WPARAM)record.w_param))
+			{
+				continue;
+			}
+
+			window_handle = ResolveRecordedWindow(replay,record.window);
+			if(window_handle == nullptr)
+			{
+				continue;
+			}
+			w_param = (record.flags & MESSAGE_LOG_W_PARAM_WINDOW) != 0 ? (WPARAM)ResolveRecordedWindow(replay,(DWORD)record.w_param) : (WPARAM)record.w_param;
+			l_param = (record.flags & MESSAGE_LOG_L_PARAM_WINDOW) != 0 ? (LPARAM)ResolveRecordedWindow(replay,(DWORD)record.l_param) : (LPARAM)record.l_param;
+
+			while(paced)
+			{
+				LARGE_INTEGER now;
+				LONGLONG elapsed;
+
+
+				QueryPerformanceCounter(&now);
+				elapsed = (now.QuadPart - start.QuadPart) * 1000000 / frequency.QuadPart;
+				if(elapsed >= record.time)
+				{
+					break;
+				}
+				Sleep((DWORD)((record.time - elapsed + 999) / 1000));  //Rounded up, as Sleep(0) would spin through the last millisecond.
+			}
+
+			SendMessage(window_handle,record.message,w_param,l_param);
+			FlushInvalidations();  //As the message loop would before waiting for the next message.
+			++replayed;
+		}
+
+		return replayed;
+	}
+
+	void ResetMessageLatencyStatistics()
+	{
+		std::lock_guard<std::mutex> lock(message_latency_tables_mutex);
+
+
+		for(MessageLatencySlot* table : message_latency_tables)
+		{
+			for(size_t slot = 0;slot < MESSAGE_LATENCY_SLOTS;++slot)
+			{
+				Statistics::Histogram* histogram = table[slot].histogram.load(std::memory_order_acquire);
+
+
+				if(histogram != nullptr)
+				{
+					histogram->reset();
+				}
+			}
+		}
+	}
+
+	bool RetainGdiObject(HANDLE handle)
+	{
+		std::lock_guard<std::mutex> lock(gdi_cache_mutex);
+		auto entry = gdi_cache_entries.find(handle);
+
+
+		if(entry == gdi_cache_entries.end())
+		{
+			return false;
+		}
+
+		++entry->second.references;
+
+		return true;
+	}
+
+	void RunAnimationFrame()
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		double now = GetAnimationClock();
+		std::map<HWND,std::vector<std::pair<Window*,RECT>>> batches;
+		std::vector<std::pair<Window*,BYTE>> opacities;
+		std::vector<std::pair<Window*,COLORREF>> colors;
+		std::vector<std::pair<Window*,size_t>> finished;
+		std::vector<std::pair<Window*,AnimationHandler>> completions;
+
+
+		thread_state.animation_timeline.evaluate(now);
+
+		/* Gather the whole frame before applying any of it, as applying it sends messages whose handlers may start or stop animations. */
+		for(auto& entry : thread_state.window_animations)
+		{
+			Window* window = entry.first;
+			const size_t* tweens = entry.second.tweens;
+
+
+			if(tweens[WindowAnimation::X] != ANIMATION_NONE)
+			{
+				RECT rectangle;
+
+
+				rectangle.left = RoundAnimationValue(thread_state.animation_timeline.getValue(tweens[WindowAnimation::X]));
+				rectangle.top = RoundAnimationValue(thread_state.animation_timeline.getValue(tweens[WindowAnimation::Y]));
+				rectangle.right = rectangle.left + RoundAnimationValue(thread_state.animation_timeline.getValue(tweens[WindowAnimation::WIDTH]));
+				rectangle.bottom = rectangle.top + RoundAnimationValue(thread_state.animation_timeline.getValue(tweens[WindowAnimation::HEIGHT]));
+				if(window->isRealized())
+				{
+					batches[GetAncestor(window->getNativeHandle(),GA_PARENT)].push_back(std::make_pair(window,rectangle));
+				}
+				else
+				{
+					window->setPosition(rectangle.left,rectangle.top);
+					window->setDimensions(rectangle.right - rectangle.left,rectangle.bottom - rectangle.top);
+				}
+			}
+
+			if(tweens[WindowAnimation::OPACITY] != ANIMATION_NONE && window->isRealized())
+			{
+				opacities.push_back(std::make_pair(window,(BYTE)RoundAnimationValue(thread_state.animation_timeline.getValue(tweens[WindowAnimation::OPACITY]))));
+			}
+
+			if(tweens[WindowAnimation::RED] != ANIMATION_NONE)
+			{
+				colors.push_back(std::make_pair(window,RGB(
+					RoundAnimationValue(thread_state.animation_timeline.getValue(tweens[WindowAnimation::RED])),
+					RoundAnimationValue(thread_state.animation_timeline.getValue(tweens[WindowAnimation::GREEN])),
+					RoundAnimationValue(thread_state.animation_timeline.getValue(tweens[WindowAnimation::BLUE]))
+				)));
+			}
+
+			for(size_t group = 0;group < WindowAnimation::GROUPS;++group)
+			{
+				if(entry.second.ends[group] <= now && IsAnimationGroupActive(entry.second,group))
+				{
+					finished.push_back(std::make_pair(window,group));
+				}
+			}
+		}
+
+		for(auto& group : finished)  //A window's finished groups are adjacent, so it is only forgotten once the last of them is stopped.
+		{
+			auto animation = thread_state.window_animations.find(group.first);
+
+
+			completions.push_back(std::make_pair(group.first,animation->second.handlers[group.second]));
+			StopAnimationGroup(animation->second,group.second);
+			if(!IsAnimationGroupActive(animation->second,WindowAnimation::GEOMETRY) && !IsAnimationGroupActive(animation->second,WindowAnimation::TRANSLUCENCY) && !IsAnimationGroupActive(animation->second,WindowAnimation::BACKGROUND))
+			{
+				thread_state.window_animations.erase(animation);
+			}
+		}
+
+		/* Apply the frame, batching the windows which share a parent into a single deferred update. */
+		for(auto& batch : batches)
+		{
+			HDWP positions = BeginDeferWindowPos((int)batch.second.size());
+
+
+			for(auto& change : batch.second)
+			{
+				if(change.first->isAlive())
+				{
+					positions = DeferWindowPos(positions,change.first->getNativeHandle(),nullptr,change.second.left,change.second.top,change.second.right - change.second.left,change.second.bottom - change.second.top,SWP_NOZORDER | SWP_NOACTIVATE);
+				}
+			}
+			EndDeferWindowPos(positions);
+		}
+
+		for(auto& change : opacities)
+		{
+			if(change.first->isAlive())
+			{
+				SetWindowOpacity(change.first,change.second);
+			}
+		}
+
+		for(auto& change : colors)
+		{
+			if(change.first->isAlive())
+			{
+				change.first->setBackground(change.second);
+			}
+		}
+
+		for(auto& completion : completions)
+		{
+			if(completion.second && completion.first->isAlive())
+			{
+				completion.second(completion.first);
+			}
+		}
+
+		ArmAnimationTimer();
+	}
+
+	void SaveMessageRecording(const wchar* path)
+	{
+		HANDLE file;
+		DWORD message_count = (DWORD)(message_recording_wrapped ? MESSAGE_RECORDING_CAPACITY : message_recording_next);
+		MessageLogHeader header = MakeMessageLogHeader(message_count);
+		bool succeeded;
+
+
+		assert(message_recording_file == INVALID_HANDLE_VALUE);
+
+		file = CreateFile(path,GENERIC_WRITE,0,nullptr,CREATE_ALWAYS,FILE_ATTRIBUTE_NORMAL,nullptr);
+		if(file == INVALID_HANDLE_VALUE)
+		{
+			throw OS::RuntimeException("Failed to create message log.",GetLastError());
+		}
+
+		succeeded = WriteMessageLog(file,&header,sizeof(header));
+		if(succeeded && message_recording_wrapped)  //The oldest records are those the next record would overwrite.
+		{
+			succeeded = WriteMessageLog(file,message_recording_buffer.data() + message_recording_next,(MESSAGE_RECORDING_CAPACITY - message_recording_next) * sizeof(MessageLogRecord));
+		}
+		succeeded = succeeded && WriteMessageLog(file,message_recording_buffer.data(),message_recording_next * sizeof(MessageLogRecord)) && WriteMessageLogWindows(file);
+		CloseHandle(file);
+		if(!succeeded)
+		{
+			throw OS::RuntimeException("Failed to write message log.");
+		}
+	}
+
+	void SetBackBufferBudget(size_t bytes)
+	{
+		back_buffer_budget = bytes;
+	}
+
+	void SetMessageLatencyDumpInterval(UINT milliseconds)
+	{
+		if(message_latency_dump_timer != 0)
+		{
+			KillTimer(nullptr,message_latency_dump_timer);
+			message_latency_dump_timer = 0;
+		}
+
+		if(milliseconds > 0)
+		{
+			message_latency_dump_timer = SetTimer(nullptr,0,milliseconds,DumpMessageLatencyTimerProc);
+		}
+	}
+
+	void SetMessageLatencyRecording(bool enabled)
+	{
+		message_latency_recording.store(enabled,std::memory_order_relaxed);
+	}
+
+	void SetResourceCacheBudget(size_t bytes)
+	{
+		std::lock_guard<std::mutex> lock(resource_cache_mutex);
+
+
+		resource_cache_budget = bytes;
+		while(resource_cache_usage > resource_cache_budget)
+		{
+			resource_cache_usage -= resource_cache.back().size;
+			resource_cache_by_stored_data.erase(resource_cache.back().stored_data);
+			resource_cache.pop_back();
+		}
+	}
+
+	int StartMessageLoop()
+	{
+		MSG message;
+
+
+		for(;;)
+		{
+			FlushInvalidations();
+
+			if(GetMessage(&message,nullptr,0,0) <= 0)
+			{
+				break;
+			}
+
+			TranslateMessage(&message);
+			DispatchMessage(&message);
+		}
+
+		return message.wParam;
+	}
+
+	void StartMessageRecording(const wchar* path)
+	{
+		LARGE_INTEGER now;
+
+
+		assert(!message_recording.load(std::memory_order_relaxed));
+
+		if(path != nullptr)
+		{
+			MessageLogHeader header = {};  //Completed by OS::StopMessageRecording.
+
+
+			message_recording_file = CreateFile(path,GENERIC_WRITE,0,nullptr,CREATE_ALWAYS,FILE_ATTRIBUTE_NORMAL,nullptr);
+			if(message_recording_file == INVALID_HANDLE_VALUE)
+			{
+				throw OS::RuntimeException("Failed to create message log.",GetLastError());
+			}
+			WriteMessageLog(message_recording_file,&header,sizeof(header));
+		}
+
+		QueryPerformanceFrequency(&now);
+		message_recording_frequency = now.QuadPart;
+		QueryPerformanceCounter(&now);
+		message_recording_start = now.QuadPart;
+		message_recording_buffer.resize(MESSAGE_RECORDING_CAPACITY);
+		message_recording_next = 0;
+		message_recording_wrapped = false;
+		message_recording_written = 0;
+		recorded_window_ids.clear();
+		recorded_windows.clear();
+		message_recording_thread = GetCurrentThreadId();
+		message_recording.store(true,std::memory_order_relaxed);
+	}
+
+	void StopMessageLoop(int exit_code)
+	{
+		PostQuitMessage(exit_code);
+	}
+
+	void StopMessageRecording()
+	{
+		MessageLogHeader header;
+		bool succeeded;
+
+
+		message_recording.store(false,std::memory_order_relaxed);
+		if(message_recording_file == INVALID_HANDLE_VALUE)
+		{
+			return;  //A recording to memory is kept for OS::SaveMessageRecording.
+		}
+
+		succeeded = WriteMessageLog(message_recording_file,message_recording_buffer.data(),message_recording_next * sizeof(MessageLogRecord));
+		message_recording_written += (DWORD)message_recording_next;
+		message_recording_next = 0;
+		header = MakeMessageLogHeader(message_recording_written);
+		succeeded = succeeded && WriteMessageLogWindows(message_recording_file) && SetFilePointer(message_recording_file,0,nullptr,FILE_BEGIN) == 0 && WriteMessageLog(message_recording_file,&header,sizeof(header));
+		CloseHandle(message_recording_file);
+		message_recording_file = INVALID_HANDLE_VALUE;
+		if(!succeeded)
+		{
+			OutputDebugString(L"Failed to complete the message log.\n");
+		}
+	}
+
+	/* Type [OS::RuntimeException] Definition */
+	RuntimeException::RuntimeException()
+	: RuntimeException("A runtime exception has occured.  Use the \"cause\" method to obtain additional information.",GetLastError())
+	{
+	}
+
+	RuntimeException::RuntimeException(const char* information)
+	: RuntimeException(information,GetLastError())
+	{
+	}
+	
+	RuntimeException::RuntimeException(const std::string& information)
+	: RuntimeException(information.c_str(),GetLastError())
+	{
+	}
+	
+	RuntimeException::RuntimeException(const char* information,DWORD cause)
+	: std::runtime_error(information)
+	{
+		this->m_cause = cause;
+	}
+	
+	RuntimeException::RuntimeException(const std::string& information,DWORD cause)
+	: RuntimeException(information.c_str(),cause)
+	{
+	}
+
+	DWORD RuntimeException::cause() const
+	{
+		return this->m_cause;
+	}
+
+	/* Type [OS::Module] Definition */
+	Module::Module(HINSTANCE module)
+	{
+		//assert();
+
+
+		this->module_handle = module;
+	}
+
+	Module Module::GetCurrent()
+	{
+		return Module(GetModuleHandle(nullptr));
+	}
+
+	void Module::attachResourcePack(ResourcePack* pack)
+	{
+		std::lock_guard<std::mutex> lock(resource_index_mutex);
+
+
+		if(pack == nullptr)
+		{
+			resource_packs.erase(this->module_handle);
+		}
+		else
+		{
+			resource_packs[this->module_handle] = pack;
+		}
+
+		for(auto entry = resource_index.begin();entry != resource_index.end();)  //Forget whatever was looked up with the previous set of resources.
+		{
+			if(entry->first.module == this->module_handle)
+			{
+				entry = resource_index.erase(entry);
+			}
+			else
+			{
+				++entry;
+			}
+		}
+	}
+
+	void* Module::getResource(WORD resource_id,const wchar* resource_type,WORD language)
+	{
+		return const_cast<void*>(this->getResourceEntry(resource_id,resource_type,language).data);
+	}
+
+	Module::Resource Module::getResourceEntry(WORD resource_id,const wchar* resource_type,WORD language)
+	{
+		IndexedResource indexed = LocateResource(this->module_handle,resource_id,resource_type,language);
+		Resource resource;
+
+
+		if(indexed.stored.compressed)
+		{
+			return DecompressResource(indexed);
+		}
+
+		resource.location = indexed.location;
+		resource.data = indexed.stored.data;
+		resource.size = indexed.stored.size;
+
+		return resource;
+	}
+
+	HRSRC Module::getResourceLocation(WORD resource_id,const wchar* resource_type,WORD language)
+	{
+		return LocateResource(this->module_handle,resource_id,resource_type,language).location;
+	}
+
+	DWORD Module::getResourceSize(WORD resource_id,const wchar* resource_type,WORD language)
+	{
+		DWORD resource_size = LocateResource(this->module_handle,resource_id,resource_type,language).stored.original_size;  //No need to decompress the resource to know its size.
+
+
+		if(resource_size == 0)
+		{
+			if(IsDebuggerPresent())
+			{
+				DisplayErrorMessage();
+			}
+
+			throw OS::RuntimeException();
+		}
+
+		return resource_size;
+	}
+
+	std::wstring Module::getStringResource(WORD resource_id)
+	{
+		TRACE_SCOPE("OS::Module::getStringResource");
+		const wchar* buffer;
+		int length;
+
+
+		{
+			Module::Resource packed;
+
+
+			if(FindPackedString(this->module_handle,resource_id,packed))
+			{
+				return std::wstring((const wchar*)packed.data,packed.size / sizeof(wchar));
+			}
+		}
+
+		length = LoadString(*this,resource_id,(wchar*)&buffer,0);  //With no buffer, the string is left in place; it is not null-terminated, hence the length.
+		if(length == 0)
+		{
+			if(IsDebuggerPresent())
+			{
+				DisplayErrorMessage();
+			}
+
+			throw OS::RuntimeException(std::string("The requested resource does not exist.").c_str());
+		}
+
+		return std::wstring(buffer,length);
+	}
+
+	DWORD Module::getStringResourceSize(WORD resource_id)
+	{
+		wchar* buffer;
+
+
+		{
+			Module::Resource packed;
+
+
+			if(FindPackedString(this->module_handle,resource_id,packed))
+			{
+				return packed.size / sizeof(wchar);
+			}
+		}
+
+		return LoadString(*this,resource_id,(wchar*)&buffer,0);
+	}
+
+	void Module::streamResource(WORD resource_id,const wchar* resource_type,const std::function<void(const void* data,size_t size)>& consumer,WORD language)
+	{
+		IndexedResource indexed = LocateResource(this->module_handle,resource_id,resource_type,language);
+
+
+		if(!indexed.stored.compressed)
+		{
+			consumer(indexed.stored.data,indexed.stored.size);
+
+			return;
+		}
+
+		if(!Compression::DecompressStream((const BYTE*)indexed.stored.data,indexed.stored.size,[&consumer](const std::uint8_t* data,size_t size){
+			consumer(data,size);
+		}))
+		{
+			throw OS::RuntimeException("A compressed resource is corrupt.");
+		}
+	}
+
+	Module::operator HINSTANCE&()
+	{
+		return this->module_handle;
+	}
+
+	/* Type [OS::PropertyStore] Definition */
+	PropertyStore::~PropertyStore()
+	{
+		this->clear();
+	}
+
+	void PropertyStore::Release(Entry& entry)
+	{
+		if(entry.destroy != nullptr)
+		{
+			entry.destroy(entry);
+		}
+	}
+
+	void PropertyStore::clear()
+	{
+		for(Entry& entry : this->entries)
+		{
+			PropertyStore::Release(entry);
+		}
+		this->entries.clear();
+	}
+
+	bool PropertyStore::contains(PropertyId property) const
+	{
+		return const_cast<PropertyStore*>(this)->locate(property) != nullptr;
+	}
+
+	size_t PropertyStore::getCount() const
+	{
+		return this->entries.size();
+	}
+
+	void PropertyStore::insert(const Entry& entry)
+	{
+		auto position = std::lower_bound(this->entries.begin(),this->entries.end(),entry.property,[](const Entry& existing,PropertyId property){
+			return existing.property < property;
+		});
+
+
+		this->entries.insert(position,entry);
+	}
+
+	PropertyStore::Entry* PropertyStore::locate(PropertyId property)
+	{
+		auto entry = std::lower_bound(this->entries.begin(),this->entries.end(),property,[](const Entry& existing,PropertyId property){
+			return existing.property < property;
+		});
+
+
+		return entry != this->entries.end() && entry->property == property ? &*entry : nullptr;
+	}
+
+	bool PropertyStore::remove(PropertyId property)
+	{
+		Entry* entry = this->locate(property);
+
+
+		if(entry == nullptr)
+		{
+			return false;
+		}
+
+		PropertyStore::Release(*entry);
+		this->entries.erase(this->entries.begin() + (entry - this->entries.data()));
+
+		return true;
+	}
+
+	/* Type [OS::StyleEdit] Definition */
+	StyleEdit::~StyleEdit()
+	{
+		this->commit();
+	}
+
+	void StyleEdit::addExtendedStyle(Window* window,DWORD style)
+	{
+		this->getEntry(window).style_extended |= style;
+	}
+
+	void StyleEdit::addStyle(Window* window,DWORD style)
+	{
+		this->getEntry(window).style |= style;
+	}
+
+	void StyleEdit::commit()
+	{
+		std::vector<Entry> entries;
+
+
+		entries.swap(this->entries);  //Committing sends messages, whose handlers may start editing through this transaction again.
+		for(Entry& entry : entries)
+		{
+			Window* window = entry.window;
+			HWND window_handle;
+			DWORD style;
+			UINT flags = SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE;
+
+
+			if(!window->isRealized())
+			{
+				window->deferred.style = entry.style;
+				window->deferred.style_extended = entry.style_extended;
+
+				continue;
+			}
+
+			window_handle = window->getNativeHandle();
+			style = (entry.style & ~WS_VISIBLE) | (entry.original_style & WS_VISIBLE);  //Visibility is changed by SetWindowPos below, so that the window is actually shown or hidden.
+			if(entry.reparent && (entry.style & WS_CHILD) == 0)
+			{
+				SetParent(window_handle,entry.parent);
+			}
+
+			if(style != entry.original_style)
+			{
+				SetWindowLongPtr(window_handle,GWL_STYLE,style);
+			}
+			if(entry.style_extended != entry.original_style_extended)
+			{
+				SetWindowLongPtr(window_handle,GWL_EXSTYLE,entry.style_extended);
+			}
+			if(((style ^ entry.original_style) & FRAME_STYLES) != 0 || ((entry.style_extended ^ entry.original_style_extended) & FRAME_EXTENDED_STYLES) != 0)
+			{
+				flags |= SWP_FRAMECHANGED;
+			}
+
+			if(entry.reparent && (entry.style & WS_CHILD) != 0)
+			{
+				SetParent(window_handle,entry.parent);
+			}
+
+			if(((entry.style ^ entry.original_style) & WS_VISIBLE) != 0)
+			{
+				flags |= (entry.style & WS_VISIBLE) != 0 ? SWP_SHOWWINDOW : SWP_HIDEWINDOW;
+			}
+
+			if((flags & (SWP_FRAMECHANGED | SWP_SHOWWINDOW | SWP_HIDEWINDOW)) != 0)
+			{
+				SetWindowPos(window_handle,nullptr,0,0,0,0,flags);
+			}
+		}
+	}
+
+	StyleEdit::Entry& StyleEdit::getEntry(Window* window)
+	{
+		Entry entry;
+
+
+		assert(window != nullptr);
+
+		for(Entry& existing : this->entries)  //Transactions rarely span more than a few windows.
+		{
+			if(existing.window == window)
+			{
+				return existing;
+			}
+		}
+
+		entry.window = window;
+		entry.original_style = window->getStyle();
+		entry.original_style_extended = window->getExtendedStyle();
+		entry.style = entry.original_style;
+		entry.style_extended = entry.original_style_extended;
+		entry.reparent = false;
+		entry.parent = nullptr;
+		this->entries.push_back(entry);
+
+		return this->entries.back();
+	}
+
+	DWORD StyleEdit::getExtendedStyle(Window* window)
+	{
+		return this->getEntry(window).style_extended;
+	}
+
+	DWORD StyleEdit::getStyle(Window* window)
+	{
+		return this->getEntry(window).style;
+	}
+
+	void StyleEdit::removeExtendedStyle(Window* window,DWORD style)
+	{
+		this->getEntry(window).style_extended &= ~style;
+	}
+
+	void StyleEdit::removeStyle(Window* window,DWORD style)
+	{
+		this->getEntry(window).style &= ~style;
+	}
+
+	void StyleEdit::setExtendedStyle(Window* window,DWORD style)
+	{
+		this->getEntry(window).style_extended = style;
+	}
+
+	void StyleEdit::setParent(Window* window,Window* parent)
+	{
+		Entry& entry = this->getEntry(window);
+
+
+		assert(window->isRealized());
+
+		entry.reparent = true;
+		entry.parent = parent != nullptr ? parent->getNativeHandle() : nullptr;
+	}
+
+	void StyleEdit::setStyle(Window* window,DWORD style)
+	{
+		this->getEntry(window).style = style;
+	}
+
+	/* Type [OS::Window] Definition */
+	Window::Window(HWND window_handle,WindowClass* window_class)
+	: module((HINSTANCE)GetWindowLongPtr(window_handle,GWLP_HINSTANCE))
+	{
+		assert(IsWindow(window_handle));
+
+
+		this->focused_control = nullptr;
+		this->indexed_parent = nullptr;
+		this->unindexed_children = false;
+		this->invalidation.pending = false;
+		this->last_property_observer = 0;
+		this->layout = nullptr;
+		this->back_buffer.enabled = false;
+		this->back_buffer.device_context = nullptr;
+		this->back_buffer.bitmap = nullptr;
+		this->back_buffer.previous_bitmap = nullptr;
+		this->back_buffer.width = 0;
+		this->back_buffer.height = 0;
+		this->back_buffer.saved_state = 0;
+		this->back_buffer.controls_painted = false;
+		this->painting_suspensions = 0;
+		this->properties.background = nullptr;
+		this->surface = nullptr;
+		this->render_cache.content = nullptr;
+		this->render_cache.stale = true;
+		this->deferred.pending = false;
+		this->deferred.destroyed = false;
+		this->deferred.parent = nullptr;
+		this->static_message_map = nullptr;
+		this->window_handle = window_handle;
+		this->window_class = window_class;
+	}
+
+	Window::Window(WindowClass* window_class)
+	: module(GetModuleHandle(nullptr))
+	{
+		assert(window_class != nullptr);
+
+
+		this->focused_control = nullptr;
+		this->indexed_parent = nullptr;
+		this->unindexed_children = false;
+		this->invalidation.pending = false;
+		this->last_property_observer = 0;
+		this->layout = nullptr;
+		this->back_buffer.enabled = false;
+		this->back_buffer.device_context = nullptr;
+		this->back_buffer.bitmap = nullptr;
+		this->back_buffer.previous_bitmap = nullptr;
+		this->back_buffer.width = 0;
+		this->back_buffer.height = 0;
+		this->back_buffer.saved_state = 0;
+		this->back_buffer.controls_painted = false;
+		this->painting_suspensions = 0;
+		this->properties.background = nullptr;
+		this->surface = nullptr;
+		this->render_cache.content = nullptr;
+		this->render_cache.stale = true;
+		this->deferred.pending = true;
+		this->deferred.destroyed = false;
+		this->deferred.parent = nullptr;
+		this->static_message_map = nullptr;
+		this->window_handle = nullptr;
+		this->window_class = window_class;
+	}
+
+	Window::~Window()
+	{
+	}
+
+	bool Window::acquireBackBuffer(HDC device_context,int width,int height)
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+
+
+		if(width <= 0 || height <= 0)
+		{
+			return false;
+		}
+
+		if(this->back_buffer.device_context == nullptr || width > this->back_buffer.width || height > this->back_buffer.height)
+		{
+			HDC buffer_context;
+			HBITMAP bitmap;
+
+
+			width = width > this->back_buffer.width ? width : this->back_buffer.width;  //Grow to cover both dimensions so that alternating resizes don't reallocate every time.
+			height = height > this->back_buffer.height ? height : this->back_buffer.height;
+
+			this->releaseBackBuffer();
+
+			buffer_context = CreateCompatibleDC(device_context);
+			bitmap = buffer_context == nullptr ? nullptr : CreateCompatibleBitmap(device_context,width,height);
+			if(bitmap == nullptr)
+			{
+				if(buffer_context != nullptr)
+				{
+					DeleteDC(buffer_context);
+				}
+
+				return false;
+			}
+
+			this->back_buffer.device_context = buffer_context;
+			this->back_buffer.bitmap = bitmap;
+			this->back_buffer.previous_bitmap = SelectObject(buffer_context,bitmap);
+			this->back_buffer.width = width;
+			this->back_buffer.height = height;
+			back_buffer_usage += (size_t)width * height * 4;
+			thread_state.back_buffered_windows.push_front(this);
+
+			/* Release the buffers of the least recently painted windows until the budget is met again. */
+			if(back_buffer_usage > back_buffer_budget)
+			{
+				std::vector<Window*> candidates(thread_state.back_buffered_windows.rbegin(),thread_state.back_buffered_windows.rend());
+
+
+				for(Window* candidate : candidates)
+				{
+					if(back_buffer_usage <= back_buffer_budget)
+					{
+						break;
+					}
+
+					if(candidate != this && candidate->back_buffer.saved_state == 0)
+					{
+						candidate->releaseBackBuffer();
+					}
+				}
+			}
+		}
+		else if(thread_state.back_buffered_windows.front() != this)
+		{
+			thread_state.back_buffered_windows.remove(this);
+			thread_state.back_buffered_windows.push_front(this);
+		}
+
+		return true;
+	}
+
+	void Window::addExtendedStyle(DWORD style)
+	{
+		StyleEdit edit;
+
+
+		edit.addExtendedStyle(this,style);
+	}
+
+	void Window::addStyle(DWORD style)
+	{
+		StyleEdit edit;
+
+
+		edit.addStyle(this,style);
+	}
+
+	void Window::animateBackground(COLORREF color,UINT milliseconds,Animation::Easing easing,AnimationHandler handler)
+	{
+		COLORREF current = GetBrushColor(this->properties.background);
+		float from[WindowAnimation::CHANNELS];
+		float to[WindowAnimation::CHANNELS];
+
+
+		from[WindowAnimation::RED] = GetRValue(current);
+		from[WindowAnimation::GREEN] = GetGValue(current);
+		from[WindowAnimation::BLUE] = GetBValue(current);
+		to[WindowAnimation::RED] = GetRValue(color);
+		to[WindowAnimation::GREEN] = GetGValue(color);
+		to[WindowAnimation::BLUE] = GetBValue(color);
+
+		StartAnimation(this,WindowAnimation::BACKGROUND,from,to,milliseconds,easing,handler);
+	}
+
+	void Window::animateGeometry(const RECT& rectangle,UINT milliseconds,Animation::Easing easing,AnimationHandler handler)
+	{
+		RECT current = GetPlacementRectangle(this);
+		float from[WindowAnimation::CHANNELS];
+		float to[WindowAnimation::CHANNELS];
+
+
+		from[WindowAnimation::X] = (float)current.left;
+		from[WindowAnimation::Y] = (float)current.top;
+		from[WindowAnimation::WIDTH] = (float)(current.right - current.left);
+		from[WindowAnimation::HEIGHT] = (float)(current.bottom - current.top);
+		to[WindowAnimation::X] = (float)rectangle.left;
+		to[WindowAnimation::Y] = (float)rectangle.top;
+		to[WindowAnimation::WIDTH] = (float)(rectangle.right - rectangle.left);
+		to[WindowAnimation::HEIGHT] = (float)(rectangle.bottom - rectangle.top);
+
+		StartAnimation(this,WindowAnimation::GEOMETRY,from,to,milliseconds,easing,handler);
+	}
+
+	void Window::animateOpacity(BYTE opacity,UINT milliseconds,Animation::Easing easing,AnimationHandler handler)
+	{
+		float from[WindowAnimation::CHANNELS];
+		float to[WindowAnimation::CHANNELS];
+
+
+		from[WindowAnimation::OPACITY] = this->isRealized() ? GetWindowOpacity(this) : 255.0f;
+		to[WindowAnimation::OPACITY] = opacity;
+
+		StartAnimation(this,WindowAnimation::TRANSLUCENCY,from,to,milliseconds,easing,handler);
+	}
+
+	HDC Window::beginPaint(PAINTSTRUCT& paintstruct)
+	{
+		HDC device_context = BeginPaint(this->getNativeHandle(),&paintstruct);
+		RECT client_rectangle;
+
+
+		if(!this->back_buffer.enabled || device_context == nullptr)
+		{
+			return device_context;
+		}
+
+		client_rectangle = this->getRectangle(true);
+		if(!this->acquireBackBuffer(device_context,client_rectangle.right,client_rectangle.bottom))  //Fall back to painting directly to the screen.
+		{
+			return device_context;
+		}
+
+		this->back_buffer.saved_state = SaveDC(this->back_buffer.device_context);
+		IntersectClipRect(this->back_buffer.device_context,paintstruct.rcPaint.left,paintstruct.rcPaint.top,paintstruct.rcPaint.right,paintstruct.rcPaint.bottom);
+		FillRect(this->back_buffer.device_context,&paintstruct.rcPaint,this->getBackground());  //Stands in for WM_ERASEBKGND, which is skipped for double-buffered windows.
+
+		return this->back_buffer.device_context;
+	}
+
+	void Window::cancelTimer(UINT_PTR timer)
+	{
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		size_t index = (size_t)(timer & (((UINT_PTR)1 << TIMER_GENERATION_SHIFT) - 1)) - 1;
+
+
+		if(index < thread_state.timers.size() && thread_state.timers[index].active && thread_state.timers[index].window == this && (thread_state.timers[index].generation & ((UINT)-1 >> TIMER_GENERATION_SHIFT)) == (UINT)(timer >> TIMER_GENERATION_SHIFT))
+		{
+			RemoveTimer(index);
+			ArmNativeTimer();
+		}
+	}
+
+	Control* Window::createControl()
+	{
+		return this->createControl(L"");
+	}
+
+	Control* Window::createControl(const wchar* control_name)
+	{
+		assert(control_name != nullptr);
+
+
+		Control* control = new Control(this,control_name);
+
+
+		this->controls.push_back(control);
+		this->control_index.insert(control,control->rectangle);
+
+		return control;
+	}
+
+	Control* Window::createControl(const std::wstring& control_name)
+	{
+		return this->createControl(control_name.c_str());
+	}
+
+	void Window::destroy()
+	{
+		if(!this->isRealized())
+		{
+			std::vector<Window*> children;
+
+
+			if(this->deferred.destroyed)
+			{
+				return;
+			}
+			this->deferred.destroyed = true;  //Set first, so that a handler destroying this window again has no effect.
+
+			this->getMessageHandler(WM_DESTROY)(this,0,0);  //As for a native window: the parent is told before its children, and the children are gone before the parent's WM_NCDESTROY.
+			this->destroyControls();
+			children.swap(this->deferred.children);
+			for(Window* child : children)
+			{
+				child->destroy();
+			}
+
+			if(this->deferred.parent != nullptr)
+			{
+				std::vector<Window*>& siblings = this->deferred.parent->deferred.children;
+
+
+				siblings.erase(std::remove(siblings.begin(),siblings.end(),this),siblings.end());
+				this->deferred.parent = nullptr;
+			}
+			this->getMessageHandler(WM_NCDESTROY)(this,0,0);
+
+			this->deferred.properties.clear();
+			this->releaseResources();
+			this->window_class->retire(this);
+
+			return;
+		}
+
+		if(this->isAlive())
+		{
+			if(!DestroyWindow(this->window_handle))
+			{
+				DisplayErrorMessage();
+			}
+		}
+	}
+
+	void Window::destroyControl(Control*& control)
+	{
+		assert(control != nullptr);
+		assert(control->host == this);
+
+
+		if(this->focused_control == control)
+		{
+			this->focused_control = nullptr;
+		}
+
+		control->sendMessage(WM_DESTROY);
+		control->invalidate();
+		this->control_index.remove(control);
+		this->controls.erase(std::remove(this->controls.begin(),this->controls.end(),control),this->controls.end());
+		delete control;
+
+		control = nullptr;
+	}
+
+	void Window::destroyControls()
+	{
+		std::vector<Control*> controls;
+
+
+		controls.swap(this->controls);
+		this->control_index = SpatialIndex<Control*>();
+		this->focused_control = nullptr;
+
+		for(Control* control : controls)
+		{
+			control->sendMessage(WM_DESTROY);
+			delete control;
+		}
+	}
+
+	bool Window::dispatchToControls(UINT message,WPARAM w_param,LPARAM l_param,LRESULT& result)
+	{
+		Control* control;
+
+
+		switch(message)
+		{
+			case WM_MOUSEMOVE:
+			case WM_LBUTTONDOWN:
+			case WM_LBUTTONUP:
+			case WM_RBUTTONDOWN:
+			case WM_RBUTTONUP:
+			{
+				LONG x = GET_X_LPARAM(l_param);
+				LONG y = GET_Y_LPARAM(l_param);
+
+
+				control = this->getControlByLocation(x,y,CWP_SKIPINVISIBLE | CWP_SKIPDISABLED);
+				if(control == nullptr)
+				{
+					return false;
+				}
+
+				if(message == WM_LBUTTONDOWN || message == WM_RBUTTONDOWN)
+				{
+					control->setFocus();
+				}
+				l_param = MAKELPARAM(x - control->rectangle.left,y - control->rectangle.top);
+
+				break;
+			}
+
+			case WM_KEYDOWN:
+			case WM_KEYUP:
+			case WM_CHAR:
+				control = this->focused_control;
+				if(control == nullptr)
+				{
+					return false;
+				}
+
+				if(message == WM_KEYDOWN && w_param == VK_TAB)  //Cycle focus through the focusable controls, the same as a dialog would for child windows.
+				{
+					auto position = std::find(this->controls.begin(),this->controls.end(),control);
+
+
+					for(size_t step = 1;step < this->controls.size();++step)
+					{
+						Control* candidate = this->controls[(position - this->controls.begin() + step) % this->controls.size()];
+
+
+						if(candidate->isVisible() && candidate->isEnabled())
+						{
+							candidate->setFocus();
+
+							break;
+						}
+					}
+
+					result = 0;
+
+					return true;
+				}
+
+				break;
+
+			default:
+				return false;
+		}
+
+		result = control->sendMessage(message,w_param,l_param);
+
+		return true;
+	}
+
+	void Window::endPaint(PAINTSTRUCT& paintstruct)
+	{
+		if(this->back_buffer.saved_state != 0)
+		{
+			const RECT& area = paintstruct.rcPaint;
+
+
+			if(!this->controls.empty())
+			{
+				this->paintControls(this->back_buffer.device_context,area);
+				this->back_buffer.controls_painted = true;
+			}
+
+			BitBlt(paintstruct.hdc,area.left,area.top,area.right - area.left,area.bottom - area.top,this->back_buffer.device_context,area.left,area.top,SRCCOPY);
+			RestoreDC(this->back_buffer.device_context,this->back_buffer.saved_state);
+			this->back_buffer.saved_state = 0;
+		}
+
+		EndPaint(this->getNativeHandle(),&paintstruct);
+	}
+
+	void Window::extendMessageHandler(UINT message,ExtendingMessageHandler handler)
+	{
+		assert(handler);
+
+
+		this->setMessageHandler(message,ExtendMessageHandler<Window>(this->getMessageHandler(message),handler));
+	}
+
+	Window* Window::FromHandle(HWND window_handle)
+	{
+		unsigned generation = window_instance_generation.load(std::memory_order_acquire);
+		Window* window;
+
+
+		if(window_handle == last_window_handle && generation == last_window_generation)  //Successive messages are usually for the same window.
+		{
+			return last_window;
+		}
+
+		window = GetWindowInstance(window_handle);
+		if(window == nullptr)
+		{
+			window = WindowClass::GetByWindowHandle(window_handle)->manage(window_handle);
+			if(window->getName() == L"button#prototype")
+			{
+				DebugBreak();
+			}
+		}
+
+		last_window_handle = window_handle;
+		last_window = window;
+		last_window_generation = generation;
+
+		return window;
+	}
+
+	HBRUSH Window::getBackground()
+	{
+		if(this->properties.background == nullptr)
+		{
+			return this->window_class->getBackground();
+		}
+		else
+		{
+			return this->properties.background;
+		}
+	}
+
+	Window* Window::getChildByLocation(LONG x,LONG y,UINT flags)
+	{
+		if(!this->isRealized())
+		{
+			return nullptr;
+		}
+
+		POINT point = {x,y};
+		RECT client_rectangle = this->getRectangle(true);
+		Window* child;
+
+
+		if(!PtInRect(&client_rectangle,point))
+		{ 
+			return nullptr;
+		}
+
+		if(this->unindexed_children)
+		{
+			HWND child_handle = ChildWindowFromPointEx(this->window_handle,point,flags);
+
+
+			return child_handle == nullptr ? nullptr : Window::FromHandle(child_handle);
+		}
+
+		child = this->child_index.queryPoint(x,y,[flags](Window* child){
+			return child->isEligibleForHitTest(flags);
+		});
+
+		return child == nullptr ? this : child;  //As with ChildWindowFromPointEx, a point inside this window but over no child yields this window.
+	}
+
+	std::vector<Window*> Window::getChildrenInRectangle(const RECT& rectangle,UINT flags)
+	{
+		if(this->unindexed_children)
+		{
+			std::vector<Window*> children;
+
+
+			for(HWND child_handle = GetWindow(this->window_handle,GW_CHILD);child_handle != nullptr;child_handle = GetWindow(child_handle,GW_HWNDNEXT))  //Top-most first.
+			{
+				Window* child = Window::FromHandle(child_handle);
+				RECT child_rectangle;
+				RECT intersection;
+
+
+				GetWindowRect(child_handle,&child_rectangle);
+				MapWindowPoints(nullptr,this->window_handle,(POINT*)&child_rectangle,2);
+				if(IntersectRect(&intersection,&child_rectangle,&rectangle) && child->isEligibleForHitTest(flags))
+				{
+					children.push_back(child);
+				}
+			}
+			std::reverse(children.begin(),children.end());
+
+			return children;
+		}
+
+		return this->child_index.queryRectangle(rectangle,[flags](Window* child){
+			return child->isEligibleForHitTest(flags);
+		});
+	}
+
+	Control* Window::getControlByLocation(LONG x,LONG y,UINT flags)
+	{
+		return this->control_index.queryPoint(x,y,[flags](Control* control){
+			return control->isEligibleForHitTest(flags);
+		});
+	}
+
+	const std::vector<Control*>& Window::getControls() const
+	{
+		return this->controls;
+	}
+
+	std::vector<Control*> Window::getControlsInRectangle(const RECT& rectangle,UINT flags)
+	{
+		return this->control_index.queryRectangle(rectangle,[flags](Control* control){
+			return control->isEligibleForHitTest(flags);
+		});
+	}
+
+	DWORD Window::getExtendedStyle()
+	{
+		if(!this->isRealized())
+		{
+			return this->deferred.style_extended;
+		}
+
+		return GetWindowLongPtr(this->getNativeHandle(),GWL_EXSTYLE);
+	}
+
+	Control* Window::getFocusedControl()
+	{
+		return this->focused_control;
+	}
+
+	int Window::getHeight()
+	{
+		RECT rectangle = this->getRectangle();
+
+
+		return rectangle.bottom - rectangle.top;
+	}
+
+	int Window::getIdentifier()
+	{
+		return GetWindowLongPtr(this->getNativeHandle(),GWLP_ID);
+	}
+
+	Layout* Window::getLayout()
+	{
+		if(this->layout == nullptr)
+		{
+			this->layout = new Layout(this);
+		}
+
+		return this->layout;
+	}
+
+	MessageHandler Window::getMessageHandler(UINT message)
+	{
+		auto handler = this->message_handlers.find(message);
+
+
+		if(handler != this->message_handlers.end())
+		{
+			return handler->second;
+		}
+		else if(this->static_message_map != nullptr && this->static_message_map->handles(message))
+		{
+			const StaticMessageMap* message_map = this->static_message_map;
+
+
+			return [message_map,message](Window* window,WPARAM w_param,LPARAM l_param)
+			{
+				LRESULT result = 0;
+
+
+				message_map->dispatch(window,message,w_param,l_param,result);
+
+				return result;
+			};
+		}
+		else
+		{
+			return this->getWindowClass()->getDefaultMessageHandler(message);
+		}
+	}
+
+	Module& Window::getModule()
+	{
+		return this->module;
+	}
+
+	std::wstring Window::getName()
+	{
+		std::wstring window_text;
+		int window_text_length;
+
+
+		if(!this->isRealized())
+		{
+			return this->deferred.name;
+		}
+
+		window_text_length = GetWindowTextLength(this->getNativeHandle());
+		if(window_text_length > 0)
+		{
+			wchar* buffer;
+
+
+			buffer = new wchar[window_text_length + 1];
+			buffer[window_text_length] = 0;
+			GetWindowText(this->getNativeHandle(),buffer,window_text_length + 1);
+			window_text = buffer;
+			delete[] buffer;
+		}
+
+		return window_text;
+	}
+
+	HWND Window::getNativeHandle()
+	{
+		this->realize();
+
+		return this->window_handle;
+	}
+
+	Window* Window::getOwner()
+	{
+		HWND window_handle = GetWindow(this->getNativeHandle(),GW_OWNER);
+
+
+		return window_handle == nullptr ? nullptr : Window::FromHandle(window_handle);
+	}
+
+	Window* Window::getParent()
+	{
+		if(!this->isRealized())
+		{
+			return this->deferred.parent;
+		}
+
+		HWND parent = GetAncestor(this->getNativeHandle(),GA_PARENT);
+
+
+		if(parent == this->getWindowClass()->prototype->getNativeHandle())
+		{
+			return nullptr;
+		}
+		else
+		{
+			return parent == nullptr ? nullptr : Window::FromHandle(parent);
+		}
+	}
+
+	HANDLE Window::getProperty(const wchar* property_name)
+	{
+		if(!this->isRealized())
+		{
+			auto property = this->deferred.properties.find(property_name);
+
+
+			return property == this->deferred.properties.end() ? nullptr : property->second;
+		}
+
+		return GetProp(this->getNativeHandle(),property_name);
+	}
+
+	HANDLE Window::getProperty(const std::wstring& property_name)
+	{
+		return this->getProperty(property_name.c_str());
+	}
+
+	RECT Window::getRectangle(bool client_area)
+	{
+		RECT rectangle;
+
+
+		if(!this->isRealized())  //Non-client metrics are unknown until the window exists, so both areas are reported as the recorded bounds.
+		{
+			rectangle.left = client_area ? 0 : this->deferred.x;
+			rectangle.top = client_area ? 0 : this->deferred.y;
+			rectangle.right = rectangle.left + this->deferred.width;
+			rectangle.bottom = rectangle.top + this->deferred.height;
+		}
+		else if(client_area)
+		{
+			GetClientRect(this->getNativeHandle(),&rectangle);
+		}
+		else
+		{
+			GetWindowRect(this->getNativeHandle(),&rectangle);
+		}
+
+		return rectangle;
+	}
+
+	DWORD Window::getStyle()
+	{
+		if(!this->isRealized())
+		{
+			return this->deferred.style;
+		}
+
+		return GetWindowLongPtr(this->getNativeHandle(),GWL_STYLE);
+	}
+
+	Graphics::Surface& Window::getSurface()
+	{
+		RECT client_rectangle = this->getRectangle(true);
+
+
+		if(this->surface == nullptr)
+		{
+			this->surface = new Graphics::Surface();
+		}
+		this->surface->resize(client_rectangle.right,client_rectangle.bottom);
+
+		return *this->surface;
+	}
+
+	int Window::getWidth()
+	{
+		RECT rectangle = this->getRectangle();
+
+
+		return rectangle.right - rectangle.left;
+	}
+
+	WindowClass* Window::getWindowClass() const
+	{
+		return this->window_class;
+	}
+
+	int Window::getXCoordinate(bool relative)
+	{
+		if(!this->isRealized())
+		{
+			return this->deferred.x;
+		}
+
+		RECT rectangle = this->getRectangle();
+
+
+		if(relative)
+		{
+			POINT point;
+
+
+			point.x = rectangle.left;
+			point.y = rectangle.top;
+
+			ScreenToClient(this->getNativeHandle(),&point);
+
+			return point.x;
+		}
+		else
+		{
+			return rectangle.left;
+		}
+	}
+
+	int Window::getYCoordinate(bool relative)
+	{
+		if(!this->isRealized())
+		{
+			return this->deferred.y;
+		}
+
+		RECT rectangle = this->getRectangle();
+
+
+		if(relative)
+		{
+			POINT point;
+
+
+			point.x = rectangle.left;
+			point.y = rectangle.top;
+
+			ScreenToClient(this->getNativeHandle(),&point);
+
+			return point.y;
+		}
+		else
+		{
+			return rectangle.top;
+		}
+	}
+
+	LRESULT Window::HandleMessage(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param)
+	{
+		LRESULT result;
+		RECT update_rectangle = {0,0,0,0};
+		Window* window = Window::FromHandle(window_handle);
+		MessageDispatchScope dispatch;  //Declared before the recorder, so that the flush is not counted as part of handling the message.
+		MessageLatencyRecorder latency(message,window->window_class);  //Captures the class up front, as the window may be gone by the time the message has been handled.
+
+
+		if(message_recording.load(std::memory_order_relaxed))
+		{
+			RecordMessage(window_handle,message,w_param,l_param);
+		}
+
+		switch(message)
+		{
+			case WM_NCCREATE:
+				//this->init();
+
+				break;
+
+			case WM_PAINT:
+				if(!window->controls.empty())
+				{
+					GetUpdateRect(window_handle,&update_rectangle,FALSE);  //Captured before the handler validates the window.
+				}
+				window->back_buffer.controls_painted = false;
+				window->render_cache.stale = true;
+
+				break;
+
+			case WM_ENABLE:
+			case WM_SETTEXT:
+			case WM_SIZE:
+				window->render_cache.stale = true;
+
+				break;
+		}
+
+		if(!window->controls.empty() && window->dispatchToControls(message,w_param,l_param,result))
+		{
+			return result;
+		}
+
+		if(window->static_message_map == nullptr || window->message_handlers.count(message) != 0 || !window->static_message_map->dispatch(window,message,w_param,l_param,result))  //A static handler is called directly, unless the window has been given one at run time.
+		{
+			result = window->getMessageHandler(message)(window,w_param,l_param);
+		}
+
+		switch(message)
+		{
+			case WM_CREATE:
+				window->indexInParent();
+
+				break;
+
+			case WM_PARENTNOTIFY:
+				if(LOWORD(w_param) == WM_CREATE && GetAncestor((HWND)l_param,GA_PARENT) == window_handle)  //Sent after the child's WM_CREATE, by which a managed child has indexed itself.
+				{
+					Window* child = GetWindowInstance((HWND)l_param);
+
+
+					if(child == nullptr || !window->child_index.contains(child))
+					{
+						window->unindexed_children = true;
+					}
+				}
+
+				break;
+
+			case WM_PAINT:
+				if(!window->controls.empty() && !window->back_buffer.controls_painted)  //A double-buffered paint draws the controls into the back buffer before copying it.
+				{
+					HDC device_context = GetDC(window_handle);
+
+
+					window->paintControls(device_context,update_rectangle);
+					ReleaseDC(window_handle,device_context);
+				}
+
+				break;
+
+			case WM_SIZE:
+				if(window->layout != nullptr && window->layout->parent == nullptr)  //Only a root lays itself out again when resized; other nodes are sized by their parent.
+				{
+					window->layout->arrange_valid = false;
+					window->layout->update();
+				}
+
+				break;
+
+			case WM_WINDOWPOSCHANGED:
+				window->indexInParent((const WINDOWPOS*)l_param);
+
+				break;
+
+			case WM_NCDESTROY:
+				{
+					std::vector<Window*> children;  //Hidden children which were never realized, and so were not destroyed along with the native window.
+
+
+					children.swap(window->deferred.children);
+					for(Window* child : children)
+					{
+						child->destroy();
+					}
+				}
+				window->releaseResources();
+				window->removeProperty(WINDOW_INSTANCE_PROPERTY);
+				window_instance_generation.fetch_add(1,std::memory_order_release);
+				window->window_handle = nullptr;
+
+				break;
+		}
+
+		return result;
+	}
+
+	bool Window::hasParent()
+	{
+		return this->getParent() != nullptr;
+	}
+
+	void Window::indexInParent(const WINDOWPOS* position)
+	{
+		HWND parent_handle = GetAncestor(this->window_handle,GA_PARENT);
+		Window* parent = nullptr;
+		RECT rectangle;
+
+
+		if((GetWindowLongPtr(this->window_handle,GWL_STYLE) & WS_CHILD) != 0 && parent_handle != nullptr)
+		{
+			parent = GetWindowInstance(parent_handle);  //Only windows managed by this API keep an index; prototypes and foreign windows do not.
+		}
+
+		if(this->indexed_parent != nullptr && this->indexed_parent != parent)
+		{
+			this->indexed_parent->child_index.remove(this);
+		}
+		this->indexed_parent = parent;
+
+		if(parent == nullptr)
+		{
+			return;
+		}
 
+		GetWindowRect(this->window_handle,&rectangle);
+		MapWindowPoints(nullptr,parent_handle,(POINT*)&rectangle,2);
 
-		if(resource_location == nullptr)
+		if(!parent->child_index.contains(this))
 		{
-			if(IsDebuggerPresent())
+			parent->child_index.insert(this,rectangle);  //Newly created and newly re-parented windows are placed at the top of the z-order.
+		}
+		else
+		{
+			parent->child_index.update(this,rectangle);
+
+			if(position != nullptr && (position->flags & SWP_NOZORDER) == 0)
 			{
-				OutputDebugString(std::wstring(L"Failed to locate resource with id=").append(std::to_wstring(resource_id)).append(L".\n").c_str());
-				DisplayErrorMessage();
-			}
+				if(position->hwndInsertAfter == HWND_TOP || position->hwndInsertAfter == HWND_TOPMOST)
+				{
+					parent->child_index.raise(this);
+				}
+				else if(position->hwndInsertAfter == HWND_BOTTOM)
+				{
+					parent->child_index.lower(this);
+				}
+				else
+				{
+					std::vector<Window*> siblings;
 
-			throw OS::RuntimeException();
-		}
 
-		return resource_location;
+					for(HWND sibling = GetWindow(parent_handle,GW_CHILD);sibling != nullptr;sibling = GetWindow(sibling,GW_HWNDNEXT))
+					{
+						siblings.push_back(GetWindowInstance(sibling));
+					}
+
+					parent->child_index.setZOrder(siblings);
+				}
+			}
+		}
 	}
 
-	DWORD Module::getResourceSize(WORD resource_id,const wchar* resource_type,WORD language)
+	void Window::invalidate(const RECT* rectangle,bool erase)
 	{
-		DWORD resource_size = SizeofResource(*this,this->getResourceLocation(resource_id,resource_type,language));
+		ThreadWindowState& thread_state = GetThreadWindowState();
 
 
-		if(resource_size == 0)
+		if(!this->isRealized())
 		{
-			if(IsDebuggerPresent())
-			{
-				DisplayErrorMessage();
-			}
-
-			throw OS::RuntimeException();
+			return;
 		}
 
-		return resource_size;
-	}
+		this->render_cache.stale = true;
 
-	std::wstring Module::getStringResource(WORD resource_id)
-	{
-		wchar* buffer;
-		std::wstring resource;
+		if(!this->invalidation.pending)
+		{
+			this->invalidation.pending = true;
+			this->invalidation.children = false;
+			this->invalidation.erase = false;
+			this->invalidation.whole = false;
+			SetRectEmpty(&this->invalidation.rectangle);
 
+			thread_state.invalidated_windows.push_back(this);
+		}
 
-		if(LoadString(*this,resource_id,(wchar*)&buffer,0) == 0)
+		if(erase)
 		{
-			if(IsDebuggerPresent())
-			{
-				DisplayErrorMessage();
-			}
-
-			throw OS::RuntimeException(std::string("The requested resource does not exist.").c_str());
+			this->invalidation.erase = true;
 		}
 
-		//TODO:  The following is an ugly quickfix for the fact that strings are having random control characters appended to them where there should be a null character
-		resource = buffer;
-		if(resource.find_first_of(L"\x1\x2\x3\x4\x5\x6\x7\x8\x9\xA\xB\xC\xD\xE\xF\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1A\x1B\x1C\x1D\x1E\x1F") != std::wstring::npos)
+		if(rectangle == nullptr)
 		{
-			return resource.substr(0,resource.find_first_of(L"\x1\x2\x3\x4\x5\x6\x7\x8\x9\xA\xB\xC\xD\xE\xF\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1A\x1B\x1C\x1D\x1E\x1F"));
+			this->invalidation.whole = true;
 		}
-		else
+		else if(!this->invalidation.whole)
 		{
-			return buffer;
+			UnionRect(&this->invalidation.rectangle,&this->invalidation.rectangle,rectangle);
 		}
 	}
 
-	DWORD Module::getStringResourceSize(WORD resource_id)
+	bool Window::hasProperty(PropertyId property)
 	{
-		wchar* buffer;
-
-
-		return LoadString(*this,resource_id,(wchar*)&buffer,0);
+		return this->property_store.contains(property);
 	}
 
-	Module::operator HINSTANCE&()
+	bool Window::isAlive()
 	{
-		return this->module_handle;
+		if(this->deferred.destroyed)
+		{
+			return false;
+		}
+
+		return !this->isRealized() || (this->window_handle != nullptr && IsWindow(this->window_handle));
 	}
 
-	/* Type [OS::Window] Definition */
-	Window::Window(HWND window_handle,WindowClass* window_class)
-	: module((HINSTANCE)GetWindowLongPtr(window_handle,GWLP_HINSTANCE))
+	bool Window::isAnimating()
 	{
-		assert(IsWindow(window_handle));
+		ThreadWindowState& thread_state = GetThreadWindowState();
 
 
-		this->window_handle = window_handle;
-		this->window_class = window_class;
+		return thread_state.window_animations.find(this) != thread_state.window_animations.end();
 	}
 
-	void Window::addExtendedStyle(DWORD style)
+	bool Window::isDoubleBuffered()
 	{
-		this->setExtendedStyle(this->getExtendedStyle() | style);
+		return this->back_buffer.enabled;
 	}
 
-	void Window::addStyle(DWORD style)
+	bool Window::isEligibleForHitTest(UINT flags)
 	{
-		this->setStyle(this->getStyle() | style);
-	}
+		if((flags & CWP_SKIPINVISIBLE) != 0 && !IsWindowVisible(this->window_handle))
+		{
+			return false;
+		}
 
-	HDC Window::beginPaint(PAINTSTRUCT& paintstruct)
-	{
-		return BeginPaint(this->getNativeHandle(),&paintstruct);
+		if((flags & CWP_SKIPDISABLED) != 0 && !IsWindowEnabled(this->window_handle))
+		{
+			return false;
+		}
+
+		if((flags & CWP_SKIPTRANSPARENT) != 0 && (GetWindowLongPtr(this->window_handle,GWL_EXSTYLE) & WS_EX_TRANSPARENT) != 0)
+		{
+			return false;
+		}
+
+		return true;
 	}
 
-	void Window::destroy()
+	bool Window::isPaintingSuspended()
 	{
-		if(this->isAlive())
+		for(Window* window = this;window != nullptr;window = window->indexed_parent)  //The indexed parent is the nearest managed ancestor.
 		{
-			if(!DestroyWindow(this->window_handle))
+			if(window->painting_suspensions > 0)
 			{
-				DisplayErrorMessage();
+				return true;
 			}
 		}
+
+		return false;
 	}
 
-	void Window::endPaint(PAINTSTRUCT& paintstruct)
+	bool Window::isRealized() const
 	{
-		EndPaint(this->getNativeHandle(),&paintstruct);
+		return !this->deferred.pending;
 	}
 
-	void Window::extendMessageHandler(UINT message,ExtendingMessageHandler handler)
+	bool Window::isTopLevel()
 	{
-		assert(handler);
+		return !this->hasParent();
+	}
 
+	bool Window::isVisible()
+	{
+		if(!this->isRealized())
+		{
+			return false;
+		}
 
-		MessageHandler previous_handler = this->getMessageHandler(message);
+		return IsWindowVisible(this->getNativeHandle()) == TRUE;
+	}
 
+	void Window::maximize(bool animate)
+	{
+		HWND window_handle = this->getNativeHandle();
+		WINDOWPLACEMENT placement;
 
-		this->setMessageHandler(message,[handler,previous_handler](Window* window,WPARAM w_param,LPARAM l_param){
-			LRESULT result;
 
+		if(!animate || !IsWindowVisible(window_handle) || IsIconic(window_handle) || IsZoomed(window_handle))
+		{
+			ShowWindow(window_handle,SW_MAXIMIZE);
 
-			result = previous_handler(window,w_param,l_param);
-			handler(window,w_param,l_param);
+			return;
+		}
 
-			return result;
+		placement.length = sizeof(placement);
+		GetWindowPlacement(window_handle,&placement);
+		placement.showCmd = SW_MAXIMIZE;
+		this->animateGeometry(GetMaximizedRectangle(window_handle),WINDOW_STATE_ANIMATION_DURATION,Animation::Easing::EASE_OUT,[placement](Window* window){
+			SetWindowPlacement(window->getNativeHandle(),&placement);  //Maximizes the window while keeping the position it is restored to as it was before the animation.
 		});
 	}
 
-	Window* Window::FromHandle(HWND window_handle)
+	void Window::minimize(bool animate)
 	{
-		Window* window;
+		HWND window_handle = this->getNativeHandle();
+		BYTE opacity;
+		bool layered;
 
 
-		window = (Window*)GetProp(window_handle,WINDOW_INSTANCE_PROPERTY);
-		if(window == nullptr)
+		if(!animate || !IsWindowVisible(window_handle) || IsIconic(window_handle) || (this->getStyle() & WS_CHILD) != 0)
 		{
-			window = WindowClass::GetByWindowHandle(window_handle)->manage(window_handle);
-			if(window->getName() == L"button#prototype")
-			{
-				DebugBreak();
-			}
+			ShowWindow(window_handle,SW_MINIMIZE);
+
+			return;
 		}
 
-		return window;
+		opacity = GetWindowOpacity(this);
+		layered = (this->getExtendedStyle() & WS_EX_LAYERED) != 0;
+		this->animateOpacity(0,WINDOW_STATE_ANIMATION_DURATION,Animation::Easing::EASE_IN,[opacity,layered](Window* window){
+			ShowWindow(window->getNativeHandle(),SW_MINIMIZE);
+			if(layered)
+			{
+				SetWindowOpacity(window,opacity);
+			}
+			else
+			{
+				window->removeExtendedStyle(WS_EX_LAYERED);
+			}
+		});
 	}
 
-	HBRUSH Window::getBackground()
+	void Window::notifyPropertyObservers(PropertyId property)
 	{
-		if(this->properties.background == nullptr)
+		std::vector<PropertyObserver> observers;
+
+
+		for(auto& entry : this->property_observers)  //Copied first, as observers may observe or unobserve properties themselves.
 		{
-			return this->window_class->getBackground();
+			if(entry.property == property)
+			{
+				observers.push_back(entry.observer);
+			}
 		}
-		else
+
+		for(auto& observer : observers)
 		{
-			return this->properties.background;
+			observer(this,property);
 		}
 	}
 
-	Window* Window::getChildByLocation(LONG x,LONG y,UINT flags)
+	UINT_PTR Window::observeProperty(PropertyId property,PropertyObserver observer)
 	{
-		POINT point = {x,y};
-		HWND child_handle = ChildWindowFromPointEx(this->window_handle,point,flags);
+		PropertyObserverEntry entry;
 
 
-		if(child_handle == nullptr)
-		{ 
-			return nullptr;
-		}
-		else
-		{
-			return WindowClass::GetByWindowHandle(child_handle)->manage(child_handle);
-		}
-	}
+		assert(observer);
 
-	DWORD Window::getExtendedStyle()
-	{
-		return GetWindowLongPtr(this->getNativeHandle(),GWL_EXSTYLE);
+		entry.id = ++this->last_property_observer;
+		entry.property = property;
+		entry.observer = observer;
+		this->property_observers.push_back(entry);
+
+		return entry.id;
 	}
 
-	int Window::getHeight()
+	void Window::paintControls(HDC device_context,const RECT& update_rectangle)
 	{
-		RECT rectangle = this->getRectangle();
+		for(Control* control : this->getControlsInRectangle(update_rectangle,CWP_SKIPINVISIBLE))
+		{
+			RECT clip_rectangle;
 
 
-		return rectangle.bottom - rectangle.top;
-	}
+			IntersectRect(&clip_rectangle,&control->rectangle,&update_rectangle);
 
-	int Window::getIdentifier()
-	{
-		return GetWindowLongPtr(this->getNativeHandle(),GWLP_ID);
+			int saved_state = SaveDC(device_context);
+
+
+			IntersectClipRect(device_context,clip_rectangle.left,clip_rectangle.top,clip_rectangle.right,clip_rectangle.bottom);
+			control->sendMessage(WM_PAINT,(WPARAM)device_context,(LPARAM)&control->rectangle);
+			RestoreDC(device_context,saved_state);
+		}
 	}
 
-	MessageHandler Window::getMessageHandler(UINT message)
+	void Window::presentSurface(HDC device_context,const RECT* area)
 	{
-		if(this->message_handlers.count(message) > 0)
+		assert(device_context != nullptr);
+
+
+		BITMAPINFO bitmap_info = {};
+		Graphics::Bounds bounds;
+
+
+		if(this->surface == nullptr)
+		{
+			return;
+		}
+
+		if(area == nullptr)
 		{
-			return this->message_handlers[message];
+			bounds = {0,0,this->surface->getWidth(),this->surface->getHeight()};
 		}
 		else
 		{
-			return this->getWindowClass()->getDefaultMessageHandler(message);
+			bounds = {area->left,area->top,area->right,area->bottom};
+		}
+		if(!this->surface->clip(bounds))
+		{
+			return;
 		}
-	}
 
-	Module& Window::getModule()
-	{
-		return this->module;
+		bitmap_info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		bitmap_info.bmiHeader.biWidth = this->surface->getStride();
+		bitmap_info.bmiHeader.biHeight = -(bounds.bottom - bounds.top);  //Top-down, matching the surface's row order.
+		bitmap_info.bmiHeader.biPlanes = 1;
+		bitmap_info.bmiHeader.biBitCount = 32;
+		bitmap_info.bmiHeader.biCompression = BI_RGB;
+
+		//Only the rows of the area are passed, which sidesteps the bottom-up source origin SetDIBitsToDevice uses even for top-down bitmaps.
+		SetDIBitsToDevice(device_context,bounds.left,bounds.top,bounds.right - bounds.left,bounds.bottom - bounds.top,bounds.left,0,0,bounds.bottom - bounds.top,this->surface->getRow(bounds.top),&bitmap_info,DIB_RGB_COLORS);
 	}
 
-	std::wstring Window::getName()
+	void Window::realize()
 	{
-		std::wstring window_text;
-		int window_text_length;
+		TRACE_SCOPE("OS::Window::realize");
+		HWND parent_handle;
+		Window* previous_realizing_window;
+		std::vector<Window*> children;
 
 
-		window_text_length = GetWindowTextLength(this->getNativeHandle());
-		if(window_text_length > 0)
+		if(this->isRealized() || this->deferred.destroyed)
 		{
-			wchar* buffer;
+			return;
+		}
+
+		if(this->deferred.parent != nullptr)
+		{
+			parent_handle = this->deferred.parent->getNativeHandle();
+			if(this->isRealized())  //Realizing the parent realized this window too, as one of its visible children.
+			{
+				return;
+			}
+		}
+		else
+		{
+			parent_handle = this->window_class->prototype->getNativeHandle();
+		}
+
+		this->deferred.pending = false;  //Messages sent during creation must see this window as realized.
+		previous_realizing_window = realizing_window;
+		realizing_window = this;  //WindowClass::manage adopts this object for the handle instead of creating a new one.
+		CreateWindowEx(
+			this->deferred.style_extended,  // Extended Style
+			this->window_class->getClassName(),  // Window class name
+			this->deferred.name.c_str(),  // Window name
+			this->deferred.style, // Window style
+			this->deferred.x, // Window x-coordinate
+			this->deferred.y, // Window y-coordinate
+			this->deferred.width, // Window width
+			this->deferred.height, // Window height
+			parent_handle, // Parent window handle
+			0, // Menu handle
+			this->module,
+			nullptr
+		);
+		realizing_window = previous_realizing_window;  //Restored for a window whose creation is realizing this one.
 
+		if(this->window_handle == nullptr)
+		{
+			this->deferred.pending = true;
 
-			buffer = new wchar[window_text_length + 1];
-			buffer[window_text_length] = 0;
-			GetWindowText(this->getNativeHandle(),buffer,window_text_length + 1);
-			window_text = buffer;
-			delete[] buffer;
+			DisplayErrorMessage();
+			throw OS::RuntimeException("Failed to realize deferred window.");
 		}
 
-		return window_text;
+		for(auto& property : this->deferred.properties)
+		{
+			SetProp(this->window_handle,property.first.c_str(),property.second);
+		}
+		this->deferred.properties.clear();
+
+		if(this->deferred.parent != nullptr)
+		{
+			std::vector<Window*>& siblings = this->deferred.parent->deferred.children;
+
+
+			siblings.erase(std::remove(siblings.begin(),siblings.end(),this),siblings.end());
+			this->deferred.parent = nullptr;
+		}
+
+		children.swap(this->deferred.children);
+		for(Window* child : children)
+		{
+			if((child->deferred.style & WS_VISIBLE) != 0)
+			{
+				child->realize();
+			}
+			else
+			{
+				this->deferred.children.push_back(child);
+			}
+		}
 	}
 
-	HWND Window::getNativeHandle() const
+	void Window::releaseBackBuffer()
 	{
-		return this->window_handle;
+		ThreadWindowState& thread_state = GetThreadWindowState();
+
+
+		if(this->back_buffer.device_context == nullptr)
+		{
+			return;
+		}
+
+		SelectObject(this->back_buffer.device_context,this->back_buffer.previous_bitmap);
+		DeleteObject(this->back_buffer.bitmap);
+		DeleteDC(this->back_buffer.device_context);
+		back_buffer_usage -= (size_t)this->back_buffer.width * this->back_buffer.height * 4;
+		thread_state.back_buffered_windows.remove(this);
+
+		this->back_buffer.device_context = nullptr;
+		this->back_buffer.bitmap = nullptr;
+		this->back_buffer.previous_bitmap = nullptr;
+		this->back_buffer.width = 0;
+		this->back_buffer.height = 0;
 	}
 
-	Window* Window::getOwner()
+	void Window::releaseResources()
 	{
-		HWND window_handle = GetWindow(this->getNativeHandle(),GW_OWNER);
+		if(this->indexed_parent != nullptr)
+		{
+			this->indexed_parent->child_index.remove(this);
+			this->indexed_parent = nullptr;
+		}
+		if(this->invalidation.pending)
+		{
+			std::vector<Window*>& invalidated_windows = GetThreadWindowState().invalidated_windows;
 
 
-		return window_handle == nullptr ? nullptr : Window::FromHandle(window_handle);
+			invalidated_windows.erase(std::remove(invalidated_windows.begin(),invalidated_windows.end(),this),invalidated_windows.end());
+			this->invalidation.pending = false;
+		}
+		this->destroyControls();
+		this->releaseBackBuffer();
+		ReleaseGdiObject(this->properties.background);
+		this->properties.background = nullptr;
+		delete this->surface;
+		this->surface = nullptr;
+		delete this->render_cache.content;
+		this->render_cache.content = nullptr;
+		delete this->layout;
+		this->layout = nullptr;
+		CancelWindowTimers(this);
+		StopWindowAnimations(this);
+		this->property_store.clear();
+		this->property_observers.clear();
 	}
 
-	Window* Window::getParent()
+	void Window::removeExtendedStyle(DWORD style)
 	{
-		HWND parent = GetAncestor(this->getNativeHandle(),GA_PARENT);
+		StyleEdit edit;
 
 
-		if(parent == this->getWindowClass()->prototype->getNativeHandle())
-		{
-			return nullptr;
-		}
-		else
+		edit.removeExtendedStyle(this,style);
+	}
+	
+	void Window::removeProperty(const wchar* property_name)
+	{
+		if(!this->isRealized())
 		{
-			return parent == nullptr ? nullptr : Window::FromHandle(parent);
+			this->deferred.properties.erase(property_name);
+
+			return;
 		}
+
+		RemoveProp(this->getNativeHandle(),property_name);
 	}
 
-	HANDLE Window::getProperty(const wchar* property_name)
+	void Window::removeProperty(const std::wstring& property_name)
 	{
-		return GetProp(this->getNativeHandle(),property_name);
+		this->removeProperty(property_name.c_str());
 	}
 
-	HANDLE Window::getProperty(const std::wstring& property_name)
+	void Window::removeProperty(PropertyId property)
 	{
-		return this->getProperty(property_name.c_str());
+		if(this->property_store.remove(property) && !this->property_observers.empty())
+		{
+			this->notifyPropertyObservers(property);
+		}
 	}
 
-	RECT Window::getRectangle(bool client_area)
+	void Window::resumePainting()
 	{
-		RECT rectangle;
+		assert(this->painting_suspensions > 0);
 
 
-		if(client_area)
+		if(--this->painting_suspensions > 0)
 		{
-			GetClientRect(this->getNativeHandle(),&rectangle);
+			return;
 		}
-		else
+
+		if(this->isRealized() && this->isAlive())
 		{
-			GetWindowRect(this->getNativeHandle(),&rectangle);
+			SendMessage(this->window_handle,WM_SETREDRAW,TRUE,0);
 		}
 
-		return rectangle;
+		this->invalidate();
+		if(this->invalidation.pending)
+		{
+			this->invalidation.children = true;
+		}
 	}
 
-	DWORD Window::getStyle()
+	void Window::removeStyle(DWORD style)
 	{
-		return GetWindowLongPtr(this->getNativeHandle(),GWL_STYLE);
+		StyleEdit edit;
+
+
+		edit.removeStyle(this,style);
 	}
 
-	int Window::getWidth()
+	void Window::render(Graphics::Surface& target)
 	{
-		RECT rectangle = this->getRectangle();
+		RECT client_rectangle = this->getRectangle(true);
+		Graphics::Bounds clip = {0,0,client_rectangle.right,client_rectangle.bottom};
 
 
-		return rectangle.right - rectangle.left;
-	}
+		target.resize(client_rectangle.right,client_rectangle.bottom);
+		Graphics::FillRectangle(target,clip,0);
 
-	WindowClass* Window::getWindowClass() const
-	{
-		return this->window_class;
+		this->renderTree(target,0,0,clip);
 	}
 
-	int Window::getXCoordinate(bool relative)
+	void Window::renderContent()
 	{
-		RECT rectangle = this->getRectangle();
-
+		RECT client_rectangle = this->getRectangle(true);
+		int width = client_rectangle.right;
+		int height = client_rectangle.bottom;
+		BITMAPINFO bitmap_info = {};
+		void* bits = nullptr;
+		HDC screen_context;
+		HDC device_context;
+		HBITMAP bitmap;
+		HGDIOBJ previous_bitmap;
+
+
+		if(this->render_cache.content == nullptr)
+		{
+			this->render_cache.content = new Graphics::Surface();
+		}
+		else if(!this->render_cache.stale && this->render_cache.content->getWidth() == width && this->render_cache.content->getHeight() == height)
+		{
+			return;
+		}
 
-		if(relative)
+		this->render_cache.content->resize(width,height);
+		if(width <= 0 || height <= 0)
 		{
-			POINT point;
+			this->render_cache.stale = false;
 
+			return;
+		}
 
-			point.x = rectangle.left;
-			point.y = rectangle.top;
+		bitmap_info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		bitmap_info.bmiHeader.biWidth = width;
+		bitmap_info.bmiHeader.biHeight = -height;
+		bitmap_info.bmiHeader.biPlanes = 1;
+		bitmap_info.bmiHeader.biBitCount = 32;
+		bitmap_info.bmiHeader.biCompression = BI_RGB;
+
+		screen_context = GetDC(nullptr);
+		device_context = CreateCompatibleDC(screen_context);
+		bitmap = CreateDIBSection(screen_context,&bitmap_info,DIB_RGB_COLORS,&bits,nullptr,0);
+		ReleaseDC(nullptr,screen_context);
+		if(bitmap == nullptr)
+		{
+			DeleteDC(device_context);
 
-			ScreenToClient(this->getNativeHandle(),&point);
+			throw OS::RuntimeException("Failed to create a bitmap to render into.");
+		}
+		previous_bitmap = SelectObject(device_context,bitmap);
 
-			return point.x;
+		FillRect(device_context,&client_rectangle,this->getBackground());  //Double-buffered windows skip WM_ERASEBKGND.
+		SendMessage(this->window_handle,WM_PRINT,(WPARAM)device_context,PRF_CLIENT | PRF_ERASEBKGND);
+		if(!this->controls.empty())
+		{
+			this->paintControls(device_context,client_rectangle);
 		}
-		else
+		GdiFlush();
+
+		for(int y = 0;y < height;++y)
 		{
-			return rectangle.left;
+			const Graphics::Color* source = (const Graphics::Color*)bits + (size_t)y * width;
+			Graphics::Color* destination = this->render_cache.content->getRow(y);
+
+
+			for(int x = 0;x < width;++x)
+			{
+				destination[x] = source[x] | 0xFF000000;  //GDI leaves the alpha channel cleared.
+			}
 		}
-	}
 
-	int Window::getYCoordinate(bool relative)
-	{
-		RECT rectangle = this->getRectangle();
+		SelectObject(device_context,previous_bitmap);
+		DeleteObject(bitmap);
+		DeleteDC(device_context);
 
+		this->render_cache.stale = false;
+	}
 
-		if(relative)
-		{
-			POINT point;
+	HBITMAP Window::renderToBitmap()
+	{
+		Graphics::Surface target;
+		BITMAPINFO bitmap_info = {};
+		void* bits = nullptr;
+		HBITMAP bitmap;
 
 
-			point.x = rectangle.left;
-			point.y = rectangle.top;
+		this->render(target);
 
-			ScreenToClient(this->getNativeHandle(),&point);
+		bitmap_info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		bitmap_info.bmiHeader.biWidth = target.getStride();
+		bitmap_info.bmiHeader.biHeight = -target.getHeight();
+		bitmap_info.bmiHeader.biPlanes = 1;
+		bitmap_info.bmiHeader.biBitCount = 32;
+		bitmap_info.bmiHeader.biCompression = BI_RGB;
 
-			return point.y;
+		bitmap = CreateDIBSection(nullptr,&bitmap_info,DIB_RGB_COLORS,&bits,nullptr,0);
+		if(bitmap == nullptr)
+		{
+			throw OS::RuntimeException("Failed to create a bitmap to render into.");
 		}
-		else
+		if(target.getHeight() > 0)
 		{
-			return rectangle.top;
+			std::memcpy(bits,target.getRow(0),(size_t)target.getStride() * target.getHeight() * sizeof(Graphics::Color));
 		}
+
+		return bitmap;
 	}
 
-	LRESULT Window::HandleMessage(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param)
+	void Window::renderTree(Graphics::Surface& target,int x,int y,const Graphics::Bounds& clip)
 	{
-		LRESULT result;
-		Window* window = Window::FromHandle(window_handle);
+		Graphics::Bounds bounds;
+		std::vector<HWND> children;
 
 
-		switch(message)
+		if(!this->isRealized())
 		{
-			case WM_NCCREATE:
-				//this->init();
-
-				break;
+			return;
 		}
 
-		result = window->getMessageHandler(message)(window,w_param,l_param);
+		this->renderContent();
 
-		switch(message)
+		bounds.left = x > clip.left ? x : clip.left;
+		bounds.top = y > clip.top ? y : clip.top;
+		bounds.right = x + this->render_cache.content->getWidth() < clip.right ? x + this->render_cache.content->getWidth() : clip.right;
+		bounds.bottom = y + this->render_cache.content->getHeight() < clip.bottom ? y + this->render_cache.content->getHeight() : clip.bottom;
+		if(bounds.left >= bounds.right || bounds.top >= bounds.bottom)
 		{
-			case WM_NCDESTROY:
-				window->removeProperty(WINDOW_INSTANCE_PROPERTY);
-				window->window_handle = nullptr;
-
-				break;
+			return;
 		}
 
-		return result;
-	}
+		Graphics::CopySurface(target,*this->render_cache.content,x,y,&bounds);
 
-	bool Window::hasParent()
-	{
-		return this->getParent() != nullptr;
-	}
+		for(HWND child = GetWindow(this->window_handle,GW_CHILD);child != nullptr;child = GetWindow(child,GW_HWNDNEXT))  //Top-most first.
+		{
+			children.push_back(child);
+		}
+		for(auto child = children.rbegin();child != children.rend();++child)
+		{
+			POINT origin = {0,0};
 
-	bool Window::isAlive()
-	{
-		return this->getNativeHandle() != nullptr && IsWindow(this->getNativeHandle());
-	}
 
-	bool Window::isTopLevel()
-	{
-		return !this->hasParent();
-	}
+			if((GetWindowLongPtr(*child,GWL_STYLE) & WS_VISIBLE) == 0)
+			{
+				continue;
+			}
 
-	bool Window::isVisible()
-	{
-		return IsWindowVisible(this->getNativeHandle()) == TRUE;
+			MapWindowPoints(*child,this->window_handle,&origin,1);  //The child's client area, relative to this window's client area.
+			Window::FromHandle(*child)->renderTree(target,x + origin.x,y + origin.y,bounds);
+		}
 	}
 
-	void Window::maximize(bool animate)
+	void Window::restore(bool animate)
 	{
-		//TODO:  Perform animation
+		HWND window_handle = this->getNativeHandle();
 
-		ShowWindow(this->getNativeHandle(),SW_MAXIMIZE);
-	}
 
-	void Window::minimize(bool animate)
-	{
-		//TODO:  Perform animation
+		if(animate && IsWindowVisible(window_handle) && IsIconic(window_handle) && (this->getStyle() & WS_CHILD) == 0)
+		{
+			BYTE opacity = GetWindowOpacity(this);
+			bool layered = (this->getExtendedStyle() & WS_EX_LAYERED) != 0;
 
-		ShowWindow(this->getNativeHandle(),SW_MINIMIZE);
-	}
 
-	void Window::removeExtendedStyle(DWORD style)
-	{
-		this->setExtendedStyle(this->getExtendedStyle() & ~style);
-	}
-	
-	void Window::removeProperty(const wchar* property_name)
-	{
-		RemoveProp(this->getNativeHandle(),property_name);
+			SetWindowOpacity(this,0);
+			ShowWindow(window_handle,SW_RESTORE);
+			this->animateOpacity(opacity,WINDOW_STATE_ANIMATION_DURATION,Animation::Easing::EASE_OUT,[layered](Window* window){
+				if(!layered)
+				{
+					window->removeExtendedStyle(WS_EX_LAYERED);
+				}
+			});
+		}
+		else if(animate && IsWindowVisible(window_handle) && IsZoomed(window_handle))
+		{
+			WINDOWPLACEMENT placement;
+			POINT offset = GetWorkspaceOffset(window_handle);
+			RECT restored;
+
+
+			placement.length = sizeof(placement);
+			GetWindowPlacement(window_handle,&placement);
+			restored = placement.rcNormalPosition;
+			OffsetRect(&restored,offset.x,offset.y);
+
+			/* Leave the maximized state without moving, then shrink to the restored position. */
+			placement.rcNormalPosition = GetPlacementRectangle(this);
+			OffsetRect(&placement.rcNormalPosition,-offset.x,-offset.y);
+			placement.showCmd = SW_SHOWNORMAL;
+			SetWindowPlacement(window_handle,&placement);
+			this->animateGeometry(restored,WINDOW_STATE_ANIMATION_DURATION,Animation::Easing::EASE_OUT);
+		}
+		else
+		{
+			ShowWindow(window_handle,SW_RESTORE);
+		}
 	}
 
-	void Window::removeProperty(const std::wstring& property_name)
+	void Window::setBackground(HBRUSH background)
 	{
-		this->removeProperty(property_name.c_str());
+		RetainGdiObject(background);
+		ReleaseGdiObject(this->properties.background);
+		this->properties.background = background;
+		
+		this->invalidate();
 	}
 
-	void Window::removeStyle(DWORD style)
+	void Window::setBackground(COLORREF color)
 	{
-		this->setStyle(this->getStyle() & ~style);
-	}
+		HBRUSH background = AcquireBrush(color);
 
-	void Window::restore(bool animate)
-	{
-		//TODO:  Perform animation
 
-		ShowWindow(this->getNativeHandle(),SW_RESTORE);
+		this->setBackground(background);
+		ReleaseGdiObject(background);
 	}
 
-	void Window::setBackground(HBRUSH background)
+	void Window::setDimensions(int width,int height)
 	{
-		this->properties.background = background;
-		
-		RedrawWindow(this->getNativeHandle(),nullptr,nullptr,RDW_ERASE | RDW_INVALIDATE);
+		if(!this->isRealized())
+		{
+			this->deferred.width = width;
+			this->deferred.height = height;
+
+			return;
+		}
+
+		SetWindowPos(this->getNativeHandle(),nullptr,0,0,width,height,SWP_NOMOVE | SWP_NOZORDER);
 	}
 
-	void Window::setDimensions(int width,int height)
+	void Window::setDoubleBuffered(bool double_buffered)
 	{
-		SetWindowPos(this->getNativeHandle(),nullptr,0,0,width,height,SWP_NOMOVE | SWP_NOZORDER);
+		this->back_buffer.enabled = double_buffered;
+
+		if(!double_buffered)
+		{
+			this->releaseBackBuffer();
+		}
+
+		this->invalidate();
 	}
 
 	void Window::setExtendedStyle(DWORD style)
 	{
-		SetWindowLongPtr(this->getNativeHandle(),GWL_EXSTYLE,style);
+		StyleEdit edit;
+
+
+		edit.setExtendedStyle(this,style);
 	}
 
 	void Window::setMessageHandler(UINT message,MessageHandler handler)
@@ -595,6 +4704,13 @@ namespace OS
 		assert(window_name != nullptr);
 		
 
+		if(!this->isRealized())
+		{
+			this->deferred.name = window_name;
+
+			return;
+		}
+
 		SetWindowText(this->getNativeHandle(),window_name);
 	}
 
@@ -614,25 +4730,43 @@ namespace OS
 
 	void Window::setParent(Window* parent,bool alter_visibility)
 	{
+		StyleEdit edit;  //Applied along with the move, so that the frame is recalculated just once.
+
+
 		if(this->isTopLevel() && parent == nullptr) //If the window is already a desktop window, calling this method with a null parent has no effect.
 		{
 			return;
 		}
 
-		if(parent == nullptr)
+		if(!this->isRealized())
 		{
-			SetParent(this->getNativeHandle(),nullptr);
+			bool was_top_level = this->isTopLevel();
 
-			this->removeStyle(WS_CHILD);
-			this->addStyle(WS_POPUP);
-			if(alter_visibility)
+
+			if(this->deferred.parent != nullptr)
 			{
-				this->setVisible(false);
+				std::vector<Window*>& siblings = this->deferred.parent->deferred.children;
+
+
+				siblings.erase(std::remove(siblings.begin(),siblings.end(),this),siblings.end());
 			}
-		}
-		else
-		{
-			if(this->isTopLevel()) //Only modify the window's styles if the window was not already a child window.
+
+			this->deferred.parent = parent;
+			if(parent != nullptr && !parent->isRealized())
+			{
+				parent->deferred.children.push_back(this);
+			}
+
+			if(parent == nullptr)
+			{
+				this->removeStyle(WS_CHILD);
+				this->addStyle(WS_POPUP);
+				if(alter_visibility)
+				{
+					this->setVisible(false);
+				}
+			}
+			else if(was_top_level)
 			{
 				this->removeStyle(WS_POPUP);
 				this->addStyle(WS_CHILD);
@@ -642,13 +4776,44 @@ namespace OS
 				}
 			}
 
-			SetParent(this->getNativeHandle(),parent->getNativeHandle());
+			return;
+		}
+
+		if(parent == nullptr)
+		{
+			edit.removeStyle(this,WS_CHILD);
+			edit.addStyle(this,WS_POPUP);
+			if(alter_visibility)
+			{
+				edit.removeStyle(this,WS_VISIBLE);
+			}
+		}
+		else if(this->isTopLevel()) //Only modify the window's styles if the window was not already a child window.
+		{
+			edit.removeStyle(this,WS_POPUP);
+			edit.addStyle(this,WS_CHILD);
+			if(alter_visibility)
+			{
+				edit.addStyle(this,WS_VISIBLE);
+			}
 		}
+		edit.setParent(this,parent);
+		edit.commit();
+
+		this->indexInParent();
 		//TODO:  Update window UI states?
 	}
 
 	void Window::setPosition(int x,int y,bool relative)
 	{
+		if(!this->isRealized())
+		{
+			this->deferred.x = x;
+			this->deferred.y = y;
+
+			return;
+		}
+
 		if(relative)
 		{
 			MoveWindow(this->getNativeHandle(),x,y,this->getWidth(),this->getHeight(),true);
@@ -661,6 +4826,13 @@ namespace OS
 
 	void Window::setProperty(const wchar* property_name,HANDLE value)
 	{
+		if(!this->isRealized())
+		{
+			this->deferred.properties[property_name] = value;
+
+			return;
+		}
+
 		SetProp(this->getNativeHandle(),property_name,value);
 	}
 
@@ -671,13 +4843,83 @@ namespace OS
 
 	void Window::setStyle(DWORD style)
 	{
-		SetWindowLongPtr(this->getNativeHandle(),GWL_STYLE,style);
+		StyleEdit edit;
+
+
+		edit.setStyle(this,style);
+	}
+
+	UINT_PTR Window::setTimer(UINT milliseconds,TimerHandler handler,bool repeat)
+	{
+		assert(handler);
+		assert(!this->isRealized() || GetWindowThreadProcessId(this->window_handle,nullptr) == GetCurrentThreadId());  //Each thread has a wheel of its own, which only the windows belonging to the thread use.
+
+
+		ThreadWindowState& thread_state = GetThreadWindowState();
+		ULONGLONG now = GetTimerClock();
+		size_t index;
+		size_t window_first;
+
+
+		if(thread_state.timer_slots.empty())
+		{
+			thread_state.timer_slots.assign(((size_t)1 << TIMER_SLOT_BITS) + (TIMER_LEVELS - 1) * ((size_t)1 << TIMER_LEVEL_BITS),TIMER_NONE);
+		}
+		if(thread_state.active_timers == 0)  //An empty wheel can be moved straight to the present.
+		{
+			thread_state.timer_wheel_time = now;
+		}
+
+		if(thread_state.free_timers != TIMER_NONE)
+		{
+			index = thread_state.free_timers;
+			thread_state.free_timers = thread_state.timers[index].next;
+		}
+		else
+		{
+			assert(thread_state.timers.size() + 1 < ((size_t)1 << TIMER_GENERATION_SHIFT));
+
+			index = thread_state.timers.size();
+			thread_state.timers.push_back(WindowTimer());
+			thread_state.timers[index].generation = 0;
+		}
+
+		WindowTimer& entry = thread_state.timers[index];
+
+
+		entry.window = this;
+		entry.handler = handler;
+		entry.interval = milliseconds > 0 ? milliseconds : 1;
+		entry.expiry = now + milliseconds;
+		entry.repeat = repeat;
+		entry.active = true;
+		entry.firing = false;
+		ScheduleTimer(index);
+
+		window_first = thread_state.window_timers.count(this) > 0 ? thread_state.window_timers[this] : TIMER_NONE;
+		entry.window_previous = TIMER_NONE;
+		entry.window_next = window_first;
+		if(window_first != TIMER_NONE)
+		{
+			thread_state.timers[window_first].window_previous = index;
+		}
+		thread_state.window_timers[this] = index;
+
+		++thread_state.active_timers;
+		ArmNativeTimer();
+
+		return (UINT_PTR)(entry.generation & ((UINT)-1 >> TIMER_GENERATION_SHIFT)) << TIMER_GENERATION_SHIFT | (index + 1);
 	}
 
 	void Window::setVisible(bool visible)
 	{
 		if(visible)
 		{
+			if(this->deferred.parent == nullptr || this->deferred.parent->isRealized())  //Children of a deferred parent are realized along with it.
+			{
+				this->realize();
+			}
+
 			this->addStyle(WS_VISIBLE);
 		}
 		else
@@ -691,6 +4933,32 @@ namespace OS
 		ShowWindow(this->getNativeHandle(),show_command);
 	}
 
+	void Window::stopAnimations()
+	{
+		StopWindowAnimations(this);
+	}
+
+	void Window::suspendPainting()
+	{
+		if(this->painting_suspensions++ == 0 && this->isRealized() && this->isAlive())
+		{
+			SendMessage(this->window_handle,WM_SETREDRAW,FALSE,0);
+		}
+	}
+
+	void Window::unobserveProperty(UINT_PTR observer)
+	{
+		for(auto entry = this->property_observers.begin();entry != this->property_observers.end();++entry)
+		{
+			if(entry->id == observer)
+			{
+				this->property_observers.erase(entry);
+
+				return;
+			}
+		}
+	}
+
 	void Window::unsetMessageHandler(UINT message)
 	{
 		this->message_handlers.erase(message);
@@ -703,8 +4971,12 @@ namespace OS
 		assert(WindowClass::IsValidClassName(class_name));
 
 
+		TRACE_SCOPE("OS::WindowClass::WindowClass");
+
+
 		lstrcpy(this->class_name,class_name);
 		this->context = context;
+		this->message_handlers.store(new MessageHandlerTable());
 
 		if(!WindowClass::Exists(class_name,context))
 		{
@@ -717,12 +4989,12 @@ namespace OS
 			data.cbClsExtra = 0;
 			data.cbWndExtra = 0;
 			data.hInstance = context;
-			data.hIcon = LoadIcon(nullptr,IDI_APPLICATION);
-			data.hCursor = LoadCursor(nullptr,IDC_ARROW);
+			data.hIcon = AcquireIcon(nullptr,IDI_APPLICATION);
+			data.hCursor = AcquireCursor(nullptr,IDC_ARROW);
 			data.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
 			data.lpszMenuName = nullptr;
 			data.lpszClassName = this->class_name;
-			data.hIconSm = LoadIcon(nullptr,IDI_APPLICATION);
+			data.hIconSm = AcquireIcon(nullptr,IDI_APPLICATION,GetSystemMetrics(SM_CXSMICON));
 
 			if(!RegisterClassEx(&data))
 			{
@@ -732,8 +5004,8 @@ namespace OS
 
 		this->createPrototype();
 		this->default_window_procedure = (WNDPROC)GetClassLongPtr(this->prototype->getNativeHandle(),GCLP_WNDPROC);
-		SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_WNDPROC,(LONG)(WNDPROC)[](HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param){
-			SetWindowLongPtr(window_handle,GWLP_WNDPROC,(LONG)Window::HandleMessage);
+		SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_WNDPROC,(LONG_PTR)(WNDPROC)[](HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param){
+			SetWindowLongPtr(window_handle,GWLP_WNDPROC,(LONG_PTR)Window::HandleMessage);
 			return Window::HandleMessage(window_handle,message,w_param,l_param);
 		});
 		this->setDefaultMessageHandlers();
@@ -796,17 +5068,14 @@ namespace OS
 		assert(handler);
 
 
-		MessageHandler previous_handler = this->getDefaultMessageHandler(message);
-
+		std::lock_guard<std::mutex> lock(this->message_handlers_mutex);  //The handler being extended must not change before it is replaced.
 
-		this->setDefaultMessageHandler(message,[handler,previous_handler](Window* window,WPARAM w_param,LPARAM l_param){
-			LRESULT result;
 
+		PublishSharedTable(this->message_handlers,[this,message,&handler](MessageHandlerTable& handlers){
+			auto existing = handlers.find(message);
 
-			result = previous_handler(window,w_param,l_param);
-			handler(window,w_param,l_param);
 
-			return result;
+			handlers[message] = ExtendMessageHandler<Window>(existing != handlers.end() ? existing->second : this->getWindowProcedureHandler(message),handler);
 		});
 	}
 
@@ -815,7 +5084,21 @@ namespace OS
 		assert(window->getWindowClass() == this);
 
 
-		this->instantiated_windows.erase(window->getNativeHandle());
+		std::lock_guard<std::mutex> lock(this->windows_mutex);
+
+
+		if(window->isRealized())
+		{
+			this->instantiated_windows.erase(window->window_handle);
+		}
+		else if(window->deferred.destroyed)
+		{
+			this->destroyed_windows.erase(std::remove(this->destroyed_windows.begin(),this->destroyed_windows.end(),window),this->destroyed_windows.end());
+		}
+		else
+		{
+			this->deferred_windows.erase(window);
+		}
 	}
 
 	ATOM WindowClass::getAtom() const
@@ -833,20 +5116,53 @@ namespace OS
 		std::wstring class_name_lowercase(class_name);
 
 
-		for(unsigned offset = 0;offset < class_name_lowercase.length();++offset)
+		for(unsigned offset = 0;offset < class_name_lowercase.length();++offset)
+		{
+			wchar character = class_name_lowercase[offset];
+
+
+			if(character < 0x80)  //Spares the locale-aware conversion for the ASCII names nearly every class has.
+			{
+				class_name_lowercase[offset] = character >= L'A' && character <= L'Z' ? character + (L'a' - L'A') : character;
+			}
+			else
+			{
+				class_name_lowercase[offset] = std::towlower(character);
+			}
+		}
+
 		{
-			class_name_lowercase[offset] = std::towlower(class_name_lowercase[offset]);
+			SharedTableRead read;
+			const WindowClassTable& classes = *window_class_by_name.load();
+			auto known = classes.find(class_name_lowercase);
+
+
+			if(known != classes.end() && known->second->getContext() == context)  //A class known in this context needs no asking the system whether it exists.
+			{
+				return known->second;
+			}
 		}
 
 		if(WindowClass::Exists(class_name_lowercase,context))
 		{
-			if(window_class_by_name.count(class_name_lowercase) == 0)
+			std::lock_guard<std::recursive_mutex> lock(window_class_registration_mutex);
+			const WindowClassTable& classes = *window_class_by_name.load();  //Only replaced while the lock is held.
+			auto known = classes.find(class_name_lowercase);
+			WindowClass* window_class;
+
+
+			if(known != classes.end())
 			{
-				/* In this case, the window class already existed, but was not registered in this module. */
-				window_class_by_name[class_name_lowercase] = new WindowClass(class_name_lowercase,context);
+				return known->second;
 			}
 
-			return window_class_by_name[class_name_lowercase];
+			/* In this case, the window class already existed, but was not registered in this module. */
+			window_class = new WindowClass(class_name_lowercase,context);
+			PublishSharedTable(window_class_by_name,[&class_name_lowercase,window_class](WindowClassTable& classes){
+				classes[class_name_lowercase] = window_class;
+			});
+
+			return window_class;
 		}
 		
 		if(create)
@@ -892,16 +5208,18 @@ namespace OS
 
 	MessageHandler WindowClass::getDefaultMessageHandler(UINT message)
 	{
-		if(this->message_handlers.count(message) > 0)
+		SharedTableRead read;
+		const MessageHandlerTable& handlers = *this->message_handlers.load();
+		auto handler = handlers.find(message);
+
+
+		if(handler != handlers.end())
 		{
-			return this->message_handlers[message];
+			return handler->second;
 		}
 		else
 		{
-			return [this,message](Window* window,WPARAM w_param,LPARAM l_param)
-			{
-				return CallWindowProc(this->default_window_procedure,window->getNativeHandle(),message,w_param,l_param);
-			};
+			return this->getWindowProcedureHandler(message);
 		}
 	}
 
@@ -927,6 +5245,7 @@ namespace OS
 
 	std::vector<Window*> WindowClass::getWindows()
 	{
+		std::lock_guard<std::mutex> lock(this->windows_mutex);
 		std::vector<Window*> windows;  //Not that Windows, the other windows.
 
 
@@ -935,19 +5254,48 @@ namespace OS
 			windows.push_back(hwnd_window_pair.second);
 		}
 
+		for(Window* window : this->deferred_windows)
+		{
+			windows.push_back(window);
+		}
+
 		return windows;
 	}
 
+	MessageHandler WindowClass::getWindowProcedureHandler(UINT message)
+	{
+		return [this,message](Window* window,WPARAM w_param,LPARAM l_param)
+		{
+			if(!window->isRealized())  //Only for a window destroyed before being realized, which has no native procedure to call.
+			{
+				return (LRESULT)0;
+			}
+
+			return CallWindowProc(this->default_window_procedure,window->getNativeHandle(),message,w_param,l_param);
+		};
+	}
+
 	Window* WindowClass::instantiate()
 	{
 		return this->instantiate(L"Untitled Window");
 	}
 
-	Window* WindowClass::instantiate(const wchar* window_name)
+	Window* WindowClass::instantiate(const wchar* window_name,bool defer_realization)
 	{
+		TRACE_SCOPE("OS::WindowClass::instantiate");
 		HWND window_handle;
 
 		
+		if(defer_realization)
+		{
+			Window* window = new Window(this);
+
+
+			this->prepareDeferred(window,window_name);
+
+			return window;
+		}
+
 		window_handle = CreateWindowEx(
 			this->prototype->getExtendedStyle(),  // Extended Style
 			this->getClassName(),  // Window class name
@@ -974,9 +5322,9 @@ namespace OS
 		}
 	}
 
-	Window* WindowClass::instantiate(const std::wstring& window_name)
+	Window* WindowClass::instantiate(const std::wstring& window_name,bool defer_realization)
 	{
-		return this->instantiate(window_name.c_str());
+		return this->instantiate(window_name.c_str(),defer_realization);
 	}
 	
 	bool WindowClass::IsValidClassName(const wchar* name)
@@ -1000,9 +5348,24 @@ namespace OS
 
 	Window* WindowClass::manage(HWND window_handle)
 	{
+		std::lock_guard<std::mutex> lock(this->windows_mutex);
+
+
 		if(this->instantiated_windows.count(window_handle) == 0) //I don't think this should ever not be the case, but it's here just in case.
 		{
-			Window* window = new Window(window_handle,this);
+			Window* window;
+
+
+			if(realizing_window != nullptr && realizing_window->window_class == this && realizing_window->window_handle == nullptr)
+			{
+				window = realizing_window;
+				window->window_handle = window_handle;
+				this->deferred_windows.erase(window);
+			}
+			else
+			{
+				window = new Window(window_handle,this);
+			}
 
 
 			this->instantiated_windows[window_handle] = window;
@@ -1012,9 +5375,29 @@ namespace OS
 		return this->instantiated_windows[window_handle];
 	}
 
+	void WindowClass::prepareDeferred(Window* window,const wchar* window_name)
+	{
+		window->deferred.name = window_name;
+		window->deferred.style = this->prototype->getStyle();
+		window->deferred.style_extended = this->prototype->getExtendedStyle();
+		window->deferred.x = this->prototype->getXCoordinate();
+		window->deferred.y = this->prototype->getYCoordinate();
+		window->deferred.width = this->prototype->getWidth();
+		window->deferred.height = this->prototype->getHeight();
+		{
+			std::lock_guard<std::mutex> lock(this->windows_mutex);
+
+
+			this->deferred_windows.insert(window);
+		}
+	}
+
 	WindowClass* WindowClass::Register(const wchar* class_name,HINSTANCE context)
 	{
+		TRACE_SCOPE("OS::WindowClass::Register");
+		std::lock_guard<std::recursive_mutex> lock(window_class_registration_mutex);
 		std::wstring class_name_lowercase(class_name);
+		WindowClass* window_class;
 
 
 		for(unsigned offset = 0;offset < class_name_lowercase.length();++offset)
@@ -1028,9 +5411,12 @@ namespace OS
 		}
 		else
 		{
-			window_class_by_name[class_name_lowercase] = new WindowClass(class_name_lowercase,context);
+			window_class = new WindowClass(class_name_lowercase,context);
+			PublishSharedTable(window_class_by_name,[&class_name_lowercase,window_class](WindowClassTable& classes){
+				classes[class_name_lowercase] = window_class;
+			});
 			
-			return window_class_by_name[class_name_lowercase];
+			return window_class;
 		}
 	}
 
@@ -1039,19 +5425,51 @@ namespace OS
 		return WindowClass::Register(class_name.c_str(),context);
 	}
 
+	void WindowClass::retire(Window* window)
+	{
+		assert(window->getWindowClass() == this);
+
+
+		std::lock_guard<std::mutex> lock(this->windows_mutex);
+
+
+		this->deferred_windows.erase(window);
+		this->destroyed_windows.push_back(window);
+	}
+
 	void WindowClass::setBackground(HBRUSH background)
 	{
-		SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HBRBACKGROUND,(LONG)background);
+		RetainGdiObject(background);
+		ReleaseGdiObject((HANDLE)SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HBRBACKGROUND,(LONG_PTR)background));
 
 		for(auto& window : this->getWindows())
 		{
-			UpdateWindow(window->getNativeHandle());
+			window->invalidate();
 		}
 	}
 
+	void WindowClass::setBackground(COLORREF color)
+	{
+		HBRUSH background = AcquireBrush(color);
+
+
+		this->setBackground(background);
+		ReleaseGdiObject(background);
+	}
+
 	void WindowClass::setCursor(HCURSOR cursor)
 	{
-		SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HCURSOR,(LONG)cursor);
+		RetainGdiObject(cursor);
+		ReleaseGdiObject((HANDLE)SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HCURSOR,(LONG_PTR)cursor));
+	}
+
+	void WindowClass::setCursor(HINSTANCE module,const wchar* resource)
+	{
+		HCURSOR cursor = AcquireCursor(module,resource);
+
+
+		this->setCursor(cursor);
+		ReleaseGdiObject(cursor);
 	}
 
 	void WindowClass::setDefaultMessageHandler(UINT message,MessageHandler handler)
@@ -1059,7 +5477,12 @@ namespace OS
 		assert(handler);
 
 
-		this->message_handlers[message] = handler;
+		std::lock_guard<std::mutex> lock(this->message_handlers_mutex);
+
+
+		PublishSharedTable(this->message_handlers,[message,&handler](MessageHandlerTable& handlers){
+			handlers[message] = handler;
+		});
 	}
 
 	void WindowClass::setDefaultMessageHandlers()
@@ -1069,6 +5492,11 @@ namespace OS
 		});
 
 		this->setDefaultMessageHandler(WM_ERASEBKGND,[](Window* window,WPARAM w_param,LPARAM l_param){
+			if(window->isDoubleBuffered())  //The background is filled into the back buffer by Window::beginPaint instead.
+			{
+				return 1;
+			}
+
 			HBRUSH background = window->getBackground();
 			RECT client_rect = window->getRectangle(true);
 
@@ -1081,17 +5509,37 @@ namespace OS
 
 	void WindowClass::setIcon(HICON icon)
 	{
-		SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HICON,(LONG)icon);
+		RetainGdiObject(icon);
+		ReleaseGdiObject((HANDLE)SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HICON,(LONG_PTR)icon));
+	}
+
+	void WindowClass::setIcon(HINSTANCE module,const wchar* resource)
+	{
+		HICON icon = AcquireIcon(module,resource);
+
+
+		this->setIcon(icon);
+		ReleaseGdiObject(icon);
 	}
 
 	void WindowClass::setIconSmall(HICON icon)
 	{
-		SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HICONSM,(LONG)icon);
+		RetainGdiObject(icon);
+		ReleaseGdiObject((HANDLE)SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HICONSM,(LONG_PTR)icon));
+	}
+
+	void WindowClass::setIconSmall(HINSTANCE module,const wchar* resource)
+	{
+		HICON icon = AcquireIcon(module,resource,GetSystemMetrics(SM_CXSMICON));
+
+
+		this->setIconSmall(icon);
+		ReleaseGdiObject(icon);
 	}
 
 	void WindowClass::setMenuName(const wchar* menu_name)
 	{
-		SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HICON,(LONG)menu_name);
+		SetClassLongPtr(this->prototype->getNativeHandle(),GCLP_HICON,(LONG_PTR)menu_name);
 	}
 
 	void WindowClass::setMenuName(const std::wstring& menu_name)
@@ -1133,14 +5581,19 @@ namespace OS
 		assert(name != nullptr);
 
 
+		std::lock_guard<std::recursive_mutex> lock(window_class_registration_mutex);
+		const WindowClassTable& classes = *window_class_by_name.load();
+		auto known = classes.find(name);
+
+
 		if(!WindowClass::Exists(name,context))
 		{
 			return;
 		}
 
-		if(window_class_by_name.count(name) > 0)  //It could be the case that the window class wasn't being managed by this API
+		if(known != classes.end())  //It could be the case that the window class wasn't being managed by this API
 		{
-			WindowClass* window_class = window_class_by_name[name];
+			WindowClass* window_class = known->second;  //Copied, as destroying the windows below may replace the table.
 
 
 			for(Window* window : window_class->getWindows())
@@ -1152,12 +5605,30 @@ namespace OS
 				window_class->forget(window);
 				delete window;
 			}
+			{
+				std::lock_guard<std::mutex> lock(window_class->windows_mutex);
+
+
+				for(Window* window : window_class->destroyed_windows)
+				{
+					delete window;
+				}
+				window_class->destroyed_windows.clear();
+			}
+
+			ReleaseGdiObject(window_class->getBackground());  //Drop the references held through the class's data.
+			ReleaseGdiObject(window_class->getCursor());
+			ReleaseGdiObject(window_class->getIcon());
+			ReleaseGdiObject(window_class->getIconSmall());
 
 			window_class->prototype->destroy();
 			delete window_class->prototype;
 			window_class->prototype = nullptr;
 
-			window_class_by_name.erase(name);
+			VirtualList::classes.erase(window_class);
+			PublishSharedTable(window_class_by_name,[name](WindowClassTable& classes){
+				classes.erase(name);
+			});
 		}
 
 		UnregisterClass(name,context);
@@ -1170,6 +5641,312 @@ namespace OS
 
 	void WindowClass::unsetDefaultMessageHandler(UINT message)
 	{
-		this->message_handlers.erase(message);
+		std::lock_guard<std::mutex> lock(this->message_handlers_mutex);
+
+
+		PublishSharedTable(this->message_handlers,[message](MessageHandlerTable& handlers){
+			handlers.erase(message);
+		});
+	}
+
+	/* Type [OS::UIClass] Definition */
+	UIClass::UIClass(const Module& module)
+	: module(module)
+	{
+		this->defaults.x = 0;
+		this->defaults.y = 0;
+		this->defaults.width = 0;
+		this->defaults.height = 0;
+		this->defaults.fields = 0;
+	}
+
+	void UIClass::addHandler(const std::wstring& event,const std::wstring& procedure_name)
+	{
+		size_t event_index = GetUIClassEvent(event);
+		std::string procedure_name_narrow;
+
+
+		if(event_index == UI_CLASS_NO_EVENT)
+		{
+			throw OS::RuntimeException(std::string("The UIClass handles an unknown event, \"").append(event.begin(),event.end()).append("\"."));
+		}
+
+		for(wchar character : procedure_name)  //Exported names are ASCII.
+		{
+			procedure_name_narrow.push_back((char)character);
+		}
+
+		this->handlers[event_index].push_back(this->module.getProcedure<WindowCallbackSignature>(procedure_name_narrow.c_str()));
+	}
+
+	std::wstring UIClass::getCapability(const std::wstring& capability,const std::wstring& fallback) const
+	{
+		auto value = this->capabilities.find(capability);
+
+
+		return value != this->capabilities.end() ? value->second : fallback;
+	}
+
+	UIClass* UIClass::GetByName(const wchar* name)
+	{
+		std::lock_guard<std::mutex> lock(ui_classes_mutex);
+		auto ui_class = ui_classes.find(GetUIClassKey(name));
+
+
+		return ui_class != ui_classes.end() ? ui_class->second : nullptr;
+	}
+
+	UIClass* UIClass::GetByName(const std::wstring& name)
+	{
+		return UIClass::GetByName(name.c_str());
+	}
+
+	const std::wstring& UIClass::getName() const
+	{
+		return this->name;
+	}
+
+	std::wstring UIClass::getPrototypeAttribute(const std::wstring& attribute,const std::wstring& fallback) const
+	{
+		auto value = this->prototype.find(attribute);
+
+
+		return value != this->prototype.end() ? value->second : fallback;
+	}
+
+	const wchar* UIClass::getTitle() const
+	{
+		return (this->defaults.fields & TITLE) != 0 ? this->defaults.title.c_str() : L"";
+	}
+
+	WindowClass* UIClass::getWindowClass()
+	{
+		WindowClass* window_class = WindowClass::GetByName(this->window_class_name,this->module);
+
+
+		if(window_class == nullptr)
+		{
+			throw OS::RuntimeException(std::string("The window class of the UIClass \"").append(this->name.begin(),this->name.end()).append("\" does not exist."));
+		}
+
+		return window_class;
+	}
+
+	const std::wstring& UIClass::getWindowClassName() const
+	{
+		return this->window_class_name;
+	}
+
+	bool UIClass::hasCapability(const std::wstring& capability) const
+	{
+		return lstrcmpi(this->getCapability(capability).c_str(),L"true") == 0;
+	}
+
+	Window* UIClass::instantiate(bool defer_realization)
+	{
+		TRACE_SCOPE("OS::UIClass::instantiate");
+		Window* window = this->getWindowClass()->instantiate(this->getTitle(),true);
+
+
+		this->prepare(window,defer_realization);
+
+		return window;
+	}
+
+	UIClass* UIClass::Load(Module& module,WORD resource_id)
+	{
+		TRACE_SCOPE("OS::UIClass::Load");
+		std::lock_guard<std::mutex> lock(ui_classes_mutex);
+		Module::Resource resource = module.getResourceEntry(resource_id,L"XML");
+		XML::Element definition(XML::Element::Type::CONTAINER);
+		const XML::Element* name_element;
+		const XML::Element* base_element;
+		const XML::Element* section;
+		std::unique_ptr<UIClass> ui_class;
+		std::wstring key;
+
+
+		try
+		{
+			definition = XML::Parse((const char*)resource.data,resource.size);
+		}
+		catch(const std::runtime_error& exception)
+		{
+			throw OS::RuntimeException(exception.what());
+		}
+
+		name_element = definition.getChild(L"Name");
+		if(definition.getName() != L"UIClass" || name_element == nullptr || name_element->getText().empty())
+		{
+			throw OS::RuntimeException("The resource is not a UIClass definition.");
+		}
+
+		key = GetUIClassKey(name_element->getText());
+		if(ui_classes.count(key) > 0)
+		{
+			return ui_classes[key];
+		}
+
+		/* Start from a flattened copy of the class extended, so that nothing need be looked up in it again. */
+		base_element = definition.getChild(L"Extends");
+		if(base_element == nullptr || base_element->getText().empty())
+		{
+			ui_class.reset(new UIClass(module));
+			ui_class->window_class_name = name_element->getText();  //A class which extends nothing is built on the native class of the same name.
+		}
+		else if(ui_classes.count(GetUIClassKey(base_element->getText())) > 0)
+		{
+			ui_class.reset(new UIClass(*ui_classes[GetUIClassKey(base_element->getText())]));
+			ui_class->module = module;
+		}
+		else if(WindowClass::Exists(base_element->getText(),module))
+		{
+			ui_class.reset(new UIClass(module));
+			ui_class->window_class_name = base_element->getText();
+		}
+		else
+		{
+			throw OS::RuntimeException(std::string("The UIClass extends \"").append(base_element->getText().begin(),base_element->getText().end()).append("\", which is neither a loaded UIClass nor a window class."));
+		}
+		ui_class->name = name_element->getText();
+
+		section = definition.getChild(L"Capabilities");
+		if(section != nullptr)
+		{
+			for(const XML::Element& capability : section->getChildren())
+			{
+				if(capability.type == XML::Element::Type::CONTAINER)
+				{
+					ui_class->capabilities[capability.getName()] = capability.getText();
+				}
+			}
+		}
+
+		section = definition.getChild(L"LifecycleHandlers");
+		if(section != nullptr)
+		{
+			for(const XML::Element& handler : section->getChildren())
+			{
+				if(handler.type == XML::Element::Type::CONTAINER)
+				{
+					ui_class->addHandler(handler.getName(),handler.getText());
+				}
+			}
+		}
+
+		section = definition.getChild(L"Prototype");
+		if(section != nullptr)
+		{
+			for(auto& attribute : section->getAttributes())
+			{
+				if(attribute.first.compare(0,2,L"on") == 0)  //Handlers may also be given as attributes, as in UI definitions.
+				{
+					ui_class->addHandler(attribute.first,attribute.second);
+				}
+				else
+				{
+					ui_class->setPrototypeAttribute(attribute.first,attribute.second);
+				}
+			}
+		}
+
+		ui_classes[key] = ui_class.get();
+
+		return ui_class.release();
+	}
+
+	void UIClass::prepare(Window* window,bool defer_realization)
+	{
+		if((this->defaults.fields & X) != 0)
+		{
+			window->deferred.x = this->defaults.x;
+		}
+		if((this->defaults.fields & Y) != 0)
+		{
+			window->deferred.y = this->defaults.y;
+		}
+		if((this->defaults.fields & WIDTH) != 0)
+		{
+			window->deferred.width = this->defaults.width;
+		}
+		if((this->defaults.fields & HEIGHT) != 0)
+		{
+			window->deferred.height = this->defaults.height;
+		}
+
+		for(size_t event = 0;event < EVENTS;++event)
+		{
+			const std::vector<WindowCallback>* handlers = &this->handlers[event];
+
+
+			if(event == ON_CREATE || handlers->empty())
+			{
+				continue;
+			}
+
+			window->extendMessageHandler(UI_CLASS_EVENT_MESSAGES[event],[handlers](Window* window,WPARAM w_param,LPARAM l_param){
+				for(const WindowCallback& handler : *handlers)
+				{
+					handler(*window);
+				}
+			});
+		}
+
+		if(!defer_realization)
+		{
+			window->realize();
+		}
+
+		for(const WindowCallback& handler : this->handlers[ON_CREATE])
+		{
+			handler(*window);
+		}
+	}
+
+	void UIClass::setPrototypeAttribute(const std::wstring& attribute,const std::wstring& value)
+	{
+		this->prototype[attribute] = value;
+
+		if(attribute == L"title")
+		{
+			this->defaults.title = value;
+			this->defaults.fields |= TITLE;
+		}
+		else if(attribute == L"x")
+		{
+			this->defaults.x = ParseUIClassInteger(attribute,value);
+			this->defaults.fields |= X;
+		}
+		else if(attribute == L"y")
+		{
+			this->defaults.y = ParseUIClassInteger(attribute,value);
+			this->defaults.fields |= Y;
+		}
+		else if(attribute == L"width")
+		{
+			this->defaults.width = ParseUIClassInteger(attribute,value);
+			this->defaults.fields |= WIDTH;
+		}
+		else if(attribute == L"height")
+		{
+			this->defaults.height = ParseUIClassInteger(attribute,value);
+			this->defaults.fields |= HEIGHT;
+		}
+	}
+
+	void UIClass::Unload(UIClass*& ui_class)
+	{
+		assert(ui_class != nullptr);
+
+
+		{
+			std::lock_guard<std::mutex> lock(ui_classes_mutex);
+
+
+			ui_classes.erase(GetUIClassKey(ui_class->name));
+		}
+
+		delete ui_class;
+		ui_class = nullptr;
 	}
 }
\ No newline at end of file
@@ -1,13 +1,26 @@
 #ifndef OS_H
 #define OS_H
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <Windows.h>
 
+#include "Animation.h"
+#include "Graphics.h"
+#include "ResourcePack.h"
+#include "SpatialIndex.h"
+
 #define EXPORT extern "C" __declspec(dllexport)
 
 
@@ -18,15 +31,51 @@ typedef WORD word;
 
 namespace OS
 {
+	class Control;
+
+	class Layout;
+
+	template<typename Value>
+	class Property;
+
+	class PropertyStore;
+
+	class ResourcePack;
+
 	class RuntimeException;
+
+	template<typename Item>
+	class SpatialIndex;
+
+	template<typename Derived>
+	class StaticWindow;
+
+	class StyleEdit;
+
+	class UIClass;
 	
+	class VirtualList;
+
 	class Window;
 
 	class WindowClass;
 
 	typedef std::function<LRESULT(Window*,WPARAM,LPARAM)> MessageHandler;
 	typedef std::function<void(Window*,WPARAM,LPARAM)> ExtendingMessageHandler;
+	typedef std::function<LRESULT(Control*,WPARAM,LPARAM)> ControlMessageHandler;
+	typedef std::function<void(Control*,WPARAM,LPARAM)> ExtendingControlMessageHandler;
+
+	typedef std::function<void(Window* cell,size_t row,size_t column)> VirtualListCellBinder;
 
+	typedef std::function<void(Window*)> AnimationHandler;
+
+	typedef UINT PropertyId;
+	typedef std::function<void(Window*,PropertyId)> PropertyObserver;
+
+	typedef std::function<void(Window*)> TimerHandler;
+
+	typedef void(WindowCallbackSignature)(OS::Window&);
+	typedef std::function<WindowCallbackSignature> WindowCallback;
 	typedef void(WindowOnClickCallbackSignature)(OS::Window&);
 	typedef std::function<WindowOnClickCallbackSignature> WindowOnClickCallback;
 	typedef void(WindowOnCloseCallbackSignature)(OS::Window&);
@@ -36,15 +85,237 @@ namespace OS
 	typedef void(WindowOnDestroyCallbackSignature)(OS::Window&);
 	typedef std::function<WindowOnDestroyCallbackSignature> WindowOnDestroyCallback;
 
+	struct GdiCacheStatistics
+	{
+		size_t brushes;
+		size_t cursors;
+		size_t icons;
+		size_t hits;
+		size_t misses;
+		DWORD gdi_objects;  //Held by the whole process, as reported by GetGuiResources.
+		DWORD user_objects;
+	};
+
+	struct MessageLatencyStatistics
+	{
+		UINT message;
+		const WindowClass* window_class;  //nullptr for windows which belong to no known class.
+		std::wstring class_name;
+		std::uint64_t count;
+		double total;  //All times are in microseconds, and include the time spent handling any messages sent while handling this one.
+		double mean;
+		double median;
+		double percentile_90;
+		double percentile_99;
+		double maximum;
+	};
+
+	struct StaticMessageMap  //Generated by OS::StaticWindow for each type of window derived from it.
+	{
+		bool (*dispatch)(Window* window,UINT message,WPARAM w_param,LPARAM l_param,LRESULT& result);  //Returns false if the message has no static handler.
+		bool (*handles)(UINT message);
+	};
+
+	struct TimerStatistics
+	{
+		size_t active;
+		std::uint64_t fired;
+		double median_lateness;  //In milliseconds, from when a timer was due to when its handler was called.
+		double percentile_99_lateness;
+		double maximum_lateness;
+	};
+
 	/* Function Prototypes */
+	/**
+	 * Gets a solid brush of the given color from the shared GDI object cache, creating it if no other reference to it is held.  Each call must be balanced by a call to OS::ReleaseGdiObject.
+	 */
+	HBRUSH AcquireBrush(COLORREF color);
+
+	/**
+	 * Gets a cursor from the shared GDI object cache, loading it if no other reference to it is held.  Each call must be balanced by a call to OS::ReleaseGdiObject.
+	 *
+	 * @param
+	 *   module
+	 *     Module containing the cursor, or nullptr for one of the system's cursors (such as IDC_ARROW).
+	 *   resource
+	 *     Name or MAKEINTRESOURCE identifier of the cursor.
+	 *
+	 * @throw
+	 *   OS::RuntimeException
+	 *     Thrown if the cursor could not be loaded.
+	 */
+	HCURSOR AcquireCursor(HINSTANCE module,const wchar* resource);
+
+	/**
+	 * Gets an icon from the shared GDI object cache, loading it if no other reference to it is held.  Each call must be balanced by a call to OS::ReleaseGdiObject.
+	 *
+	 * @param
+	 *   module
+	 *     Module containing the icon, or nullptr for one of the system's icons (such as IDI_APPLICATION).
+	 *   resource
+	 *     Name or MAKEINTRESOURCE identifier of the icon.
+	 *   size
+	 *     Width and height of the icon, or 0 for the system's default icon size.
+	 *
+	 * @throw
+	 *   OS::RuntimeException
+	 *     Thrown if the icon could not be loaded.
+	 */
+	HICON AcquireIcon(HINSTANCE module,const wchar* resource,int size = 0);
+
 	void DisplayErrorMessage();
 
 	void DisplayErrorMessage(DWORD error);
 
+	/**
+	 * Writes the statistics returned by OS::GetMessageLatencyStatistics to the debugger's output, one line per message and window class.
+	 */
+	void DumpMessageLatencyStatistics();
+
+	/**
+	 * Passes the invalidations accumulated through OS::Window::invalidate on the calling thread on to the system, one merged region per window.  Called by the message loop before it waits for the next message, and whenever the outermost message being handled on a thread returns, so that any number of visual changes made while handling one message result in at most one repaint per window, including under modal loops which never return to the message loop.
+	 */
+	void FlushInvalidations();
+
+	/**
+	 * Gets the number of windows of the calling thread with at least one animation in progress.
+	 */
+	size_t GetAnimatedWindowCount();
+
+	/**
+	 * Gets the number of bytes currently held by the back buffers of double-buffered windows, over every thread.
+	 */
+	size_t GetBackBufferUsage();
+
+	GdiCacheStatistics GetGdiCacheStatistics();
+
+	/**
+	 * Gets how often, and for how long, each message has been handled by the windows of each class since recording was enabled (or last reset).  The histograms of all threads are merged; percentiles are accurate to within 1/8th of their value.
+	 *
+	 * @return Returns one entry per message and window class, those which took the most time in total first.
+	 */
+	std::vector<MessageLatencyStatistics> GetMessageLatencyStatistics();
+
+	/**
+	 * Gets the name a property identifier was interned from.
+	 */
+	std::wstring GetPropertyName(PropertyId property);
+
+	/**
+	 * Gets the number of bytes currently held by the cache of decompressed resources.
+	 */
+	size_t GetResourceCacheUsage();
+
+	/**
+	 * Gets the number of window timers pending on the calling thread and how late they have been firing since the thread set its first.
+	 */
+	TimerStatistics GetTimerStatistics();
+
+	/**
+	 * Gets the identifier of a property name, assigning the next identifier if the name has not been seen before.  Names are case-sensitive and identifiers are never reused; identifiers start at 1.  May be called from any thread.
+	 *
+	 * @see OS::Property
+	 */
+	PropertyId InternProperty(const wchar* name);
+
+	bool IsRecordingMessageLatency();
+
+	/**
+	 * Drops one reference to an object obtained from the shared GDI object cache, destroying the object once no references remain.  Handles which did not come from the cache are ignored.
+	 *
+	 * @return Returns true if the handle came from the cache.
+	 */
+	bool ReleaseGdiObject(HANDLE handle);
+
+	/**
+	 * Sends the messages of a log written by OS::StartMessageRecording or OS::SaveMessageRecording to the windows of this thread, so that handling them can be measured repeatably.  Each recorded window is matched to the live window with the same class and parent (preferring one with the same name) which has not already been matched; window handles passed as parameters are mapped the same way.  Messages whose parameters are pointers or GDI handles from the recording process, those which create windows and those which would close or destroy windows or end the message loop are skipped, as are messages for windows which could not be matched.
+	 *
+	 * @param
+	 *   paced
+	 *     If true, the messages are sent at the intervals at which they were recorded; otherwise they are sent as quickly as they are handled.
+	 *
+	 * @return Returns the number of messages sent.
+	 *
+	 * @throw
+	 *   OS::RuntimeException
+	 *     Thrown if the log could not be read or is corrupt.
+	 */
+	size_t ReplayMessages(const wchar* path,bool paced = false);
+
+	/**
+	 * Discards the message latencies recorded so far.
+	 */
+	void ResetMessageLatencyStatistics();
+
+	/**
+	 * Adds a reference to an object obtained from the shared GDI object cache.  Handles which did not come from the cache are ignored.
+	 *
+	 * @return Returns true if the handle came from the cache.
+	 */
+	bool RetainGdiObject(HANDLE handle);
+
+	/**
+	 * Advances every animation of the calling thread's windows to the present as one frame: all values are interpolated for the same instant, the geometry of the animated windows is applied in one deferred update per parent, and then the handlers of the animations which finished are called.  Called by the thread's frame clock; may also be called directly, such as to step animations of unrealized windows without a message loop.
+	 *
+	 * @see OS::Window::animateGeometry
+	 */
+	void RunAnimationFrame();
+
+	/**
+	 * Writes the messages kept by a recording made without a log file to one, oldest first.  May be called while recording or after it has stopped.
+	 *
+	 * @throw
+	 *   OS::RuntimeException
+	 *     Thrown if the log could not be written.
+	 */
+	void SaveMessageRecording(const wchar* path);
+
 	int StartMessageLoop();
+
+	/**
+	 * Starts recording every message which reaches OS::Window::HandleMessage on the calling thread, along with the identity of each window involved.  Records are buffered and written in batches, so recording can be left on.
+	 *
+	 * @param
+	 *   path
+	 *     File to which the log is streamed, or nullptr to keep only the most recent messages in memory for OS::SaveMessageRecording.
+	 *
+	 * @throw
+	 *   OS::RuntimeException
+	 *     Thrown if the log file could not be created.
+	 */
+	void StartMessageRecording(const wchar* path = nullptr);
 	
+	/**
+	 * Sets the number of bytes which the back buffers of all double-buffered windows may hold together.  When a back buffer is allocated beyond this budget, the buffers of the least recently painted windows of the allocating thread are released; buffers of other threads' windows are left for those threads to release.
+	 */
+	void SetBackBufferBudget(size_t bytes);
+
+	/**
+	 * Periodically calls OS::DumpMessageLatencyStatistics from the calling thread's message loop.
+	 *
+	 * @param
+	 *   milliseconds
+	 *     Time between dumps, or 0 to stop dumping.
+	 */
+	void SetMessageLatencyDumpInterval(UINT milliseconds);
+
+	/**
+	 * Enables or disables recording of the time taken by OS::Window::HandleMessage.  While disabled, each message costs a single flag test; while enabled, it costs two reads of the performance counter and a histogram update local to the thread.
+	 */
+	void SetMessageLatencyRecording(bool enabled);
+
+	/**
+	 * Sets the number of bytes of decompressed resources which are kept around for later requests.  The least recently used resources are dropped first; resources larger than the whole budget are never cached.
+	 */
+	void SetResourceCacheBudget(size_t bytes);
+
 	void StopMessageLoop(int exit_code = 0);
 
+	/**
+	 * Stops recording messages and, if a log file was being written, completes and closes it.
+	 */
+	void StopMessageRecording();
+
 	/* Class Prototypes */
 	class RuntimeException : public std::runtime_error
 	{
@@ -70,6 +341,15 @@ namespace OS
 
 	class Module
 	{
+		public:
+			struct Resource
+			{
+				HRSRC location;
+				const void* data;
+				DWORD size;
+				std::shared_ptr<const void> storage;  //Owns the data of a resource which had to be decompressed; empty otherwise.
+			};
+
 		public:
 			static Module GetCurrent();
 
@@ -79,6 +359,15 @@ namespace OS
 		public:
 			Module(HINSTANCE module);
 
+			/**
+			 * Serves this module's resources from a resource pack before falling back to the resources linked into the module.  Applies to every OS::Module referring to the same module.
+			 *
+			 * @param
+			 *   pack
+			 *     Pack to attach, which must outlive the attachment, or nullptr to detach the current one.
+			 */
+			void attachResourcePack(ResourcePack* pack);
+
 			template<typename ProcedureSignature>
 			std::function<ProcedureSignature> getProcedure(const char* procedure_name)
 			{
@@ -102,48 +391,462 @@ namespace OS
 				}
 			}
 
+			/**
+			 * Gets a resource's data.  The data of a compressed resource is only guaranteed to remain valid while it stays in the cache of decompressed resources; use getResourceEntry to hold on to it for longer.
+			 */
 			void* getResource(WORD resource_id,const wchar* resource_type,WORD language = MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL));
 
+			/**
+			 * Locates a resource and maps its data, decompressing it first if it was stored compressed in an attached resource pack.  Each resource is only looked up in the module once; every later request for it, through any OS::Module referring to the same module, is answered from an index.  Safe to call from any thread.
+			 *
+			 * @return Returns the resource's location along with a read-only view of its data, which remains valid for as long as the module is loaded or, for a decompressed resource, for as long as the returned entry's storage is held.
+			 *
+			 * @throw
+			 *   OS::RuntimeException
+			 *     Thrown if the resource does not exist.
+			 */
+			Resource getResourceEntry(WORD resource_id,const wchar* resource_type,WORD language = MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL));
+
 			HRSRC getResourceLocation(WORD resource_id,const wchar* resource_type,WORD language = MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL));
 
 			DWORD getResourceSize(WORD resource_id,const wchar* resource_type,WORD language = MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL));
 
 			std::wstring getStringResource(WORD resource_id);
 
+			/**
+			 * Passes a resource's data to a consumer piece by piece.  A compressed resource is decompressed as it is consumed, without ever being held in memory as a whole, which suits resources larger than the cache of decompressed resources.
+			 *
+			 * @throw
+			 *   OS::RuntimeException
+			 *     Thrown if the resource does not exist or is corrupt.
+			 */
+			void streamResource(WORD resource_id,const wchar* resource_type,const std::function<void(const void* data,size_t size)>& consumer,WORD language = MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL));
+
 			DWORD getStringResourceSize(WORD resource_id);
 
 			operator HINSTANCE&();
 	};
 
+	/**
+	 * Typed key of a property kept by OS::Window::setProperty.  The name is interned the first time the key is used, so keys can be declared as constants anywhere; after that, the key is compared as an integer.
+	 */
+	template<typename Value>
+	class Property
+	{
+		public:
+			typedef Value ValueType;
+
+		private:
+			const wchar* name;
+			mutable std::atomic<PropertyId> id;  //0 until first used.
+
+		public:
+			explicit Property(const wchar* name)
+			: name(name),id(0)
+			{
+				assert(name != nullptr);
+			}
+
+			Property(const Property&) = delete;
+
+			Property& operator=(const Property&) = delete;
+
+			operator PropertyId() const
+			{
+				return this->getId();
+			}
+
+			PropertyId getId() const
+			{
+				PropertyId id = this->id.load(std::memory_order_relaxed);
+
+
+				if(id == 0)  //Interning is idempotent, so threads racing to do it agree on the result.
+				{
+					id = InternProperty(this->name);
+					this->id.store(id,std::memory_order_relaxed);
+				}
+
+				return id;
+			}
+
+			const wchar* getName() const
+			{
+				return this->name;
+			}
+	};
+
+	/**
+	 * Flat map from interned property identifiers to values of any copyable type, kept sorted by identifier so that a lookup is a binary search over contiguous memory.  Values which are trivially copyable and no larger than two pointers are stored within their entry; others are allocated separately.
+	 */
+	class PropertyStore
+	{
+		private:
+			typedef std::aligned_storage<2 * sizeof(void*)>::type InlineStorage;
+
+			struct Entry
+			{
+				PropertyId property;
+				const void* type;  //Unique to each type of value; see PropertyStore::GetType.
+				void (*destroy)(Entry& entry);  //nullptr for values stored within the entry.
+				InlineStorage storage;  //The value itself, or a pointer to it.
+			};
+
+			template<typename Value,bool Inline = std::is_trivially_copyable<Value>::value && sizeof(Value) <= sizeof(InlineStorage) && std::alignment_of<Value>::value <= std::alignment_of<InlineStorage>::value>
+			struct Storage
+			{
+				static void Construct(Entry& entry,const Value& value)
+				{
+					new(&entry.storage) Value(value);
+					entry.destroy = nullptr;
+				}
+
+				static Value* Get(Entry& entry)
+				{
+					return reinterpret_cast<Value*>(&entry.storage);
+				}
+			};
+
+			template<typename Value>
+			struct Storage<Value,false>
+			{
+				static void Construct(Entry& entry,const Value& value)
+				{
+					*reinterpret_cast<Value**>(&entry.storage) = new Value(value);
+					entry.destroy = &Storage::Destroy;
+				}
+
+				static void Destroy(Entry& entry)
+				{
+					delete Storage::Get(entry);
+				}
+
+				static Value* Get(Entry& entry)
+				{
+					return *reinterpret_cast<Value**>(&entry.storage);
+				}
+			};
+
+		private:
+			std::vector<Entry> entries;
+
+		private:
+			template<typename Value>
+			static const void* GetType()
+			{
+				static char type;  //Writable, so that the linker cannot fold the tags of different types together.
+
+
+				return &type;
+			}
+
+			static void Release(Entry& entry);
+
+			void insert(const Entry& entry);
+
+			Entry* locate(PropertyId property);
+
+		public:
+			PropertyStore() = default;
+
+			PropertyStore(const PropertyStore&) = delete;
+
+			~PropertyStore();
+
+			PropertyStore& operator=(const PropertyStore&) = delete;
+
+			void clear();
+
+			bool contains(PropertyId property) const;
+
+			/**
+			 * Gets a property's value, which must have been set with the same type.
+			 *
+			 * @return Returns nullptr if the property is not set.  The value stays where it is until the property is set to a value of another type, removed or cleared.
+			 */
+			template<typename Value>
+			Value* find(PropertyId property)
+			{
+				Entry* entry = this->locate(property);
+
+
+				if(entry == nullptr)
+				{
+					return nullptr;
+				}
+
+				assert(entry->type == PropertyStore::GetType<Value>());
+
+				return Storage<Value>::Get(*entry);
+			}
+
+			size_t getCount() const;
+
+			/**
+			 * @return Returns true if the property was set.
+			 */
+			bool remove(PropertyId property);
+
+			/**
+			 * Sets a property's value, assigning over the current value if it has the same type and replacing it otherwise.
+			 */
+			template<typename Value>
+			void set(PropertyId property,const Value& value)
+			{
+				Entry* existing = this->locate(property);
+				Entry entry;
+
+
+				if(existing != nullptr && existing->type == PropertyStore::GetType<Value>())
+				{
+					*Storage<Value>::Get(*existing) = value;
+
+					return;
+				}
+
+				if(existing == nullptr)
+				{
+					this->entries.reserve(this->entries.size() + 1);  //Inserting below cannot throw once the value is constructed.
+				}
+
+				entry.property = property;
+				entry.type = PropertyStore::GetType<Value>();
+				Storage<Value>::Construct(entry,value);
+				if(existing == nullptr)
+				{
+					this->insert(entry);
+				}
+				else
+				{
+					PropertyStore::Release(*existing);
+					*existing = entry;
+				}
+			}
+	};
+
+	/**
+	 * Transaction over the styles of one or more windows.  Each window's style and extended style are read once, when the window is first edited.  On commit, each window's changed styles are written once, followed by a single SetWindowPos if anything more is needed: recalculating its frame (SWP_FRAMECHANGED) if a style affecting the frame changed, and showing or hiding it if WS_VISIBLE changed.  Windows are committed in the order in which they were first edited, and whatever has not been committed is committed when the transaction is destroyed.
+	 */
+	class StyleEdit
+	{
+		private:
+			struct Entry
+			{
+				Window* window;
+				DWORD original_style;
+				DWORD original_style_extended;
+				DWORD style;
+				DWORD style_extended;
+				bool reparent;
+				HWND parent;
+			};
+
+		private:
+			std::vector<Entry> entries;
+
+		private:
+			Entry& getEntry(Window* window);
+
+		public:
+			StyleEdit() = default;
+
+			StyleEdit(const StyleEdit&) = delete;
+
+			~StyleEdit();
+
+			StyleEdit& operator=(const StyleEdit&) = delete;
+
+			void addExtendedStyle(Window* window,DWORD style);
+
+			void addStyle(Window* window,DWORD style);
+
+			/**
+			 * Applies the changes made so far.  The transaction may be used again afterwards, reading the styles of the windows it edits afresh.
+			 */
+			void commit();
+
+			/**
+			 * Gets a window's extended style, including the changes made by this transaction.
+			 */
+			DWORD getExtendedStyle(Window* window);
+
+			/**
+			 * Gets a window's style, including the changes made by this transaction.
+			 */
+			DWORD getStyle(Window* window);
+
+			void removeExtendedStyle(Window* window,DWORD style);
+
+			void removeStyle(Window* window,DWORD style);
+
+			void setExtendedStyle(Window* window,DWORD style);
+
+			/**
+			 * Moves a realized window to a new parent, or to the desktop if parent is nullptr, as part of this transaction.  As SetParent requires, a window which is becoming a child window is reparented after its styles are written, and any other window before.
+			 */
+			void setParent(Window* window,Window* parent);
+
+			void setStyle(Window* window,DWORD style);
+	};
+
 	class Window
 	{
+		friend class Control;
+		template<typename Derived> friend class StaticWindow;
+		friend class StyleEdit;
+		friend class UIClass;
 		friend class WindowClass;
 
+		friend void FlushInvalidations();
+
 		private:
 			static LRESULT WINAPI HandleMessage(HWND window_handle,UINT message,WPARAM w_param,LPARAM l_param);
 
 		public:
 			static Window* FromHandle(HWND window_handle);
 
+		private:
+			struct PropertyObserverEntry
+			{
+				UINT_PTR id;
+				PropertyId property;
+				PropertyObserver observer;
+			};
+
 		private:
 			struct
 			{
 				HBRUSH background;
 			} properties;
 
+			PropertyStore property_store;  //Typed properties, kept within this object rather than by the system.
+			std::vector<PropertyObserverEntry> property_observers;
+			UINT_PTR last_property_observer;
+
+			struct
+			{
+				bool pending;
+				bool destroyed;  //Destroyed before being realized, after which it never will be.
+				std::wstring name;
+				DWORD style;
+				DWORD style_extended;
+				int x;
+				int y;
+				int width;
+				int height;
+				Window* parent;
+				std::vector<Window*> children;
+				std::map<std::wstring,HANDLE> properties;
+			} deferred;  //State recorded for a window whose native counterpart has not yet been created.
+
+			struct
+			{
+				bool pending;
+				bool children;
+				bool erase;
+				bool whole;
+				RECT rectangle;
+			} invalidation;  //Accumulated until the next OS::FlushInvalidations.
+
+			unsigned painting_suspensions;
+
+			struct
+			{
+				bool enabled;
+				HDC device_context;
+				HBITMAP bitmap;
+				HGDIOBJ previous_bitmap;
+				int width;
+				int height;
+				int saved_state;  //Non-zero while a paint is being drawn into the buffer.
+				bool controls_painted;
+			} back_buffer;
+
+			Graphics::Surface* surface;  //Created on first use.
+
+			struct
+			{
+				Graphics::Surface* content;  //This window's client area alone, without its children.
+				bool stale;
+			} render_cache;
+
+			SpatialIndex<Window*> child_index;  //Rectangles of this window's managed children, in client coordinates.
+			bool unindexed_children;  //Whether a native child has been created which the index does not hold, such as a window of a class not managed by this API.  Hit tests are then left to the system.
+			SpatialIndex<Control*> control_index;
+			std::vector<Control*> controls;  //Ordered bottom-most to top-most.
+			Control* focused_control;
+			Window* indexed_parent;
+			Layout* layout;
 			std::map<UINT,MessageHandler> message_handlers;
 			Module module;
+			const StaticMessageMap* static_message_map;  //nullptr unless this is an OS::StaticWindow.
 			WindowClass* window_class;
 			HWND window_handle;
 
 		private:
 			Window(HWND window_handle,WindowClass* window_class);
 
+			Window(WindowClass* window_class);
+
+			virtual ~Window();  //Virtual so that windows of an OS::StaticWindow type are deleted whole by their class.
+
+			bool acquireBackBuffer(HDC device_context,int width,int height);
+
+			bool dispatchToControls(UINT message,WPARAM w_param,LPARAM l_param,LRESULT& result);
+
+			void destroyControls();
+
+			void indexInParent(const WINDOWPOS* position = nullptr);
+
+			bool isEligibleForHitTest(UINT flags);
+
+			void notifyPropertyObservers(PropertyId property);
+
+			void paintControls(HDC device_context,const RECT& update_rectangle);
+
+			void releaseBackBuffer();
+
+			/**
+			 * Releases everything this window holds besides its native counterpart, once it has been destroyed, whether or not it was ever realized.
+			 */
+			void releaseResources();
+
+			void renderContent();
+
+			void renderTree(Graphics::Surface& target,int x,int y,const Graphics::Bounds& clip);
+
 		public:
 			void addExtendedStyle(DWORD style);
 
 			void addStyle(DWORD style);
 
+			/**
+			 * Fades this window's background to a solid color.  The background is set through the shared GDI object cache on each frame.
+			 *
+			 * @see OS::Window::animateGeometry
+			 */
+			void animateBackground(COLORREF color,UINT milliseconds,Animation::Easing easing = Animation::Easing::EASE_IN_OUT,AnimationHandler handler = nullptr);
+
+			/**
+			 * Moves and sizes this window to the given rectangle over time.  Frames are paced by a single clock shared by every animation of the thread, and each frame's geometry changes are applied together.  Starting an animation replaces any animation of the same kind already in progress, from where it left off and without calling its handler; animations of different kinds (geometry, opacity and background) run independently.  A window's animations are stopped when it is destroyed.
+			 *
+			 * @param
+			 *   rectangle
+			 *     Final bounds, in the coordinates used by setPosition:  relative to the parent's client area for child windows, or to the screen for top-level windows.
+			 *   handler
+			 *     Called once the animation has finished, unless it was stopped or replaced.
+			 *
+			 * @see OS::RunAnimationFrame
+			 */
+			void animateGeometry(const RECT& rectangle,UINT milliseconds,Animation::Easing easing = Animation::Easing::EASE_IN_OUT,AnimationHandler handler = nullptr);
+
+			/**
+			 * Fades this window to the given opacity, where 0 is transparent and 255 opaque, making it a layered window if it is not one already.  Only top-level windows can be made translucent before Windows 8; the opacity of unrealized windows is not applied.
+			 *
+			 * @see OS::Window::animateGeometry
+			 */
+			void animateOpacity(BYTE opacity,UINT milliseconds,Animation::Easing easing = Animation::Easing::EASE_IN_OUT,AnimationHandler handler = nullptr);
+
 			/**
 			 * Causes this window to arrange its minimized children.
 			 *
@@ -161,6 +864,11 @@ namespace OS
 			 */
 			UINT arrangeMinimizedChildren();
 
+			/**
+			 * Prepares this window for painting.  If this window is double-buffered, the returned device context draws into this window's back buffer, clipped to the area being painted and already filled with this window's background; the area is copied to the screen by endPaint.
+			 *
+			 * @see BeginPaint (http://msdn.microsoft.com/en-us/library/windows/desktop/dd183362(v=vs.85).aspx)
+			 */
 			HDC beginPaint(PAINTSTRUCT& paint_struct);
 
 			/**
@@ -174,6 +882,11 @@ namespace OS
 			 */
 			void bringToTop();
 
+			/**
+			 * Stops a timer started by OS::Window::setTimer.  Has no effect if the timer has already stopped.
+			 */
+			void cancelTimer(UINT_PTR timer);
+
 			/**
 			 * Modifies the User Interface Privilege Isolation (UIPI) message filter foor a specified window.
 			 *
@@ -198,8 +911,28 @@ namespace OS
 			 */
 			void changeMessageFilter(UINT message,DWORD action);
 
+			/**
+			 * Creates a windowless control hosted by this window.  The control has no native handle; this window performs its hit testing, focus tracking, painting and message routing.  The new control is placed on top of any existing controls.
+			 *
+			 * @param
+			 *   control_name
+			 *     Name of the new control.
+			 *
+			 * @return Returns the new control.  It remains owned by this window and is destroyed along with it.
+			 */
+			Control* createControl();
+
+			Control* createControl(const wchar* control_name);
+
+			Control* createControl(const std::wstring& control_name);
+
+			/**
+			 * Destroys this window and its children.  A window destroyed before being realized has no native counterpart: its WM_DESTROY and WM_NCDESTROY handlers are still called, but the native window procedure is not.
+			 */
 			void destroy();
 
+			void destroyControl(Control*& control);
+
 			void endPaint(PAINTSTRUCT& paint_struct);
 
 			void extendMessageHandler(UINT message,ExtendingMessageHandler handler);
@@ -224,15 +957,62 @@ namespace OS
 			 * @return
 			 *   Returns the Window that is under the specified location.  If the location specified is outside of this window or if there are no children at that point, the window returned by this call will return false on a call to its Window::isValid() method.
 			 *
+			 * @note
+			 *   Children are looked up through a spatial index which this window maintains as its children are created, moved, resized, re-parented and destroyed, rather than by walking every child.  Once this window has been told of a native child the index does not hold (through WM_PARENTNOTIFY), they are looked up with ChildWindowFromPointEx instead, so that such children are still found.
+			 *
 			 * @see GetChildFromPoint (http://msdn.microsoft.com/en-us/library/windows/desktop/ms632676(v=vs.85).aspx)
 			 */
 			Window* getChildByLocation(LONG x,LONG y,UINT flags = CWP_ALL);
 
-			DWORD getExtendedStyle();
-
-			int getHeight();
+			/**
+			 * Gets the children of this window which intersect the given rectangle, ordered bottom-most first.  The rectangle is relative to this window's client area.  The flags are the same as those accepted by getChildByLocation.
+			 */
+			std::vector<Window*> getChildrenInRectangle(const RECT& rectangle,UINT flags = CWP_ALL);
 
-			int getIdentifier();
+			/**
+			 * Gets the top-most windowless control hosted by this window that lies underneath the location (x,y).  The given coordinates are relative to this window's client area.
+			 *
+			 * @param
+			 *   flags
+			 *     May be one or more of the following values:
+			 *       CWP_ALL
+			 *       CWP_SKIPDISABLED
+			 *       CWP_SKIPINVISIBLE
+			 *
+			 * @return Returns the control under the specified location, or nullptr if there is none.
+			 */
+			Control* getControlByLocation(LONG x,LONG y,UINT flags = CWP_ALL);
+
+			const std::vector<Control*>& getControls() const;
+
+			/**
+			 * Gets the windowless controls hosted by this window which intersect the given rectangle, ordered bottom-most first.  The flags are the same as those accepted by getControlByLocation.
+			 */
+			std::vector<Control*> getControlsInRectangle(const RECT& rectangle,UINT flags = CWP_ALL);
+
+			DWORD getExtendedStyle();
+
+			Control* getFocusedControl();
+
+			int getHeight();
+
+			int getIdentifier();
+
+			/**
+			 * Marks part of this window as needing to be repainted.  Invalidations are merged and only passed on to the system by the next OS::FlushInvalidations, which is performed once the outermost message being handled returns and by the message loop before waiting for a message.  Must be called from the thread this window belongs to.
+			 *
+			 * @param
+			 *   rectangle
+			 *     Area to invalidate, relative to this window's client area.  If nullptr, the whole window is invalidated.
+			 *   erase
+			 *     Whether or not the background should be erased before the area is repainted.
+			 */
+			void invalidate(const RECT* rectangle = nullptr,bool erase = true);
+
+			/**
+			 * Gets the layout node which positions and sizes this window, creating it if necessary.  The node is owned by this window and is destroyed along with it.
+			 */
+			Layout* getLayout();
 
 			MessageHandler getMessageHandler(UINT message);
 
@@ -240,20 +1020,51 @@ namespace OS
 
 			std::wstring getName();
 
-			HWND getNativeHandle() const;
+			/**
+			 * Gets the native handle of this window.  If this window's realization was deferred, the native window is created by this call.
+			 *
+			 * @see OS::Window::realize
+			 */
+			HWND getNativeHandle();
 
 			Window* getOwner();
 
 			Window* getParent();
 
+			/**
+			 * Gets a property stored with this window's native counterpart through GetProp, where native code and other processes can see it.  Properties used only by this process are better kept as typed properties.
+			 *
+			 * @see OS::Window::setProperty
+			 */
 			HANDLE getProperty(const wchar* property_name);
 
 			HANDLE getProperty(const std::wstring& property_name);
 
+			/**
+			 * Gets a typed property of this window.
+			 *
+			 * @return Returns fallback if the property is not set.
+			 */
+			template<typename Value>
+			Value getProperty(const Property<Value>& property,const typename Property<Value>::ValueType& fallback = Value())
+			{
+				const Value* value = this->property_store.find<Value>(property.getId());
+
+
+				return value != nullptr ? *value : fallback;
+			}
+
 			RECT getRectangle(bool client_area = false);
 
 			DWORD getStyle();
 
+			/**
+			 * Gets the software-rendered surface of this window, creating it if necessary.  The surface is resized to match this window's client area on every call.  Whatever is drawn into it is shown on screen by OS::Window::presentSurface.
+			 *
+			 * @see Graphics
+			 */
+			Graphics::Surface& getSurface();
+
 			int getWidth();
 
 			WindowClass* getWindowClass() const;
@@ -264,16 +1075,37 @@ namespace OS
 
 			bool hasParent();
 
+			bool hasProperty(PropertyId property);
+
 			bool isAlive();
 
+			bool isAnimating();
+
+			bool isDoubleBuffered();
+
+			/**
+			 * Checks whether or not painting is suspended for this window, either directly or through one of its ancestors.
+			 */
+			bool isPaintingSuspended();
+
+			/**
+			 * Checks whether or not the native counterpart of this window has been created.
+			 *
+			 * @return Returns false if this window was instantiated with deferred realization and has not yet been realized, true otherwise.
+			 */
+			bool isRealized() const;
+
 			bool isTopLevel();
 
 			bool isVisible();
 
+			/**
+			 * Maximizes this window.  If animated, a visible window is first grown to fill the work area of its monitor (or its parent's client area), after which its restored position is kept as it was.
+			 */
 			void maximize(bool animate = true);
 
 			/**
-		  	 * Minimizes this window.
+		  	 * Minimizes this window.  If animated, a visible top-level window is first faded out.
 			 *
 			 * @throw
 			 *   OS::WindowRuntimeException
@@ -283,20 +1115,90 @@ namespace OS
 			 */
 			void minimize(bool animate = true);
 
+			/**
+			 * Calls an observer after a typed property of this window is set or removed, whether or not its value changed.  Observers are forgotten when this window is destroyed.
+			 *
+			 * @return Returns an identifier for OS::Window::unobserveProperty.
+			 */
+			UINT_PTR observeProperty(PropertyId property,PropertyObserver observer);
+
+			/**
+			 * Copies this window's software-rendered surface to a device context, typically the one returned by OS::Window::beginPaint.  Has no effect if the surface was never used.
+			 *
+			 * @param
+			 *   device_context
+			 *     Device context to copy to, whose origin is the top-left corner of this window's client area.
+			 *   area
+			 *     Part of the client area to copy.  If nullptr, the whole surface is copied.
+			 */
+			void presentSurface(HDC device_context,const RECT* area = nullptr);
+
+			/**
+			 * Creates the native counterpart of a window that was instantiated with deferred realization, applying the name, styles, geometry, parent and properties recorded so far.  The parent is realized first.  Any deferred children which are marked visible are realized along with it.  Has no effect if this window is already realized or was destroyed before being realized.
+			 *
+			 * @throw
+			 *   OS::RuntimeException
+			 *     Thrown if the native window could not be created.
+			 */
+			void realize();
+
 			void removeExtendedStyle(DWORD style);
 
 			void removeProperty(const wchar* property_name);
 
 			void removeProperty(const std::wstring& property_name);
 
+			void removeProperty(PropertyId property);
+
 			void removeStyle(DWORD style);
 
+			/**
+			 * Renders the client area of this window and of its visible descendants, in z-order and clipped to their parents, without requiring any of them to be on screen.  The client area of each window is cached and only drawn again once the window has been invalidated, resized or repainted, so rendering an unchanged tree amounts to copying pixels.  Each window's client area is captured through WM_PRINT, so only what its painting draws into a memory device context is rendered; under the headless stand-in that excludes text and images.
+			 *
+			 * @param
+			 *   target
+			 *     Surface to render into.  It is resized to this window's client area.
+			 */
+			void render(Graphics::Surface& target);
+
+			/**
+			 * Renders this window as OS::Window::render does, into a new 32-bit top-down DIB section which the caller must delete with DeleteObject.
+			 *
+			 * @throw
+			 *   OS::RuntimeException
+			 *     Thrown if the bitmap could not be created.
+			 */
+			HBITMAP renderToBitmap();
+
+			/**
+			 * Restores this window from being minimized or maximized.  If animated, a minimized top-level window is faded in once restored and a maximized window is shrunk to its restored position.
+			 */
 			void restore(bool animate = true);
 
+			/**
+			 * Undoes one call to suspendPainting.  Once every suspension is undone, this window and its children are invalidated as a whole.
+			 */
+			void resumePainting();
+
+			/**
+			 * Sets the brush used to erase this window's background.  If the brush came from the shared GDI object cache, this window holds a reference to it for as long as it is in use.
+			 */
 			void setBackground(HBRUSH background);
 
+			/**
+			 * Sets this window's background to a solid color, using a brush from the shared GDI object cache.
+			 */
+			void setBackground(COLORREF color);
+
 			void setDimensions(int width,int height);
 
+			/**
+			 * Enables or disables double-buffered painting.  A double-buffered window keeps a back buffer the size of its client area, which is only reallocated when the client area grows beyond it, and paints only the invalidated area before copying it to the screen in a single blit.
+			 *
+			 * @see OS::SetBackBufferBudget
+			 */
+			void setDoubleBuffered(bool double_buffered);
+
 			void setExtendedStyle(DWORD style);
 
 			void setMessageHandler(UINT message,MessageHandler handler);
@@ -315,15 +1217,58 @@ namespace OS
 
 			void setProperty(const std::wstring& property_name,HANDLE value);
 
+			/**
+			 * Sets a typed property of this window.  Typed properties are kept within this object, so they are available before the window is realized and cost no more than a binary search over this window's properties; they are released when the window is destroyed.
+			 *
+			 * @see OS::Window::observeProperty
+			 */
+			template<typename Value>
+			void setProperty(const Property<Value>& property,const typename Property<Value>::ValueType& value)
+			{
+				this->property_store.set(property.getId(),value);
+				if(!this->property_observers.empty())
+				{
+					this->notifyPropertyObservers(property.getId());
+				}
+			}
+
 			void setStyle(DWORD style);
 
+			/**
+			 * Calls a handler once the given time has passed, and again each time it passes after that if repeat is true.  Timers must be set from the thread this window belongs to, from whose message loop the handlers are called; all timers of a thread share a single native timer, so any number may be pending.  A window's timers are cancelled when it is destroyed.
+			 *
+			 * @return Returns an identifier for OS::Window::cancelTimer.
+			 *
+			 * @see OS::GetTimerStatistics
+			 */
+			UINT_PTR setTimer(UINT milliseconds,TimerHandler handler,bool repeat = true);
+
 			void setVisible(bool visible);
 
 			void show(int show_command = SW_SHOW);
 
+			/**
+			 * Stops this window's animations where they are, without calling their handlers.
+			 */
+			void stopAnimations();
+
+			/**
+			 * Stops this window and its children from being repainted until a matching call to resumePainting.  Calls may be nested.
+			 *
+			 * @message
+			 *   WM_SETREDRAW
+			 *     Sent to this window when painting is first suspended and when it is finally resumed.
+			 */
+			void suspendPainting();
+
+			void unobserveProperty(UINT_PTR observer);
+
 			void unsetMessageHandler(UINT message);
 	};
 
+	/**
+	 * Class of windows, through which the default message handlers of its windows are set.  Classes may be looked up, and their windows' messages dispatched, from any number of threads at once without locking; registering, unregistering and changing handlers are serialized, and never block those readers.
+	 */
 	class WindowClass
 	{
 		friend class Window;
@@ -356,9 +1301,13 @@ namespace OS
 		private:
 			wchar class_name[256];
 			HINSTANCE context;
+			std::set<Window*> deferred_windows;  //Guarded by windows_mutex, as are destroyed_windows and instantiated_windows.
+			std::vector<Window*> destroyed_windows;  //Destroyed before being realized; kept only to be deleted when this class is unregistered.
 			std::map<HWND,Window*> instantiated_windows;
-			std::map<UINT,MessageHandler> message_handlers;
+			std::atomic<const std::map<UINT,MessageHandler>*> message_handlers;  //Replaced by a changed copy rather than changed, so that messages are dispatched without locking.
+			std::mutex message_handlers_mutex;  //Serializes changes to the handlers.
 			Window* prototype;
+			std::mutex windows_mutex;
 
 			WNDPROC default_window_procedure;
 
@@ -371,8 +1320,23 @@ namespace OS
 
 			void forget(Window* window);  //Unmanage?
 
+			/**
+			 * Gets a handler which passes a message on to the window procedure this class had before it was subclassed.
+			 */
+			MessageHandler getWindowProcedureHandler(UINT message);
+
 			Window* manage(HWND window_handle);
 
+			/**
+			 * Gives a window which has no native counterpart yet this class's defaults, and tracks it until it is realized.
+			 */
+			void prepareDeferred(Window* window,const wchar* window_name);
+
+			/**
+			 * Stops tracking a window which was destroyed before being realized.  The window is kept only to be deleted when this class is unregistered.
+			 */
+			void retire(Window* window);
+
 			void setDefaultMessageHandlers();
 
 		public:
@@ -402,22 +1366,81 @@ namespace OS
 
 			Window* instantiate();
 
-			Window* instantiate(const wchar* window_name);
+			/**
+			 * Creates a new window of this class.
+			 *
+			 * @param
+			 *   window_name
+			 *     Name of the new window.
+			 *   defer_realization
+			 *     If true, only the in-memory window is created; the native window is created on the first call to show, setVisible(true) or getNativeHandle.
+			 */
+			Window* instantiate(const wchar* window_name,bool defer_realization = false);
+
+			Window* instantiate(const std::wstring& window_name,bool defer_realization = false);
+
+			/**
+			 * Creates a new window of this class as an object of a type derived from OS::StaticWindow, whose handlers are dispatched without looking them up.
+			 *
+			 * @param
+			 *   window_name
+			 *     Name of the new window.
+			 *   defer_realization
+			 *     If true, only the in-memory window is created; the native window is created on the first call to show, setVisible(true) or getNativeHandle.
+			 *
+			 * @see OS::StaticWindow
+			 */
+			template<typename Derived>
+			Derived* instantiate(const wchar* window_name = L"Untitled Window",bool defer_realization = false)
+			{
+				Derived* window = new Derived(this);
+
 
-			Window* instantiate(const std::wstring& window_name);
+				this->prepareDeferred(window,window_name);
+				if(!defer_realization)
+				{
+					window->realize();
+				}
+
+				return window;
+			}
 			
+			/**
+			 * Sets the brush used to erase the background of this class's windows.  If the brush came from the shared GDI object cache, this class holds a reference to it for as long as it is in use.
+			 */
 			void setBackground(HBRUSH background);
 
+			/**
+			 * Sets the background of this class's windows to a solid color, using a brush from the shared GDI object cache.
+			 */
+			void setBackground(COLORREF color);
+
 			void setCursor(HCURSOR cursor);
 
+			/**
+			 * Sets this class's cursor to one loaded through the shared GDI object cache.
+			 *
+			 * @see OS::AcquireCursor
+			 */
+			void setCursor(HINSTANCE module,const wchar* resource);
+
 			void setDefaultMessageHandler(UINT message,MessageHandler handler);
 
 			void setWindowDefaults(DWORD style,DWORD extended_style,int x,int y,int width,int height);
 
 			void setIcon(HICON icon);
 
+			/**
+			 * Sets this class's icon to one loaded through the shared GDI object cache.
+			 *
+			 * @see OS::AcquireIcon
+			 */
+			void setIcon(HINSTANCE module,const wchar* resource);
+
 			void setIconSmall(HICON icon);
 
+			void setIconSmall(HINSTANCE module,const wchar* resource);
+
 			void setMenuName(const wchar* menu_name);
 
 			void setMenuName(const std::wstring& menu_name);
@@ -426,6 +1449,474 @@ namespace OS
 
 			void unsetDefaultMessageHandler(UINT message);
 	};
+
+	/**
+	 * A window whose handlers are members of Derived, chosen when it is compiled.  Derived declares any of the handlers below with the same signature, and must declare them public; those it declares are dispatched through a switch, without a table lookup or a std::function, and messages it has no handler for fall back to the handlers set at run time.  A handler which also wants the default handling calls the StaticWindow version of itself.  Handlers set on the window itself at run time, including through OS::Window::extendMessageHandler, take precedence over static ones, and those set on its class are preceded by them.
+	 *
+	 * Windows of such a type are created by OS::WindowClass::instantiate<Derived>, which requires a constructor taking the window class:
+	 *
+	 *   struct MainWindow : OS::StaticWindow<MainWindow>
+	 *   {
+	 *     MainWindow(OS::WindowClass* window_class) : StaticWindow(window_class) {}
+	 *
+	 *     LRESULT onPaint(WPARAM w_param,LPARAM l_param);
+	 *   };
+	 */
+	template<typename Derived>
+	class StaticWindow : public Window
+	{
+		private:
+			template<typename Handler>
+			struct IsDeclared  //Tells whether Derived declares a handler, rather than inheriting the one below.
+			{
+				static const bool value = !std::is_same<Handler,LRESULT (StaticWindow::*)(WPARAM,LPARAM)>::value;
+			};
+
+		private:
+			static const StaticMessageMap message_map;
+
+		private:
+			static bool Dispatch(Window* window,UINT message,WPARAM w_param,LPARAM l_param,LRESULT& result)
+			{
+				Derived* derived = static_cast<Derived*>(window);
+
+
+				switch(message)
+				{
+					case WM_CHAR:
+						if(IsDeclared<decltype(&Derived::onChar)>::value)
+						{
+							result = derived->onChar(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_CLOSE:
+						if(IsDeclared<decltype(&Derived::onClose)>::value)
+						{
+							result = derived->onClose(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_COMMAND:
+						if(IsDeclared<decltype(&Derived::onCommand)>::value)
+						{
+							result = derived->onCommand(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_CREATE:
+						if(IsDeclared<decltype(&Derived::onCreate)>::value)
+						{
+							result = derived->onCreate(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_DESTROY:
+						if(IsDeclared<decltype(&Derived::onDestroy)>::value)
+						{
+							result = derived->onDestroy(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_ERASEBKGND:
+						if(IsDeclared<decltype(&Derived::onEraseBackground)>::value)
+						{
+							result = derived->onEraseBackground(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_KEYDOWN:
+						if(IsDeclared<decltype(&Derived::onKeyDown)>::value)
+						{
+							result = derived->onKeyDown(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_KEYUP:
+						if(IsDeclared<decltype(&Derived::onKeyUp)>::value)
+						{
+							result = derived->onKeyUp(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_LBUTTONDOWN:
+						if(IsDeclared<decltype(&Derived::onLeftButtonDown)>::value)
+						{
+							result = derived->onLeftButtonDown(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_LBUTTONUP:
+						if(IsDeclared<decltype(&Derived::onLeftButtonUp)>::value)
+						{
+							result = derived->onLeftButtonUp(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_MOUSEMOVE:
+						if(IsDeclared<decltype(&Derived::onMouseMove)>::value)
+						{
+							result = derived->onMouseMove(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_PAINT:
+						if(IsDeclared<decltype(&Derived::onPaint)>::value)
+						{
+							result = derived->onPaint(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_SIZE:
+						if(IsDeclared<decltype(&Derived::onSize)>::value)
+						{
+							result = derived->onSize(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+
+					case WM_TIMER:
+						if(IsDeclared<decltype(&Derived::onTimer)>::value)
+						{
+							result = derived->onTimer(w_param,l_param);
+
+							return true;
+						}
+
+						break;
+				}
+
+				return false;
+			}
+
+			static bool Handles(UINT message)
+			{
+				switch(message)
+				{
+					case WM_CHAR:
+						return IsDeclared<decltype(&Derived::onChar)>::value;
+
+					case WM_CLOSE:
+						return IsDeclared<decltype(&Derived::onClose)>::value;
+
+					case WM_COMMAND:
+						return IsDeclared<decltype(&Derived::onCommand)>::value;
+
+					case WM_CREATE:
+						return IsDeclared<decltype(&Derived::onCreate)>::value;
+
+					case WM_DESTROY:
+						return IsDeclared<decltype(&Derived::onDestroy)>::value;
+
+					case WM_ERASEBKGND:
+						return IsDeclared<decltype(&Derived::onEraseBackground)>::value;
+
+					case WM_KEYDOWN:
+						return IsDeclared<decltype(&Derived::onKeyDown)>::value;
+
+					case WM_KEYUP:
+						return IsDeclared<decltype(&Derived::onKeyUp)>::value;
+
+					case WM_LBUTTONDOWN:
+						return IsDeclared<decltype(&Derived::onLeftButtonDown)>::value;
+
+					case WM_LBUTTONUP:
+						return IsDeclared<decltype(&Derived::onLeftButtonUp)>::value;
+
+					case WM_MOUSEMOVE:
+						return IsDeclared<decltype(&Derived::onMouseMove)>::value;
+
+					case WM_PAINT:
+						return IsDeclared<decltype(&Derived::onPaint)>::value;
+
+					case WM_SIZE:
+						return IsDeclared<decltype(&Derived::onSize)>::value;
+
+					case WM_TIMER:
+						return IsDeclared<decltype(&Derived::onTimer)>::value;
+				}
+
+				return false;
+			}
+
+		protected:
+			StaticWindow(WindowClass* window_class)
+			: Window(window_class)
+			{
+				this->static_message_map = &StaticWindow::message_map;
+			}
+
+			/**
+			 * Handles a message as this window's class does.
+			 */
+			LRESULT callDefaultMessageHandler(UINT message,WPARAM w_param,LPARAM l_param)
+			{
+				return this->window_class->getDefaultMessageHandler(message)(this,w_param,l_param);
+			}
+
+		public:
+			LRESULT onChar(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_CHAR,w_param,l_param);
+			}
+
+			LRESULT onClose(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_CLOSE,w_param,l_param);
+			}
+
+			LRESULT onCommand(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_COMMAND,w_param,l_param);
+			}
+
+			LRESULT onCreate(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_CREATE,w_param,l_param);
+			}
+
+			LRESULT onDestroy(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_DESTROY,w_param,l_param);
+			}
+
+			LRESULT onEraseBackground(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_ERASEBKGND,w_param,l_param);
+			}
+
+			LRESULT onKeyDown(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_KEYDOWN,w_param,l_param);
+			}
+
+			LRESULT onKeyUp(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_KEYUP,w_param,l_param);
+			}
+
+			LRESULT onLeftButtonDown(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_LBUTTONDOWN,w_param,l_param);
+			}
+
+			LRESULT onLeftButtonUp(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_LBUTTONUP,w_param,l_param);
+			}
+
+			LRESULT onMouseMove(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_MOUSEMOVE,w_param,l_param);
+			}
+
+			LRESULT onPaint(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_PAINT,w_param,l_param);
+			}
+
+			LRESULT onSize(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_SIZE,w_param,l_param);
+			}
+
+			LRESULT onTimer(WPARAM w_param,LPARAM l_param)
+			{
+				return this->callDefaultMessageHandler(WM_TIMER,w_param,l_param);
+			}
+	};
+
+	template<typename Derived>
+	const StaticMessageMap StaticWindow<Derived>::message_map = {&StaticWindow<Derived>::Dispatch,&StaticWindow<Derived>::Handles};
+
+	/**
+	 * A class of windows described by a UIClass resource: the native window class its windows are created from, the defaults of its prototype, the lifecycle handlers called for its windows and the capabilities it declares.  A class may extend another UIClass, or a native window class, through <Extends>.  Inheritance is resolved once, when the class is loaded, into a flattened copy of everything the class inherits: prototype attributes and capabilities are overridden by those of the class, and its handlers are called after those it inherits.  Instantiating a window therefore never walks the chain.
+	 */
+	class UIClass
+	{
+		public:
+			/**
+			 * Gets a loaded class.
+			 *
+			 * @return Returns nullptr if no class of the given name has been loaded.
+			 */
+			static UIClass* GetByName(const wchar* name);
+
+			static UIClass* GetByName(const std::wstring& name);
+
+			/**
+			 * Loads a class from an XML resource of the given module, resolving the names of its handlers to procedures exported by that module.  A class extending another UIClass must be loaded after it.  Safe to call from any thread.
+			 *
+			 * @return Returns the class already loaded under the same name, if any.
+			 *
+			 * @throw
+			 *   OS::RuntimeException
+			 *     Thrown if the resource does not exist or is not a UIClass definition, if the class extends one which is neither a loaded UIClass nor a native window class, or if one of its handlers is for an unknown event or does not exist within the module.
+			 */
+			static UIClass* Load(Module& module,WORD resource_id);
+
+			/**
+			 * Forgets a class.  Windows instantiated from it must have been destroyed, and classes extending it are unaffected.
+			 */
+			static void Unload(UIClass*& ui_class);
+
+		private:
+			enum Event
+			{
+				ON_CLICK,
+				ON_CLOSE,
+				ON_CREATE,
+				ON_DESTROY,
+				EVENTS
+			};
+
+			enum PrototypeField
+			{
+				TITLE = 0x1,
+				X = 0x2,
+				Y = 0x4,
+				WIDTH = 0x8,
+				HEIGHT = 0x10
+			};
+
+		private:
+			std::map<std::wstring,std::wstring> capabilities;
+			struct
+			{
+				std::wstring title;
+				int x;
+				int y;
+				int width;
+				int height;
+				unsigned fields;  //UIClass::PrototypeField flags of those set by the prototype.
+			} defaults;  //Parsed out of the prototype's attributes when the class is loaded.
+			std::vector<WindowCallback> handlers[EVENTS];
+			Module module;
+			std::wstring name;
+			std::map<std::wstring,std::wstring> prototype;
+			std::wstring window_class_name;
+
+		private:
+			UIClass(const Module& module);
+
+			/**
+			 * Resolves a handler and adds it to those called for an event, after any inherited ones.
+			 */
+			void addHandler(const std::wstring& event,const std::wstring& procedure_name);
+
+			/**
+			 * Gets the title of this class's prototype, or an empty one if it sets none.
+			 */
+			const wchar* getTitle() const;
+
+			/**
+			 * @throw
+			 *   OS::RuntimeException
+			 *     Thrown if the native window class does not exist.
+			 */
+			WindowClass* getWindowClass();
+
+			/**
+			 * Applies this class's prototype and handlers to a window of its native window class, realizes it unless told otherwise and calls its OnCreate handlers.
+			 */
+			void prepare(Window* window,bool defer_realization);
+
+			void setPrototypeAttribute(const std::wstring& attribute,const std::wstring& value);
+
+		public:
+			/**
+			 * Gets a capability declared by this class or one it extends.
+			 *
+			 * @return Returns fallback if the capability is not declared.
+			 */
+			std::wstring getCapability(const std::wstring& capability,const std::wstring& fallback = std::wstring()) const;
+
+			const std::wstring& getName() const;
+
+			/**
+			 * Gets an attribute of this class's prototype, as set by this class or one it extends.
+			 *
+			 * @return Returns fallback if the attribute is not set.
+			 */
+			std::wstring getPrototypeAttribute(const std::wstring& attribute,const std::wstring& fallback = std::wstring()) const;
+
+			/**
+			 * Gets the name of the native window class at the root of this class's inheritance.
+			 */
+			const std::wstring& getWindowClassName() const;
+
+			/**
+			 * Tells whether a capability is declared as "true" by this class or one it extends.
+			 */
+			bool hasCapability(const std::wstring& capability) const;
+
+			/**
+			 * Creates a window of this class's native window class with this class's prototype applied.  The OnCreate handlers are called once the window has been created (or, if its realization is deferred, once it has been instantiated); OnClick, OnClose and OnDestroy handlers are called when it is released by the left mouse button, asked to close and destroyed.  This class must not be unloaded while the window exists.
+			 *
+			 * @throw
+			 *   OS::RuntimeException
+			 *     Thrown if the native window class does not exist.
+			 */
+			Window* instantiate(bool defer_realization = false);
+
+			/**
+			 * Creates a window of this class as an object of a type derived from OS::StaticWindow, as OS::WindowClass::instantiate<Derived> does.  Its static handlers are called before the handlers of this class for the same message, which extend them.
+			 *
+			 * @throw
+			 *   OS::RuntimeException
+			 *     Thrown if the native window class does not exist.
+			 *
+			 * @see OS::StaticWindow
+			 */
+			template<typename Derived>
+			Derived* instantiate(bool defer_realization = false)
+			{
+				Derived* window = this->getWindowClass()->instantiate<Derived>(this->getTitle(),true);
+
+
+				this->prepare(window,defer_realization);
+
+				return window;
+			}
+	};
 }
 
 #endif
\ No newline at end of file
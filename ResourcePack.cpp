@@ -0,0 +1,361 @@
+#include "ResourcePack.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+namespace
+{
+	struct Header
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t entry_count;
+		std::uint32_t directory_offset;
+		std::uint32_t displacements_offset;
+		std::uint32_t slots_offset;
+		std::uint32_t names_offset;
+		std::uint32_t names_size;
+	};
+
+	struct DirectoryEntry
+	{
+		std::uint32_t type_offset;  //Relative to the names.
+		std::uint32_t name_offset;
+		std::uint32_t data_offset;  //Relative to the start of the pack.
+		std::uint32_t data_size;
+		std::uint32_t original_size;
+		std::uint16_t language;
+		std::uint16_t flags;
+	};
+
+	/* Constants */
+	const std::uint16_t ENTRY_COMPRESSED = 0x1;
+	const std::uint16_t NEUTRAL_LANGUAGE = 0;  //MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL)
+	const std::uint32_t VERSION = 2;
+
+	int CompareName(const char16_t* stored,const std::u16string& name)  //Compares UTF-16 code units, as the directory was sorted.
+	{
+		size_t index = 0;
+
+
+		for(;index < name.size() && stored[index] == name[index];++index)
+		{
+		}
+
+		if(index == name.size())
+		{
+			return stored[index] == 0 ? 0 : 1;
+		}
+
+		return stored[index] < name[index] ? -1 : 1;
+	}
+
+	std::u16string GetIdentifier(const wchar_t* identifier)  //Integer identifiers are written as "#<id>"; names are converted to UTF-16 where wchar_t is wider.
+	{
+		std::u16string converted;
+
+
+		if(((std::uintptr_t)identifier >> 16) == 0)  //IS_INTRESOURCE
+		{
+			for(char digit : "#" + std::to_string((unsigned long long)(std::uintptr_t)identifier))
+			{
+				converted.push_back((char16_t)digit);
+			}
+
+			return converted;
+		}
+
+		for(;*identifier != 0;++identifier)
+		{
+			std::uint32_t code_point = (std::uint32_t)*identifier;
+
+
+			if(code_point > 0xFFFF)
+			{
+				code_point -= 0x10000;
+				converted.push_back((char16_t)(0xD800 + (code_point >> 10)));
+				converted.push_back((char16_t)(0xDC00 + (code_point & 0x3FF)));
+			}
+			else
+			{
+				converted.push_back((char16_t)code_point);
+			}
+		}
+
+		return converted;
+	}
+
+	std::uint32_t HashKey(const std::u16string& type,const std::u16string& name,std::uint16_t language,std::uint32_t seed)  //32-bit FNV-1a; must match Tools/PackResources.py.
+	{
+		std::uint32_t hash = 2166136261u ^ seed;
+		auto hash_byte = [&hash](std::uint8_t value){
+			hash = (hash ^ value) * 16777619u;
+		};
+		auto hash_string = [&hash_byte](const std::u16string& string){
+			for(char16_t unit : string)
+			{
+				hash_byte((std::uint8_t)(unit & 0xFF));
+				hash_byte((std::uint8_t)(unit >> 8));
+			}
+			hash_byte(0);
+			hash_byte(0);
+		};
+
+
+		hash_string(type);
+		hash_string(name);
+		hash_byte((std::uint8_t)(language & 0xFF));
+		hash_byte((std::uint8_t)(language >> 8));
+
+		return hash;
+	}
+}
+
+namespace OS
+{
+	/* Type [OS::ResourcePack] Definition */
+	ResourcePack::ResourcePack(const wchar_t* path)
+	: view(nullptr),size(0),mapped(false)
+	{
+		assert(path != nullptr);
+
+
+#if defined(_WIN32)
+		HANDLE file = CreateFile(path,GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+		HANDLE mapping = nullptr;
+		LARGE_INTEGER file_size;
+
+
+		if(file == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error("Failed to open resource pack.");
+		}
+
+		if(GetFileSizeEx(file,&file_size) && file_size.QuadPart >= (LONGLONG)sizeof(Header))
+		{
+			this->size = (size_t)file_size.QuadPart;
+			mapping = CreateFileMapping(file,nullptr,PAGE_READONLY,0,0,nullptr);
+		}
+		if(mapping != nullptr)
+		{
+			this->view = (const std::uint8_t*)MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+			CloseHandle(mapping);  //The view keeps the mapping alive.
+		}
+		CloseHandle(file);
+#else
+		std::string narrow_path;
+		int file;
+		struct stat status;
+
+
+		for(;*path != 0;++path)  //UTF-8, as POSIX file names are bytes.
+		{
+			std::uint32_t code_point = (std::uint32_t)*path;
+
+
+			if(code_point < 0x80)
+			{
+				narrow_path.push_back((char)code_point);
+			}
+			else if(code_point < 0x800)
+			{
+				narrow_path.push_back((char)(0xC0 | (code_point >> 6)));
+				narrow_path.push_back((char)(0x80 | (code_point & 0x3F)));
+			}
+			else if(code_point < 0x10000)
+			{
+				narrow_path.push_back((char)(0xE0 | (code_point >> 12)));
+				narrow_path.push_back((char)(0x80 | ((code_point >> 6) & 0x3F)));
+				narrow_path.push_back((char)(0x80 | (code_point & 0x3F)));
+			}
+			else
+			{
+				narrow_path.push_back((char)(0xF0 | (code_point >> 18)));
+				narrow_path.push_back((char)(0x80 | ((code_point >> 12) & 0x3F)));
+				narrow_path.push_back((char)(0x80 | ((code_point >> 6) & 0x3F)));
+				narrow_path.push_back((char)(0x80 | (code_point & 0x3F)));
+			}
+		}
+
+		file = open(narrow_path.c_str(),O_RDONLY);
+		if(file == -1)
+		{
+			throw std::runtime_error("Failed to open resource pack.");
+		}
+
+		if(fstat(file,&status) == 0 && status.st_size >= (off_t)sizeof(Header))
+		{
+			void* view = mmap(nullptr,(size_t)status.st_size,PROT_READ,MAP_SHARED,file,0);
+
+
+			if(view != MAP_FAILED)
+			{
+				this->view = (const std::uint8_t*)view;
+				this->size = (size_t)status.st_size;
+			}
+		}
+		close(file);  //The mapping keeps the file open.
+#endif
+
+		if(this->view == nullptr)
+		{
+			throw std::runtime_error("Failed to map resource pack.");
+		}
+		this->mapped = true;
+
+		this->validate();
+	}
+
+	ResourcePack::ResourcePack(const std::wstring& path)
+	: ResourcePack(path.c_str())
+	{
+	}
+
+	ResourcePack::ResourcePack(const void* data,size_t size)
+	: view((const std::uint8_t*)data),size(size),mapped(false)
+	{
+		assert(data != nullptr || size == 0);
+		assert(((std::uintptr_t)data & 3) == 0);
+
+
+		this->validate();
+	}
+
+	ResourcePack::~ResourcePack()
+	{
+		this->unmap();
+	}
+
+	bool ResourcePack::findResource(const wchar_t* resource_type,const wchar_t* resource_name,std::uint16_t language,Entry& entry) const
+	{
+		assert(resource_type != nullptr);
+		assert(resource_name != nullptr);
+
+
+		const Header* header = (const Header*)this->view;
+		const DirectoryEntry* directory = (const DirectoryEntry*)(this->view + header->directory_offset);
+		const std::uint32_t* displacements = (const std::uint32_t*)(this->view + header->displacements_offset);
+		const std::uint32_t* slots = (const std::uint32_t*)(this->view + header->slots_offset);
+		const char16_t* names = (const char16_t*)(this->view + header->names_offset);
+		std::u16string type = GetIdentifier(resource_type);
+		std::u16string name = GetIdentifier(resource_name);
+		const DirectoryEntry* found = nullptr;
+		auto compare = [&](const DirectoryEntry& entry){  //Orders entries by type and name only, as the directory is sorted.
+			int order = CompareName(names + entry.type_offset / sizeof(char16_t),type);
+
+
+			return order != 0 ? order : CompareName(names + entry.name_offset / sizeof(char16_t),name);
+		};
+
+
+		if(header->entry_count == 0)
+		{
+			return false;
+		}
+
+		{
+			std::uint32_t displacement = displacements[HashKey(type,name,language,0) % header->entry_count];
+			std::uint32_t slot = slots[HashKey(type,name,language,displacement) % header->entry_count];
+
+
+			if(slot < header->entry_count && directory[slot].language == language && compare(directory[slot]) == 0)
+			{
+				found = &directory[slot];
+			}
+		}
+
+		if(found == nullptr && language == NEUTRAL_LANGUAGE)
+		{
+			const DirectoryEntry* first = std::lower_bound(directory,directory + header->entry_count,0,[&compare](const DirectoryEntry& entry,int){
+				return compare(entry) < 0;
+			});
+
+
+			if(first != directory + header->entry_count && compare(*first) == 0)
+			{
+				found = first;
+			}
+		}
+
+		if(found == nullptr || found->data_offset + (size_t)found->data_size > this->size)
+		{
+			return false;
+		}
+
+		entry.data = this->view + found->data_offset;
+		entry.size = found->data_size;
+		entry.original_size = found->original_size;
+		entry.compressed = (found->flags & ENTRY_COMPRESSED) != 0;
+
+		return true;
+	}
+
+	size_t ResourcePack::getResourceCount() const
+	{
+		return ((const Header*)this->view)->entry_count;
+	}
+
+	void ResourcePack::unmap()
+	{
+		if(this->view != nullptr && this->mapped)
+		{
+#if defined(_WIN32)
+			UnmapViewOfFile(this->view);
+#else
+			munmap((void*)this->view,this->size);
+#endif
+		}
+		this->view = nullptr;
+		this->mapped = false;
+	}
+
+	void ResourcePack::validate()  //Checks every table lies within the pack and every name is terminated within the names, so that lookups can't read past the end.
+	{
+		const Header* header = (const Header*)this->view;
+		const DirectoryEntry* directory;
+		const char16_t* names;
+		size_t name_count;
+
+
+		if(this->size < sizeof(Header)
+			|| std::memcmp(header->magic,"RPAK",4) != 0
+			|| header->version != VERSION
+			|| header->directory_offset + (size_t)header->entry_count * sizeof(DirectoryEntry) > this->size
+			|| header->displacements_offset + (size_t)header->entry_count * sizeof(std::uint32_t) > this->size
+			|| header->slots_offset + (size_t)header->entry_count * sizeof(std::uint32_t) > this->size
+			|| header->names_offset + (size_t)header->names_size > this->size
+			|| header->names_size % sizeof(char16_t) != 0)
+		{
+			this->unmap();
+
+			throw std::runtime_error("The file is not a valid resource pack.");
+		}
+
+		directory = (const DirectoryEntry*)(this->view + header->directory_offset);
+		names = (const char16_t*)(this->view + header->names_offset);
+		name_count = header->names_size / sizeof(char16_t);
+		for(std::uint32_t index = 0;index < header->entry_count;++index)
+		{
+			if(directory[index].type_offset / sizeof(char16_t) >= name_count
+				|| directory[index].name_offset / sizeof(char16_t) >= name_count
+				|| names[name_count - 1] != 0)
+			{
+				this->unmap();
+
+				throw std::runtime_error("The file is not a valid resource pack.");
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef RESOURCEPACK_H
+#define RESOURCEPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+namespace OS
+{
+	/* Class Prototypes */
+	/**
+	 * Read-only, memory-mapped archive of resources produced by Tools/PackResources.py, which lets resources be replaced without relinking the module.  Resources may be stored compressed (see Compression.h).  Resources are looked up by type, name and language through a minimal perfect hash; names and types which are integers are written as "#<id>".  Every view returned points directly into the mapped file and remains valid for the lifetime of the pack.  Packs are little-endian, and are mapped with MapViewOfFile on Windows and mmap elsewhere.
+	 *
+	 * @see OS::Module::attachResourcePack
+	 */
+	class ResourcePack
+	{
+		public:
+			struct Entry
+			{
+				const void* data;  //As stored in the pack.
+				std::uint32_t size;
+				std::uint32_t original_size;
+				bool compressed;
+			};
+
+		private:
+			const std::uint8_t* view;
+			size_t size;
+			bool mapped;  //False if the pack was given in memory, and so isn't unmapped.
+
+		private:
+			ResourcePack(const ResourcePack&) = delete;
+
+			ResourcePack& operator=(const ResourcePack&) = delete;
+
+			void unmap();
+
+			void validate();
+
+		public:
+			/**
+			 * Opens and maps a resource pack.
+			 *
+			 * @throw
+			 *   std::runtime_error
+			 *     Thrown if the file could not be mapped or is not a valid resource pack.
+			 */
+			ResourcePack(const wchar_t* path);
+
+			ResourcePack(const std::wstring& path);
+
+			/**
+			 * Uses a resource pack which is already in memory, such as one embedded in another resource.  The data must be 4-byte aligned and outlive the pack.
+			 *
+			 * @throw
+			 *   std::runtime_error
+			 *     Thrown if the data is not a valid resource pack.
+			 */
+			ResourcePack(const void* data,size_t size);
+
+			~ResourcePack();
+
+			/**
+			 * Looks up a resource.  If no resource matches a neutral language exactly, the first resource with the same type and name is used instead, similarly to FindResourceEx.
+			 *
+			 * @param
+			 *   resource_type
+			 *     Name or MAKEINTRESOURCE identifier of the resource's type.
+			 *   resource_name
+			 *     Name or MAKEINTRESOURCE identifier of the resource.
+			 *   entry
+			 *     Receives the resource's data as stored, which may be compressed.
+			 *
+			 * @return Returns false if the pack does not contain the resource.
+			 */
+			bool findResource(const wchar_t* resource_type,const wchar_t* resource_name,std::uint16_t language,Entry& entry) const;
+
+			size_t getResourceCount() const;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,8 +1,6 @@
 #define Application_Title 0x1
 
 #define Application_UIClass_Button_Name 0x2
-#define Application_UIClass_Window_Name 0x3
-#define Application_UIClass_Window_OnClose 0x4
 
 #define Application_MadButton_Class 0x5
 #define Application_MadButton_OnClick 0x6
@@ -12,3 +10,5 @@
 #define Application_MainWindow_OnCreate 0xA
 
 #define Application_Config 0xB
+#define Application_UIClass_PushButton 0xC
+#define Application_UIClass_Window 0xD
@@ -0,0 +1,316 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <Windows.h>
+
+
+namespace OS
+{
+	/* Class Prototypes */
+	/**
+	 * Uniform grid over the rectangles of a set of items (typically the children of one window), used to answer hit tests without walking every item.  Each item also carries a z-order so that overlapping items are reported top-most first for point queries and bottom-most first for rectangle queries.  Items whose rectangle spans more than a handful of cells are kept in a separate list rather than being stamped into every cell they cover.
+	 */
+	template<typename Item>
+	class SpatialIndex
+	{
+		private:
+			struct Entry
+			{
+				RECT rectangle;
+				long long z_order;
+				bool oversized;
+			};
+
+			static const int MAXIMUM_CELLS_PER_ITEM = 64;
+
+		private:
+			int cell_size;
+			std::unordered_map<long long,std::vector<Item>> cells;
+			std::unordered_map<Item,Entry> entries;
+			std::vector<Item> oversized_items;
+			long long z_order_bottom;
+			long long z_order_top;
+
+		private:
+			static long long GetCellKey(long long column,long long row)
+			{
+				return (long long)(((unsigned long long)row << 32) ^ ((unsigned long long)column & 0xFFFFFFFF));
+			}
+
+			long long getCell(LONG coordinate) const
+			{
+				return coordinate >= 0 ? coordinate / this->cell_size : -((-(long long)coordinate + this->cell_size - 1) / this->cell_size);
+			}
+
+			template<typename Visitor>
+			void forEachCell(const RECT& rectangle,Visitor visit) const
+			{
+				if(rectangle.right <= rectangle.left || rectangle.bottom <= rectangle.top)
+				{
+					return;
+				}
+
+				for(long long row = this->getCell(rectangle.top);row <= this->getCell(rectangle.bottom - 1);++row)
+				{
+					for(long long column = this->getCell(rectangle.left);column <= this->getCell(rectangle.right - 1);++column)
+					{
+						visit(SpatialIndex::GetCellKey(column,row));
+					}
+				}
+			}
+
+			bool isOversized(const RECT& rectangle) const
+			{
+				if(rectangle.right <= rectangle.left || rectangle.bottom <= rectangle.top)
+				{
+					return false;
+				}
+
+				return (this->getCell(rectangle.right - 1) - this->getCell(rectangle.left) + 1) * (this->getCell(rectangle.bottom - 1) - this->getCell(rectangle.top) + 1) > MAXIMUM_CELLS_PER_ITEM;
+			}
+
+			void link(Item item,Entry& entry)
+			{
+				entry.oversized = this->isOversized(entry.rectangle);
+				if(entry.oversized)
+				{
+					this->oversized_items.push_back(item);
+				}
+				else
+				{
+					this->forEachCell(entry.rectangle,[this,item](long long key){
+						this->cells[key].push_back(item);
+					});
+				}
+			}
+
+			void unlink(Item item,const Entry& entry)
+			{
+				if(entry.oversized)
+				{
+					this->oversized_items.erase(std::find(this->oversized_items.begin(),this->oversized_items.end(),item));
+				}
+				else
+				{
+					this->forEachCell(entry.rectangle,[this,item](long long key){
+						std::vector<Item>& cell = this->cells[key];
+
+
+						cell.erase(std::find(cell.begin(),cell.end(),item));
+						if(cell.empty())
+						{
+							this->cells.erase(key);
+						}
+					});
+				}
+			}
+
+		public:
+			SpatialIndex(int cell_size = 64)
+			{
+				assert(cell_size > 0);
+
+
+				this->cell_size = cell_size;
+				this->z_order_bottom = 0;
+				this->z_order_top = 0;
+			}
+
+			bool contains(Item item) const
+			{
+				return this->entries.count(item) > 0;
+			}
+
+			/**
+			 * Adds an item to the index, placing it on top of all other items.  If the item is already indexed, its rectangle is updated and it is raised.
+			 */
+			void insert(Item item,const RECT& rectangle)
+			{
+				this->update(item,rectangle);
+				this->raise(item);
+			}
+
+			void lower(Item item)
+			{
+				assert(this->contains(item));
+
+
+				this->entries[item].z_order = --this->z_order_bottom;
+			}
+
+			/**
+			 * Gets the top-most item whose rectangle contains the point (x,y) and which satisfies the given filter.
+			 *
+			 * @return Returns the item found, or a value-initialized Item if there is none.
+			 */
+			template<typename Filter>
+			Item queryPoint(LONG x,LONG y,Filter filter) const
+			{
+				POINT point = {x,y};
+				RECT cell_rectangle = {x,y,x + 1,y + 1};
+				Item found = Item();
+				long long found_z_order = 0;
+				auto consider = [&](Item item){
+					const Entry& entry = this->entries.at(item);
+
+
+					if((found == Item() || entry.z_order > found_z_order) && PtInRect(&entry.rectangle,point) && filter(item))
+					{
+						found = item;
+						found_z_order = entry.z_order;
+					}
+				};
+
+
+				this->forEachCell(cell_rectangle,[&](long long key){
+					auto cell = this->cells.find(key);
+
+
+					if(cell != this->cells.end())
+					{
+						for(Item item : cell->second)
+						{
+							consider(item);
+						}
+					}
+				});
+
+				for(Item item : this->oversized_items)
+				{
+					consider(item);
+				}
+
+				return found;
+			}
+
+			/**
+			 * Gets every item whose rectangle intersects the given rectangle and which satisfies the given filter, ordered bottom-most first.
+			 */
+			template<typename Filter>
+			std::vector<Item> queryRectangle(const RECT& rectangle,Filter filter) const
+			{
+				std::vector<std::pair<long long,Item>> candidates;
+				std::vector<Item> found;
+				auto consider = [&](Item item){
+					const Entry& entry = this->entries.at(item);
+					RECT intersection;
+
+
+					if(IntersectRect(&intersection,&entry.rectangle,&rectangle))
+					{
+						candidates.push_back(std::make_pair(entry.z_order,item));
+					}
+				};
+
+
+				this->forEachCell(rectangle,[&](long long key){
+					auto cell = this->cells.find(key);
+
+
+					if(cell != this->cells.end())
+					{
+						for(Item item : cell->second)
+						{
+							consider(item);
+						}
+					}
+				});
+
+				for(Item item : this->oversized_items)
+				{
+					consider(item);
+				}
+
+				std::sort(candidates.begin(),candidates.end());
+				candidates.erase(std::unique(candidates.begin(),candidates.end()),candidates.end());  //Items spanning several cells are seen once per cell.
+				for(auto& candidate : candidates)
+				{
+					if(filter(candidate.second))
+					{
+						found.push_back(candidate.second);
+					}
+				}
+
+				return found;
+			}
+
+			void raise(Item item)
+			{
+				assert(this->contains(item));
+
+
+				this->entries[item].z_order = ++this->z_order_top;
+			}
+
+			void remove(Item item)
+			{
+				auto entry = this->entries.find(item);
+
+
+				if(entry != this->entries.end())
+				{
+					this->unlink(item,entry->second);
+					this->entries.erase(entry);
+				}
+			}
+
+			/**
+			 * Assigns z-orders to the given items, ordered top-most first.  Items which are not indexed are ignored.
+			 */
+			void setZOrder(const std::vector<Item>& items_top_to_bottom)
+			{
+				long long z_order = (long long)items_top_to_bottom.size();
+
+
+				this->z_order_bottom = 0;
+				this->z_order_top = z_order;
+				for(Item item : items_top_to_bottom)
+				{
+					auto entry = this->entries.find(item);
+
+
+					if(entry != this->entries.end())
+					{
+						entry->second.z_order = z_order--;
+					}
+				}
+			}
+
+			size_t size() const
+			{
+				return this->entries.size();
+			}
+
+			/**
+			 * Changes the rectangle of an item while preserving its z-order.  If the item is not yet indexed it is added below all other items.
+			 */
+			void update(Item item,const RECT& rectangle)
+			{
+				auto existing = this->entries.find(item);
+
+
+				if(existing == this->entries.end())
+				{
+					Entry& entry = this->entries[item];
+
+
+					entry.rectangle = rectangle;
+					entry.z_order = --this->z_order_bottom;
+					this->link(item,entry);
+				}
+				else if(!EqualRect(&existing->second.rectangle,&rectangle))
+				{
+					this->unlink(item,existing->second);
+					existing->second.rectangle = rectangle;
+					this->link(item,existing->second);
+				}
+			}
+	};
+}
+
+#endif
\ No newline at end of file
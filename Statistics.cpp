@@ -0,0 +1,132 @@
+#include "Statistics.h"
+
+
+namespace Statistics
+{
+	/* Function Definitions */
+	int GetBucket(std::uint64_t value)
+	{
+		int exponent = 0;
+
+
+		if(value < (std::uint64_t)SUB_BUCKETS)
+		{
+			return (int)value;
+		}
+
+		if(value >> VALUE_BITS != 0)
+		{
+			return BUCKETS - 1;
+		}
+
+		for(std::uint64_t remaining = value >> SUB_BUCKET_BITS;remaining != 0;remaining >>= 1)
+		{
+			++exponent;
+		}
+
+		return exponent * SUB_BUCKETS + (int)((value >> (exponent - 1)) & (SUB_BUCKETS - 1));
+	}
+
+	std::uint64_t GetBucketLowerBound(int bucket)
+	{
+		int exponent = bucket / SUB_BUCKETS;
+
+
+		if(exponent == 0)
+		{
+			return (std::uint64_t)bucket;
+		}
+
+		return (std::uint64_t)(SUB_BUCKETS + bucket % SUB_BUCKETS) << (exponent - 1);
+	}
+
+	/* Type [Statistics::Distribution] Definition */
+	Distribution::Distribution()
+	: buckets(),count(0),maximum(0),total(0)
+	{
+	}
+
+	double Distribution::getMean() const
+	{
+		return this->count == 0 ? 0.0 : (double)this->total / this->count;
+	}
+
+	std::uint64_t Distribution::getPercentile(double fraction) const
+	{
+		std::uint64_t rank = (std::uint64_t)(fraction * this->count + 0.5);
+		std::uint64_t seen = 0;
+
+
+		if(this->count == 0)
+		{
+			return 0;
+		}
+
+		if(rank == 0)
+		{
+			rank = 1;
+		}
+
+		for(int bucket = 0;bucket < BUCKETS - 1;++bucket)
+		{
+			seen += this->buckets[bucket];
+			if(seen >= rank)
+			{
+				std::uint64_t upper_bound = GetBucketLowerBound(bucket + 1) - 1;
+
+
+				return upper_bound < this->maximum ? upper_bound : this->maximum;
+			}
+		}
+
+		return this->maximum;
+	}
+
+	/* Type [Statistics::Histogram] Definition */
+	Histogram::Histogram()
+	{
+		this->reset();
+	}
+
+	void Histogram::addTo(Distribution& distribution) const
+	{
+		std::uint64_t maximum = this->maximum.load(std::memory_order_relaxed);
+
+
+		for(int bucket = 0;bucket < BUCKETS;++bucket)
+		{
+			distribution.buckets[bucket] += this->buckets[bucket].load(std::memory_order_relaxed);
+		}
+		distribution.count += this->count.load(std::memory_order_relaxed);
+		distribution.total += this->total.load(std::memory_order_relaxed);
+		if(maximum > distribution.maximum)
+		{
+			distribution.maximum = maximum;
+		}
+	}
+
+	void Histogram::record(std::uint64_t value)
+	{
+		std::atomic<std::uint32_t>& bucket = this->buckets[GetBucket(value)];
+
+
+		bucket.store(bucket.load(std::memory_order_relaxed) + 1,std::memory_order_relaxed);  //A single writer needs no read-modify-write.
+		this->count.store(this->count.load(std::memory_order_relaxed) + 1,std::memory_order_relaxed);
+		this->total.store(this->total.load(std::memory_order_relaxed) + value,std::memory_order_relaxed);
+		if(value > this->maximum.load(std::memory_order_relaxed))
+		{
+			this->maximum.store(value,std::memory_order_relaxed);
+		}
+	}
+
+	void Histogram::reset()
+	{
+		for(int bucket = 0;bucket < BUCKETS;++bucket)
+		{
+			this->buckets[bucket].store(0,std::memory_order_relaxed);
+		}
+		this->count.store(0,std::memory_order_relaxed);
+		this->maximum.store(0,std::memory_order_relaxed);
+		this->total.store(0,std::memory_order_relaxed);
+	}
+}
\ No newline at end of file
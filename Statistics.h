@@ -0,0 +1,87 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <atomic>
+#include <cstdint>
+
+
+/**
+ * Log-linear ("HDR") histograms for latencies and other non-negative integer measurements.  Each power of two is split into SUB_BUCKETS buckets of equal width, so any value is known to within 1 / SUB_BUCKETS of itself while the whole range fits in a few hundred counters.
+ */
+namespace Statistics
+{
+	/* Constants */
+	const int SUB_BUCKET_BITS = 3;
+	const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	const int VALUE_BITS = 40;  //Larger values are counted in the last bucket.
+	const int BUCKETS = (VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	/* Function Prototypes */
+	int GetBucket(std::uint64_t value);
+
+	/**
+	 * Gets the smallest value counted in the given bucket.
+	 */
+	std::uint64_t GetBucketLowerBound(int bucket);
+
+	/* Class Prototypes */
+	/**
+	 * Non-atomic copy of one or more histograms, taken so they can be examined.
+	 */
+	struct Distribution
+	{
+		std::uint64_t buckets[BUCKETS];
+		std::uint64_t count;
+		std::uint64_t maximum;
+		std::uint64_t total;
+
+		Distribution();
+
+		double getMean() const;
+
+		/**
+		 * Gets the value below which the given fraction of the recorded values lie.  The result is the upper bound of the bucket containing that value, capped at the largest value recorded.
+		 *
+		 * @param
+		 *   fraction
+		 *     Between 0 and 1, such as 0.99 for the 99th percentile.
+		 */
+		std::uint64_t getPercentile(double fraction) const;
+	};
+
+	/**
+	 * Histogram which one thread records into while any other thread reads it, without locking.  Recording is a handful of relaxed loads and stores, as there is only ever one writer.
+	 */
+	class Histogram
+	{
+		private:
+			std::atomic<std::uint32_t> buckets[BUCKETS];
+			std::atomic<std::uint64_t> count;
+			std::atomic<std::uint64_t> maximum;
+			std::atomic<std::uint64_t> total;
+
+		public:
+			Histogram();
+
+			Histogram(const Histogram&) = delete;
+
+			Histogram& operator=(const Histogram&) = delete;
+
+			/**
+			 * Adds this histogram's counts to the given distribution.  Values recorded while this runs may or may not be included.
+			 */
+			void addTo(Distribution& distribution) const;
+
+			/**
+			 * Records one value.  Must only be called by the histogram's writing thread.
+			 */
+			void record(std::uint64_t value);
+
+			/**
+			 * Discards every recorded value.  Values recorded while this runs may survive it.
+			 */
+			void reset();
+	};
+}
+
+#endif
\ No newline at end of file
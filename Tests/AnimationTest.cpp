@@ -0,0 +1,158 @@
+#include "Animation.h"
+#include "Test.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using Animation::Easing;
+using Animation::Timeline;
+
+
+namespace
+{
+	struct Tween
+	{
+		float from;
+		float to;
+		double start;
+		double duration;
+		Easing easing;
+	};
+
+	/* Constants */
+	const double TOLERANCE = 1e-4;  //Relative to the distance a tween covers, allowing for single-precision arithmetic.
+
+	std::uint32_t random_state = 0x2545F491;
+
+	std::uint32_t Random()  //xorshift32, so that every run tests the same cases.
+	{
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+
+		return random_state;
+	}
+
+	double RandomReal(double low,double high)
+	{
+		return low + (high - low) * (Random() / 4294967296.0);
+	}
+
+	/**
+	 * Evaluates a tween directly from the definition of its easing curve.
+	 */
+	double Evaluate(const Tween& tween,double now)
+	{
+		double t = tween.duration > 0.0 ? (now - tween.start) / tween.duration : (now < tween.start ? 0.0 : 1.0);
+		double eased = 0.0;
+
+
+		t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+		switch(tween.easing)
+		{
+			case Easing::LINEAR:
+				eased = t;
+
+				break;
+
+			case Easing::EASE_IN:
+				eased = t * t * t;
+
+				break;
+
+			case Easing::EASE_OUT:
+				eased = 1.0 - (1.0 - t) * (1.0 - t) * (1.0 - t);
+
+				break;
+
+			case Easing::EASE_IN_OUT:
+				eased = t * t * (3.0 - 2.0 * t);
+
+				break;
+		}
+
+		return tween.from + (tween.to - tween.from) * eased;
+	}
+
+	bool Near(double actual,double expected,const Tween& tween)
+	{
+		return std::fabs(actual - expected) <= TOLERANCE * (std::fabs(tween.to - tween.from) + 1.0);
+	}
+
+	void TestEvaluate()
+	{
+		Timeline timeline;
+		std::vector<Tween> tweens;
+		Easing easings[] = {Easing::LINEAR,Easing::EASE_IN,Easing::EASE_OUT,Easing::EASE_IN_OUT};
+
+
+		for(int index = 0;index < 1000;++index)
+		{
+			Tween tween = {(float)RandomReal(-500,500),(float)RandomReal(-500,500),RandomReal(0,5000),index % 50 == 0 ? 0.0 : RandomReal(1,2000),easings[index % 4]};
+
+
+			tweens.push_back(tween);
+			TEST_CHECK(timeline.add(tween.from,tween.to,tween.start,tween.duration,tween.easing) == (size_t)index);
+			TEST_CHECK(timeline.getEnd(index) == tween.start + tween.duration);
+			TEST_CHECK(timeline.getValue(index) == tween.from);  //Holds its initial value until first evaluated.
+		}
+		TEST_CHECK(timeline.getCount() == tweens.size());
+
+		for(double now = -100.0;now < 7500.0;now += 37.5)
+		{
+			int mismatches = 0;
+
+
+			timeline.evaluate(now);
+			for(size_t index = 0;index < tweens.size();++index)
+			{
+				if(!Near(timeline.getValue(index),Evaluate(tweens[index],now),tweens[index]) && mismatches++ == 0)
+				{
+					std::fprintf(stderr,"At %g, tween %zu is %g rather than %g.\n",now,index,timeline.getValue(index),Evaluate(tweens[index],now));
+				}
+			}
+			TEST_CHECK(mismatches == 0);
+		}
+
+		timeline.evaluate(-1.0);  //Before every tween starts, and after every one ends.
+		for(size_t index = 0;index < tweens.size();++index)
+		{
+			TEST_CHECK(timeline.getValue(index) == tweens[index].from);
+		}
+		timeline.evaluate(1e6);
+		for(size_t index = 0;index < tweens.size();++index)
+		{
+			TEST_CHECK(Near(timeline.getValue(index),tweens[index].to,tweens[index]));
+		}
+	}
+
+	void TestRemove()
+	{
+		Timeline timeline;
+
+
+		timeline.add(0.0f,10.0f,0.0,10.0,Easing::LINEAR);
+		timeline.add(0.0f,20.0f,0.0,10.0,Easing::LINEAR);
+		timeline.add(0.0f,30.0f,0.0,10.0,Easing::LINEAR);
+
+		TEST_CHECK(timeline.remove(0) == 2);  //The last tween moves into the gap.
+		TEST_CHECK(timeline.getCount() == 2);
+		timeline.evaluate(5.0);
+		TEST_CHECK(timeline.getValue(0) == 15.0f && timeline.getValue(1) == 10.0f);
+
+		TEST_CHECK(timeline.remove(1) == 1);  //Removing the last tween moves nothing.
+		TEST_CHECK(timeline.remove(0) == 0);
+		TEST_CHECK(timeline.getCount() == 0);
+		timeline.evaluate(5.0);
+	}
+}
+
+int main()
+{
+	TestEvaluate();
+	TestRemove();
+
+	return Test::GetResult();
+}
\ No newline at end of file
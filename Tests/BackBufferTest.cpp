@@ -0,0 +1,114 @@
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+
+namespace
+{
+	/* Constants */
+	const int WINDOW_SIZE = 100;  //Of each window's client area, in pixels.
+	const size_t BUFFER_BYTES = (size_t)WINDOW_SIZE * WINDOW_SIZE * 4;
+
+	OS::Window* CreateBufferedWindow(OS::WindowClass* window_class)
+	{
+		OS::Window* window = window_class->instantiate(L"Buffered");
+
+
+		window->setDoubleBuffered(true);
+		window->show();
+		OS::FlushInvalidations();
+		UpdateWindow(window->getNativeHandle());  //Allocates its back buffer.
+
+		return window;
+	}
+
+	size_t Paint(OS::Window* window)  //Returns how many back buffers were allocated to paint it.
+	{
+		Headless::ResetCallCounts();
+		window->invalidate();
+		OS::FlushInvalidations();
+		UpdateWindow(window->getNativeHandle());
+
+		return Headless::GetCallCount("CreateCompatibleBitmap");
+	}
+
+	void TestEviction(OS::WindowClass* window_class)
+	{
+		OS::Window* first;
+		OS::Window* second;
+		OS::Window* third;
+
+
+		/* Within the budget, every window keeps its buffer. */
+		OS::SetBackBufferBudget(2 * BUFFER_BYTES);
+		first = CreateBufferedWindow(window_class);
+		second = CreateBufferedWindow(window_class);
+		TEST_CHECK(OS::GetBackBufferUsage() == 2 * BUFFER_BYTES);
+		TEST_CHECK(Paint(first) == 0 && Paint(second) == 0);
+
+		/* Beyond it, the least recently painted window gives its buffer up, and allocates another the next time it is painted. */
+		TEST_CHECK(Paint(first) == 0);
+		third = CreateBufferedWindow(window_class);
+		TEST_CHECK(OS::GetBackBufferUsage() == 2 * BUFFER_BYTES);
+		TEST_CHECK(Paint(first) == 0 && Paint(third) == 0);
+		TEST_CHECK(Paint(second) == 1);  //Evicting the first, which was painted before the third.
+		TEST_CHECK(Paint(third) == 0 && Paint(second) == 0);
+		TEST_CHECK(Paint(first) == 1);
+		TEST_CHECK(OS::GetBackBufferUsage() == 2 * BUFFER_BYTES);
+
+		/* A window keeps the buffer it allocates to paint with, however small the budget. */
+		OS::SetBackBufferBudget(0);
+		TEST_CHECK(Paint(first) == 0);  //Nothing is evicted until a buffer is allocated.
+		TEST_CHECK(Paint(third) == 1);
+		TEST_CHECK(OS::GetBackBufferUsage() == BUFFER_BYTES);
+
+		/* Destroying a window releases its buffer. */
+		third->destroy();
+		TEST_CHECK(OS::GetBackBufferUsage() == 0);
+		second->destroy();
+		first->destroy();
+	}
+
+	void TestGrowth(OS::WindowClass* window_class)
+	{
+		OS::Window* window;
+
+
+		/* A buffer is only reallocated when the client area grows beyond it, and then covers both sizes. */
+		OS::SetBackBufferBudget(16 * BUFFER_BYTES);
+		window = CreateBufferedWindow(window_class);
+		window->setDimensions(WINDOW_SIZE / 2,WINDOW_SIZE * 2);
+		TEST_CHECK(Paint(window) == 1);
+		TEST_CHECK(OS::GetBackBufferUsage() == 2 * BUFFER_BYTES);
+		window->setDimensions(WINDOW_SIZE,WINDOW_SIZE);
+		TEST_CHECK(Paint(window) == 0);
+		TEST_CHECK(OS::GetBackBufferUsage() == 2 * BUFFER_BYTES);
+
+		window->destroy();
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"BackBufferWindow");
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,WINDOW_SIZE,WINDOW_SIZE);
+	window_class->setDefaultMessageHandler(WM_PAINT,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+		PAINTSTRUCT paint_struct;
+
+
+		window->beginPaint(paint_struct);
+		window->endPaint(paint_struct);
+
+		return 0;
+	});
+
+	TestEviction(window_class);
+	TestGrowth(window_class);
+
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "Compression.h"
+#include "Test.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+typedef std::vector<std::uint8_t> Bytes;
+
+
+namespace
+{
+	std::uint32_t random_state = 0x9E3779B9;
+
+	std::uint32_t Random()  //xorshift32, so that every run tests the same cases.
+	{
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+
+		return random_state;
+	}
+
+	Bytes MakeRandom(size_t size)
+	{
+		Bytes data(size);
+
+
+		for(std::uint8_t& byte : data)
+		{
+			byte = (std::uint8_t)Random();
+		}
+
+		return data;
+	}
+
+	Bytes MakeText(size_t size)  //Repetitive, like the markup and strings the codec is used for.
+	{
+		const char* words[] = {"<Window ","name=\"","Button","\" x=\"12\" ","width=\"200\" ","/>\n","Label","text=\"Hello, world\" ","<Layout>","</Layout>\n"};
+		Bytes data;
+
+
+		while(data.size() < size)
+		{
+			const char* word = words[Random() % (sizeof(words) / sizeof(words[0]))];
+
+
+			data.insert(data.end(),word,word + std::char_traits<char>::length(word));
+		}
+		data.resize(size);
+
+		return data;
+	}
+
+	Bytes Decompress(const Bytes& block,size_t size,bool& succeeded)
+	{
+		Bytes data(size);
+
+
+		succeeded = Compression::Decompress(block.data(),block.size(),data.data(),data.size());
+
+		return data;
+	}
+
+	Bytes DecompressStream(const Bytes& block,bool& succeeded,size_t& largest_piece)
+	{
+		Bytes data;
+
+
+		largest_piece = 0;
+		succeeded = Compression::DecompressStream(block.data(),block.size(),[&](const std::uint8_t* piece,size_t size)
+		{
+			data.insert(data.end(),piece,piece + size);
+			largest_piece = size > largest_piece ? size : largest_piece;
+		});
+
+		return data;
+	}
+
+	void TestRoundTrip(const Bytes& data,const char* description)
+	{
+		Bytes block = Compression::Compress(data.data(),data.size());
+		bool succeeded;
+		size_t largest_piece;
+
+
+		if(!TEST_CHECK(Decompress(block,data.size(),succeeded) == data && succeeded))
+		{
+			std::fprintf(stderr,"Decompress failed for %s (%zu bytes).\n",description,data.size());
+		}
+		if(!TEST_CHECK(DecompressStream(block,succeeded,largest_piece) == data && succeeded && largest_piece <= 65536))
+		{
+			std::fprintf(stderr,"DecompressStream failed for %s (%zu bytes).\n",description,data.size());
+		}
+	}
+
+	void TestRoundTrips()
+	{
+		size_t sizes[] = {0,1,3,4,5,15,16,19,20,255,270,4096,65535,65536,65537,200000};
+
+
+		for(size_t size : sizes)
+		{
+			TestRoundTrip(MakeRandom(size),"random data");
+			TestRoundTrip(MakeText(size),"text");
+			TestRoundTrip(Bytes(size,'a'),"a run");  //Overlapping matches with long lengths.
+		}
+
+		Bytes distant = MakeRandom(70000);  //Repeats from just beyond the furthest offset a match may reach.
+
+
+		distant.insert(distant.end(),distant.begin(),distant.begin() + 1000);
+		TestRoundTrip(distant,"a distant repeat");
+
+		Bytes near = MakeRandom(65535);  //Repeats from exactly the furthest offset.
+
+
+		near.insert(near.end(),near.begin(),near.begin() + 1000);
+		TestRoundTrip(near,"a repeat at the furthest offset");
+		TEST_CHECK(Compression::Compress(near.data(),near.size()).size() < near.size());
+	}
+
+	void TestCompressionRatio()
+	{
+		Bytes text = MakeText(100000);
+		Bytes run(100000,'x');
+
+
+		TEST_CHECK(Compression::Compress(text.data(),text.size()).size() < text.size() / 3);
+		TEST_CHECK(Compression::Compress(run.data(),run.size()).size() < 500);
+	}
+
+	void TestCorruptBlocks()
+	{
+		Bytes data = MakeText(5000);
+		Bytes block = Compression::Compress(data.data(),data.size());
+		bool succeeded;
+		size_t largest_piece;
+
+
+		Decompress(block,data.size() - 1,succeeded);
+		TEST_CHECK(!succeeded);  //Too small a destination.
+		Decompress(block,data.size() + 1,succeeded);
+		TEST_CHECK(!succeeded);  //Too large a destination.
+
+		for(size_t size = 0;size < block.size();size += 7)  //Truncated blocks must be rejected rather than read past.
+		{
+			Bytes truncated(block.begin(),block.begin() + size);
+
+
+			Decompress(truncated,data.size(),succeeded);
+			TEST_CHECK(!succeeded);
+		}
+
+		Bytes zero_offset = {0x10,'a',0x00,0x00,0x00};
+		Bytes early_offset = {0x10,'a',0x02,0x00,0x00};
+
+
+		Decompress(zero_offset,5,succeeded);
+		TEST_CHECK(!succeeded);
+		DecompressStream(zero_offset,succeeded,largest_piece);
+		TEST_CHECK(!succeeded);
+		Decompress(early_offset,5,succeeded);
+		TEST_CHECK(!succeeded);
+		DecompressStream(early_offset,succeeded,largest_piece);
+		TEST_CHECK(!succeeded);
+
+		for(int trial = 0;trial < 2000;++trial)  //Random damage must never read or write out of bounds.
+		{
+			Bytes damaged = block;
+
+
+			for(int change = 0;change < 3;++change)
+			{
+				damaged[Random() % damaged.size()] = (std::uint8_t)Random();
+			}
+			Decompress(damaged,data.size(),succeeded);
+			DecompressStream(damaged,succeeded,largest_piece);
+		}
+	}
+}
+
+int main()
+{
+	TestRoundTrips();
+	TestCompressionRatio();
+	TestCorruptBlocks();
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "Control.h"
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+#include <vector>
+
+
+namespace
+{
+	/* Constants */
+	const UINT RECORDED_MESSAGES[] = {WM_LBUTTONDOWN,WM_LBUTTONUP,WM_MOUSEMOVE,WM_KEYDOWN,WM_CHAR,WM_SETFOCUS,WM_KILLFOCUS,WM_ENABLE,WM_SHOWWINDOW,WM_PAINT};
+
+	struct Delivery
+	{
+		OS::Control* control;
+		UINT message;
+		WPARAM w_param;
+		LPARAM l_param;
+	};
+
+	std::vector<Delivery> deliveries;
+	int host_clicks = 0;  //Which no control took.
+
+	OS::Control* CreateControl(OS::Window* host,const wchar_t* name,int x,int y)
+	{
+		OS::Control* control = host->createControl(name);
+
+
+		control->setPosition(x,y);
+		control->setDimensions(50,20);
+		for(UINT message : RECORDED_MESSAGES)
+		{
+			control->setMessageHandler(message,[message](OS::Control* control,WPARAM w_param,LPARAM l_param) -> LRESULT {
+				deliveries.push_back({control,message,w_param,l_param});
+
+				return 0;
+			});
+		}
+
+		return control;
+	}
+
+	bool Delivered(OS::Control* control,UINT message)
+	{
+		for(const Delivery& delivery : deliveries)
+		{
+			if(delivery.control == control && delivery.message == message)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void TestRouting(OS::Window* host,OS::Control* first,OS::Control* second,OS::Control* third)
+	{
+		/* Mouse messages go to the control under the cursor, relative to it, and a click focuses it. */
+		deliveries.clear();
+		SendMessage(host->getNativeHandle(),WM_LBUTTONDOWN,0,MAKELPARAM(12,35));
+		TEST_CHECK(deliveries.size() == 2);
+		TEST_CHECK(deliveries[0].control == second && deliveries[0].message == WM_SETFOCUS);
+		TEST_CHECK(deliveries[1].control == second && deliveries[1].message == WM_LBUTTONDOWN && deliveries[1].l_param == MAKELPARAM(2,5));
+		TEST_CHECK(second->hasFocus() && host->getFocusedControl() == second);
+
+		/* Clicking elsewhere is left to the host. */
+		deliveries.clear();
+		host_clicks = 0;
+		SendMessage(host->getNativeHandle(),WM_LBUTTONDOWN,0,MAKELPARAM(90,90));
+		TEST_CHECK(deliveries.empty() && host_clicks == 1);
+		TEST_CHECK(second->hasFocus());
+
+		/* Keyboard messages go to the focused control, and Tab moves the focus on. */
+		deliveries.clear();
+		SendMessage(host->getNativeHandle(),WM_CHAR,L'x',0);
+		TEST_CHECK(deliveries.size() == 1 && deliveries[0].control == second && deliveries[0].message == WM_CHAR && deliveries[0].w_param == L'x');
+		deliveries.clear();
+		SendMessage(host->getNativeHandle(),WM_KEYDOWN,VK_TAB,0);
+		TEST_CHECK(third->hasFocus() && !second->hasFocus());
+		TEST_CHECK(Delivered(second,WM_KILLFOCUS) && Delivered(third,WM_SETFOCUS) && !Delivered(third,WM_KEYDOWN));
+		SendMessage(host->getNativeHandle(),WM_KEYDOWN,VK_TAB,0);
+		TEST_CHECK(first->hasFocus());  //Round to the first again.
+	}
+
+	void TestEnabledAndVisible(OS::Window* host,OS::Control* first,OS::Control* second,OS::Control* third)
+	{
+		/* A disabled control loses the focus, is told so, and is passed over by the mouse and by Tab. */
+		first->setFocus();
+		deliveries.clear();
+		first->setEnabled(false);
+		TEST_CHECK(!first->isEnabled() && !first->hasFocus() && host->getFocusedControl() == nullptr);
+		TEST_CHECK(Delivered(first,WM_KILLFOCUS) && Delivered(first,WM_ENABLE));
+		TEST_CHECK(host->getControlByLocation(5,5) == first);
+		TEST_CHECK(host->getControlByLocation(5,5,CWP_SKIPDISABLED) == nullptr);
+		deliveries.clear();
+		SendMessage(host->getNativeHandle(),WM_LBUTTONDOWN,0,MAKELPARAM(5,5));
+		TEST_CHECK(deliveries.empty());
+
+		second->setFocus();
+		SendMessage(host->getNativeHandle(),WM_KEYDOWN,VK_TAB,0);
+		TEST_CHECK(third->hasFocus());
+		SendMessage(host->getNativeHandle(),WM_KEYDOWN,VK_TAB,0);
+		TEST_CHECK(second->hasFocus());  //The first is skipped on the way round.
+
+		/* So is a hidden control, and the control underneath it is found instead. */
+		deliveries.clear();
+		third->setVisible(false);
+		TEST_CHECK(!third->isVisible() && Delivered(third,WM_SHOWWINDOW));
+		TEST_CHECK(host->getControlByLocation(30,45) == third);
+		TEST_CHECK(host->getControlByLocation(30,45,CWP_SKIPINVISIBLE) == second);
+		deliveries.clear();
+		SendMessage(host->getNativeHandle(),WM_LBUTTONUP,0,MAKELPARAM(30,45));
+		TEST_CHECK(deliveries.size() == 1 && deliveries[0].control == second && deliveries[0].l_param == MAKELPARAM(20,15));
+		SendMessage(host->getNativeHandle(),WM_KEYDOWN,VK_TAB,0);
+		TEST_CHECK(second->hasFocus());  //Nothing else can take it.
+
+		first->setEnabled(true);
+		third->setVisible(true);
+	}
+
+	void TestPainting(OS::Window* host,OS::Control* first,OS::Control* second,OS::Control* third)
+	{
+		RECT area = {0,0,10,10};
+
+
+		/* Only the controls within the area repainted are painted, bottom-most first. */
+		host->show();
+		OS::FlushInvalidations();
+		UpdateWindow(host->getNativeHandle());
+		deliveries.clear();
+		host->invalidate(&area);
+		OS::FlushInvalidations();
+		UpdateWindow(host->getNativeHandle());
+		TEST_CHECK(deliveries.size() == 1 && deliveries[0].control == first && deliveries[0].message == WM_PAINT);
+
+		deliveries.clear();
+		host->invalidate();
+		OS::FlushInvalidations();
+		UpdateWindow(host->getNativeHandle());
+		TEST_CHECK(deliveries.size() == 3 && deliveries[1].control == second && deliveries[2].control == third);
+		TEST_CHECK(deliveries.size() == 3 && ((RECT*)deliveries[2].l_param)->left == 20);
+
+		deliveries.clear();
+		third->setVisible(false);
+		OS::FlushInvalidations();
+		UpdateWindow(host->getNativeHandle());
+		TEST_CHECK(!Delivered(third,WM_PAINT) && Delivered(second,WM_PAINT));  //What was underneath it.
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"ControlHost");
+	OS::Window* host;
+	OS::Control* first;
+	OS::Control* second;
+	OS::Control* third;
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,100,100);
+	host = window_class->instantiate(L"Host");
+	host->setMessageHandler(WM_LBUTTONDOWN,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+		++host_clicks;
+
+		return 0;
+	});
+	first = CreateControl(host,L"First",0,0);
+	second = CreateControl(host,L"Second",10,30);
+	third = CreateControl(host,L"Third",20,40);  //Over part of the second.
+
+	TestRouting(host,first,second,third);
+	TestEnabledAndVisible(host,first,second,third);
+	TestPainting(host,first,second,third);
+
+	host->destroy();
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+
+namespace
+{
+	/* Constants */
+	const COLORREF COLOR = RGB(10,20,30);
+	const COLORREF OTHER_COLOR = RGB(30,20,10);
+	const int ACQUISITIONS = 100;
+	const WORD ICON_ID = 1;
+
+	bool IsBrush(HBRUSH brush)  //Which has not been deleted.
+	{
+		LOGBRUSH description;
+
+
+		return GetObject(brush,sizeof(description),&description) == sizeof(description);
+	}
+
+	void TestBrushes()
+	{
+		OS::GdiCacheStatistics before = OS::GetGdiCacheStatistics();
+		OS::GdiCacheStatistics after;
+		HBRUSH brush;
+		HBRUSH other_brush;
+		HBRUSH uncached_brush;
+
+
+		/* The first acquisition of a color creates its brush, and every later one shares it. */
+		Headless::ResetCallCounts();
+		brush = OS::AcquireBrush(COLOR);
+		for(int acquisition = 1;acquisition < ACQUISITIONS;++acquisition)
+		{
+			TEST_CHECK(OS::AcquireBrush(COLOR) == brush);
+		}
+		other_brush = OS::AcquireBrush(OTHER_COLOR);
+		TEST_CHECK(other_brush != brush);
+		TEST_CHECK(Headless::GetCallCount("CreateSolidBrush") == 2);
+		after = OS::GetGdiCacheStatistics();
+		TEST_CHECK(after.hits - before.hits == ACQUISITIONS - 1 && after.misses - before.misses == 2);
+		TEST_CHECK(after.brushes - before.brushes == 2 && after.gdi_objects - before.gdi_objects == 2);
+
+		/* Only handles from the cache are counted. */
+		uncached_brush = CreateSolidBrush(COLOR);
+		TEST_CHECK(uncached_brush != brush);
+		TEST_CHECK(OS::RetainGdiObject(brush));
+		TEST_CHECK(!OS::RetainGdiObject(uncached_brush) && !OS::ReleaseGdiObject(uncached_brush));
+		DeleteObject(uncached_brush);
+
+		/* A brush is deleted once every acquisition and retention of it is released, and not before. */
+		Headless::ResetCallCounts();
+		for(int release = 0;release < ACQUISITIONS;++release)
+		{
+			TEST_CHECK(OS::ReleaseGdiObject(brush));
+		}
+		TEST_CHECK(Headless::GetCallCount("DeleteObject") == 0 && IsBrush(brush));
+		TEST_CHECK(OS::ReleaseGdiObject(brush));
+		TEST_CHECK(Headless::GetCallCount("DeleteObject") == 1 && !IsBrush(brush));
+		TEST_CHECK(!OS::ReleaseGdiObject(brush));  //Forgotten by the cache.
+		after = OS::GetGdiCacheStatistics();
+		TEST_CHECK(after.brushes - before.brushes == 1 && after.gdi_objects - before.gdi_objects == 1);
+
+		/* So the next acquisition creates it again. */
+		Headless::ResetCallCounts();
+		brush = OS::AcquireBrush(COLOR);
+		TEST_CHECK(Headless::GetCallCount("CreateSolidBrush") == 1);
+		OS::ReleaseGdiObject(brush);
+		OS::ReleaseGdiObject(other_brush);
+		after = OS::GetGdiCacheStatistics();
+		TEST_CHECK(after.brushes == before.brushes && after.gdi_objects == before.gdi_objects);
+	}
+
+	void TestImages()
+	{
+		OS::GdiCacheStatistics before = OS::GetGdiCacheStatistics();
+		OS::GdiCacheStatistics after;
+		HCURSOR cursor;
+		HICON icon;
+		HICON small_icon;
+
+
+		/* Images are shared by resource as brushes are by color. */
+		cursor = OS::AcquireCursor(nullptr,IDC_ARROW);
+		TEST_CHECK(OS::AcquireCursor(nullptr,IDC_ARROW) == cursor);
+		icon = OS::AcquireIcon(GetModuleHandle(nullptr),MAKEINTRESOURCE(ICON_ID),32);
+		TEST_CHECK(OS::AcquireIcon(GetModuleHandle(nullptr),MAKEINTRESOURCE(ICON_ID),32) == icon);
+		small_icon = OS::AcquireIcon(GetModuleHandle(nullptr),MAKEINTRESOURCE(ICON_ID),16);
+		TEST_CHECK(small_icon != icon);  //Another size is another image.
+		after = OS::GetGdiCacheStatistics();
+		TEST_CHECK(after.cursors - before.cursors == 1 && after.icons - before.icons == 2);
+		TEST_CHECK(after.hits - before.hits == 2 && after.misses - before.misses == 3);
+
+		/* Released to nothing, the application's icon is destroyed but the system's cursor, which is shared, is only forgotten. */
+		Headless::ResetCallCounts();
+		OS::ReleaseGdiObject(cursor);
+		OS::ReleaseGdiObject(icon);
+		TEST_CHECK(Headless::GetCallCount("DestroyCursor") == 0 && Headless::GetCallCount("DestroyIcon") == 0);
+		OS::ReleaseGdiObject(cursor);
+		OS::ReleaseGdiObject(icon);
+		TEST_CHECK(Headless::GetCallCount("DestroyCursor") == 0 && Headless::GetCallCount("DestroyIcon") == 1);
+		after = OS::GetGdiCacheStatistics();
+		TEST_CHECK(after.cursors == before.cursors && after.icons - before.icons == 1);
+		OS::ReleaseGdiObject(small_icon);
+		after = OS::GetGdiCacheStatistics();
+		TEST_CHECK(after.icons == before.icons);
+		TEST_CHECK(after.user_objects - before.user_objects == 1);  //The shared cursor, which lives as long as the process, as it does on Windows.
+	}
+}
+
+
+int main()
+{
+	TestBrushes();
+	TestImages();
+
+	return Test::GetResult();
+}
\ No newline at end of file
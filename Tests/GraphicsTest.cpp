@@ -0,0 +1,270 @@
+#include "Graphics.h"
+#include "Test.h"
+
+#include <cstdio>
+#include <vector>
+
+using Graphics::Bounds;
+using Graphics::Color;
+using Graphics::Surface;
+
+
+namespace
+{
+	/* Constants */
+	const int TRIALS = 400;
+
+	std::uint32_t random_state = 0x12345678;
+
+	std::uint32_t Random()  //xorshift32, so that every run tests the same cases.
+	{
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+
+		return random_state;
+	}
+
+	int Random(int low,int high)  //Inclusive.
+	{
+		return low + (int)(Random() % (std::uint32_t)(high - low + 1));
+	}
+
+	Color RandomColor()
+	{
+		switch(Random(0,3))  //Weighted towards the alphas the rasterizer treats specially.
+		{
+			case 0:
+				return Random() & 0x00FFFFFF;
+
+			case 1:
+				return Random() | 0xFF000000;
+
+			default:
+				return Random();
+		}
+	}
+
+	Bounds RandomBounds(const Surface& surface)  //Often partly or wholly outside of the surface, and sometimes empty.
+	{
+		Bounds bounds;
+
+
+		bounds.left = Random(-20,surface.getWidth() + 4);
+		bounds.top = Random(-20,surface.getHeight() + 4);
+		bounds.right = bounds.left + Random(-2,surface.getWidth() + 24);
+		bounds.bottom = bounds.top + Random(-2,surface.getHeight() + 24);
+
+		return bounds;
+	}
+
+	Surface RandomSurface()
+	{
+		Surface surface(Random(1,70),Random(1,40));
+
+
+		for(int y = 0;y < surface.getHeight();++y)
+		{
+			for(int x = 0;x < surface.getWidth();++x)
+			{
+				surface.setPixel(x,y,RandomColor());
+			}
+		}
+
+		return surface;
+	}
+
+	/**
+	 * Compares two surfaces pixel by pixel, reporting the first difference.
+	 */
+	bool Equal(const Surface& actual,const Surface& expected,const char* operation,int trial)
+	{
+		for(int y = 0;y < expected.getHeight();++y)
+		{
+			for(int x = 0;x < expected.getWidth();++x)
+			{
+				if(actual.getPixel(x,y) != expected.getPixel(x,y))
+				{
+					std::fprintf(stderr,"%s, trial %d: pixel (%d,%d) is %08X rather than %08X.\n",operation,trial,x,y,actual.getPixel(x,y),expected.getPixel(x,y));
+
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void TestBlendRectangle()
+	{
+		for(int trial = 0;trial < TRIALS;++trial)
+		{
+			Surface actual = RandomSurface();
+			Surface expected = actual;
+			Bounds bounds = RandomBounds(actual);
+			Color color = RandomColor();
+
+
+			Graphics::BlendRectangle(actual,bounds,color);
+			Graphics::Reference::BlendRectangle(expected,bounds,color);
+			TEST_CHECK(Equal(actual,expected,"BlendRectangle",trial));
+		}
+	}
+
+	void TestBlendSurface()
+	{
+		for(int trial = 0;trial < TRIALS;++trial)
+		{
+			Surface actual = RandomSurface();
+			Surface expected = actual;
+			Surface source = RandomSurface();
+			int x = Random(-source.getWidth(),actual.getWidth());
+			int y = Random(-source.getHeight(),actual.getHeight());
+
+
+			Graphics::BlendSurface(actual,source,x,y);
+			Graphics::Reference::BlendSurface(expected,source,x,y);
+			TEST_CHECK(Equal(actual,expected,"BlendSurface",trial));
+		}
+	}
+
+	void TestCopySurface()  //Has no reference implementation, as it only copies.
+	{
+		for(int trial = 0;trial < TRIALS;++trial)
+		{
+			Surface actual = RandomSurface();
+			Surface expected = actual;
+			Surface source = RandomSurface();
+			Bounds clip = RandomBounds(actual);
+			bool clipped = Random(0,1) == 1;
+			int x = Random(-source.getWidth(),actual.getWidth());
+			int y = Random(-source.getHeight(),actual.getHeight());
+
+
+			Graphics::CopySurface(actual,source,x,y,clipped ? &clip : nullptr);
+			for(int row = 0;row < source.getHeight();++row)
+			{
+				for(int column = 0;column < source.getWidth();++column)
+				{
+					int target_x = x + column;
+					int target_y = y + row;
+
+
+					if(target_x < 0 || target_y < 0 || target_x >= expected.getWidth() || target_y >= expected.getHeight())
+					{
+						continue;
+					}
+					if(clipped && (target_x < clip.left || target_y < clip.top || target_x >= clip.right || target_y >= clip.bottom))
+					{
+						continue;
+					}
+					expected.setPixel(target_x,target_y,source.getPixel(column,row));
+				}
+			}
+			TEST_CHECK(Equal(actual,expected,"CopySurface",trial));
+		}
+	}
+
+	void TestDrawMask()
+	{
+		for(int trial = 0;trial < TRIALS;++trial)
+		{
+			Surface actual = RandomSurface();
+			Surface expected = actual;
+			int width = Random(1,90);
+			int height = Random(1,30);
+			int stride = (width + 7) / 8 + Random(0,3);
+			std::vector<std::uint8_t> mask(stride * height);
+			int x = Random(-width,actual.getWidth());
+			int y = Random(-height,actual.getHeight());
+			Color color = RandomColor();
+
+
+			for(std::uint8_t& byte : mask)
+			{
+				byte = (std::uint8_t)(Random(0,4) == 0 ? 0 : Random());  //Empty bytes are skipped by the vectorized paths.
+			}
+
+			Graphics::DrawMask(actual,x,y,mask.data(),width,height,stride,color);
+			Graphics::Reference::DrawMask(expected,x,y,mask.data(),width,height,stride,color);
+			TEST_CHECK(Equal(actual,expected,"DrawMask",trial));
+		}
+	}
+
+	void TestFillGradient()
+	{
+		for(int trial = 0;trial < TRIALS;++trial)
+		{
+			Surface actual = RandomSurface();
+			Surface expected = actual;
+			Bounds bounds = RandomBounds(actual);
+			Color from = RandomColor();
+			Color to = RandomColor();
+			bool vertical = Random(0,1) == 1;
+
+
+			Graphics::FillGradient(actual,bounds,from,to,vertical);
+			Graphics::Reference::FillGradient(expected,bounds,from,to,vertical);
+			TEST_CHECK(Equal(actual,expected,"FillGradient",trial));
+		}
+	}
+
+	void TestFillRectangle()
+	{
+		for(int trial = 0;trial < TRIALS;++trial)
+		{
+			Surface actual = RandomSurface();
+			Surface expected = actual;
+			Bounds bounds = RandomBounds(actual);
+			Color color = RandomColor();
+
+
+			Graphics::FillRectangle(actual,bounds,color);
+			Graphics::Reference::FillRectangle(expected,bounds,color);
+			TEST_CHECK(Equal(actual,expected,"FillRectangle",trial));
+		}
+	}
+
+	void TestSurface()
+	{
+		Surface surface(5,3);
+
+
+		TEST_CHECK(surface.getStride() % 8 == 0 && surface.getStride() >= 5);  //Rows are padded to 32 bytes.
+
+		surface.resize(40,2);
+		TEST_CHECK(surface.getWidth() == 40 && surface.getHeight() == 2 && surface.getStride() == 40);
+
+		Bounds outside = {40,0,50,2};
+		Bounds partial = {-3,1,2,9};
+
+
+		TEST_CHECK(!surface.clip(outside));
+		TEST_CHECK(surface.clip(partial) && partial.left == 0 && partial.top == 1 && partial.right == 2 && partial.bottom == 2);
+		TEST_CHECK(Graphics::MakeColor(0x12,0x34,0x56,0x78) == 0x78123456);
+	}
+}
+
+int main()
+{
+#if defined(__AVX2__) && defined(__GNUC__)
+	if(!__builtin_cpu_supports("avx2"))
+	{
+		std::printf("Skipped, as this machine doesn't support AVX2.\n");
+
+		return 77;  //SKIP_RETURN_CODE
+	}
+#endif
+
+	std::printf("Instruction set: %s\n",Graphics::GetInstructionSet());
+
+	TestSurface();
+	TestFillRectangle();
+	TestBlendRectangle();
+	TestFillGradient();
+	TestBlendSurface();
+	TestCopySurface();
+	TestDrawMask();
+
+	return Test::GetResult();
+}
\ No newline at end of file
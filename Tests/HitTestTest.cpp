@@ -0,0 +1,112 @@
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+#include <vector>
+
+
+namespace
+{
+	/* Constants */
+	const wchar_t* FOREIGN_CLASS_NAME = L"ForeignChild";  //Registered directly, so that its windows are not created through this API.
+
+	OS::Window* CreateChild(OS::WindowClass* child_class,OS::Window* parent,int x,int y,int width,int height)
+	{
+		OS::Window* child = child_class->instantiate(L"Child");
+
+
+		child->setParent(parent);
+		child->setPosition(x,y);
+		child->setDimensions(width,height);
+
+		return child;
+	}
+
+	void TestIndexedChildren(OS::Window* window,OS::WindowClass* child_class)
+	{
+		OS::Window* first = CreateChild(child_class,window,10,10,40,40);
+		OS::Window* second = CreateChild(child_class,window,30,30,40,40);
+		RECT rectangle = {0,0,100,100};
+		std::vector<OS::Window*> children;
+
+
+		/* The child created last is top-most. */
+		TEST_CHECK(window->getChildByLocation(35,35) == second);
+		TEST_CHECK(window->getChildByLocation(15,15) == first);
+		TEST_CHECK(window->getChildByLocation(5,5) == window);
+		TEST_CHECK(window->getChildByLocation(-5,5) == nullptr);
+
+		/* Z-order changes are followed. */
+		SetWindowPos(first->getNativeHandle(),HWND_TOP,0,0,0,0,SWP_NOMOVE | SWP_NOSIZE);
+		TEST_CHECK(window->getChildByLocation(35,35) == first);
+		children = window->getChildrenInRectangle(rectangle);
+		TEST_CHECK(children.size() == 2 && children[0] == second && children[1] == first);
+
+		/* As do moves, and the flags. */
+		second->setPosition(60,60);
+		TEST_CHECK(window->getChildByLocation(35,35) == first);
+		TEST_CHECK(window->getChildByLocation(65,65) == second);
+		first->setVisible(false);
+		TEST_CHECK(window->getChildByLocation(15,15,CWP_SKIPINVISIBLE) == window);
+		TEST_CHECK(window->getChildByLocation(15,15) == first);
+
+		first->destroy();
+		second->destroy();
+		TEST_CHECK(window->getChildByLocation(65,65) == window);
+	}
+
+	void TestForeignChildren(OS::Window* window,OS::WindowClass* child_class)
+	{
+		OS::Window* managed = CreateChild(child_class,window,10,10,40,40);
+		HWND foreign_handle = CreateWindowEx(0,FOREIGN_CLASS_NAME,L"Foreign",WS_CHILD | WS_VISIBLE,30,30,40,40,window->getNativeHandle(),nullptr,GetModuleHandle(nullptr),nullptr);
+		RECT rectangle = {0,0,100,100};
+		std::vector<OS::Window*> children;
+
+
+		/* The window was told of a child its index does not hold, and still finds it. */
+		TEST_CHECK(foreign_handle != nullptr);
+		TEST_CHECK(window->getChildByLocation(35,35)->getNativeHandle() == foreign_handle);
+		TEST_CHECK(window->getChildByLocation(15,15) == managed);
+		TEST_CHECK(window->getChildByLocation(80,80) == window);
+		children = window->getChildrenInRectangle(rectangle);
+		TEST_CHECK(children.size() == 2 && children[0] == managed && children[1]->getNativeHandle() == foreign_handle);
+
+		SetWindowPos(managed->getNativeHandle(),HWND_TOP,0,0,0,0,SWP_NOMOVE | SWP_NOSIZE);
+		TEST_CHECK(window->getChildByLocation(35,35) == managed);
+		EnableWindow(managed->getNativeHandle(),FALSE);
+		TEST_CHECK(window->getChildByLocation(35,35,CWP_SKIPDISABLED)->getNativeHandle() == foreign_handle);
+
+		managed->destroy();
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"HitTestWindow");
+	OS::WindowClass* child_class = OS::WindowClass::Register(L"HitTestChild");
+	OS::Window* indexed;
+	OS::Window* mixed;
+	WNDCLASSEX foreign_class = {};
+
+
+	foreign_class.cbSize = sizeof(foreign_class);
+	foreign_class.lpfnWndProc = DefWindowProc;
+	foreign_class.hInstance = GetModuleHandle(nullptr);
+	foreign_class.lpszClassName = FOREIGN_CLASS_NAME;
+	RegisterClassEx(&foreign_class);
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,100,100);
+	child_class->setWindowDefaults(WS_CHILD | WS_VISIBLE,0,0,0,10,10);
+	indexed = window_class->instantiate(L"Indexed");
+	mixed = window_class->instantiate(L"Mixed");
+
+	TestIndexedChildren(indexed,child_class);
+	TestForeignChildren(mixed,child_class);
+
+	mixed->destroy();
+	indexed->destroy();
+	OS::WindowClass::Unregister(child_class);
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
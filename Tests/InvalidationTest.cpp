@@ -0,0 +1,148 @@
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+#include <vector>
+
+
+namespace
+{
+	/* Constants */
+	const UINT WM_CHANGE = WM_APP;  //Handled by invalidating each of the changed rectangles, as a window does when several of its parts change at once.
+	const RECT CHANGED_RECTANGLES[] = {{10,10,20,20},{50,5,60,15},{30,40,35,70},{12,12,18,18}};
+	const RECT CHANGED_UNION = {10,5,60,70};
+
+	struct Paint
+	{
+		OS::Window* window;
+		RECT update_rectangle;
+	};
+
+	std::vector<Paint> paints;
+
+	OS::Window* CreateRecordingWindow(OS::WindowClass* window_class)
+	{
+		OS::Window* window = window_class->instantiate(L"Recording");
+
+
+		window->setMessageHandler(WM_PAINT,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+			PAINTSTRUCT paint;
+			RECT update_rectangle;
+
+
+			GetUpdateRect(window->getNativeHandle(),&update_rectangle,FALSE);
+			paints.push_back({window,update_rectangle});
+			BeginPaint(window->getNativeHandle(),&paint);
+			EndPaint(window->getNativeHandle(),&paint);
+
+			return 0;
+		});
+		window->setMessageHandler(WM_CHANGE,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+			for(const RECT& rectangle : CHANGED_RECTANGLES)
+			{
+				window->invalidate(&rectangle);
+			}
+
+			return 0;
+		});
+		window->show();
+		OS::FlushInvalidations();
+		Headless::PumpMessages();  //Paints the window as first shown.
+
+		return window;
+	}
+
+	bool PaintedOnce(OS::Window* window,const RECT& rectangle)
+	{
+		int painted = 0;
+
+
+		for(const Paint& paint : paints)
+		{
+			if(paint.window == window)
+			{
+				if(!EqualRect(&paint.update_rectangle,&rectangle))
+				{
+					return false;
+				}
+				++painted;
+			}
+		}
+
+		return painted == 1;
+	}
+
+	void TestOneTurn(OS::Window* window)
+	{
+		/* Invalidations made while handling a message reach the system as one region once the message returns, and are painted once. */
+		paints.clear();
+		Headless::ResetCallCounts();
+		SendMessage(window->getNativeHandle(),WM_CHANGE,0,0);
+		TEST_CHECK(Headless::GetCallCount("RedrawWindow") == 1);
+		TEST_CHECK(paints.empty());
+		Headless::PumpMessages();
+		TEST_CHECK(PaintedOnce(window,CHANGED_UNION));
+		TEST_CHECK(Headless::GetCallCount("BeginPaint") == 1);
+
+		/* Nothing is left to flush or paint afterwards. */
+		paints.clear();
+		Headless::ResetCallCounts();
+		OS::FlushInvalidations();
+		Headless::PumpMessages();
+		TEST_CHECK(Headless::GetCallCount("RedrawWindow") == 0 && paints.empty());
+	}
+
+	void TestExplicitFlush(OS::Window* window,OS::Window* other)
+	{
+		RECT client_rectangle;
+
+
+		/* Outside of a message, invalidations wait for the flush, which passes on one region for each window invalidated. */
+		paints.clear();
+		Headless::ResetCallCounts();
+		for(const RECT& rectangle : CHANGED_RECTANGLES)
+		{
+			window->invalidate(&rectangle);
+			other->invalidate(&rectangle);
+		}
+		TEST_CHECK(Headless::GetCallCount("RedrawWindow") == 0);
+		OS::FlushInvalidations();
+		TEST_CHECK(Headless::GetCallCount("RedrawWindow") == 2);
+		Headless::PumpMessages();
+		TEST_CHECK(paints.size() == 2 && PaintedOnce(window,CHANGED_UNION) && PaintedOnce(other,CHANGED_UNION));
+
+		/* Invalidating the whole window takes in any rectangle invalidated before or after it. */
+		paints.clear();
+		Headless::ResetCallCounts();
+		window->invalidate(&CHANGED_RECTANGLES[0]);
+		window->invalidate();
+		window->invalidate(&CHANGED_RECTANGLES[1]);
+		OS::FlushInvalidations();
+		TEST_CHECK(Headless::GetCallCount("RedrawWindow") == 1);
+		Headless::PumpMessages();
+		GetClientRect(window->getNativeHandle(),&client_rectangle);
+		TEST_CHECK(PaintedOnce(window,client_rectangle));
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"InvalidationWindow");
+	OS::Window* window;
+	OS::Window* other;
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,100,100);
+	window = CreateRecordingWindow(window_class);
+	other = CreateRecordingWindow(window_class);
+
+	TestOneTurn(window);
+	TestExplicitFlush(window,other);
+
+	other->destroy();
+	window->destroy();
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "Headless.h"
+#include "Layout.h"
+#include "OS.h"
+#include "Test.h"
+
+#include <map>
+
+
+namespace
+{
+	/* Constants */
+	const int BRANCHES = 3;
+	const int LEAVES = 3;  //Per branch.
+
+	std::map<OS::Window*,int> moves;  //Of each window, by WM_WINDOWPOSCHANGED.
+
+	OS::Window* CreateNode(OS::WindowClass* window_class,OS::Window* parent)
+	{
+		OS::Window* window = window_class->instantiate(L"Node");
+
+
+		window->setParent(parent);
+		parent->getLayout()->appendChild(window->getLayout());
+		window->extendMessageHandler(WM_WINDOWPOSCHANGED,[](OS::Window* window,WPARAM w_param,LPARAM l_param){
+			++moves[window];
+		});
+
+		return window;
+	}
+
+	int CountMoves(OS::Window* window)
+	{
+		auto found = moves.find(window);
+
+
+		return found == moves.end() ? 0 : found->second;
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"LayoutRoot");
+	OS::WindowClass* child_class = OS::WindowClass::Register(L"LayoutNode");
+	OS::Window* root;
+	OS::Window* branches[BRANCHES];
+	OS::Window* leaves[BRANCHES][LEAVES];
+	RECT first_leaf;
+	RECT first_leaf_after;
+	RECT moved_branch;
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,300,300);
+	child_class->setWindowDefaults(WS_CHILD | WS_VISIBLE,0,0,0,0,0);
+	root = window_class->instantiate(L"Root");
+	root->getLayout()->setWidth(300);
+	root->getLayout()->setHeight(300);
+	for(int branch = 0;branch < BRANCHES;++branch)
+	{
+		branches[branch] = CreateNode(child_class,root);
+		branches[branch]->getLayout()->setOrientation(OS::Layout::Orientation::HORIZONTAL);
+		branches[branch]->getLayout()->setSpacing(5);
+		for(int leaf = 0;leaf < LEAVES;++leaf)
+		{
+			leaves[branch][leaf] = CreateNode(child_class,branches[branch]);
+			leaves[branch][leaf]->getLayout()->setWidth(40);
+			leaves[branch][leaf]->getLayout()->setHeight(20);
+		}
+	}
+	root->getLayout()->update();
+	TEST_CHECK(leaves[1][2]->getLayout()->getRectangle().left == 90 && leaves[1][2]->getLayout()->getRectangle().right == 130);
+	TEST_CHECK(branches[2]->getLayout()->getRectangle().top == 40);
+
+	/* Nothing changed, so nothing moves. */
+	moves.clear();
+	root->getLayout()->update();
+	TEST_CHECK(moves.empty());
+
+	/* Widening a leaf moves only it and the siblings after it, and none of the other branches. */
+	first_leaf = leaves[1][0]->getLayout()->getRectangle();
+	leaves[1][1]->getLayout()->setWidth(60);
+	root->getLayout()->update();
+	TEST_CHECK(moves.size() == 2);
+	TEST_CHECK(CountMoves(leaves[1][1]) == 1 && CountMoves(leaves[1][2]) == 1);
+	TEST_CHECK(leaves[1][2]->getLayout()->getRectangle().left == 110);
+	first_leaf_after = leaves[1][0]->getLayout()->getRectangle();
+	TEST_CHECK(EqualRect(&first_leaf,&first_leaf_after));
+
+	/* The last leaf has no siblings after it to move. */
+	moves.clear();
+	leaves[1][2]->getLayout()->setWidth(50);
+	root->getLayout()->update();
+	TEST_CHECK(moves.size() == 1 && CountMoves(leaves[1][2]) == 1);
+
+	/* Making a leaf taller moves its branch and the branches below it, but not their leaves, which keep their places within their branches. */
+	moves.clear();
+	moved_branch = branches[2]->getLayout()->getRectangle();
+	leaves[1][0]->getLayout()->setHeight(30);
+	root->getLayout()->update();
+	TEST_CHECK(CountMoves(leaves[1][0]) == 1 && CountMoves(branches[1]) == 1 && CountMoves(branches[2]) == 1);
+	TEST_CHECK(moves.size() == 3);
+	TEST_CHECK(branches[2]->getLayout()->getRectangle().top == moved_branch.top + 10);
+	TEST_CHECK(CountMoves(branches[0]) == 0 && CountMoves(leaves[2][0]) == 0);
+
+	root->destroy();
+	OS::WindowClass::Unregister(child_class);
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+#include <chrono>
+#include <vector>
+
+
+namespace
+{
+	/* Constants */
+	const UINT WM_TEST = WM_APP;
+	const UINT WM_TEST_WINDOW = WM_APP + 1;  //With a window's handle as its lParam.
+	const UINT OBSERVED_MESSAGES[] = {WM_TEST,WM_TEST_WINDOW,WM_COMMAND,WM_KILLFOCUS,WM_PARENTNOTIFY,WM_SETTEXT,WM_CLOSE};
+	const wchar_t* FOREIGN_CLASS_NAME = L"ReplayForeign";  //Registered directly, so that its windows are not created through this API and their messages are not recorded.
+	const wchar_t* LOG_PATH = L"MessageReplayTest.log";  //In the working directory.
+	const WORD COMMAND_ID = 1;
+	const int PACE = 30;  //Milliseconds between the messages of the paced recording.
+
+	struct Delivery
+	{
+		HWND window;
+		UINT message;
+		WPARAM w_param;
+		LPARAM l_param;
+	};
+
+	struct Tree
+	{
+		OS::Window* host;
+		OS::Window* first;
+		OS::Window* second;
+		HWND foreign;  //Created last, as a child of the host.
+	};
+
+	std::vector<Delivery> deliveries;
+
+	void Observe(OS::Window* window)
+	{
+		for(UINT message : OBSERVED_MESSAGES)
+		{
+			window->setMessageHandler(message,[message](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+				deliveries.push_back({window->getNativeHandle(),message,w_param,l_param});
+
+				return 0;  //So that WM_CLOSE destroys nothing.
+			});
+		}
+	}
+
+	Tree CreateTree(OS::WindowClass* window_class,OS::WindowClass* child_class)
+	{
+		Tree tree;
+
+
+		tree.host = window_class->instantiate(L"Host");
+		tree.first = child_class->instantiate(L"First");
+		tree.second = child_class->instantiate(L"Second");
+		tree.first->setParent(tree.host);
+		tree.second->setParent(tree.host);
+		Observe(tree.host);
+		Observe(tree.first);
+		Observe(tree.second);
+
+		return tree;
+	}
+
+	HWND CreateForeignChild(Tree& tree)
+	{
+		return CreateWindowEx(0,FOREIGN_CLASS_NAME,L"Foreign",WS_CHILD,0,0,10,10,tree.host->getNativeHandle(),nullptr,GetModuleHandle(nullptr),nullptr);
+	}
+
+	const Delivery* FindDelivery(HWND window,UINT message)
+	{
+		for(const Delivery& delivery : deliveries)
+		{
+			if(delivery.window == window && delivery.message == message)
+			{
+				return &delivery;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void TestRoundTrip(OS::WindowClass* window_class,OS::WindowClass* child_class)
+	{
+		Tree recorded = CreateTree(window_class,child_class);
+		Tree replayed;
+		const Delivery* delivery;
+
+
+		/* Windows passed as parameters are recorded whether or not a message has been sent to them yet. */
+		OS::StartMessageRecording(LOG_PATH);
+		SendMessage(recorded.first->getNativeHandle(),WM_TEST,7,8);
+		recorded.foreign = CreateForeignChild(recorded);  //Notifies the host with the new child's handle.
+		SendMessage(recorded.host->getNativeHandle(),WM_COMMAND,MAKEWPARAM(COMMAND_ID,0),(LPARAM)recorded.second->getNativeHandle());  //Before the second has received anything.
+		SendMessage(recorded.first->getNativeHandle(),WM_KILLFOCUS,(WPARAM)recorded.foreign,0);
+		SendMessage(recorded.host->getNativeHandle(),WM_TEST_WINDOW,0,(LPARAM)recorded.first->getNativeHandle());
+		SendMessage(recorded.second->getNativeHandle(),WM_SETTEXT,0,(LPARAM)L"Text");
+		SendMessage(recorded.host->getNativeHandle(),WM_CLOSE,0,0);
+		OS::StopMessageRecording();
+		recorded.host->destroy();
+
+		/* Replayed to a tree like the one recorded, each message reaches the same window, and every window it carries is the matching one. */
+		replayed = CreateTree(window_class,child_class);
+		replayed.foreign = CreateForeignChild(replayed);
+		deliveries.clear();
+		TEST_CHECK(OS::ReplayMessages(LOG_PATH) > 0);
+		delivery = FindDelivery(replayed.first->getNativeHandle(),WM_TEST);
+		TEST_CHECK(delivery != nullptr && delivery->w_param == 7 && delivery->l_param == 8);
+		delivery = FindDelivery(replayed.host->getNativeHandle(),WM_PARENTNOTIFY);
+		TEST_CHECK(delivery != nullptr && LOWORD(delivery->w_param) == WM_CREATE && (HWND)delivery->l_param == replayed.foreign);
+		delivery = FindDelivery(replayed.host->getNativeHandle(),WM_COMMAND);
+		TEST_CHECK(delivery != nullptr && LOWORD(delivery->w_param) == COMMAND_ID && (HWND)delivery->l_param == replayed.second->getNativeHandle());
+		delivery = FindDelivery(replayed.first->getNativeHandle(),WM_KILLFOCUS);
+		TEST_CHECK(delivery != nullptr && (HWND)delivery->w_param == replayed.foreign);
+		delivery = FindDelivery(replayed.host->getNativeHandle(),WM_TEST_WINDOW);
+		TEST_CHECK(delivery != nullptr && (HWND)delivery->l_param == replayed.first->getNativeHandle());
+
+		/* Messages with pointers and those which would close windows are not replayed. */
+		TEST_CHECK(FindDelivery(replayed.second->getNativeHandle(),WM_SETTEXT) == nullptr);
+		TEST_CHECK(FindDelivery(replayed.host->getNativeHandle(),WM_CLOSE) == nullptr);
+		TEST_CHECK(deliveries.size() == 5);
+
+		replayed.host->destroy();
+	}
+
+	void TestPacing(OS::WindowClass* window_class,OS::WindowClass* child_class)
+	{
+		Tree tree = CreateTree(window_class,child_class);
+		std::chrono::steady_clock::time_point start;
+		long long elapsed;
+
+
+		/* A paced replay keeps the intervals at which the messages were recorded, sleeping rather than spinning through them. */
+		OS::StartMessageRecording();
+		SendMessage(tree.first->getNativeHandle(),WM_TEST,1,0);
+		Sleep(PACE);
+		SendMessage(tree.first->getNativeHandle(),WM_TEST,2,0);
+		OS::StopMessageRecording();
+		OS::SaveMessageRecording(LOG_PATH);
+
+		deliveries.clear();
+		Headless::ResetCallCounts();
+		start = std::chrono::steady_clock::now();
+		TEST_CHECK(OS::ReplayMessages(LOG_PATH,true) == 2);
+		elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		TEST_CHECK(deliveries.size() == 2 && deliveries[1].w_param == 2);
+		TEST_CHECK(elapsed >= PACE - 1);
+		TEST_CHECK(Headless::GetCallCount("Sleep") >= 1 && Headless::GetCallCount("Sleep") <= 3);
+
+		/* Unpaced, it does not wait at all. */
+		Headless::ResetCallCounts();
+		TEST_CHECK(OS::ReplayMessages(LOG_PATH) == 2);
+		TEST_CHECK(Headless::GetCallCount("Sleep") == 0);
+
+		tree.host->destroy();
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"ReplayHost");
+	OS::WindowClass* child_class = OS::WindowClass::Register(L"ReplayChild");
+	WNDCLASSEX foreign_class = {};
+
+
+	foreign_class.cbSize = sizeof(foreign_class);
+	foreign_class.lpfnWndProc = DefWindowProc;
+	foreign_class.hInstance = GetModuleHandle(nullptr);
+	foreign_class.lpszClassName = FOREIGN_CLASS_NAME;
+	RegisterClassEx(&foreign_class);
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,100,100);
+	child_class->setWindowDefaults(WS_CHILD,0,0,0,10,10);
+
+	TestRoundTrip(window_class,child_class);
+	TestPacing(window_class,child_class);
+
+	OS::WindowClass::Unregister(child_class);
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
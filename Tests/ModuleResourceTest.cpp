@@ -0,0 +1,135 @@
+#include "Headless.h"
+#include "OS.h"
+#include "ResourcePack.h"
+#include "Resources/Resources.h"
+#include "Test.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+
+namespace
+{
+	/* Constants */
+	const WORD NEUTRAL_LANGUAGE = MAKELANGID(LANG_NEUTRAL,SUBLANG_NEUTRAL);
+	const WORD ENGLISH_LANGUAGE = MAKELANGID(LANG_ENGLISH,SUBLANG_DEFAULT);
+	const WORD GERMAN_LANGUAGE = 0x0407;  //Which the module has no resources in.
+	const WORD PACKED_ID = Application_Config;  //In the packs as well as in the module.
+	const WORD UNPACKED_ID = 1000;  //Only in the module.
+	const char NEUTRAL_DATA[] = "<Config/>";
+	const char ENGLISH_DATA[] = "<Config language=\"en\"/>";
+	const char UNPACKED_DATA[] = "<Unpacked/>";
+
+	std::string ReadFile(const std::string& path)
+	{
+		std::ifstream file(path.c_str(),std::ios::binary);
+
+
+		return std::string(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+	}
+
+	std::wstring Widen(const char* text)
+	{
+		return std::wstring(text,text + std::strlen(text));
+	}
+
+	std::string GetData(const OS::Module::Resource& resource)
+	{
+		return std::string((const char*)resource.data,resource.size);
+	}
+
+	bool Throws(OS::Module& module,WORD resource_id)
+	{
+		try
+		{
+			module.getResourceEntry(resource_id,L"XML");
+		}
+		catch(const OS::RuntimeException&)
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+	void TestIndex(OS::Module& module)
+	{
+		OS::Module other(GetModuleHandle(nullptr));
+		OS::Module::Resource resource;
+
+
+		/* A resource is looked up in the module once, and every later request for it is answered from the index, through any OS::Module. */
+		Headless::ResetCallCounts();
+		resource = module.getResourceEntry(PACKED_ID,L"XML");
+		TEST_CHECK(GetData(resource) == std::string(NEUTRAL_DATA,sizeof(NEUTRAL_DATA)));
+		TEST_CHECK(resource.location != nullptr && !resource.storage);
+		TEST_CHECK(module.getResource(PACKED_ID,L"XML") == resource.data);
+		TEST_CHECK(module.getResourceSize(PACKED_ID,L"XML") == sizeof(NEUTRAL_DATA));
+		TEST_CHECK(module.getResourceLocation(PACKED_ID,L"XML") == resource.location);
+		TEST_CHECK(other.getResourceEntry(PACKED_ID,L"xml").data == resource.data);  //Types are compared without regard to case.
+		TEST_CHECK(Headless::GetCallCount("FindResourceEx") == 1 && Headless::GetCallCount("LoadResource") == 1);
+
+		/* Resources which do not exist are not indexed. */
+		TEST_CHECK(Throws(module,UNPACKED_ID + 1));
+		TEST_CHECK(Throws(module,UNPACKED_ID + 1));
+	}
+
+	void TestLanguages(OS::Module& module)
+	{
+		/* Each language is indexed apart, with the module's own fallback to the neutral language. */
+		Headless::ResetCallCounts();
+		TEST_CHECK(GetData(module.getResourceEntry(PACKED_ID,L"XML",ENGLISH_LANGUAGE)) == std::string(ENGLISH_DATA,sizeof(ENGLISH_DATA)));
+		TEST_CHECK(GetData(module.getResourceEntry(PACKED_ID,L"XML",GERMAN_LANGUAGE)) == std::string(NEUTRAL_DATA,sizeof(NEUTRAL_DATA)));
+		TEST_CHECK(GetData(module.getResourceEntry(PACKED_ID,L"XML",NEUTRAL_LANGUAGE)) == std::string(NEUTRAL_DATA,sizeof(NEUTRAL_DATA)));
+		TEST_CHECK(module.getResource(PACKED_ID,L"XML",ENGLISH_LANGUAGE) != module.getResource(PACKED_ID,L"XML",GERMAN_LANGUAGE));
+		TEST_CHECK(Headless::GetCallCount("FindResourceEx") == 2);  //The neutral one was indexed already.
+	}
+
+	void TestPacks(OS::Module& module)
+	{
+		OS::ResourcePack pack(Widen(RESOURCE_PACK));
+		OS::ResourcePack compressed_pack(Widen(COMPRESSED_RESOURCE_PACK));
+		std::string packed_data = ReadFile(RESOURCE_DIRECTORY "Application.xml");
+		OS::Module::Resource resource;
+
+
+		/* An attached pack overrides the module, which still serves what the pack lacks, and the index forgets what it found before. */
+		module.attachResourcePack(&pack);
+		Headless::ResetCallCounts();
+		resource = module.getResourceEntry(PACKED_ID,L"XML");
+		TEST_CHECK(GetData(resource) == packed_data && resource.location == nullptr);
+		TEST_CHECK(module.getResourceEntry(PACKED_ID,L"XML").data == resource.data);
+		TEST_CHECK(Headless::GetCallCount("FindResourceEx") == 0);
+		TEST_CHECK(GetData(module.getResourceEntry(UNPACKED_ID,L"XML")) == std::string(UNPACKED_DATA,sizeof(UNPACKED_DATA)));
+		TEST_CHECK(Headless::GetCallCount("FindResourceEx") == 1);
+
+		/* The size of a compressed resource is known without decompressing it. */
+		module.attachResourcePack(&compressed_pack);
+		TEST_CHECK(module.getResourceSize(PACKED_ID,L"XML") == packed_data.size());
+		resource = module.getResourceEntry(PACKED_ID,L"XML");
+		TEST_CHECK(GetData(resource) == packed_data && resource.storage);
+
+		/* Detached, the module's own resources are served again. */
+		module.attachResourcePack(nullptr);
+		TEST_CHECK(GetData(module.getResourceEntry(PACKED_ID,L"XML")) == std::string(NEUTRAL_DATA,sizeof(NEUTRAL_DATA)));
+	}
+}
+
+
+int main()
+{
+	OS::Module module(GetModuleHandle(nullptr));
+
+
+	Headless::AddResource(nullptr,L"XML",PACKED_ID,NEUTRAL_DATA,sizeof(NEUTRAL_DATA));
+	Headless::AddResource(nullptr,L"XML",PACKED_ID,ENGLISH_DATA,sizeof(ENGLISH_DATA),ENGLISH_LANGUAGE);
+	Headless::AddResource(nullptr,L"XML",UNPACKED_ID,UNPACKED_DATA,sizeof(UNPACKED_DATA));
+
+	TestIndex(module);
+	TestLanguages(module);
+	TestPacks(module);
+
+	return Test::GetResult();
+}
\ No newline at end of file
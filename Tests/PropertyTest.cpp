@@ -0,0 +1,158 @@
+#include "OS.h"
+#include "Test.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	/* Constants */
+	const OS::Property<int> COUNT(L"PropertyTestCount");
+	const OS::Property<std::wstring> LABEL(L"PropertyTestLabel");  //Stored apart from its entry.
+	const OS::Property<std::shared_ptr<int>> TOKEN(L"PropertyTestToken");
+
+	struct Notification
+	{
+		OS::Window* window;
+		OS::PropertyId property;
+	};
+
+	std::vector<Notification> notifications;
+
+	OS::PropertyObserver Record()
+	{
+		return [](OS::Window* window,OS::PropertyId property){
+			notifications.push_back({window,property});
+		};
+	}
+
+	void TestValues(OS::WindowClass* window_class)
+	{
+		OS::Window* window = window_class->instantiate(L"Values",true);  //Deferred, as typed properties need no native window.
+		std::shared_ptr<int> token = std::make_shared<int>(1);
+
+
+		/* Values of any type are kept until replaced or removed, and unset properties give the fallback. */
+		TEST_CHECK(window->getProperty(COUNT) == 0 && window->getProperty(COUNT,-1) == -1);
+		TEST_CHECK(!window->hasProperty(COUNT));
+		window->setProperty(COUNT,3);
+		window->setProperty(LABEL,std::wstring(100,L'x'));
+		TEST_CHECK(window->getProperty(COUNT,-1) == 3 && window->getProperty(LABEL) == std::wstring(100,L'x'));
+		window->setProperty(COUNT,4);
+		TEST_CHECK(window->getProperty(COUNT) == 4);
+		window->removeProperty(COUNT);
+		TEST_CHECK(!window->hasProperty(COUNT) && window->getProperty(COUNT,-1) == -1);
+		TEST_CHECK(window->hasProperty(LABEL));
+
+		/* They are released when the window is destroyed. */
+		window->setProperty(TOKEN,token);
+		TEST_CHECK(token.use_count() == 2);
+		window->realize();
+		TEST_CHECK(window->getProperty(TOKEN) == token);
+		window->destroy();
+		TEST_CHECK(token.use_count() == 1);
+	}
+
+	void TestObservers(OS::WindowClass* window_class)
+	{
+		OS::Window* window = window_class->instantiate(L"Observed");
+		OS::Window* other_window = window_class->instantiate(L"Unobserved");
+		UINT_PTR observer;
+		UINT_PTR other_observer;
+
+
+		/* An observer is called on every set, changed or not, and only for its own property of its own window. */
+		observer = window->observeProperty(COUNT,Record());
+		window->setProperty(COUNT,1);
+		window->setProperty(COUNT,1);
+		window->setProperty(LABEL,std::wstring(L"Label"));
+		other_window->setProperty(COUNT,1);
+		TEST_CHECK(notifications.size() == 2);
+		TEST_CHECK(notifications[0].window == window && notifications[0].property == COUNT.getId());
+
+		/* And on removal, but only of a property which was set. */
+		notifications.clear();
+		window->removeProperty(COUNT);
+		window->removeProperty(COUNT);
+		TEST_CHECK(notifications.size() == 1 && notifications[0].property == COUNT);
+
+		/* Every observer of a property is called, in the order they were added, until it is removed. */
+		notifications.clear();
+		other_observer = window->observeProperty(COUNT,[](OS::Window* window,OS::PropertyId property){
+			notifications.push_back({nullptr,property});
+		});
+		window->setProperty(COUNT,2);
+		TEST_CHECK(notifications.size() == 2 && notifications[0].window == window && notifications[1].window == nullptr);
+		window->unobserveProperty(observer);
+		window->unobserveProperty(observer);  //Already removed.
+		notifications.clear();
+		window->setProperty(COUNT,3);
+		TEST_CHECK(notifications.size() == 1 && notifications[0].window == nullptr);
+		window->unobserveProperty(other_observer);
+		notifications.clear();
+		window->setProperty(COUNT,4);
+		TEST_CHECK(notifications.empty());
+
+		window->destroy();
+		other_window->destroy();
+	}
+
+	void TestReentrantObservers(OS::WindowClass* window_class)
+	{
+		OS::Window* window = window_class->instantiate(L"Reentrant");
+		std::shared_ptr<int> token = std::make_shared<int>(1);
+		UINT_PTR observer = 0;
+		int calls = 0;
+		int added_calls = 0;
+
+
+		/* Observers may remove themselves and add others while being notified; the others are first called for the next change. */
+		observer = window->observeProperty(COUNT,[&](OS::Window* window,OS::PropertyId property){
+			++calls;
+			window->unobserveProperty(observer);
+			window->observeProperty(COUNT,[&added_calls](OS::Window* window,OS::PropertyId property){
+				++added_calls;
+			});
+		});
+		window->setProperty(COUNT,1);
+		TEST_CHECK(calls == 1 && added_calls == 0);
+		window->setProperty(COUNT,2);
+		TEST_CHECK(calls == 1 && added_calls == 1);
+
+		/* The value is already set when observers are called, and may be read or set again by them. */
+		window->observeProperty(LABEL,[](OS::Window* window,OS::PropertyId property){
+			if(window->getProperty(LABEL) == L"First")
+			{
+				window->setProperty(LABEL,std::wstring(L"Second"));
+			}
+		});
+		window->setProperty(LABEL,std::wstring(L"First"));
+		TEST_CHECK(window->getProperty(LABEL) == L"Second");
+
+		/* Observers are forgotten when the window is destroyed. */
+		window->observeProperty(TOKEN,[token](OS::Window* window,OS::PropertyId property){
+		});
+		TEST_CHECK(token.use_count() == 2);
+		window->destroy();
+		TEST_CHECK(token.use_count() == 1);
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"PropertyWindow");
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,100,100);
+
+	TestValues(window_class);
+	TestObservers(window_class);
+	TestReentrantObservers(window_class);
+
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "Graphics.h"
+#include "Headless.h"
+#include "Layout.h"
+#include "OS.h"
+#include "Test.h"
+#include "XML.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	/* Constants */
+	enum : WORD
+	{
+		UI_CLASS_WINDOW = 1,
+		UI_CLASS_PUSH_BUTTON
+	};
+
+	const COLORREF WINDOW_COLOR = RGB(0x20,0x40,0x60);
+	const COLORREF BUTTON_COLOR = RGB(0xC0,0x80,0x40);
+	const COLORREF FIRST_COLOR = RGB(0xFF,0x00,0x00);
+	const COLORREF SECOND_COLOR = RGB(0x00,0xFF,0x00);
+
+	int prints = 0;  //Of client areas, each of which is one window's cached surface being drawn again.
+
+	std::string ReadFile(const char* path)
+	{
+		std::ifstream file(path,std::ios::binary);
+
+
+		return std::string(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+	}
+
+	Graphics::Color ToPixel(COLORREF color)
+	{
+		return 0xFF000000 | GetRValue(color) << 16 | GetGValue(color) << 8 | GetBValue(color);
+	}
+
+	/**
+	 * Creates a window, and the windows of its children, from an element of a UI description whose name is the UIClass of the window.
+	 */
+	OS::Window* CreateFromDescription(const XML::Element& element,std::vector<OS::Window*>& windows)
+	{
+		OS::Window* window = OS::UIClass::GetByName(element.getName())->instantiate();
+
+
+		windows.push_back(window);
+		window->setName(element.getText());
+		window->extendMessageHandler(WM_PRINTCLIENT,[](OS::Window* window,WPARAM w_param,LPARAM l_param){
+			++prints;
+		});
+		for(const std::pair<const std::wstring,std::wstring>& attribute : element.getAttributes())
+		{
+			window->getLayout()->setAttribute(attribute.first,attribute.second);
+		}
+		for(const XML::Element& child : element.getChildren())
+		{
+			if(child.type == XML::Element::Type::CONTAINER)
+			{
+				OS::Window* child_window = CreateFromDescription(child,windows);
+
+
+				child_window->setParent(window);
+				child_window->show();
+				window->getLayout()->appendChild(child_window->getLayout());
+			}
+		}
+
+		return window;
+	}
+
+	void TestMainDescription()
+	{
+		std::string document = ReadFile(RESOURCE_DIRECTORY "UI/Main.xml");
+		XML::Element description = XML::Parse(document.data(),document.size());
+		std::vector<OS::Window*> windows;
+		OS::Window* window = CreateFromDescription(*description.getChild(L"Window"),windows);
+		OS::Window* button = windows.back();
+		Graphics::Surface target;
+		Graphics::Surface again;
+		RECT button_rectangle;
+		HBITMAP bitmap;
+
+
+		window->getLayout()->update();
+		window->setBackground(WINDOW_COLOR);
+		button->setBackground(BUTTON_COLOR);
+		button_rectangle = button->getLayout()->getRectangle();
+		TEST_CHECK(windows.size() == 2);
+		TEST_CHECK(button->getName() == L"Do Not Click");
+		TEST_CHECK(button_rectangle.left == 15 && button_rectangle.top == 15);
+		TEST_CHECK(button->getWidth() == 300 && button->getHeight() == 25);
+
+		/* Every window is drawn once, the button over the window. */
+		prints = 0;
+		window->render(target);
+		TEST_CHECK(prints == 2);
+		TEST_CHECK(target.getWidth() == window->getRectangle(true).right && target.getHeight() == window->getRectangle(true).bottom);
+		TEST_CHECK(target.getPixel(5,5) == ToPixel(WINDOW_COLOR));
+		TEST_CHECK(target.getPixel(15,15) == ToPixel(BUTTON_COLOR));
+		TEST_CHECK(target.getPixel(314,39) == ToPixel(BUTTON_COLOR));
+		TEST_CHECK(target.getPixel(315,40) == ToPixel(WINDOW_COLOR));
+		TEST_CHECK(target.getPixel(14,14) == ToPixel(WINDOW_COLOR));
+
+		/* Nothing changed, so nothing is drawn again. */
+		prints = 0;
+		window->render(again);
+		TEST_CHECK(prints == 0);
+		TEST_CHECK(again.getPixel(15,15) == ToPixel(BUTTON_COLOR));
+
+		/* Only the window which changed is. */
+		button->setBackground(WINDOW_COLOR);
+		window->render(again);
+		TEST_CHECK(prints == 1);
+		TEST_CHECK(again.getPixel(15,15) == ToPixel(WINDOW_COLOR));
+
+		/* Hidden windows are left out. */
+		button->setVisible(false);
+		button->setBackground(BUTTON_COLOR);
+		window->render(again);
+		TEST_CHECK(again.getPixel(15,15) == ToPixel(WINDOW_COLOR));
+
+		bitmap = window->renderToBitmap();
+		TEST_CHECK(bitmap != nullptr);
+		DeleteObject(bitmap);
+
+		window->destroy();
+	}
+
+	void TestOrderAndClipping(OS::WindowClass* window_class,OS::WindowClass* child_class)
+	{
+		OS::Window* window = window_class->instantiate(L"Root");
+		OS::Window* first = child_class->instantiate(L"First");
+		OS::Window* second = child_class->instantiate(L"Second");
+		OS::Window* grandchild = child_class->instantiate(L"Grandchild");
+		Graphics::Surface target;
+
+
+		window->setDimensions(100,100);
+		window->setBackground(WINDOW_COLOR);
+		for(OS::Window* child : {first,second})
+		{
+			child->setParent(window);
+			child->setDimensions(40,40);
+		}
+		first->setPosition(10,10);
+		first->setBackground(FIRST_COLOR);
+		second->setPosition(30,30);
+		second->setBackground(SECOND_COLOR);
+		grandchild->setParent(first);
+		grandchild->setPosition(20,20);
+		grandchild->setDimensions(60,60);  //Reaches beyond its parent.
+		grandchild->setBackground(BUTTON_COLOR);
+
+		/* Siblings are drawn bottom-most first. */
+		SetWindowPos(second->getNativeHandle(),HWND_TOP,0,0,0,0,SWP_NOMOVE | SWP_NOSIZE);
+		window->render(target);
+		TEST_CHECK(target.getPixel(45,45) == ToPixel(SECOND_COLOR));
+		TEST_CHECK(target.getPixel(15,15) == ToPixel(FIRST_COLOR));
+
+		SetWindowPos(first->getNativeHandle(),HWND_TOP,0,0,0,0,SWP_NOMOVE | SWP_NOSIZE);
+		window->render(target);
+		TEST_CHECK(target.getPixel(45,45) == ToPixel(BUTTON_COLOR));  //The grandchild, above its parent, above the second.
+		TEST_CHECK(target.getPixel(65,65) == ToPixel(SECOND_COLOR));  //The grandchild, but outside its parent.
+		TEST_CHECK(target.getPixel(85,85) == ToPixel(WINDOW_COLOR));
+
+		window->destroy();
+	}
+}
+
+
+int main()
+{
+	OS::Module module(GetModuleHandle(nullptr));
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"Window");
+	OS::WindowClass* child_class = OS::WindowClass::Register(L"Child");
+	OS::WindowClass* button_class = OS::WindowClass::GetByName(L"Button");
+	OS::UIClass* ui_classes[2];
+	std::string definitions[] = {ReadFile(RESOURCE_DIRECTORY "UIClass/Window.xml"),ReadFile(RESOURCE_DIRECTORY "UIClass/PushButton.xml")};
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,640,480);
+	child_class->setWindowDefaults(WS_CHILD | WS_VISIBLE,0,0,0,10,10);
+	button_class->setWindowDefaults(WS_TABSTOP | WS_CHILD | BS_PUSHBUTTON,0,0,0,0,0);  //As Application::Load sets them.
+	Headless::AddResource(nullptr,L"XML",UI_CLASS_WINDOW,definitions[0].data(),definitions[0].size());
+	Headless::AddResource(nullptr,L"XML",UI_CLASS_PUSH_BUTTON,definitions[1].data(),definitions[1].size());
+	ui_classes[0] = OS::UIClass::Load(module,UI_CLASS_WINDOW);
+	ui_classes[1] = OS::UIClass::Load(module,UI_CLASS_PUSH_BUTTON);
+
+	TestMainDescription();
+	TestOrderAndClipping(window_class,child_class);
+
+	OS::UIClass::Unload(ui_classes[1]);
+	OS::UIClass::Unload(ui_classes[0]);
+	OS::WindowClass::Unregister(child_class);
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
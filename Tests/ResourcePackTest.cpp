@@ -0,0 +1,208 @@
+#include "Compression.h"
+#include "ResourcePack.h"
+#include "Resources/Resources.h"
+#include "Test.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using OS::ResourcePack;
+
+typedef std::vector<std::uint8_t> Bytes;
+
+
+namespace
+{
+	struct XmlResource
+	{
+		const wchar_t* name;
+		const char* path;  //Relative to the resource directory.
+	};
+
+	struct StringResource
+	{
+		std::uintptr_t id;
+		const char* text;
+	};
+
+	/* Constants */
+	const std::uint16_t NEUTRAL_LANGUAGE = 0;
+	const wchar_t* const RT_STRING_TYPE = (const wchar_t*)6;
+	const XmlResource XML_RESOURCES[] = {
+		{(const wchar_t*)Application_Config,"Application.xml"},
+		{L"APPLICATION_UI","UI/Main.xml"},  //Not defined in Resources.h, so packed by name.
+		{(const wchar_t*)Application_UIClass_PushButton,"UIClass/PushButton.xml"},
+		{(const wchar_t*)Application_UIClass_Window,"UIClass/Window.xml"},
+	};
+	const StringResource STRING_RESOURCES[] = {
+		{Application_Title,"The Angry Button"},
+		{Application_UIClass_Button_Name,"Button"},
+		{Application_MainWindow_OnCreate,"MainWindow_OnCreate"},
+	};
+
+	const wchar_t* MakeIdentifier(std::uintptr_t id)  //MAKEINTRESOURCE
+	{
+		return (const wchar_t*)id;
+	}
+
+	Bytes ReadFile(const std::string& path)
+	{
+		std::ifstream file(path.c_str(),std::ios::binary);
+
+
+		return Bytes(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+	}
+
+	std::wstring Widen(const char* text)
+	{
+		return std::wstring(text,text + std::strlen(text));
+	}
+
+	Bytes GetData(const ResourcePack::Entry& entry)
+	{
+		const std::uint8_t* data = (const std::uint8_t*)entry.data;
+		Bytes original(entry.original_size);
+
+
+		if(!entry.compressed)
+		{
+			return Bytes(data,data + entry.size);
+		}
+		if(!Compression::Decompress(data,entry.size,original.data(),original.size()))
+		{
+			return Bytes();
+		}
+
+		return original;
+	}
+
+	void TestPack(const ResourcePack& pack,bool compressed)
+	{
+		ResourcePack::Entry entry;
+		bool any_compressed = false;
+
+
+		TEST_CHECK(pack.getResourceCount() == 12);  //Four documents and eight strings.
+
+		for(const XmlResource& resource : XML_RESOURCES)  //Looked up by a string type and by integer or string names.
+		{
+			if(TEST_CHECK(pack.findResource(L"XML",resource.name,NEUTRAL_LANGUAGE,entry)))
+			{
+				TEST_CHECK(GetData(entry) == ReadFile(std::string(RESOURCE_DIRECTORY) + resource.path));
+				TEST_CHECK(((std::uintptr_t)entry.data & 15) == 0);
+				any_compressed = any_compressed || entry.compressed;
+			}
+		}
+		TEST_CHECK(any_compressed == compressed);
+
+		for(const StringResource& resource : STRING_RESOURCES)  //Stored as UTF-16 without a terminator.
+		{
+			if(TEST_CHECK(pack.findResource(RT_STRING_TYPE,MakeIdentifier(resource.id),NEUTRAL_LANGUAGE,entry)))
+			{
+				Bytes expected;
+
+
+				for(const char* character = resource.text;*character != 0;++character)
+				{
+					expected.push_back((std::uint8_t)*character);
+					expected.push_back(0);
+				}
+				TEST_CHECK(GetData(entry) == expected);
+			}
+		}
+
+		TEST_CHECK(pack.findResource(L"xml",MakeIdentifier(Application_Config),0x0409,entry) == false);  //Neither the type nor the language match.
+		TEST_CHECK(pack.findResource(L"XML",MakeIdentifier(Application_Config),0x0409,entry) == false);  //Only a neutral language falls back.
+		TEST_CHECK(pack.findResource(L"XML",MakeIdentifier(Application_Title),NEUTRAL_LANGUAGE,entry) == false);
+		TEST_CHECK(pack.findResource(L"XML",L"APPLICATION_CONFIG",NEUTRAL_LANGUAGE,entry) == false);  //Defined names were packed as integers.
+		TEST_CHECK(pack.findResource(L"XML",L"APPLICATION_U",NEUTRAL_LANGUAGE,entry) == false);
+		TEST_CHECK(pack.findResource(L"XML",L"APPLICATION_UIX",NEUTRAL_LANGUAGE,entry) == false);
+		TEST_CHECK(pack.findResource(L"XÉML\U0001F600",MakeIdentifier(Application_Config),NEUTRAL_LANGUAGE,entry) == false);
+	}
+
+	bool Throws(const Bytes& data)
+	{
+		std::vector<std::uint32_t> aligned((data.size() + 3) / 4);
+
+
+		if(!data.empty())
+		{
+			std::memcpy(aligned.data(),data.data(),data.size());
+		}
+
+		try
+		{
+			ResourcePack pack(aligned.data(),data.size());
+		}
+		catch(const std::runtime_error&)
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+	void TestInvalidPacks()
+	{
+		Bytes valid = ReadFile(RESOURCE_PACK);
+		Bytes damaged;
+
+
+		TEST_CHECK(!Throws(valid));
+		TEST_CHECK(Throws(Bytes()));
+		TEST_CHECK(Throws(Bytes(valid.begin(),valid.begin() + 20)));  //Shorter than the header.
+		TEST_CHECK(Throws(Bytes(valid.begin(),valid.begin() + 100)));  //The tables run past the end.
+
+		damaged = valid;
+		damaged[0] = 'X';
+		TEST_CHECK(Throws(damaged));
+
+		damaged = valid;
+		damaged[4] = 1;  //Version.
+		TEST_CHECK(Throws(damaged));
+
+		damaged = valid;
+		std::memset(&damaged[32 + 4],0xFF,4);  //The first entry's name lies beyond the names.
+		TEST_CHECK(Throws(damaged));
+
+		try
+		{
+			ResourcePack pack(L"/nonexistent/Resources.pack");
+
+
+			TEST_CHECK(false);
+		}
+		catch(const std::runtime_error&)
+		{
+		}
+	}
+}
+
+int main()
+{
+	ResourcePack pack(Widen(RESOURCE_PACK));
+	ResourcePack compressed_pack(Widen(COMPRESSED_RESOURCE_PACK));
+	Bytes data = ReadFile(RESOURCE_PACK);
+	std::vector<std::uint32_t> aligned((data.size() + 3) / 4);
+
+
+	TestPack(pack,false);
+	TestPack(compressed_pack,true);
+
+	std::memcpy(aligned.data(),data.data(),data.size());
+	{
+		ResourcePack memory_pack(aligned.data(),data.size());
+
+
+		TestPack(memory_pack,false);
+	}
+
+	TestInvalidPacks();
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "Statistics.h"
+#include "Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using Statistics::Distribution;
+using Statistics::Histogram;
+
+
+namespace
+{
+	std::uint64_t random_state = 0x0123456789ABCDEF;
+
+	std::uint64_t Random()  //xorshift64, so that every run tests the same cases.
+	{
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 7;
+		random_state ^= random_state << 17;
+
+		return random_state;
+	}
+
+	std::uint64_t RandomLatency()  //Spread over many orders of magnitude, as latencies are.
+	{
+		return Random() >> (24 + Random() % 40);
+	}
+
+	void TestBuckets()
+	{
+		int previous = 0;
+
+
+		for(int bucket = 0;bucket < Statistics::BUCKETS;++bucket)  //Every bucket's lower bound is the first value counted in it.
+		{
+			std::uint64_t lower_bound = Statistics::GetBucketLowerBound(bucket);
+
+
+			TEST_CHECK(Statistics::GetBucket(lower_bound) == bucket);
+			if(bucket > 0)
+			{
+				TEST_CHECK(Statistics::GetBucket(lower_bound - 1) == bucket - 1);
+			}
+		}
+
+		for(int trial = 0;trial < 100000;++trial)  //Buckets are in order and no wider than 1 / SUB_BUCKETS of their values.
+		{
+			std::uint64_t value = RandomLatency();
+			int bucket = Statistics::GetBucket(value);
+			std::uint64_t lower_bound = Statistics::GetBucketLowerBound(bucket);
+
+
+			TEST_CHECK(bucket >= 0 && bucket < Statistics::BUCKETS);
+			TEST_CHECK(lower_bound <= value);
+			if(bucket < Statistics::BUCKETS - 1)
+			{
+				TEST_CHECK(value - lower_bound <= lower_bound / Statistics::SUB_BUCKETS);
+			}
+		}
+
+		for(std::uint64_t value = 0;value < 100000;++value)
+		{
+			int bucket = Statistics::GetBucket(value);
+
+
+			TEST_CHECK(bucket >= previous);
+			previous = bucket;
+		}
+
+		TEST_CHECK(Statistics::GetBucket(~(std::uint64_t)0) == Statistics::BUCKETS - 1);
+	}
+
+	void TestPercentiles()
+	{
+		Histogram histogram;
+		Distribution distribution;
+		std::vector<std::uint64_t> values;
+		double fractions[] = {0.0,0.01,0.25,0.5,0.9,0.99,0.999,1.0};
+		double total = 0;
+
+
+		TEST_CHECK(distribution.getPercentile(0.5) == 0 && distribution.getMean() == 0.0);
+
+		for(int index = 0;index < 50000;++index)
+		{
+			values.push_back(RandomLatency());
+			histogram.record(values.back());
+			total += (double)values.back();
+		}
+		histogram.addTo(distribution);
+		std::sort(values.begin(),values.end());
+
+		TEST_CHECK(distribution.count == values.size());
+		TEST_CHECK(distribution.maximum == values.back());
+		TEST_CHECK(distribution.getMean() == total / values.size());
+
+		for(double fraction : fractions)  //Never below the exact percentile, and within a bucket's width above it.
+		{
+			size_t rank = std::max<size_t>((size_t)(fraction * values.size() + 0.5),1);
+			std::uint64_t exact = values[rank - 1];
+			std::uint64_t estimate = distribution.getPercentile(fraction);
+
+
+			if(!TEST_CHECK(estimate >= exact && estimate <= exact + exact / Statistics::SUB_BUCKETS + 1 && estimate <= values.back()))
+			{
+				std::fprintf(stderr,"Percentile %g is %llu rather than about %llu.\n",fraction,(unsigned long long)estimate,(unsigned long long)exact);
+			}
+		}
+
+		histogram.reset();
+		distribution = Distribution();
+		histogram.addTo(distribution);
+		TEST_CHECK(distribution.count == 0 && distribution.maximum == 0 && distribution.total == 0);
+	}
+
+	void TestConcurrentReading()  //A reader never sees a count go backwards, and sees everything once the writer is done.
+	{
+		const std::uint64_t VALUES = 32 * 0x10000;
+		Histogram histogram;
+		std::atomic<bool> done(false);
+		bool monotonic = true;
+		std::thread writer([&]()
+		{
+			for(std::uint64_t value = 0;value < VALUES;++value)
+			{
+				histogram.record(value & 0xFFFF);
+			}
+			done = true;
+		});
+		std::uint64_t previous = 0;
+		Distribution final_distribution;
+
+
+		while(!done)
+		{
+			Distribution distribution;
+
+
+			histogram.addTo(distribution);
+			monotonic = monotonic && distribution.count >= previous;
+			previous = distribution.count;
+		}
+		writer.join();
+
+		histogram.addTo(final_distribution);
+		TEST_CHECK(monotonic);
+		TEST_CHECK(final_distribution.count == VALUES);
+		TEST_CHECK(final_distribution.maximum == 0xFFFF);
+		TEST_CHECK(final_distribution.total == (VALUES / 0x10000) * (0xFFFFull * 0x10000 / 2));
+	}
+}
+
+int main()
+{
+	TestBuckets();
+	TestPercentiles();
+	TestConcurrentReading();
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+
+namespace
+{
+	/* Constants */
+	const int WINDOWS = 3;
+
+	UINT last_position_flags = 0;  //Of the last SetWindowPos received by any window.
+
+	bool Counts(size_t styles_written,size_t positions_set)  //Of native calls since the counts were last reset.
+	{
+		return Headless::GetCallCount("SetWindowLongPtr") == styles_written && Headless::GetCallCount("SetWindowPos") == positions_set;
+	}
+
+	bool FrameChanged()
+	{
+		return (last_position_flags & SWP_FRAMECHANGED) != 0;
+	}
+
+	void TestSingleChanges(OS::Window* window)
+	{
+		/* A style which leaves the frame alone is written, and nothing more. */
+		Headless::ResetCallCounts();
+		window->addStyle(WS_CLIPCHILDREN);
+		TEST_CHECK(Counts(1,0));
+		window->removeStyle(WS_CLIPCHILDREN);
+		window->addExtendedStyle(WS_EX_TRANSPARENT);
+		TEST_CHECK(Counts(3,0));
+		TEST_CHECK((window->getStyle() & WS_CLIPCHILDREN) == 0 && (window->getExtendedStyle() & WS_EX_TRANSPARENT) != 0);
+
+		/* One which changes the frame has it recalculated. */
+		Headless::ResetCallCounts();
+		window->addStyle(WS_THICKFRAME);
+		TEST_CHECK(Counts(1,1) && FrameChanged());
+		window->addExtendedStyle(WS_EX_CLIENTEDGE);
+		TEST_CHECK(Counts(2,2) && FrameChanged());
+
+		/* Nothing is written for a style which is already as requested. */
+		Headless::ResetCallCounts();
+		window->addStyle(WS_THICKFRAME);
+		window->removeExtendedStyle(WS_EX_STATICEDGE);
+		TEST_CHECK(Counts(0,0));
+
+		/* Showing and hiding go through SetWindowPos alone. */
+		Headless::ResetCallCounts();
+		window->setVisible(true);
+		TEST_CHECK(Counts(0,1) && !FrameChanged() && window->isVisible());
+		window->setVisible(false);
+		TEST_CHECK(Counts(0,2) && !FrameChanged() && !window->isVisible());
+	}
+
+	void TestTransactions(OS::Window** windows)
+	{
+		/* Within a transaction, each window's styles are written once, with a single SetWindowPos if its frame changed. */
+		Headless::ResetCallCounts();
+		{
+			OS::StyleEdit edit;
+
+
+			for(int index = 0;index < WINDOWS;++index)
+			{
+				edit.addStyle(windows[index],WS_BORDER);
+				edit.addStyle(windows[index],WS_VSCROLL);
+				edit.removeStyle(windows[index],WS_CLIPSIBLINGS);
+				edit.addExtendedStyle(windows[index],WS_EX_STATICEDGE);
+			}
+			TEST_CHECK(Counts(0,0));
+		}
+		TEST_CHECK(Counts(2 * WINDOWS,WINDOWS) && FrameChanged());
+		TEST_CHECK((windows[0]->getStyle() & (WS_BORDER | WS_VSCROLL)) == (WS_BORDER | WS_VSCROLL) && (windows[0]->getExtendedStyle() & WS_EX_STATICEDGE) != 0);
+
+		/* Without any change to the frame, there is none. */
+		Headless::ResetCallCounts();
+		{
+			OS::StyleEdit edit;
+
+
+			for(int index = 0;index < WINDOWS;++index)
+			{
+				edit.addStyle(windows[index],WS_CLIPCHILDREN);
+				edit.addExtendedStyle(windows[index],WS_EX_NOPARENTNOTIFY);
+			}
+		}
+		TEST_CHECK(Counts(2 * WINDOWS,0));
+
+		/* Changes which cancel out cost nothing. */
+		Headless::ResetCallCounts();
+		{
+			OS::StyleEdit edit;
+
+
+			edit.addStyle(windows[0],WS_HSCROLL);
+			edit.removeStyle(windows[0],WS_HSCROLL);
+			edit.removeExtendedStyle(windows[0],WS_EX_STATICEDGE);
+			edit.addExtendedStyle(windows[0],WS_EX_STATICEDGE);
+		}
+		TEST_CHECK(Counts(0,0));
+	}
+
+	void TestDeferredWindows(OS::WindowClass* window_class)
+	{
+		OS::Window* window = window_class->instantiate(L"Deferred",true);
+
+
+		/* The styles of a window which has not been realized are only recorded, and it is created with them. */
+		Headless::ResetCallCounts();
+		window->addStyle(WS_THICKFRAME);
+		window->addExtendedStyle(WS_EX_CLIENTEDGE);
+		TEST_CHECK(Counts(0,0));
+		window->realize();
+		TEST_CHECK((GetWindowLongPtr(window->getNativeHandle(),GWL_STYLE) & WS_THICKFRAME) != 0);
+		TEST_CHECK((GetWindowLongPtr(window->getNativeHandle(),GWL_EXSTYLE) & WS_EX_CLIENTEDGE) != 0);
+
+		window->destroy();
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"StyleEditWindow");
+	OS::Window* windows[WINDOWS];
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED | WS_CLIPSIBLINGS,0,0,0,100,100);
+	window_class->setDefaultMessageHandler(WM_WINDOWPOSCHANGING,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+		last_position_flags = ((WINDOWPOS*)l_param)->flags;
+
+		return 0;
+	});
+	for(OS::Window*& window : windows)
+	{
+		window = window_class->instantiate(L"Styled");
+	}
+
+	TestSingleChanges(windows[0]);
+	TestTransactions(windows);
+	TestDeferredWindows(window_class);
+
+	for(OS::Window* window : windows)
+	{
+		window->destroy();
+	}
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "Test.h"
+
+#include <cstdio>
+
+
+namespace
+{
+	unsigned checks = 0;
+	unsigned failures = 0;
+}
+
+namespace Test
+{
+	/* Function Definitions */
+	bool Check(bool condition,const char* expression,const char* file,int line)
+	{
+		++checks;
+		if(!condition)
+		{
+			++failures;
+			std::fprintf(stderr,"%s:%d: check failed: %s\n",file,line,expression);
+		}
+
+		return condition;
+	}
+
+	int GetResult()
+	{
+		std::printf("%u of %u checks failed.\n",failures,checks);
+
+		return failures == 0 ? 0 : 1;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef TEST_H
+#define TEST_H
+
+/**
+ * Checks a condition, reporting it along with where it was made if it does not hold.
+ */
+#define TEST_CHECK(condition) Test::Check((condition),#condition,__FILE__,__LINE__)
+
+
+/**
+ * Minimal checking shared by the tests, each of which is a plain program run by CTest.  Failed checks are reported and counted rather than ending the test, and main returns Test::GetResult().
+ */
+namespace Test
+{
+	/* Function Prototypes */
+	/**
+	 * @return Returns the condition.
+	 */
+	bool Check(bool condition,const char* expression,const char* file,int line);
+
+	/**
+	 * Reports how many checks failed.
+	 *
+	 * @return Returns the exit status of the test: 0 if every check held, 1 otherwise.
+	 */
+	int GetResult();
+}
+
+#endif
\ No newline at end of file
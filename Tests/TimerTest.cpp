@@ -0,0 +1,160 @@
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+#include <chrono>
+#include <thread>
+
+
+namespace
+{
+	/* Constants */
+	const UINT DELAY = 1;  //Milliseconds, which the native timer rounds up to its minimum.
+	const UINT LONG_DELAY = 3600000;
+
+	template<typename Condition>
+	bool PumpUntil(Condition condition)
+	{
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+
+		while(!condition())
+		{
+			if(std::chrono::steady_clock::now() > deadline)
+			{
+				return false;
+			}
+
+			Headless::PumpMessages();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return true;
+	}
+
+	void Pump(int milliseconds)  //Long enough for any timer which is due to fire.
+	{
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+
+
+		PumpUntil([deadline](){
+			return std::chrono::steady_clock::now() > deadline;
+		});
+	}
+
+	void TestCancelAfterFire(OS::Window* window)
+	{
+		int first_fired = 0;
+		int second_fired = 0;
+		UINT_PTR first;
+		UINT_PTR second;
+		size_t active = OS::GetTimerStatistics().active;
+
+
+		/* A timer which has fired is forgotten, and cancelling it afterwards does nothing. */
+		first = window->setTimer(DELAY,[&first_fired](OS::Window* window){
+			++first_fired;
+		},false);
+		TEST_CHECK(PumpUntil([&first_fired](){
+			return first_fired == 1;
+		}));
+		TEST_CHECK(OS::GetTimerStatistics().active == active);
+		window->cancelTimer(first);
+		TEST_CHECK(OS::GetTimerStatistics().active == active);
+
+		/* Nor does it cancel the timer which took its place, whose identifier is of a later generation. */
+		second = window->setTimer(DELAY,[&second_fired](OS::Window* window){
+			++second_fired;
+		},false);
+		TEST_CHECK(second != first);
+		window->cancelTimer(first);
+		TEST_CHECK(OS::GetTimerStatistics().active == active + 1);
+		TEST_CHECK(PumpUntil([&second_fired](){
+			return second_fired == 1;
+		}));
+		TEST_CHECK(first_fired == 1);
+	}
+
+	void TestCancelWhileFiring(OS::Window* window)
+	{
+		int fired = 0;
+		UINT_PTR timer = 0;
+		UINT_PTR other = 0;
+		UINT_PTR timers[2];
+		size_t active = OS::GetTimerStatistics().active;
+
+
+		/* A repeating timer cancelled by its own handler fires no more, and its entry is only reused once the handler returns. */
+		timer = window->setTimer(DELAY,[&](OS::Window* window){
+			++fired;
+			window->cancelTimer(timer);
+			other = window->setTimer(LONG_DELAY,[](OS::Window* window){
+			});
+		});
+		TEST_CHECK(PumpUntil([&fired](){
+			return fired == 1;
+		}));
+		Pump(50);
+		TEST_CHECK(fired == 1);
+		TEST_CHECK(other != timer && OS::GetTimerStatistics().active == active + 1);
+		window->cancelTimer(timer);  //Stale.
+		TEST_CHECK(OS::GetTimerStatistics().active == active + 1);
+		window->cancelTimer(other);
+		TEST_CHECK(OS::GetTimerStatistics().active == active);
+
+		/* Of two timers, whichever fires first can cancel the other, even when both come due in the same batch. */
+		fired = 0;
+		for(int index = 0;index < 2;++index)
+		{
+			timers[index] = window->setTimer(DELAY,[&fired,&timers,index](OS::Window* window){
+				++fired;
+				window->cancelTimer(timers[1 - index]);
+			},false);
+		}
+		TEST_CHECK(PumpUntil([&fired](){
+			return fired > 0;
+		}));
+		Pump(50);
+		TEST_CHECK(fired == 1);
+		TEST_CHECK(OS::GetTimerStatistics().active == active);
+	}
+
+	void TestOtherWindows(OS::Window* window,OS::Window* other_window)
+	{
+		UINT_PTR timer = window->setTimer(LONG_DELAY,[](OS::Window* window){
+		});
+		size_t active = OS::GetTimerStatistics().active;
+
+
+		/* A timer is only cancelled through the window which set it, or by destroying that window. */
+		other_window->cancelTimer(timer);
+		TEST_CHECK(OS::GetTimerStatistics().active == active);
+		window->setTimer(LONG_DELAY,[](OS::Window* window){
+		});
+		window->destroy();
+		TEST_CHECK(OS::GetTimerStatistics().active == active - 1);
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"TimerWindow");
+	OS::Window* window;
+	OS::Window* other_window;
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,100,100);
+	window = window_class->instantiate(L"Timed");
+	other_window = window_class->instantiate(L"Other");
+
+	TestCancelAfterFire(window);
+	TestCancelWhileFiring(window);
+	TestOtherWindows(window,other_window);
+	TEST_CHECK(OS::GetTimerStatistics().active == 0);
+
+	other_window->destroy();
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
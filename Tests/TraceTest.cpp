@@ -0,0 +1,408 @@
+#define TRACING_ENABLED 1  //Whatever the build, so that TRACE_SCOPE records.
+
+#include "Test.h"
+#include "Trace.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	/* Constants */
+	const char* ESCAPED_NAME = "Quote \" and backslash \\";
+	const size_t THREADS = 3;
+	const size_t SCOPES_PER_THREAD = 100;
+	const size_t EXTRA_SCOPES = 5;  //Beyond a thread's buffer.
+	const wchar_t* TRACE_PATH = L"TraceTest.json";  //In the working directory.
+
+	/**
+	 * A JSON value, as much of one as a trace needs.
+	 */
+	struct Value
+	{
+		enum class Type
+		{
+			NUL,
+			BOOLEAN,
+			NUMBER,
+			STRING,
+			ARRAY,
+			OBJECT
+		} type;
+		double number;
+		std::string string;
+		std::vector<Value> elements;
+		std::vector<std::pair<std::string,Value>> members;
+
+		const Value* getMember(const char* name) const
+		{
+			for(const auto& member : this->members)
+			{
+				if(member.first == name)
+				{
+					return &member.second;
+				}
+			}
+
+			return nullptr;
+		}
+	};
+
+	/**
+	 * Parses JSON strictly, so that anything chrome://tracing would reject fails.
+	 */
+	class Parser
+	{
+		private:
+			const std::string& json;
+			size_t offset;
+
+			void skipWhitespace()
+			{
+				while(this->offset < this->json.size() && std::strchr(" \t\r\n",this->json[this->offset]) != nullptr)
+				{
+					++this->offset;
+				}
+			}
+
+			bool consume(char character)
+			{
+				this->skipWhitespace();
+				if(this->offset < this->json.size() && this->json[this->offset] == character)
+				{
+					++this->offset;
+
+					return true;
+				}
+
+				return false;
+			}
+
+			bool parseString(std::string& string)
+			{
+				if(!this->consume('"'))
+				{
+					return false;
+				}
+
+				while(this->offset < this->json.size())
+				{
+					char character = this->json[this->offset++];
+
+
+					if(character == '"')
+					{
+						return true;
+					}
+					if((unsigned char)character < 0x20)
+					{
+						return false;
+					}
+					if(character == '\\')
+					{
+						if(this->offset == this->json.size() || std::strchr("\"\\/bfnrt",this->json[this->offset]) == nullptr)  //\u escapes are never written.
+						{
+							return false;
+						}
+						character = this->json[this->offset++];
+					}
+					string.push_back(character);
+				}
+
+				return false;
+			}
+
+			bool parseValue(Value& value)
+			{
+				this->skipWhitespace();
+				if(this->offset == this->json.size())
+				{
+					return false;
+				}
+
+				switch(this->json[this->offset])
+				{
+					case '{':
+						value.type = Value::Type::OBJECT;
+						++this->offset;
+						if(this->consume('}'))
+						{
+							return true;
+						}
+						do
+						{
+							std::pair<std::string,Value> member;
+
+
+							if(!this->parseString(member.first) || !this->consume(':') || !this->parseValue(member.second))
+							{
+								return false;
+							}
+							value.members.push_back(member);
+						}
+						while(this->consume(','));
+
+						return this->consume('}');
+
+					case '[':
+						value.type = Value::Type::ARRAY;
+						++this->offset;
+						if(this->consume(']'))
+						{
+							return true;
+						}
+						do
+						{
+							value.elements.emplace_back();
+							if(!this->parseValue(value.elements.back()))
+							{
+								return false;
+							}
+						}
+						while(this->consume(','));
+
+						return this->consume(']');
+
+					case '"':
+						value.type = Value::Type::STRING;
+
+						return this->parseString(value.string);
+
+					default:
+					{
+						const char* start = this->json.c_str() + this->offset;
+						char* end;
+
+
+						if(this->json.compare(this->offset,4,"true") == 0 || this->json.compare(this->offset,4,"null") == 0)
+						{
+							value.type = this->json[this->offset] == 't' ? Value::Type::BOOLEAN : Value::Type::NUL;
+							this->offset += 4;
+
+							return true;
+						}
+						if(this->json.compare(this->offset,5,"false") == 0)
+						{
+							value.type = Value::Type::BOOLEAN;
+							this->offset += 5;
+
+							return true;
+						}
+						if(*start != '-' && (*start < '0' || *start > '9'))  //strtod would also take "inf", "nan" and hexadecimal.
+						{
+							return false;
+						}
+						value.type = Value::Type::NUMBER;
+						value.number = std::strtod(start,&end);
+						this->offset += end - start;
+
+						return end != start;
+					}
+				}
+			}
+
+		public:
+			Parser(const std::string& json)
+			: json(json),offset(0)
+			{
+			}
+
+			bool parse(Value& value)
+			{
+				if(!this->parseValue(value))
+				{
+					return false;
+				}
+				this->skipWhitespace();
+
+				return this->offset == this->json.size();
+			}
+	};
+
+	std::string ReadFile(const wchar_t* path)
+	{
+		std::ifstream file(std::string(path,path + std::wcslen(path)).c_str(),std::ios::binary);
+
+
+		return std::string(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+	}
+
+	bool IsNumber(const Value* value)
+	{
+		return value != nullptr && value->type == Value::Type::NUMBER;
+	}
+
+	bool IsCompleteEvent(const Value& event)  //As chrome://tracing expects one.
+	{
+		const Value* name = event.getMember("name");
+		const Value* phase = event.getMember("ph");
+		const Value* duration = event.getMember("dur");
+
+
+		return event.type == Value::Type::OBJECT && event.members.size() == 6 && name != nullptr && name->type == Value::Type::STRING && phase != nullptr && phase->string == "X" && IsNumber(event.getMember("ts")) && IsNumber(duration) && duration->number >= 0 && IsNumber(event.getMember("pid")) && IsNumber(event.getMember("tid"));
+	}
+
+	/**
+	 * Parses a trace and checks that it is well-formed and that each of its events is a complete event.
+	 *
+	 * @return Returns the events, or an empty vector if the trace is not well-formed.
+	 */
+	std::vector<Value> GetEvents(const std::string& json)
+	{
+		Value trace;
+		const Value* events;
+		bool complete = true;
+
+
+		if(!TEST_CHECK(Parser(json).parse(trace) && trace.type == Value::Type::OBJECT))
+		{
+			return std::vector<Value>();
+		}
+		events = trace.getMember("traceEvents");
+		if(!TEST_CHECK(events != nullptr && events->type == Value::Type::ARRAY))
+		{
+			return std::vector<Value>();
+		}
+
+		for(const Value& event : events->elements)
+		{
+			complete = complete && IsCompleteEvent(event);
+		}
+		TEST_CHECK(complete);
+
+		return events->elements;
+	}
+
+	size_t CountEvents(const std::vector<Value>& events,const char* name)
+	{
+		size_t count = 0;
+
+
+		for(const Value& event : events)
+		{
+			const Value* event_name = event.getMember("name");
+
+
+			if(event_name != nullptr && event_name->string == name)
+			{
+				++count;
+			}
+		}
+
+		return count;
+	}
+
+	void RecordScopes()
+	{
+		for(size_t scope = 0;scope < SCOPES_PER_THREAD;++scope)
+		{
+			TRACE_SCOPE("Thread");
+		}
+	}
+
+	void TestEvents()
+	{
+		std::vector<std::thread> threads;
+		std::vector<Value> events;
+		std::set<double> thread_ids;
+		const Value* outer = nullptr;
+		const Value* inner = nullptr;
+
+
+		/* Every scope of every thread becomes one event, and names are escaped. */
+		{
+			TRACE_SCOPE("Outer");
+
+
+			{
+				Trace::Scope scope(ESCAPED_NAME);
+			}
+		}
+		for(size_t thread = 0;thread < THREADS;++thread)
+		{
+			threads.emplace_back(RecordScopes);
+		}
+		for(std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		events = GetEvents(Trace::GetChromeTrace());
+		TEST_CHECK(events.size() == 2 + THREADS * SCOPES_PER_THREAD);
+		TEST_CHECK(CountEvents(events,ESCAPED_NAME) == 1 && CountEvents(events,"Thread") == THREADS * SCOPES_PER_THREAD);
+		for(const Value& event : events)
+		{
+			if(event.getMember("name")->string == "Thread")
+			{
+				thread_ids.insert(event.getMember("tid")->number);
+			}
+			else if(event.getMember("name")->string == "Outer")
+			{
+				outer = &event;
+			}
+			else
+			{
+				inner = &event;
+			}
+		}
+		TEST_CHECK(thread_ids.size() == THREADS);
+
+		/* A scope within another lies within it. */
+		if(TEST_CHECK(outer != nullptr && inner != nullptr))
+		{
+			TEST_CHECK(inner->getMember("ts")->number >= outer->getMember("ts")->number);
+			TEST_CHECK(inner->getMember("ts")->number + inner->getMember("dur")->number <= outer->getMember("ts")->number + outer->getMember("dur")->number);
+			TEST_CHECK(inner->getMember("tid")->number == outer->getMember("tid")->number);
+		}
+	}
+
+	void TestDroppedEvents()
+	{
+		/* Once its buffer is full, a thread's events are counted and dropped, until the trace is reset. */
+		Trace::Reset();
+		TEST_CHECK(GetEvents(Trace::GetChromeTrace()).empty());
+		for(size_t scope = 0;scope < Trace::EVENTS_PER_THREAD + EXTRA_SCOPES;++scope)
+		{
+			TRACE_SCOPE("Filling");
+		}
+		TEST_CHECK(Trace::GetDroppedEventCount() == EXTRA_SCOPES);
+		TEST_CHECK(GetEvents(Trace::GetChromeTrace()).size() == Trace::EVENTS_PER_THREAD);
+
+		Trace::Reset();
+		TEST_CHECK(Trace::GetDroppedEventCount() == 0);
+	}
+
+	void TestFile()
+	{
+		std::string json;
+
+
+		/* The file holds the trace as it was when written. */
+		{
+			TRACE_SCOPE("Written");
+		}
+		json = Trace::GetChromeTrace();
+		TEST_CHECK(Trace::WriteChromeTrace(TRACE_PATH));
+		TEST_CHECK(ReadFile(TRACE_PATH) == json);
+		TEST_CHECK(!Trace::WriteChromeTrace(L"/nonexistent/Trace.json"));
+	}
+}
+
+
+int main()
+{
+	TestEvents();
+	TestDroppedEvents();
+	TestFile();
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "Application.h"
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+std::wstring handler_log;  //The handlers called, in order, each followed by a space.
+
+
+EXPORT void UIClassTest_Base_OnCreate(OS::Window& window)
+{
+	handler_log += L"Base.OnCreate ";
+}
+
+EXPORT void UIClassTest_Base_OnDestroy(OS::Window& window)
+{
+	handler_log += L"Base.OnDestroy ";
+}
+
+EXPORT void UIClassTest_Middle_OnCreate(OS::Window& window)
+{
+	handler_log += L"Middle.OnCreate ";
+}
+
+EXPORT void UIClassTest_Leaf_OnCreate(OS::Window& window)
+{
+	handler_log += L"Leaf.OnCreate ";
+}
+
+EXPORT void UIClassTest_Clicker_OnClick(OS::Window& window)
+{
+	handler_log += L"Clicker.OnClick ";
+}
+
+
+namespace
+{
+	/* Constants */
+	enum : WORD
+	{
+		UI_CLASS_WINDOW = 1,
+		UI_CLASS_PUSH_BUTTON,
+		UI_CLASS_BASE,
+		UI_CLASS_MIDDLE,
+		UI_CLASS_LEAF,
+		UI_CLASS_CLICKER,
+		UI_CLASS_DUPLICATE,
+		UI_CLASS_NOT_A_CLASS,
+		UI_CLASS_NAMELESS,
+		UI_CLASS_UNKNOWN_BASE,
+		UI_CLASS_UNKNOWN_EVENT,
+		UI_CLASS_MISSING_PROCEDURE,
+		UI_CLASS_BAD_INTEGER,
+		UI_CLASS_MALFORMED,
+		UI_CLASS_MISSING = 100
+	};
+
+	void AddDefinition(WORD resource_id,const std::string& definition)
+	{
+		Headless::AddResource(nullptr,L"XML",resource_id,definition.data(),definition.size());
+	}
+
+	void AddDefinitionFile(WORD resource_id,const char* path)
+	{
+		std::ifstream file(path,std::ios::binary);
+
+
+		AddDefinition(resource_id,std::string(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>()));
+	}
+
+	bool LoadFails(OS::Module& module,WORD resource_id)
+	{
+		try
+		{
+			OS::UIClass::Load(module,resource_id);
+		}
+		catch(const OS::RuntimeException&)
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+	void TestApplicationClasses(OS::Module& module)
+	{
+		OS::UIClass* window_class = OS::UIClass::Load(module,UI_CLASS_WINDOW);
+		OS::UIClass* push_button_class = OS::UIClass::Load(module,UI_CLASS_PUSH_BUTTON);
+		size_t window_count = Headless::GetWindowCount();
+		OS::Window* window;
+
+
+		TEST_CHECK(window_class->getName() == L"Window");
+		TEST_CHECK(window_class->getWindowClassName() == L"Window");
+		TEST_CHECK(window_class->hasCapability(L"ChildrenAllowed"));
+		TEST_CHECK(window_class->getPrototypeAttribute(L"title") == L"Untitled Window");
+		TEST_CHECK(push_button_class->getName() == L"PushButton");
+		TEST_CHECK(push_button_class->getWindowClassName() == L"Button");
+		TEST_CHECK(!push_button_class->hasCapability(L"ChildrenAllowed"));
+
+		TEST_CHECK(OS::UIClass::GetByName(L"Window") == window_class);
+		TEST_CHECK(OS::UIClass::GetByName(std::wstring(L"PushButton")) == push_button_class);
+		TEST_CHECK(OS::UIClass::GetByName(L"Missing") == nullptr);
+
+		/* The window's OnClose handler, UIClass_Window_OnClose, destroys it. */
+		window = window_class->instantiate();
+		TEST_CHECK(window->getName() == L"Untitled Window");
+		TEST_CHECK(Headless::GetWindowCount() == window_count + 1);
+		SendMessage(window->getNativeHandle(),WM_CLOSE,0,0);
+		TEST_CHECK(Headless::GetWindowCount() == window_count);
+		Headless::PumpMessages();  //Takes the quit message posted by the handler.
+	}
+
+	void TestInheritance(OS::Module& module)
+	{
+		OS::UIClass* base = OS::UIClass::Load(module,UI_CLASS_BASE);
+		OS::UIClass* middle = OS::UIClass::Load(module,UI_CLASS_MIDDLE);
+		OS::UIClass* leaf = OS::UIClass::Load(module,UI_CLASS_LEAF);
+		OS::Window* window;
+		RECT rectangle;
+
+
+		TEST_CHECK(OS::UIClass::Load(module,UI_CLASS_DUPLICATE) == base);  //Under the same name, whatever the resource.
+		TEST_CHECK(OS::UIClass::Load(module,UI_CLASS_BASE) == base);
+
+		/* Everything is inherited from the whole chain, and overridden by the class nearest the leaf. */
+		TEST_CHECK(leaf->getWindowClassName() == L"Window");
+		TEST_CHECK(leaf->hasCapability(L"ChildrenAllowed"));
+		TEST_CHECK(base->hasCapability(L"Resizable"));
+		TEST_CHECK(!leaf->hasCapability(L"Resizable"));
+		TEST_CHECK(leaf->getCapability(L"Resizable") == L"false");
+		TEST_CHECK(leaf->getCapability(L"Missing",L"fallback") == L"fallback");
+		TEST_CHECK(base->getPrototypeAttribute(L"title") == L"Base");
+		TEST_CHECK(middle->getPrototypeAttribute(L"title") == L"Middle");
+		TEST_CHECK(leaf->getPrototypeAttribute(L"title") == L"Middle");
+		TEST_CHECK(leaf->getPrototypeAttribute(L"height") == L"50");
+		TEST_CHECK(middle->getPrototypeAttribute(L"height") == L"100");
+
+		/* Handlers run from the base down, and the prototype's defaults are applied before any of them. */
+		handler_log.clear();
+		window = leaf->instantiate();
+		TEST_CHECK(handler_log == L"Base.OnCreate Middle.OnCreate Leaf.OnCreate ");
+		TEST_CHECK(window->getName() == L"Middle");
+		GetWindowRect(window->getNativeHandle(),&rectangle);
+		TEST_CHECK(rectangle.left == 5 && rectangle.top == 7);
+		TEST_CHECK(window->getWidth() == 200 && window->getHeight() == 50);
+
+		handler_log.clear();
+		window->destroy();
+		TEST_CHECK(handler_log == L"Base.OnDestroy ");
+
+		/* Realization may be deferred, but the OnCreate handlers are called all the same. */
+		handler_log.clear();
+		window = middle->instantiate(true);
+		TEST_CHECK(handler_log == L"Base.OnCreate Middle.OnCreate ");
+		window->destroy();
+
+		/* Unloading a class leaves those extending it as they are. */
+		OS::UIClass::Unload(base);
+		TEST_CHECK(base == nullptr);
+		TEST_CHECK(OS::UIClass::GetByName(L"Base") == nullptr);
+		TEST_CHECK(OS::UIClass::GetByName(L"Leaf") == leaf);
+		handler_log.clear();
+		leaf->instantiate()->destroy();
+		TEST_CHECK(handler_log == L"Base.OnCreate Middle.OnCreate Leaf.OnCreate Base.OnDestroy ");
+
+		OS::UIClass::Unload(leaf);
+		OS::UIClass::Unload(middle);
+	}
+
+	void TestNativeBase(OS::Module& module)
+	{
+		OS::UIClass* clicker = OS::UIClass::Load(module,UI_CLASS_CLICKER);
+		OS::Window* button;
+		size_t window_count;
+
+
+		TEST_CHECK(clicker->getWindowClassName() == L"Button");
+
+		handler_log.clear();
+		button = clicker->instantiate();
+		window_count = Headless::GetWindowCount();
+		SendMessage(button->getNativeHandle(),WM_LBUTTONUP,0,0);
+		SendMessage(button->getNativeHandle(),WM_LBUTTONUP,0,0);
+		TEST_CHECK(handler_log == L"Clicker.OnClick Clicker.OnClick ");
+		button->destroy();
+		TEST_CHECK(Headless::GetWindowCount() == window_count - 1);
+
+		OS::UIClass::Unload(clicker);
+	}
+
+	void TestStaticWindows(OS::Module& module,OS::WindowClass* window_class)
+	{
+		OS::UIClass* clicker = OS::UIClass::Load(module,UI_CLASS_CLICKER);
+		Application::MadButton* button;
+		Application::MainWindow* window;
+		HDC device_context;
+		size_t window_count;
+
+
+		/* The class's handlers extend the static ones, rather than replacing them. */
+		handler_log.clear();
+		button = clicker->instantiate<Application::MadButton>();
+		button->on_click = [](OS::Window& window){
+			handler_log += L"MadButton.on_click ";
+		};
+		button->on_destroy = [](OS::Window& window){
+			handler_log += L"MadButton.on_destroy ";
+		};
+		SendMessage(button->getNativeHandle(),WM_LBUTTONUP,0,0);
+		TEST_CHECK(handler_log == L"MadButton.on_click Clicker.OnClick ");
+		handler_log.clear();
+		button->destroy();
+		TEST_CHECK(handler_log == L"MadButton.on_destroy ");
+
+		/* A static handler is called in place of the class's. */
+		window_class->setDefaultMessageHandler(WM_ERASEBKGND,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+			return 2;
+		});
+		window_count = Headless::GetWindowCount();
+		window = OS::UIClass::GetByName(L"Window")->instantiate<Application::MainWindow>();
+		TEST_CHECK(window->getName() == L"Untitled Window");
+		device_context = GetDC(window->getNativeHandle());
+		TEST_CHECK(SendMessage(window->getNativeHandle(),WM_ERASEBKGND,(WPARAM)device_context,0) == 1);
+		ReleaseDC(window->getNativeHandle(),device_context);
+		SendMessage(window->getNativeHandle(),WM_CLOSE,0,0);  //Still destroyed by UIClass_Window_OnClose.
+		TEST_CHECK(Headless::GetWindowCount() == window_count);
+		Headless::PumpMessages();
+
+		OS::UIClass::Unload(clicker);
+	}
+
+	void TestErrors(OS::Module& module)
+	{
+		TEST_CHECK(LoadFails(module,UI_CLASS_NOT_A_CLASS));
+		TEST_CHECK(LoadFails(module,UI_CLASS_NAMELESS));
+		TEST_CHECK(LoadFails(module,UI_CLASS_UNKNOWN_BASE));
+		TEST_CHECK(LoadFails(module,UI_CLASS_UNKNOWN_EVENT));
+		TEST_CHECK(LoadFails(module,UI_CLASS_MISSING_PROCEDURE));
+		TEST_CHECK(LoadFails(module,UI_CLASS_BAD_INTEGER));
+		TEST_CHECK(LoadFails(module,UI_CLASS_MALFORMED));
+		TEST_CHECK(LoadFails(module,UI_CLASS_MISSING));
+
+		/* A class which failed to load is not left behind half-made. */
+		TEST_CHECK(OS::UIClass::GetByName(L"UnknownBase") == nullptr);
+		TEST_CHECK(OS::UIClass::GetByName(L"MissingProcedure") == nullptr);
+	}
+}
+
+
+int main()
+{
+	OS::Module module(GetModuleHandle(nullptr));
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"Window");
+	OS::UIClass* ui_class;
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,640,480);
+
+	AddDefinitionFile(UI_CLASS_WINDOW,RESOURCE_DIRECTORY "UIClass/Window.xml");
+	AddDefinitionFile(UI_CLASS_PUSH_BUTTON,RESOURCE_DIRECTORY "UIClass/PushButton.xml");
+	AddDefinition(UI_CLASS_BASE,
+		"<UIClass><Name>Base</Name><Extends>Window</Extends>"
+		"<Capabilities><Resizable>true</Resizable></Capabilities>"
+		"<LifecycleHandlers><OnCreate>UIClassTest_Base_OnCreate</OnCreate><OnDestroy>UIClassTest_Base_OnDestroy</OnDestroy></LifecycleHandlers>"
+		"<Prototype title=\"Base\" width=\"200\" height=\"100\"/></UIClass>");
+	AddDefinition(UI_CLASS_MIDDLE,
+		"<UIClass><Name>Middle</Name><Extends>Base</Extends>"
+		"<LifecycleHandlers><OnCreate>UIClassTest_Middle_OnCreate</OnCreate></LifecycleHandlers>"
+		"<Prototype title=\"Middle\" x=\"5\" y=\"7\"/></UIClass>");
+	AddDefinition(UI_CLASS_LEAF,
+		"<UIClass><Name>Leaf</Name><Extends>Middle</Extends>"
+		"<Capabilities><Resizable>false</Resizable></Capabilities>"
+		"<Prototype height=\"50\" onCreate=\"UIClassTest_Leaf_OnCreate\"/></UIClass>");
+	AddDefinition(UI_CLASS_CLICKER,
+		"<UIClass><Name>Clicker</Name><Extends>PushButton</Extends>"
+		"<LifecycleHandlers><OnClick>UIClassTest_Clicker_OnClick</OnClick></LifecycleHandlers></UIClass>");
+	AddDefinition(UI_CLASS_DUPLICATE,"<UIClass><Name>base</Name><Extends>Nothing</Extends></UIClass>");
+	AddDefinition(UI_CLASS_NOT_A_CLASS,"<UI><Name>Base</Name></UI>");
+	AddDefinition(UI_CLASS_NAMELESS,"<UIClass><Extends>Window</Extends></UIClass>");
+	AddDefinition(UI_CLASS_UNKNOWN_BASE,"<UIClass><Name>UnknownBase</Name><Extends>Nothing</Extends></UIClass>");
+	AddDefinition(UI_CLASS_UNKNOWN_EVENT,"<UIClass><Name>UnknownEvent</Name><Extends>Window</Extends><LifecycleHandlers><OnHover>UIClassTest_Base_OnCreate</OnHover></LifecycleHandlers></UIClass>");
+	AddDefinition(UI_CLASS_MISSING_PROCEDURE,"<UIClass><Name>MissingProcedure</Name><Extends>Window</Extends><LifecycleHandlers><OnCreate>UIClassTest_Missing</OnCreate></LifecycleHandlers></UIClass>");
+	AddDefinition(UI_CLASS_BAD_INTEGER,"<UIClass><Name>BadInteger</Name><Extends>Window</Extends><Prototype width=\"wide\"/></UIClass>");
+	AddDefinition(UI_CLASS_MALFORMED,"<UIClass><Name>Malformed</Name>");
+
+	TestApplicationClasses(module);
+	TestInheritance(module);
+	TestNativeBase(module);
+	TestErrors(module);
+	TestStaticWindows(module,window_class);
+
+	for(const wchar* name : {L"PushButton",L"Window"})
+	{
+		ui_class = OS::UIClass::GetByName(name);
+		OS::UIClass::Unload(ui_class);
+	}
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+#include "VirtualList.h"
+
+#include <set>
+#include <vector>
+
+
+namespace
+{
+	/* Constants */
+	const size_t ROWS = 1000000;
+	const int ROW_HEIGHT = 20;
+	const int VISIBLE_ROWS = 5;  //Of the list's 100 pixels.
+	const int COLUMNS = 2;
+
+	struct Binding
+	{
+		OS::Window* cell;
+		size_t row;
+		size_t column;
+	};
+
+	std::vector<Binding> bindings;
+
+	std::set<size_t> GetBoundRows()
+	{
+		std::set<size_t> rows;
+
+
+		for(const Binding& binding : bindings)
+		{
+			rows.insert(binding.row);
+		}
+
+		return rows;
+	}
+
+	void TestBinding(OS::VirtualList* list)
+	{
+		std::set<OS::Window*> cells;
+		OS::Window* first_row_cell;
+
+
+		/* Only the visible rows are bound, each to a cell of its own. */
+		TEST_CHECK(list->getVisibleRowCount() == VISIBLE_ROWS);
+		TEST_CHECK(bindings.size() == VISIBLE_ROWS * COLUMNS);
+		TEST_CHECK(GetBoundRows() == std::set<size_t>({0,1,2,3,4}));
+		for(const Binding& binding : bindings)
+		{
+			cells.insert(binding.cell);
+			if(binding.row == 0 && binding.column == 0)
+			{
+				first_row_cell = binding.cell;
+			}
+		}
+		TEST_CHECK(cells.size() == VISIBLE_ROWS * COLUMNS);
+
+		/* Scrolling by a row binds only the row scrolled into view, to the cells of the row scrolled out. */
+		bindings.clear();
+		list->scrollBy(1);
+		TEST_CHECK(list->getFirstVisibleRow() == 1);
+		TEST_CHECK(bindings.size() == COLUMNS && GetBoundRows() == std::set<size_t>({5}));
+		TEST_CHECK(bindings.size() == COLUMNS && bindings[0].cell == first_row_cell);
+		TEST_CHECK(first_row_cell->getYCoordinate(false) - list->getWindow()->getYCoordinate(false) == 4 * ROW_HEIGHT);  //At the bottom.
+
+		bindings.clear();
+		list->scrollBy(3);
+		TEST_CHECK(GetBoundRows() == std::set<size_t>({6,7,8}));
+		bindings.clear();
+		list->scrollBy(-2);
+		TEST_CHECK(GetBoundRows() == std::set<size_t>({2,3}));
+
+		/* Jumping binds every visible row, still to the same cells. */
+		bindings.clear();
+		list->scrollTo(ROWS / 2);
+		TEST_CHECK(GetBoundRows() == std::set<size_t>({ROWS / 2,ROWS / 2 + 1,ROWS / 2 + 2,ROWS / 2 + 3,ROWS / 2 + 4}));
+		for(const Binding& binding : bindings)
+		{
+			TEST_CHECK(cells.count(binding.cell) == 1);
+		}
+
+		/* Nothing is bound when nothing scrolls, and the list stops at its last row. */
+		bindings.clear();
+		list->scrollTo(ROWS / 2);
+		TEST_CHECK(bindings.empty());
+		list->scrollTo(ROWS * 2);
+		TEST_CHECK(list->getFirstVisibleRow() == ROWS - VISIBLE_ROWS);
+		bindings.clear();
+		list->scrollBy(1);
+		TEST_CHECK(bindings.empty());
+
+		/* Refreshing a row binds it again only if it is visible. */
+		list->refresh(ROWS - 1);
+		TEST_CHECK(bindings.size() == COLUMNS && GetBoundRows() == std::set<size_t>({ROWS - 1}));
+		bindings.clear();
+		list->refresh(0);
+		TEST_CHECK(bindings.empty());
+		list->refresh();
+		TEST_CHECK(bindings.size() == VISIBLE_ROWS * COLUMNS);
+	}
+
+	void TestWheel(OS::VirtualList* list)
+	{
+		HWND window_handle = list->getWindow()->getNativeHandle();
+
+
+		list->scrollTo(100);
+
+		/* Three rows a notch, with partial rotation kept until it adds up to a row. */
+		SendMessage(window_handle,WM_MOUSEWHEEL,MAKEWPARAM(0,-WHEEL_DELTA),0);
+		TEST_CHECK(list->getFirstVisibleRow() == 103);
+		SendMessage(window_handle,WM_MOUSEWHEEL,MAKEWPARAM(0,WHEEL_DELTA / 6),0);
+		TEST_CHECK(list->getFirstVisibleRow() == 103);
+		SendMessage(window_handle,WM_MOUSEWHEEL,MAKEWPARAM(0,WHEEL_DELTA / 6),0);
+		TEST_CHECK(list->getFirstVisibleRow() == 102);
+		SendMessage(window_handle,WM_VSCROLL,SB_LINEDOWN,0);
+		TEST_CHECK(list->getFirstVisibleRow() == 103);
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* window_class = OS::WindowClass::Register(L"ListHost");
+	OS::WindowClass* list_class = OS::VirtualList::Register(L"List");
+	OS::WindowClass* cell_class = OS::WindowClass::Register(L"ListCell");
+	OS::Window* host;
+	OS::Window* list_window;
+	OS::VirtualList* list;
+
+
+	window_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,400,400);
+	cell_class->setWindowDefaults(WS_CHILD,0,0,0,0,0);
+	host = window_class->instantiate(L"Host");
+	list_window = list_class->instantiate(L"List");
+	list_window->setParent(host);
+	list_window->setDimensions(200,VISIBLE_ROWS * ROW_HEIGHT);
+	list = OS::VirtualList::FromWindow(list_window);
+	TEST_CHECK(list != nullptr);
+	TEST_CHECK(OS::VirtualList::FromWindow(host) == nullptr);
+	list->setRowHeight(ROW_HEIGHT);
+	list->setColumns({120,80});
+	list->setCellClass(cell_class);
+	list->setDataSource(ROWS,[](OS::Window* cell,size_t row,size_t column){
+		bindings.push_back({cell,row,column});
+	});
+
+	TestBinding(list);
+	TestWheel(list);
+
+	host->destroy();
+	OS::WindowClass::Unregister(cell_class);
+	OS::WindowClass::Unregister(list_class);
+	OS::WindowClass::Unregister(window_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
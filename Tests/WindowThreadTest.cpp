@@ -0,0 +1,247 @@
+#include "Headless.h"
+#include "OS.h"
+#include "Test.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+	/* Constants */
+	const UINT WM_TEST = WM_APP + 1;
+	const UINT WM_TEST_CHANGING = WM_APP + 2;  //Its handler is replaced over and over while it is being dispatched.
+	const int THREADS = 4;
+	const int ITERATIONS = 2000;
+	const int WINDOWS_PER_THREAD = 8;
+
+	std::atomic<int> failures(0);
+	std::atomic<int> started(0);
+	std::atomic<bool> stop(false);
+
+	void Check(bool condition)  //TEST_CHECK is only called from the main thread.
+	{
+		if(!condition)
+		{
+			++failures;
+		}
+	}
+
+	void StartTogether()  //So that the threads overlap as much as they can.
+	{
+		++started;
+		while(started.load() < THREADS)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	template<typename Condition>
+	bool PumpUntil(Condition condition)
+	{
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+
+		while(!condition())
+		{
+			if(std::chrono::steady_clock::now() > deadline)
+			{
+				return false;
+			}
+
+			Headless::PumpMessages();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return true;
+	}
+
+	/**
+	 * Looks classes up and dispatches messages through the handlers of a class while another thread registers, unregisters and changes classes.
+	 */
+	void ReadClasses(OS::WindowClass* shared_class,int thread)
+	{
+		OS::Window* window = shared_class->instantiate(L"Reader");
+
+
+		StartTogether();
+		for(int iteration = 0;iteration < ITERATIONS;++iteration)
+		{
+			LRESULT changing;
+
+
+			Check(OS::WindowClass::GetByName(L"Shared") == shared_class);
+			Check(OS::WindowClass::GetByWindowHandle(window->getNativeHandle()) == shared_class);
+			Check(OS::Window::FromHandle(window->getNativeHandle()) == window);
+			Check(SendMessage(window->getNativeHandle(),WM_TEST,iteration,0) == iteration + 1);
+
+			changing = SendMessage(window->getNativeHandle(),WM_TEST_CHANGING,0,0);
+			Check(changing == 0 || changing == 1 || changing == 2);
+
+			OS::WindowClass::GetByName(L"Transient");  //Comes and goes.
+		}
+		window->destroy();
+	}
+
+	void WriteClasses(OS::WindowClass* shared_class)
+	{
+		int iteration = 0;
+
+
+		while(!stop.load())
+		{
+			OS::WindowClass* transient_class = OS::WindowClass::Register(L"Transient");
+			LRESULT result = iteration % 2 + 1;
+
+
+			shared_class->setDefaultMessageHandler(WM_TEST_CHANGING,[result](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+				return result;
+			});
+			transient_class->instantiate(L"Transient")->destroy();
+			OS::WindowClass::Unregister(transient_class);
+			++iteration;
+		}
+	}
+
+	/**
+	 * Paints, times and animates windows of its own, as every thread with a message loop does, while other threads do the same with theirs.
+	 */
+	void RunWindows(OS::WindowClass* shared_class,int thread)
+	{
+		std::vector<OS::Window*> windows;
+		int fired = 0;
+
+
+		for(int index = 0;index < WINDOWS_PER_THREAD;++index)
+		{
+			OS::Window* window = shared_class->instantiate(L"Worker");
+
+
+			window->setDimensions(64,48);
+			window->setDoubleBuffered(true);
+			window->setBackground(RGB(index * 10,0,0));  //The same colors on every thread, so that the brushes are shared.
+			window->show();
+			windows.push_back(window);
+		}
+
+		StartTogether();
+		for(int round = 0;round < 10;++round)
+		{
+			for(OS::Window* window : windows)
+			{
+				window->invalidate();
+			}
+			OS::FlushInvalidations();  //As the message loop would.
+			Headless::PumpMessages();
+		}
+		Check(OS::GetBackBufferUsage() >= (size_t)WINDOWS_PER_THREAD * 64 * 48 * 4);
+
+		for(OS::Window* window : windows)
+		{
+			window->setTimer(1,[&fired](OS::Window* window){
+				++fired;
+			},false);
+		}
+		Check(OS::GetTimerStatistics().active == WINDOWS_PER_THREAD);  //Only this thread's.
+		Check(PumpUntil([&fired](){
+			return fired == WINDOWS_PER_THREAD;
+		}));
+		Check(OS::GetTimerStatistics().fired == WINDOWS_PER_THREAD);
+
+		for(size_t index = 0;index < windows.size();++index)
+		{
+			RECT rectangle = {(LONG)index,thread,(LONG)index + 32,thread + 24};
+
+
+			windows[index]->animateGeometry(rectangle,20);
+		}
+		Check(OS::GetAnimatedWindowCount() == WINDOWS_PER_THREAD);  //Only this thread's.
+		Check(PumpUntil([](){
+			return OS::GetAnimatedWindowCount() == 0;
+		}));
+		Check(windows.back()->getWidth() == 32 && windows.back()->getHeight() == 24);
+
+		for(OS::Window* window : windows)
+		{
+			window->destroy();
+		}
+		Headless::PumpMessages();
+	}
+
+	void TestClassRegistry(OS::WindowClass* shared_class)
+	{
+		std::vector<std::thread> readers;
+		std::thread writer(WriteClasses,shared_class);
+
+
+		started = 0;
+		stop = false;
+		for(int thread = 0;thread < THREADS;++thread)
+		{
+			readers.push_back(std::thread(ReadClasses,shared_class,thread));
+		}
+		for(std::thread& reader : readers)
+		{
+			reader.join();
+		}
+		stop = true;
+		writer.join();
+
+		TEST_CHECK(failures.load() == 0);
+		TEST_CHECK(!OS::WindowClass::Exists(L"Transient"));
+	}
+
+	void TestThreadWindows(OS::WindowClass* shared_class)
+	{
+		std::vector<std::thread> threads;
+
+
+		failures = 0;
+		started = 0;
+		for(int thread = 0;thread < THREADS;++thread)
+		{
+			threads.push_back(std::thread(RunWindows,shared_class,thread));
+		}
+		for(std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		TEST_CHECK(failures.load() == 0);
+		TEST_CHECK(OS::GetTimerStatistics().fired == 0);  //Every timer was set by another thread.
+		TEST_CHECK(OS::GetBackBufferUsage() == 0);
+		TEST_CHECK(OS::GetGdiCacheStatistics().brushes == 0);
+	}
+}
+
+
+int main()
+{
+	OS::WindowClass* shared_class = OS::WindowClass::Register(L"Shared");
+	size_t window_count = Headless::GetWindowCount();
+
+
+	shared_class->setWindowDefaults(WS_OVERLAPPED,0,0,0,64,48);
+	shared_class->setDefaultMessageHandler(WM_TEST,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+		return w_param + 1;
+	});
+	shared_class->setDefaultMessageHandler(WM_PAINT,[](OS::Window* window,WPARAM w_param,LPARAM l_param) -> LRESULT {
+		PAINTSTRUCT paint_struct;
+
+
+		window->beginPaint(paint_struct);
+		window->endPaint(paint_struct);
+
+		return 0;
+	});
+
+	TestClassRegistry(shared_class);
+	TestThreadWindows(shared_class);
+	TEST_CHECK(Headless::GetWindowCount() == window_count);
+
+	OS::WindowClass::Unregister(shared_class);
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "Test.h"
+#include "XML.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using XML::Element;
+
+
+namespace
+{
+	Element Parse(const char* document)
+	{
+		return XML::Parse(document,std::strlen(document));
+	}
+
+	bool Fails(const char* document)
+	{
+		try
+		{
+			Parse(document);
+		}
+		catch(const std::runtime_error&)
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+	void TestStructure()
+	{
+		Element root = Parse("<?xml version=\"1.0\" ?>\n<!DOCTYPE UIClass>\n<!-- Before -->\n<UIClass kind=\"window\">\n\t<Name>Window</Name>\n\t<Empty/>\n\t<Prototype title='Untitled' width = \"640\" />\n</UIClass>\n<!-- After -->\n");
+		const Element* name = root.getChild(L"Name");
+		const Element* prototype = root.getChild(L"Prototype");
+		size_t containers = 0;
+
+
+		TEST_CHECK(root.type == Element::Type::CONTAINER);
+		TEST_CHECK(root.getName() == L"UIClass");
+		TEST_CHECK(root.getAttribute(L"kind") == L"window");
+		TEST_CHECK(root.getAttribute(L"missing",L"fallback") == L"fallback");
+		TEST_CHECK(!root.hasAttribute(L"missing"));
+
+		TEST_CHECK(name != nullptr && name->getText() == L"Window");
+		TEST_CHECK(root.getChild(L"Empty") != nullptr && root.getChild(L"Empty")->getChildren().empty());
+		TEST_CHECK(prototype != nullptr && prototype->getAttribute(L"title") == L"Untitled");
+		TEST_CHECK(prototype != nullptr && prototype->getAttribute(L"width") == L"640");
+		TEST_CHECK(prototype != nullptr && prototype->getAttributes().size() == 2);
+		TEST_CHECK(root.getChild(L"Missing") == nullptr);
+
+		for(const Element& child : root.getChildren())
+		{
+			containers += child.type == Element::Type::CONTAINER;
+		}
+		TEST_CHECK(containers == 3);
+	}
+
+	void TestText()
+	{
+		Element root = Parse("<Text>\n\t one &lt;two&gt; &amp; &quot;three&quot; &apos;four&apos; &#65;&#x42;<!-- comment --><![CDATA[ <raw> &amp; ]]>\n</Text>");
+		const std::vector<Element>& children = root.getChildren();
+
+
+		TEST_CHECK(root.getText() == L"one <two> & \"three\" 'four' AB <raw> &amp;");
+		TEST_CHECK(children.size() == 4);
+		if(children.size() == 4)
+		{
+			TEST_CHECK(children[1].type == Element::Type::COMMENT);
+			TEST_CHECK(children[1].getText() == L" comment ");
+			TEST_CHECK(children[2].type == Element::Type::TEXT);
+			TEST_CHECK(children[2].getText() == L" <raw> &amp; ");  //CDATA is taken as it is.
+		}
+
+		TEST_CHECK(Parse("<a b=\"&lt;&amp;&gt;\"/>").getAttribute(L"b") == L"<&>");
+		TEST_CHECK(Parse("<a>   </a>").getText().empty());
+	}
+
+	void TestEncoding()
+	{
+		Element root = Parse("\xEF\xBB\xBF<T v=\"\xC3\xA9\">\xE2\x82\xAC\xF0\x9F\x98\x80</T>");
+		std::wstring text = root.getText();
+
+
+		TEST_CHECK(root.getAttribute(L"v") == L"\x00E9");
+		TEST_CHECK(text.size() >= 2 && text[0] == 0x20AC);
+		if(sizeof(wchar_t) == 2)  //Outside the basic multilingual plane, UTF-16 needs a surrogate pair.
+		{
+			TEST_CHECK(text.size() == 3 && text[1] == 0xD83D && text[2] == 0xDE00);
+		}
+		else
+		{
+			TEST_CHECK(text.size() == 2 && (std::uint32_t)text[1] == 0x1F600);
+		}
+
+		/* Resources may be padded with a terminator. */
+		TEST_CHECK(XML::Parse("<a/>\0",5).getName() == L"a");
+	}
+
+	void TestDepth()
+	{
+		std::string document;
+		const Element* element;
+		int depth = 0;
+
+
+		for(int level = 0;level < 64;++level)
+		{
+			document.append("<Level n=\"").append(std::to_string(level)).append("\">");
+		}
+		for(int level = 0;level < 64;++level)
+		{
+			document.append("</Level>");
+		}
+
+		Element root = XML::Parse(document.data(),document.size());
+
+
+		for(element = &root;element != nullptr;element = element->getChild(L"Level"))
+		{
+			TEST_CHECK(element->getAttribute(L"n") == std::to_wstring(depth));
+			++depth;
+		}
+		TEST_CHECK(depth == 64);
+	}
+
+	void TestMalformed()
+	{
+		TEST_CHECK(Fails(""));
+		TEST_CHECK(Fails("   "));
+		TEST_CHECK(Fails("text"));
+		TEST_CHECK(Fails("<a>"));
+		TEST_CHECK(Fails("<a></b>"));
+		TEST_CHECK(Fails("<a><b></a></b>"));
+		TEST_CHECK(Fails("<a b></a>"));
+		TEST_CHECK(Fails("<a b=c></a>"));
+		TEST_CHECK(Fails("<a b=\"c></a>"));
+		TEST_CHECK(Fails("<a>&unknown;</a>"));
+		TEST_CHECK(Fails("<a>&amp</a>"));
+		TEST_CHECK(Fails("<a>&#0;</a>"));
+		TEST_CHECK(Fails("<a>&#x110000;</a>"));
+		TEST_CHECK(Fails("<a><!-- unterminated </a>"));
+		TEST_CHECK(Fails("<a/><b/>"));
+		TEST_CHECK(Fails("<a>\xC3</a>"));
+		TEST_CHECK(Fails("<a>\xC3\x28</a>"));
+		TEST_CHECK(Fails("<a>\xFF</a>"));
+	}
+}
+
+int main()
+{
+	TestStructure();
+	TestText();
+	TestEncoding();
+	TestDepth();
+	TestMalformed();
+
+	return Test::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+"""
+Packs the resources described by Resources/Resources.rc into a resource pack which OS::ResourcePack can memory-map.
+
+Usage:
+    python PackResources.py [--compress] <resource directory> <output file>
+
+The resource directory must contain Resources.rc and the header it includes.  Resource names defined in the header
+become numeric identifiers ("#<id>"); any other name is kept as a string, upper-cased as the resource compiler does.
+Every string of the STRINGTABLE becomes a resource of its own, of type RT_STRING ("#6"), stored as UTF-16 without a
+terminator.
+
+With --compress, each resource which shrinks is stored compressed in the block format described in Compression.h and
+decompressed by OS::Module on first access.
+
+Layout (little-endian):
+    Header      magic "RPAK", version, entry count and the offsets of the tables below
+    Directory   one 24-byte entry per resource, sorted by type, name and language
+    Displacements, Slots
+                a minimal perfect hash over (type, name, language); see HashKey
+    Names       the UTF-16, null-terminated type and name strings
+    Data        each resource's bytes, aligned to 16 bytes
+"""
+
+import os
+import re
+import struct
+import sys
+
+
+MAGIC = b"RPAK"
+VERSION = 2
+HEADER_FORMAT = "<4s7I"
+ENTRY_FORMAT = "<5I2H"
+ENTRY_COMPRESSED = 0x1
+DATA_ALIGNMENT = 16
+RT_STRING = "#6"
+MAXIMUM_OFFSET = 65535
+MINIMUM_MATCH = 4
+
+
+def HashKey(type_name, name, language, seed):
+    """32-bit FNV-1a over the UTF-16 type and name (each null-terminated) and the language.  Must match OS.cpp."""
+    value = (2166136261 ^ seed) & 0xFFFFFFFF
+    for byte in type_name.encode("utf-16-le") + b"\0\0" + name.encode("utf-16-le") + b"\0\0" + struct.pack("<H", language):
+        value ^= byte
+        value = (value * 16777619) & 0xFFFFFFFF
+
+    return value
+
+
+def Compress(data):
+    """Greedy LZ77 in the block format of Compression.h; the output need not match Compression::Compress byte for byte."""
+    output = bytearray()
+    last_positions = {}
+    anchor = 0
+    position = 0
+
+
+    def WriteLength(length):
+        while length >= 255:
+            output.append(255)
+            length -= 255
+        output.append(length)
+
+    def WriteSequence(literals, offset, match_length):
+        extra_match = match_length - MINIMUM_MATCH
+        output.append((min(len(literals), 15) << 4) | (0 if match_length == 0 else min(extra_match, 15)))
+        if len(literals) >= 15:
+            WriteLength(len(literals) - 15)
+        output.extend(literals)
+        if match_length == 0:
+            return
+        output.extend(struct.pack("<H", offset))
+        if extra_match >= 15:
+            WriteLength(extra_match - 15)
+
+    while position + MINIMUM_MATCH <= len(data):
+        sequence = data[position:position + MINIMUM_MATCH]
+        candidate = last_positions.get(sequence)
+        last_positions[sequence] = position
+        if candidate is None or position - candidate > MAXIMUM_OFFSET:
+            position += 1
+            continue
+
+        match_length = MINIMUM_MATCH
+        while position + match_length < len(data) and data[candidate + match_length] == data[position + match_length]:
+            match_length += 1
+
+        WriteSequence(data[anchor:position], position - candidate, match_length)
+        position += match_length
+        anchor = position
+
+    WriteSequence(data[anchor:], 0, 0)
+
+    return bytes(output)
+
+
+def ReadDefinitions(header_path):
+    definitions = {}
+
+
+    with open(header_path, encoding="utf-8-sig") as header:
+        for line in header:
+            match = re.match(r"\s*#define\s+(\w+)\s+(0[xX][0-9A-Fa-f]+|\d+)", line)
+            if match:
+                definitions[match.group(1)] = int(match.group(2), 0)
+
+    return definitions
+
+
+def ReadResources(resource_directory):
+    script_path = os.path.join(resource_directory, "Resources.rc")
+    definitions = {}
+    resources = []
+    in_string_table = False
+
+
+    def ResolveName(name):
+        if name in definitions:
+            return "#%d" % definitions[name]
+        return name.upper()
+
+    with open(script_path, encoding="utf-8-sig") as script:
+        for line in script:
+            line = line.strip()
+            include = re.match(r'#include\s+"(.+)"', line)
+            if include:
+                definitions.update(ReadDefinitions(os.path.join(resource_directory, include.group(1))))
+            elif line == "STRINGTABLE":
+                in_string_table = True
+            elif in_string_table and line in ("{", "BEGIN"):
+                pass
+            elif in_string_table and line in ("}", "END"):
+                in_string_table = False
+            elif in_string_table:
+                string = re.match(r'(\w+)\s*,?\s*"((?:[^"]|"")*)"', line)
+                if string:
+                    text = string.group(2).replace('""', '"')
+                    resources.append((RT_STRING, ResolveName(string.group(1)), 0, text.encode("utf-16-le")))
+            else:
+                resource = re.match(r'(\w+)\s+(\w+)\s+"(.+)"', line)
+                if resource:
+                    with open(os.path.join(resource_directory, resource.group(3)), "rb") as data:
+                        resources.append((ResolveName(resource.group(2)), ResolveName(resource.group(1)), 0, data.read()))
+
+    return resources
+
+
+def BuildPerfectHash(keys):
+    count = len(keys)
+    buckets = [[] for _ in range(count)]
+    displacements = [0] * count
+    slots = [None] * count
+
+
+    for index, key in enumerate(keys):
+        buckets[HashKey(*key, 0) % count].append(index)
+
+    for bucket_index in sorted(range(count), key=lambda index: -len(buckets[index])):
+        bucket = buckets[bucket_index]
+        if not bucket:
+            break
+
+        seed = 1
+        while True:
+            positions = [HashKey(*keys[index], seed) % count for index in bucket]
+            if len(set(positions)) == len(positions) and all(slots[position] is None for position in positions):
+                break
+            seed += 1
+
+        displacements[bucket_index] = seed
+        for index, position in zip(bucket, positions):
+            slots[position] = index
+
+    return displacements, [0 if slot is None else slot for slot in slots]
+
+
+def WritePack(resources, output_path, compress=False):
+    resources = sorted(resources, key=lambda resource: (resource[0].encode("utf-16-be"), resource[1].encode("utf-16-be"), resource[2]))
+    count = len(resources)
+    names = bytearray()
+    name_offsets = {}
+    directory_offset = struct.calcsize(HEADER_FORMAT)
+    displacements_offset = directory_offset + count * struct.calcsize(ENTRY_FORMAT)
+    slots_offset = displacements_offset + count * 4
+    names_offset = slots_offset + count * 4
+    displacements, slots = BuildPerfectHash([(resource[0], resource[1], resource[2]) for resource in resources])
+
+
+    def NameOffset(name):
+        if name not in name_offsets:
+            name_offsets[name] = len(names)
+            names.extend(name.encode("utf-16-le") + b"\0\0")
+        return name_offsets[name]
+
+    name_references = [(NameOffset(resource[0]), NameOffset(resource[1])) for resource in resources]
+    data_offset = names_offset + len(names)
+    data = bytearray()
+    entries = bytearray()
+    for (type_offset, name_offset), resource in zip(name_references, resources):
+        stored = resource[3]
+        flags = 0
+        if compress:
+            compressed = Compress(stored)
+            if len(compressed) < len(stored):
+                stored = compressed
+                flags |= ENTRY_COMPRESSED
+
+        padding = -(data_offset + len(data)) % DATA_ALIGNMENT
+        data.extend(b"\0" * padding)
+        entries.extend(struct.pack(ENTRY_FORMAT, type_offset, name_offset, data_offset + len(data), len(stored), len(resource[3]), resource[2], flags))
+        data.extend(stored)
+
+    with open(output_path, "wb") as output:
+        output.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, count, directory_offset, displacements_offset, slots_offset, names_offset, len(names)))
+        output.write(entries)
+        output.write(struct.pack("<%dI" % count, *displacements))
+        output.write(struct.pack("<%dI" % count, *slots))
+        output.write(names)
+        output.write(data)
+
+
+if __name__ == "__main__":
+    arguments = sys.argv[1:]
+    compress = "--compress" in arguments
+    arguments = [argument for argument in arguments if argument != "--compress"]
+    if len(arguments) != 2:
+        sys.exit(__doc__)
+
+    WritePack(ReadResources(arguments[0]), arguments[1], compress)
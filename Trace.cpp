@@ -0,0 +1,196 @@
+#include "Trace.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER)
+	#define TRACE_THREAD_LOCAL __declspec(thread)
+#else
+	#define TRACE_THREAD_LOCAL thread_local
+#endif
+
+
+namespace
+{
+	struct Event
+	{
+		const char* name;
+		LONGLONG start;
+		LONGLONG end;
+	};
+
+	struct ThreadBuffer
+	{
+		DWORD thread_id;
+		std::atomic<size_t> count;  //Events up to count are complete; only the owning thread writes.
+		size_t dropped;
+		Event events[Trace::EVENTS_PER_THREAD];
+	};
+
+	std::vector<ThreadBuffer*> thread_buffers;  //Never freed, as a thread may end before the trace is written.
+	std::mutex thread_buffers_mutex;
+	TRACE_THREAD_LOCAL ThreadBuffer* current_thread_buffer = nullptr;
+
+	ThreadBuffer* GetThreadBuffer()
+	{
+		if(current_thread_buffer == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(thread_buffers_mutex);
+			ThreadBuffer* buffer = new ThreadBuffer;
+
+
+			buffer->thread_id = GetCurrentThreadId();
+			buffer->count = 0;
+			buffer->dropped = 0;
+			thread_buffers.push_back(buffer);
+			current_thread_buffer = buffer;
+		}
+
+		return current_thread_buffer;
+	}
+
+	void AppendEscaped(std::string& json,const char* text)
+	{
+		for(;*text != '\0';++text)
+		{
+			if(*text == '"' || *text == '\\')
+			{
+				json.push_back('\\');
+			}
+			if((unsigned char)*text >= 0x20)
+			{
+				json.push_back(*text);
+			}
+		}
+	}
+}
+
+namespace Trace
+{
+	/* Function Definitions */
+	std::string GetChromeTrace()
+	{
+		LARGE_INTEGER frequency;
+		std::string json = "{\"traceEvents\":[";
+		bool first = true;
+		DWORD process_id = GetCurrentProcessId();
+
+
+		QueryPerformanceFrequency(&frequency);
+
+		std::lock_guard<std::mutex> lock(thread_buffers_mutex);
+		for(ThreadBuffer* buffer : thread_buffers)
+		{
+			size_t count = buffer->count.load(std::memory_order_acquire);
+
+
+			for(size_t index = 0;index < count;++index)
+			{
+				const Event& event = buffer->events[index];
+
+
+				json.append(first ? "\n" : ",\n");
+				json.append("{\"name\":\"");
+				AppendEscaped(json,event.name);
+				json.append("\",\"ph\":\"X\",\"ts\":");
+				json.append(std::to_string((double)event.start * 1000000.0 / frequency.QuadPart));
+				json.append(",\"dur\":");
+				json.append(std::to_string((double)(event.end - event.start) * 1000000.0 / frequency.QuadPart));
+				json.append(",\"pid\":");
+				json.append(std::to_string(process_id));
+				json.append(",\"tid\":");
+				json.append(std::to_string(buffer->thread_id));
+				json.append("}");
+				first = false;
+			}
+		}
+		json.append("\n]}");
+
+		return json;
+	}
+
+	size_t GetDroppedEventCount()
+	{
+		std::lock_guard<std::mutex> lock(thread_buffers_mutex);
+		size_t dropped = 0;
+
+
+		for(ThreadBuffer* buffer : thread_buffers)
+		{
+			dropped += buffer->dropped;
+		}
+
+		return dropped;
+	}
+
+	void Record(const char* name,LONGLONG start,LONGLONG end)
+	{
+		ThreadBuffer* buffer = GetThreadBuffer();
+		size_t count = buffer->count.load(std::memory_order_relaxed);
+
+
+		if(count == EVENTS_PER_THREAD)
+		{
+			++buffer->dropped;
+
+			return;
+		}
+
+		buffer->events[count].name = name;
+		buffer->events[count].start = start;
+		buffer->events[count].end = end;
+		buffer->count.store(count + 1,std::memory_order_release);
+	}
+
+	void Reset()
+	{
+		std::lock_guard<std::mutex> lock(thread_buffers_mutex);
+
+
+		for(ThreadBuffer* buffer : thread_buffers)
+		{
+			buffer->count.store(0,std::memory_order_relaxed);
+			buffer->dropped = 0;
+		}
+	}
+
+	bool WriteChromeTrace(const wchar_t* path)
+	{
+		std::string json = GetChromeTrace();
+		HANDLE file = CreateFile(path,GENERIC_WRITE,0,nullptr,CREATE_ALWAYS,FILE_ATTRIBUTE_NORMAL,nullptr);
+		DWORD written = 0;
+		bool succeeded;
+
+
+		if(file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		succeeded = WriteFile(file,json.data(),(DWORD)json.size(),&written,nullptr) && written == json.size();
+		CloseHandle(file);
+
+		return succeeded;
+	}
+
+	/* Type [Trace::Scope] Definition */
+	Scope::Scope(const char* name)
+	{
+		LARGE_INTEGER now;
+
+
+		QueryPerformanceCounter(&now);
+		this->name = name;
+		this->start = now.QuadPart;
+	}
+
+	Scope::~Scope()
+	{
+		LARGE_INTEGER now;
+
+
+		QueryPerformanceCounter(&now);
+		Record(this->name,this->start,now.QuadPart);
+	}
+}
\ No newline at end of file
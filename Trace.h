@@ -0,0 +1,79 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <Windows.h>
+
+
+/**
+ * Tracing is compiled in for debug builds only, unless TRACING_ENABLED is defined otherwise.  When it is compiled out, TRACE_SCOPE expands to nothing and costs nothing.
+ */
+#ifndef TRACING_ENABLED
+	#ifdef _DEBUG
+		#define TRACING_ENABLED 1
+	#else
+		#define TRACING_ENABLED 0
+	#endif
+#endif
+
+#define TRACE_CONCATENATE_(left,right) left##right
+#define TRACE_CONCATENATE(left,right) TRACE_CONCATENATE_(left,right)
+
+#if TRACING_ENABLED
+	/**
+	 * Records the time spent from here until the end of the enclosing block under the given name, which must be a string literal.
+	 */
+	#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCATENATE(trace_scope_,__LINE__)(name)
+#else
+	#define TRACE_SCOPE(name)
+#endif
+
+
+/**
+ * Lightweight scoped timers whose results can be written out in the Chrome trace-event format (chrome://tracing or https://ui.perfetto.dev).  Each thread appends to a fixed-size buffer of its own, so recording takes no lock; a scope costs two reads of the performance counter and one store, which FrameworkBenchmark measures as its Trace::Scope case (about 80 ns with the headless stand-in's clock).  Events beyond a thread's buffer are counted and dropped.
+ */
+namespace Trace
+{
+	/* Constants */
+	const size_t EVENTS_PER_THREAD = 16384;
+
+	/* Function Prototypes */
+	/**
+	 * Gets every event recorded so far, from every thread, as a Chrome trace-event JSON document.  May be called while other threads are still recording.
+	 */
+	std::string GetChromeTrace();
+
+	/**
+	 * Gets the number of events which were dropped because a thread's buffer was full.
+	 */
+	size_t GetDroppedEventCount();
+
+	void Record(const char* name,LONGLONG start,LONGLONG end);
+
+	/**
+	 * Discards every event recorded so far, along with the count of dropped events, so that each thread's buffer can be filled again.  Must not be called while other threads are recording or the trace is being read.
+	 */
+	void Reset();
+
+	/**
+	 * Writes the result of GetChromeTrace to a file.
+	 *
+	 * @return Returns false if the file could not be written.
+	 */
+	bool WriteChromeTrace(const wchar_t* path);
+
+	/* Class Prototypes */
+	class Scope
+	{
+		private:
+			const char* name;
+			LONGLONG start;
+
+		public:
+			Scope(const char* name);
+
+			~Scope();
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,399 @@
+#include "VirtualList.h"
+
+#include <algorithm>
+
+
+namespace OS
+{
+	/* Constants */
+	const Property<VirtualList*> VIRTUAL_LIST_INSTANCE_PROPERTY(L"VirtualList.Instance");
+	const size_t VIRTUAL_LIST_NO_ROW = (size_t)-1;
+
+	/* Type [OS::VirtualList] Definition */
+	std::set<WindowClass*> VirtualList::classes;
+
+	VirtualList::VirtualList(Window* window)
+	{
+		assert(window != nullptr);
+
+
+		this->cell_class = nullptr;
+		this->first_row = 0;
+		this->row_count = 0;
+		this->row_height = 20;
+		this->visible_rows = 0;
+		this->wheel_remainder = 0;
+		this->window = window;
+	}
+
+	void VirtualList::discardCells()
+	{
+		for(Window* cell : this->cells)
+		{
+			cell->destroy();
+		}
+
+		this->cells.clear();
+		this->slot_rows.clear();
+	}
+
+	VirtualList* VirtualList::FromWindow(Window* window)
+	{
+		assert(window != nullptr);
+
+
+		VirtualList* list;
+
+
+		if(VirtualList::classes.count(window->getWindowClass()) == 0)
+		{
+			return nullptr;
+		}
+
+		list = window->getProperty(VIRTUAL_LIST_INSTANCE_PROPERTY);
+		if(list == nullptr)
+		{
+			list = new VirtualList(window);
+			window->setProperty(VIRTUAL_LIST_INSTANCE_PROPERTY,list);
+		}
+
+		return list;
+	}
+
+	size_t VirtualList::getColumnCount()
+	{
+		return this->column_widths.empty() ? 1 : this->column_widths.size();
+	}
+
+	size_t VirtualList::getFirstVisibleRow()
+	{
+		return this->first_row;
+	}
+
+	size_t VirtualList::getMaximumFirstRow()
+	{
+		LONG fully_visible_rows = this->window->getRectangle(true).bottom / this->row_height;
+
+
+		if(fully_visible_rows < 1)
+		{
+			fully_visible_rows = 1;
+		}
+
+
+		return this->row_count > (size_t)fully_visible_rows ? this->row_count - fully_visible_rows : 0;
+	}
+
+	size_t VirtualList::getRowCount()
+	{
+		return this->row_count;
+	}
+
+	int VirtualList::getRowHeight()
+	{
+		return this->row_height;
+	}
+
+	size_t VirtualList::getVisibleRowCount()
+	{
+		return this->visible_rows;
+	}
+
+	Window* VirtualList::getWindow()
+	{
+		return this->window;
+	}
+
+	void VirtualList::grow(size_t slots)
+	{
+		size_t columns = this->getColumnCount();
+
+
+		while(this->slot_rows.size() < slots)
+		{
+			for(size_t column = 0;column < columns;++column)
+			{
+				Window* cell = this->cell_class->instantiate(L"");
+
+
+				cell->setParent(this->window);
+				this->cells.push_back(cell);
+			}
+
+			this->slot_rows.push_back(VIRTUAL_LIST_NO_ROW);
+		}
+
+		std::fill(this->slot_rows.begin(),this->slot_rows.end(),VIRTUAL_LIST_NO_ROW);  //Rows are mapped to slots modulo the slot count, so every slot must be bound again.
+	}
+
+	void VirtualList::refresh()
+	{
+		std::fill(this->slot_rows.begin(),this->slot_rows.end(),VIRTUAL_LIST_NO_ROW);
+
+		this->update();
+	}
+
+	void VirtualList::refresh(size_t row)
+	{
+		if(this->slot_rows.empty() || row < this->first_row || row >= this->first_row + this->visible_rows)
+		{
+			return;
+		}
+
+		if(this->slot_rows[row % this->slot_rows.size()] == row)
+		{
+			this->slot_rows[row % this->slot_rows.size()] = VIRTUAL_LIST_NO_ROW;
+		}
+
+		this->update();
+	}
+
+	WindowClass* VirtualList::Register(const wchar* class_name,HINSTANCE context)
+	{
+		WindowClass* window_class = WindowClass::Register(class_name,context);
+
+
+		window_class->setWindowDefaults(WS_CHILD | WS_VSCROLL | WS_CLIPCHILDREN,0,0,0,0,0);
+
+		window_class->extendDefaultMessageHandler(WM_SIZE,[](Window* window,WPARAM w_param,LPARAM l_param){
+			VirtualList::FromWindow(window)->update();
+		});
+
+		window_class->extendDefaultMessageHandler(WM_VSCROLL,[](Window* window,WPARAM w_param,LPARAM l_param){
+			VirtualList* list = VirtualList::FromWindow(window);
+
+
+			switch(LOWORD(w_param))
+			{
+				case SB_LINEUP:
+					list->scrollBy(-1);
+
+					break;
+
+				case SB_LINEDOWN:
+					list->scrollBy(1);
+
+					break;
+
+				case SB_PAGEUP:
+					list->scrollBy(-(long long)list->visible_rows);
+
+					break;
+
+				case SB_PAGEDOWN:
+					list->scrollBy((long long)list->visible_rows);
+
+					break;
+
+				case SB_TOP:
+					list->scrollTo(0);
+
+					break;
+
+				case SB_BOTTOM:
+					list->scrollTo(list->getMaximumFirstRow());
+
+					break;
+
+				case SB_THUMBPOSITION:
+				case SB_THUMBTRACK:
+				{
+					SCROLLINFO scroll_info;
+
+
+					scroll_info.cbSize = sizeof(scroll_info);
+					scroll_info.fMask = SIF_TRACKPOS;
+					GetScrollInfo(window->getNativeHandle(),SB_VERT,&scroll_info);
+					list->scrollTo((size_t)scroll_info.nTrackPos);
+
+					break;
+				}
+			}
+		});
+
+		window_class->extendDefaultMessageHandler(WM_MOUSEWHEEL,[](Window* window,WPARAM w_param,LPARAM l_param){
+			VirtualList* list = VirtualList::FromWindow(window);
+			int delta = GET_WHEEL_DELTA_WPARAM(w_param);
+			int rows;
+
+
+			if((delta < 0) != (list->wheel_remainder < 0))  //Reversing direction discards what was left over.
+			{
+				list->wheel_remainder = 0;
+			}
+			list->wheel_remainder += delta * 3;  //Three rows per notch.
+			rows = list->wheel_remainder / WHEEL_DELTA;
+			list->wheel_remainder -= rows * WHEEL_DELTA;
+
+			if(rows != 0)
+			{
+				list->scrollBy(-rows);
+			}
+		});
+
+		window_class->extendDefaultMessageHandler(WM_NCDESTROY,[](Window* window,WPARAM w_param,LPARAM l_param){
+			VirtualList* list = window->getProperty(VIRTUAL_LIST_INSTANCE_PROPERTY);
+
+
+			if(list != nullptr)
+			{
+				window->removeProperty(VIRTUAL_LIST_INSTANCE_PROPERTY);
+				delete list;  //The cells are child windows and have already been destroyed along with the list's window.
+			}
+		});
+
+		VirtualList::classes.insert(window_class);
+
+		return window_class;
+	}
+
+	WindowClass* VirtualList::Register(const std::wstring& class_name,HINSTANCE context)
+	{
+		return VirtualList::Register(class_name.c_str(),context);
+	}
+
+	void VirtualList::scrollBy(long long rows)
+	{
+		if(rows < 0 && (size_t)-rows > this->first_row)
+		{
+			this->scrollTo(0);
+		}
+		else
+		{
+			this->scrollTo(this->first_row + rows);
+		}
+	}
+
+	void VirtualList::scrollTo(size_t row)
+	{
+		if(row > this->getMaximumFirstRow())
+		{
+			row = this->getMaximumFirstRow();
+		}
+
+		if(row == this->first_row)
+		{
+			return;
+		}
+
+		this->first_row = row;
+		this->update();
+	}
+
+	void VirtualList::setCellClass(WindowClass* cell_class)
+	{
+		assert(cell_class != nullptr);
+
+
+		this->discardCells();
+		this->cell_class = cell_class;
+
+		this->update();
+	}
+
+	void VirtualList::setColumns(const std::vector<int>& column_widths)
+	{
+		if(column_widths.size() != this->column_widths.size())
+		{
+			this->discardCells();
+		}
+		this->column_widths = column_widths;
+
+		this->refresh();
+	}
+
+	void VirtualList::setDataSource(size_t row_count,VirtualListCellBinder binder)
+	{
+		this->binder = binder;
+		this->row_count = row_count;
+
+		this->refresh();
+	}
+
+	void VirtualList::setRowHeight(int row_height)
+	{
+		assert(row_height > 0);
+
+
+		this->row_height = row_height;
+
+		this->refresh();
+	}
+
+	void VirtualList::update()
+	{
+		RECT client_rectangle;
+		size_t columns;
+		HDWP positions;
+		size_t slot_count;
+
+
+		if(this->cell_class == nullptr || !this->window->isRealized())
+		{
+			return;
+		}
+
+		client_rectangle = this->window->getRectangle(true);
+		this->visible_rows = (size_t)((client_rectangle.bottom + this->row_height - 1) / this->row_height);
+		if(this->visible_rows > this->slot_rows.size())
+		{
+			this->grow(this->visible_rows);
+		}
+		if(this->first_row > this->getMaximumFirstRow())
+		{
+			this->first_row = this->getMaximumFirstRow();
+		}
+
+		columns = this->getColumnCount();
+		slot_count = this->slot_rows.size();
+		positions = BeginDeferWindowPos((int)this->cells.size());
+		for(size_t offset = 0;offset < slot_count;++offset)
+		{
+			size_t row = this->first_row + offset;
+			size_t slot = row % slot_count;  //Consecutive rows cover every slot exactly once.
+			bool shown = offset < this->visible_rows && row < this->row_count;
+			int x = 0;
+
+
+			if(shown && this->slot_rows[slot] != row)
+			{
+				if(this->binder)
+				{
+					for(size_t column = 0;column < columns;++column)
+					{
+						this->binder(this->cells[slot * columns + column],row,column);
+					}
+				}
+
+				this->slot_rows[slot] = row;
+			}
+
+			for(size_t column = 0;column < columns;++column)
+			{
+				int width = this->column_widths.empty() ? client_rectangle.right : this->column_widths[column];
+
+
+				positions = DeferWindowPos(positions,this->cells[slot * columns + column]->getNativeHandle(),nullptr,x,(int)offset * this->row_height,width,this->row_height,SWP_NOZORDER | SWP_NOACTIVATE | (shown ? SWP_SHOWWINDOW : SWP_HIDEWINDOW));
+				x += width;
+			}
+		}
+		EndDeferWindowPos(positions);
+
+		this->updateScrollBar();
+	}
+
+	void VirtualList::updateScrollBar()
+	{
+		SCROLLINFO scroll_info;
+
+
+		scroll_info.cbSize = sizeof(scroll_info);
+		scroll_info.fMask = SIF_RANGE | SIF_PAGE | SIF_POS;
+		scroll_info.nMin = 0;
+		scroll_info.nMax = this->row_count == 0 ? 0 : (int)(this->row_count - 1);
+		scroll_info.nPage = (UINT)this->visible_rows;
+		scroll_info.nPos = (int)this->first_row;
+
+		SetScrollInfo(this->window->getNativeHandle(),SB_VERT,&scroll_info,TRUE);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef VIRTUAL_LIST_H
+#define VIRTUAL_LIST_H
+
+#include "OS.h"
+
+#include <set>
+#include <vector>
+
+
+namespace OS
+{
+	/* Class Prototypes */
+	/**
+	 * Scrolling container which presents a (potentially very large) number of rows while only keeping enough cell windows for the rows which are currently visible.  Cells are recycled as the list scrolls: a row keeps its cell for as long as it remains in view, and rows which scroll into view are bound to the cells of rows which scrolled out by calling the data source.
+	 *
+	 * A VirtualList is attached to each window instantiated from a window class registered through VirtualList::Register.
+	 */
+	class VirtualList
+	{
+		friend class WindowClass;
+
+		private:
+			static std::set<WindowClass*> classes;  //Registered through VirtualList::Register, and forgotten when unregistered.
+
+		public:
+			/**
+			 * Gets the list attached to a window instantiated from a class registered through VirtualList::Register.
+			 *
+			 * @return Returns the list, or nullptr if the window is not of such a class.
+			 */
+			static VirtualList* FromWindow(Window* window);
+
+			/**
+			 * Registers a window class whose windows behave as virtualized lists.
+			 *
+			 * @throw
+			 *   OS::RuntimeException
+			 *     Thrown if a window class with the given name already exists.
+			 */
+			static WindowClass* Register(const wchar* class_name,HINSTANCE context = nullptr);
+
+			static WindowClass* Register(const std::wstring& class_name,HINSTANCE context = nullptr);
+
+		private:
+			VirtualListCellBinder binder;
+			std::vector<Window*> cells;  //Row-major, one row of cells per slot.
+			WindowClass* cell_class;
+			std::vector<int> column_widths;
+			size_t first_row;
+			size_t row_count;
+			int row_height;
+			std::vector<size_t> slot_rows;  //The row currently bound to each slot.
+			size_t visible_rows;
+			int wheel_remainder;  //Wheel rotation, in the units of WM_MOUSEWHEEL, received but not yet enough to scroll by a row.
+			Window* window;
+
+		private:
+			VirtualList(Window* window);
+
+			void discardCells();
+
+			size_t getColumnCount();
+
+			size_t getMaximumFirstRow();
+
+			void grow(size_t slots);
+
+			void update();
+
+			void updateScrollBar();
+
+		public:
+			size_t getFirstVisibleRow();
+
+			size_t getRowCount();
+
+			int getRowHeight();
+
+			size_t getVisibleRowCount();
+
+			Window* getWindow();
+
+			/**
+			 * Re-binds every visible cell, for use when the data behind the rows already in view has changed.
+			 */
+			void refresh();
+
+			/**
+			 * Re-binds the cells of a single row if it is currently visible.
+			 */
+			void refresh(size_t row);
+
+			/**
+			 * Scrolls the list so that the given row is the first visible row.  Only rows which were not previously visible are bound, so the work done is proportional to the number of visible rows rather than the number of rows in the list.
+			 */
+			void scrollTo(size_t row);
+
+			void scrollBy(long long rows);
+
+			/**
+			 * Sets the window class used to create cells.  Cells which were already created are discarded.
+			 */
+			void setCellClass(WindowClass* cell_class);
+
+			/**
+			 * Sets the width of each column.  If no widths are given, a single column spanning the list's client area is used.
+			 */
+			void setColumns(const std::vector<int>& column_widths);
+
+			/**
+			 * Sets the number of rows in the list and the callback which binds a row/column to a cell.  The binder is called whenever a cell is assigned to a different row.
+			 */
+			void setDataSource(size_t row_count,VirtualListCellBinder binder);
+
+			void setRowHeight(int row_height);
+	};
+}
+
+#endif
\ No newline at end of file
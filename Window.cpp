@@ -1,12 +1,39 @@
 #include "Application.h"
+#include "Layout.h"
 #include "./Resources/Resources.h"
 
 
+namespace Application
+{
+	/* Type [Application::MainWindow] Definition */
+	MainWindow::MainWindow(OS::WindowClass* window_class)
+	: StaticWindow(window_class)
+	{
+	}
+
+	LRESULT MainWindow::onEraseBackground(WPARAM w_param,LPARAM l_param)
+	{
+		RECT client_rectangle;
+
+
+		if(this->isDoubleBuffered())  //The background is filled into the back buffer by OS::Window::beginPaint instead.
+		{
+			return 1;
+		}
+
+		client_rectangle = this->getRectangle(true);
+		FillRect((HDC)w_param,&client_rectangle,this->getBackground());
+
+		return 1;
+	}
+}
+
 EXPORT void MainWindow_OnCreate(OS::Window& window)
 {
 	window.setName(window.getModule().getStringResource(Application_Title));
 	window.setPosition(0,0);
-	window.setDimensions(345,95);
+	window.getLayout()->setWidth(345);
+	window.getLayout()->setHeight(95);
 }
 
 EXPORT void UIClass_Window_OnClose(OS::Window& window)
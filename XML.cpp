@@ -0,0 +1,502 @@
+#include "XML.h"
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace
+{
+	struct Reader
+	{
+		const char* position;
+		const char* end;
+	};
+
+	void Fail(const char* reason)
+	{
+		throw std::runtime_error(std::string("Malformed XML document: ").append(reason));
+	}
+
+	bool IsNameCharacter(char character)
+	{
+		return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') || (character >= '0' && character <= '9') || character == '_' || character == '-' || character == '.' || character == ':' || (unsigned char)character >= 0x80;
+	}
+
+	bool IsWhitespace(wchar_t character)
+	{
+		return character == ' ' || character == '\t' || character == '\r' || character == '\n';
+	}
+
+	bool StartsWith(const Reader& reader,const char* prefix)
+	{
+		size_t length = std::strlen(prefix);
+
+
+		return (size_t)(reader.end - reader.position) >= length && std::memcmp(reader.position,prefix,length) == 0;
+	}
+
+	void AppendCodePoint(std::wstring& text,std::uint32_t code_point)
+	{
+		if(code_point > 0xFFFF && sizeof(wchar_t) == 2)  //Outside the basic multilingual plane, UTF-16 needs a surrogate pair.
+		{
+			code_point -= 0x10000;
+			text.push_back((wchar_t)(0xD800 + (code_point >> 10)));
+			text.push_back((wchar_t)(0xDC00 + (code_point & 0x3FF)));
+		}
+		else
+		{
+			text.push_back((wchar_t)code_point);
+		}
+	}
+
+	void DecodeEntity(Reader& reader,std::wstring& text)
+	{
+		const char* terminator = (const char*)std::memchr(reader.position,';',reader.end - reader.position);
+		std::string entity;
+
+
+		if(terminator == nullptr)
+		{
+			Fail("unterminated entity reference");
+		}
+		entity.assign(reader.position + 1,terminator);
+		reader.position = terminator + 1;
+
+		if(entity == "lt")
+		{
+			text.push_back(L'<');
+		}
+		else if(entity == "gt")
+		{
+			text.push_back(L'>');
+		}
+		else if(entity == "amp")
+		{
+			text.push_back(L'&');
+		}
+		else if(entity == "quot")
+		{
+			text.push_back(L'"');
+		}
+		else if(entity == "apos")
+		{
+			text.push_back(L'\'');
+		}
+		else if(entity.size() > 1 && entity[0] == '#')
+		{
+			bool hexadecimal = entity[1] == 'x' || entity[1] == 'X';
+			char* digits_end;
+			unsigned long code_point = std::strtoul(entity.c_str() + (hexadecimal ? 2 : 1),&digits_end,hexadecimal ? 16 : 10);
+
+
+			if(*digits_end != '\0' || code_point == 0 || code_point > 0x10FFFF)
+			{
+				Fail("invalid character reference");
+			}
+			AppendCodePoint(text,(std::uint32_t)code_point);
+		}
+		else
+		{
+			Fail("unknown entity reference");
+		}
+	}
+
+	/**
+	 * Decodes UTF-8 text, replacing entity references with the characters they stand for unless told otherwise.
+	 */
+	std::wstring DecodeText(const char* start,const char* end,bool expand_entities = true)
+	{
+		Reader reader = {start,end};
+		std::wstring text;
+
+
+		text.reserve(end - start);
+		while(reader.position < end)
+		{
+			unsigned char lead = (unsigned char)*reader.position;
+			std::uint32_t code_point;
+			int continuation_bytes;
+
+
+			if(lead == '&' && expand_entities)
+			{
+				DecodeEntity(reader,text);
+
+				continue;
+			}
+
+			if(lead < 0x80)
+			{
+				text.push_back((wchar_t)lead);
+				++reader.position;
+
+				continue;
+			}
+			else if((lead & 0xE0) == 0xC0)
+			{
+				code_point = lead & 0x1F;
+				continuation_bytes = 1;
+			}
+			else if((lead & 0xF0) == 0xE0)
+			{
+				code_point = lead & 0x0F;
+				continuation_bytes = 2;
+			}
+			else if((lead & 0xF8) == 0xF0)
+			{
+				code_point = lead & 0x07;
+				continuation_bytes = 3;
+			}
+			else
+			{
+				Fail("invalid UTF-8");
+			}
+
+			if(end - reader.position <= continuation_bytes)
+			{
+				Fail("truncated UTF-8");
+			}
+			for(int index = 1;index <= continuation_bytes;++index)
+			{
+				unsigned char continuation = (unsigned char)reader.position[index];
+
+
+				if((continuation & 0xC0) != 0x80)
+				{
+					Fail("invalid UTF-8");
+				}
+				code_point = (code_point << 6) | (continuation & 0x3F);
+			}
+			reader.position += continuation_bytes + 1;
+			AppendCodePoint(text,code_point);
+		}
+
+		return text;
+	}
+
+	/**
+	 * Moves the reader past the given terminator.
+	 *
+	 * @return Returns where the terminator began.
+	 */
+	const char* SkipPast(Reader& reader,const char* terminator)
+	{
+		size_t length = std::strlen(terminator);
+
+
+		for(const char* candidate = reader.position;reader.end - candidate >= (std::ptrdiff_t)length;++candidate)
+		{
+			if(std::memcmp(candidate,terminator,length) == 0)
+			{
+				reader.position = candidate + length;
+
+				return candidate;
+			}
+		}
+
+		Fail("unterminated markup");
+
+		return nullptr;
+	}
+
+	void SkipWhitespace(Reader& reader)
+	{
+		while(reader.position < reader.end && IsWhitespace(*reader.position))
+		{
+			++reader.position;
+		}
+	}
+
+	std::wstring ReadName(Reader& reader)
+	{
+		const char* start = reader.position;
+
+
+		while(reader.position < reader.end && IsNameCharacter(*reader.position))
+		{
+			++reader.position;
+		}
+		if(reader.position == start)
+		{
+			Fail("expected a name");
+		}
+
+		return DecodeText(start,reader.position);
+	}
+
+	/**
+	 * Skips the declaration, processing instructions, comments and DOCTYPE which may appear outside the root element.
+	 */
+	void SkipMisc(Reader& reader)
+	{
+		for(;;)
+		{
+			SkipWhitespace(reader);
+			if(StartsWith(reader,"<?"))
+			{
+				SkipPast(reader,"?>");
+			}
+			else if(StartsWith(reader,"<!--"))
+			{
+				SkipPast(reader,"-->");
+			}
+			else if(StartsWith(reader,"<!"))
+			{
+				SkipPast(reader,">");
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+
+	XML::Element ReadElement(Reader& reader)
+	{
+		XML::Element element(XML::Element::Type::CONTAINER);
+
+
+		++reader.position;  //'<'
+		element.setName(ReadName(reader));
+
+		for(;;)  //Attributes
+		{
+			std::wstring attribute_name;
+			const char* value_end;
+			char quote;
+
+
+			SkipWhitespace(reader);
+			if(reader.position == reader.end)
+			{
+				Fail("unterminated start tag");
+			}
+
+			if(*reader.position == '>')
+			{
+				++reader.position;
+
+				break;
+			}
+			if(StartsWith(reader,"/>"))
+			{
+				reader.position += 2;
+
+				return element;
+			}
+
+			attribute_name = ReadName(reader);
+			SkipWhitespace(reader);
+			if(reader.position == reader.end || *reader.position != '=')
+			{
+				Fail("expected '=' after an attribute name");
+			}
+			++reader.position;
+			SkipWhitespace(reader);
+			if(reader.position == reader.end || (*reader.position != '"' && *reader.position != '\''))
+			{
+				Fail("expected a quoted attribute value");
+			}
+			quote = *reader.position++;
+			value_end = (const char*)std::memchr(reader.position,quote,reader.end - reader.position);
+			if(value_end == nullptr)
+			{
+				Fail("unterminated attribute value");
+			}
+			element.setAttribute(attribute_name,DecodeText(reader.position,value_end));
+			reader.position = value_end + 1;
+		}
+
+		for(;;)  //Content
+		{
+			if(reader.position == reader.end)
+			{
+				Fail("unterminated element");
+			}
+
+			if(StartsWith(reader,"</"))
+			{
+				reader.position += 2;
+				if(ReadName(reader) != element.getName())
+				{
+					Fail("mismatched end tag");
+				}
+				SkipWhitespace(reader);
+				if(reader.position == reader.end || *reader.position != '>')
+				{
+					Fail("unterminated end tag");
+				}
+				++reader.position;
+
+				return element;
+			}
+			else if(StartsWith(reader,"<!--"))
+			{
+				XML::Element comment(XML::Element::Type::COMMENT);
+				const char* start = reader.position + 4;
+
+
+				reader.position = start;
+				comment.setText(DecodeText(start,SkipPast(reader,"-->"),false));
+				element.addChild(comment);
+			}
+			else if(StartsWith(reader,"<![CDATA["))
+			{
+				XML::Element text(XML::Element::Type::TEXT);
+				const char* start = reader.position + 9;
+
+
+				reader.position = start;
+				text.setText(DecodeText(start,SkipPast(reader,"]]>"),false));
+				element.addChild(text);
+			}
+			else if(StartsWith(reader,"<?"))
+			{
+				SkipPast(reader,"?>");
+			}
+			else if(*reader.position == '<')
+			{
+				element.addChild(ReadElement(reader));
+			}
+			else
+			{
+				XML::Element text(XML::Element::Type::TEXT);
+				const char* text_end = (const char*)std::memchr(reader.position,'<',reader.end - reader.position);
+
+
+				if(text_end == nullptr)
+				{
+					Fail("unterminated element");
+				}
+				text.setText(DecodeText(reader.position,text_end));
+				reader.position = text_end;
+				element.addChild(text);
+			}
+		}
+	}
+}
+
+namespace XML
+{
+	/* Function Definitions */
+	Element Parse(const char* data,size_t size)
+	{
+		Reader reader = {data,data + size};
+		Element root(Element::Type::CONTAINER);
+
+
+		if(StartsWith(reader,"\xEF\xBB\xBF"))  //Byte order mark
+		{
+			reader.position += 3;
+		}
+
+		SkipMisc(reader);
+		if(reader.position == reader.end || *reader.position != '<')
+		{
+			Fail("expected a root element");
+		}
+		root = ReadElement(reader);
+		SkipMisc(reader);
+		if(reader.position != reader.end && *reader.position != '\0')  //Resources may be padded with a terminator.
+		{
+			Fail("content after the root element");
+		}
+
+		return root;
+	}
+
+	/* Type [XML::Element] Definition */
+	Element::Element(Type type)
+	: type(type)
+	{
+	}
+
+	Element& Element::addChild(const Element& child)
+	{
+		this->children.push_back(child);
+
+		return this->children.back();
+	}
+
+	std::wstring Element::getAttribute(const std::wstring& name,const std::wstring& fallback) const
+	{
+		auto attribute = this->attributes.find(name);
+
+
+		return attribute != this->attributes.end() ? attribute->second : fallback;
+	}
+
+	const std::map<std::wstring,std::wstring>& Element::getAttributes() const
+	{
+		return this->attributes;
+	}
+
+	const Element* Element::getChild(const std::wstring& name) const
+	{
+		for(const Element& child : this->children)
+		{
+			if(child.type == Type::CONTAINER && child.name == name)
+			{
+				return &child;
+			}
+		}
+
+		return nullptr;
+	}
+
+	const std::vector<Element>& Element::getChildren() const
+	{
+		return this->children;
+	}
+
+	const std::wstring& Element::getName() const
+	{
+		return this->name;
+	}
+
+	std::wstring Element::getText() const
+	{
+		std::wstring text;
+		size_t start;
+		size_t end;
+
+
+		if(this->type != Type::CONTAINER)
+		{
+			return this->text;
+		}
+
+		for(const Element& child : this->children)
+		{
+			if(child.type == Type::TEXT)
+			{
+				text.append(child.text);
+			}
+		}
+
+		for(start = 0;start < text.size() && IsWhitespace(text[start]);++start);
+		for(end = text.size();end > start && IsWhitespace(text[end - 1]);--end);
+
+		return text.substr(start,end - start);
+	}
+
+	bool Element::hasAttribute(const std::wstring& name) const
+	{
+		return this->attributes.count(name) > 0;
+	}
+
+	void Element::setAttribute(const std::wstring& name,const std::wstring& value)
+	{
+		this->attributes[name] = value;
+	}
+
+	void Element::setName(const std::wstring& name)
+	{
+		this->name = name;
+	}
+
+	void Element::setText(const std::wstring& text)
+	{
+		this->text = text;
+	}
+}
\ No newline at end of file
@@ -1,11 +1,18 @@
 #ifndef XML_H
 #define XML_H
 
+#include <map>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 
+/**
+ * A small, non-validating reader for the XML documents used as resources.  Elements, attributes, text, comments and CDATA sections are read; the declaration, processing instructions and DOCTYPE are skipped.
+ */
 namespace XML
 {
+	/* Class Prototypes */
 	class Element
 	{
 		public:
@@ -17,18 +24,64 @@ namespace XML
 			};
 
 		private:
+			std::map<std::wstring,std::wstring> attributes;
 			std::vector<Element> children;
+			std::wstring name;  //Of a container.
+			std::wstring text;  //Of a comment or text.
 
 		public:
-			const Type type;
+			Type type;
 
 		public:
 			Element(Type type);
 
-			virtual void addChild();
+			Element& addChild(const Element& child);
 
-			const std::vector<Element>& getChildren();
+			/**
+			 * Gets an attribute of this element.
+			 *
+			 * @return Returns fallback if the attribute is not set.
+			 */
+			std::wstring getAttribute(const std::wstring& name,const std::wstring& fallback = std::wstring()) const;
+
+			const std::map<std::wstring,std::wstring>& getAttributes() const;
+
+			/**
+			 * Gets the first container among this element's children with the given name.
+			 *
+			 * @return Returns nullptr if there is no such child.
+			 */
+			const Element* getChild(const std::wstring& name) const;
+
+			const std::vector<Element>& getChildren() const;
+
+			const std::wstring& getName() const;
+
+			/**
+			 * Gets the text of a comment or text element, or the text directly within a container with the whitespace around it removed.
+			 */
+			std::wstring getText() const;
+
+			bool hasAttribute(const std::wstring& name) const;
+
+			void setAttribute(const std::wstring& name,const std::wstring& value);
+
+			void setName(const std::wstring& name);
+
+			void setText(const std::wstring& text);
 	};
+
+	/* Function Prototypes */
+	/**
+	 * Reads a UTF-8 document.
+	 *
+	 * @return Returns the document's root element.
+	 *
+	 * @throw
+	 *   std::runtime_error
+	 *     Thrown if the document is not well-formed.
+	 */
+	Element Parse(const char* data,size_t size);
 }
 
 #endif
\ No newline at end of file